@@ -15,6 +15,11 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <chrono>
 #include <ctime>
 #include "ISDataMappings.h"
+#include "ISRinex.h"
+#include "ISLogInventory.h"
+#include "ISLogCompare.h"
+#include "ISMagCal.h"
+#include "ISMcap.h"
 
 using namespace std;
 
@@ -40,6 +45,8 @@ bool cltool_setupLogger(InertialSense& inertialSenseInterface)
     options.maxFileSize = g_commandLineOptions.maxLogFileSize;                          // each log file will be no larger than this in bytes
     options.useSubFolderTimestamp = g_commandLineOptions.logSubFolder != cISLogger::g_emptyString;
     options.timeStamp = g_commandLineOptions.logSubFolder;                              // log sub folder name
+    options.filterFile = g_commandLineOptions.logFilterFile;                            // per DID decimation rules
+    options.deltaEncoding = g_commandLineOptions.logDeltaEncoding;                      // delta encode .dat chunks
     return inertialSenseInterface.EnableLogger(
         g_commandLineOptions.enableLogging,
         g_commandLineOptions.logPath,
@@ -695,6 +702,14 @@ bool cltool_parseCommandLine(int argc, char* argv[])
         {
             g_commandLineOptions.logType = &a[4];
         }
+        else if (startsWith(a, "-lf="))
+        {
+            g_commandLineOptions.logFilterFile = &a[4];
+        }
+        else if (startsWith(a, "-ldelta"))
+        {
+            g_commandLineOptions.logDeltaEncoding = true;
+        }
         else if (startsWith(a, "-magRecal"))
         {
             g_commandLineOptions.rmcPreset = 0;
@@ -765,6 +780,46 @@ bool cltool_parseCommandLine(int argc, char* argv[])
             g_commandLineOptions.logPath = argv[++i];    // use next argument
             enable_display_mode();
         }
+        else if (startsWith(a, "-inventory") && (i + 1) < argc)
+        {
+            while ((i + 1) < argc && argv[i + 1][0] != '-')
+            {   // use all following arguments that are not options
+                g_commandLineOptions.inventoryLogPaths.push_back(argv[++i]);
+            }
+        }
+        else if (startsWith(a, "-logcmptol="))
+        {
+            g_commandLineOptions.compareLogTolerance = atof(&a[11]);
+        }
+        else if (startsWith(a, "-logcmp") && (i + 2) < argc)
+        {
+            g_commandLineOptions.compareLogPathA = argv[++i];
+            g_commandLineOptions.compareLogPathB = argv[++i];
+        }
+        else if (startsWith(a, "-magcal") && (i + 1) < argc)
+        {
+            while ((i + 1) < argc && argv[i + 1][0] != '-')
+            {   // use all following arguments that are not options
+                g_commandLineOptions.magCalLogPaths.push_back(argv[++i]);
+            }
+        }
+        else if (startsWith(a, "-mcaplz4"))
+        {
+            g_commandLineOptions.mcapLz4 = true;
+        }
+        else if (startsWith(a, "-mcap") && (i + 2) < argc)
+        {
+            g_commandLineOptions.mcapOutputFile = argv[++i];
+            g_commandLineOptions.mcapLogPath = argv[++i];
+        }
+        else if (startsWith(a, "-rinex") && (i + 2) < argc)
+        {
+            g_commandLineOptions.rinexOutputDir = argv[++i];
+            while ((i + 1) < argc && argv[i + 1][0] != '-')
+            {   // use all following arguments that are not options
+                g_commandLineOptions.rinexLogPaths.push_back(argv[++i]);
+            }
+        }
         else if (startsWith(a, "-rs="))
         {
             g_commandLineOptions.replayDataLog = true;
@@ -931,6 +986,104 @@ bool cltool_replayDataLog()
     return true;
 }
 
+bool cltool_exportRinex()
+{
+    if (g_commandLineOptions.rinexLogPaths.empty())
+    {
+        cout << "Please specify the log path(s) to export!" << endl;
+        return false;
+    }
+
+    cRinexExporter::sOptions options;
+    options.outputDirectory = g_commandLineOptions.rinexOutputDir;
+    if (g_commandLineOptions.logType.length())
+    {
+        options.logType = cISLogger::ParseLogType(g_commandLineOptions.logType);
+    }
+
+    cout << "Exporting RINEX to: " << options.outputDirectory << endl;
+    cRinexExporter::sStats stats;
+    bool ok = cRinexExporter::Export(g_commandLineOptions.rinexLogPaths, options, &stats);
+    printf("Devices: %u  Epochs: %llu  Observations: %llu  Ephemerides: %llu  Output: %.1f MB  Time: %.2f s\n",
+        stats.devices, (unsigned long long)stats.epochs, (unsigned long long)stats.observations,
+        (unsigned long long)stats.ephemerides, stats.bytesWritten * 1.0e-6, stats.elapsedSec);
+    if (!ok)
+    {
+        cout << "RINEX export failed!" << endl;
+    }
+    return ok;
+}
+
+bool cltool_exportMcap()
+{
+    cMcapExporter::sOptions options;
+    if (g_commandLineOptions.logType.length())
+    {
+        options.logType = cISLogger::ParseLogType(g_commandLineOptions.logType);
+    }
+    if (g_commandLineOptions.mcapLz4)
+    {
+        options.writer.compression = cMcapWriter::COMPRESSION_LZ4;
+    }
+
+    cout << "Exporting MCAP to: " << g_commandLineOptions.mcapOutputFile << endl;
+    cMcapExporter::sStats stats;
+    bool ok = cMcapExporter::Export(g_commandLineOptions.mcapLogPath, g_commandLineOptions.mcapOutputFile, options, &stats);
+    printf("Devices: %u  Channels: %u  Messages: %llu  Output: %.1f MB  Time: %.2f s\n",
+        stats.devices, stats.channels, (unsigned long long)stats.messages, stats.bytesWritten * 1.0e-6, stats.elapsedSec);
+    if (!ok)
+    {
+        cout << "MCAP export failed!" << endl;
+    }
+    return ok;
+}
+
+bool cltool_logInventory()
+{
+    bool ok = true;
+    for (const string& path : g_commandLineOptions.inventoryLogPaths)
+    {
+        cISLogInventory inventory;
+        if (!inventory.Scan(path))
+        {
+            cout << "No logs found in: " << path << endl;
+            ok = false;
+            continue;
+        }
+        cout << "---" << endl << inventory.ToYaml() << endl;
+    }
+    return ok;
+}
+
+bool cltool_compareLogs()
+{
+    cISLogCompare::sOptions options;
+    options.tolerance.abs = g_commandLineOptions.compareLogTolerance;
+    cISLogCompare compare;
+    if (!compare.Compare(g_commandLineOptions.compareLogPathA, g_commandLineOptions.compareLogPathB, cISLogger::ParseLogType(g_commandLineOptions.logType), options))
+    {
+        cout << "No logs found in: " << g_commandLineOptions.compareLogPathA << " or " << g_commandLineOptions.compareLogPathB << endl;
+        return false;
+    }
+    cout << "---" << endl << compare.ToYaml() << endl;
+    return compare.Passed();
+}
+
+bool cltool_magCal()
+{
+    cISMagCal cal;
+    for (const string& path : g_commandLineOptions.magCalLogPaths)
+    {
+        if (!cal.AddLog(path, cISLogger::ParseLogType(g_commandLineOptions.logType)))
+        {
+            cout << "No magnetometer data found in: " << path << endl;
+        }
+    }
+    bool ok = cal.Fit().valid;
+    cout << "---" << endl << cal.ToYaml() << endl;
+    return ok;
+}
+
 void event_outputEvToFile(string fileName, uint8_t* data, int len)
 {
     std::ofstream outfile;
@@ -1196,9 +1349,18 @@ void cltool_outputUsage()
 	cout << "    -lms=" << boldOff << "PERCENT    File culling: Log drive space limit in percent of total drive, 0.0 to 1.0. (default: " << CL_DEFAULT_LOG_DRIVE_USAGE_LIMIT_PERCENT << ")" << endlbOn;
 	cout << "    -lmf=" << boldOff << "BYTES      Log max file size in bytes (default: " << CL_DEFAULT_MAX_LOG_FILE_SIZE << ")" << endlbOn;
 	cout << "    -lts=" << boldOff << "0          Log sub folder, 0 or blank for none, 1 for timestamp, else use as is" << endlbOn;
+	cout << "    -lf=" << boldOff << "FILE        Log filter YAML with per DID decimation rules (every, period_ms, on_change)" << endlbOn;
+	cout << "    -ldelta" << boldOff << "         Delta encode repeated DIDs in dat log chunks (smaller files, needs this SDK version or newer to read)" << endlbOn;
 	cout << "    -r" << boldOff << "              Replay data log from default path" << endlbOn;
 	cout << "    -rp " << boldOff << "PATH        Replay data log from PATH" << endlbOn;
 	cout << "    -rs=" << boldOff << "SPEED       Replay data log at x SPEED. SPEED=0 runs as fast as possible." << endlbOn;
+	cout << "    -inventory " << boldOff << "PATH..   Print YAML summary (devices, DIDs, counts, time span, gaps) of .dat/.raw logs in PATH(s)" << endlbOn;
+	cout << "    -logcmp " << boldOff << "A B     Compare logs in paths A and B by DID and timestamp, print YAML report. Use -lt= to set log type." << endlbOn;
+	cout << "    -logcmptol=" << boldOff << "ABS  Allowed absolute field error for -logcmp (default: 0, exact)" << endlbOn;
+	cout << "    -magcal " << boldOff << "PATH..  Fit hard and soft iron magnetometer calibration to DID_MAGNETOMETER/DID_PIMU_MAG data in log PATH(s), print YAML result" << endlbOn;
+	cout << "    -mcap " << boldOff << "FILE PATH   Export .dat/.raw logs in PATH to MCAP FILE (one channel per device and DID). Use -lt= to set log type." << endlbOn;
+	cout << "    -mcaplz4 " << boldOff << "         LZ4 compress MCAP chunks" << endlbOn;
+	cout << "    -rinex " << boldOff << "DIR PATH.. Export GPS raw data (obs/nav) in log PATH(s) to RINEX 3 files in DIR. Use -lt= to set log type." << endlbOn;
 	cout << endlbOn;
 	cout << "OPTIONS (READ flash config) - DEPRECATED, use `-get` instead" << endl;
 	cout << "    -imxFlashCfg" << boldOff  <<  "                                # List all \"keys\" and \"values\" in IMX" << endlbOn;
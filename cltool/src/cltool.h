@@ -122,6 +122,8 @@ typedef struct cmd_options_s // we need to name this to make MSVC happy, since w
     float logDriveUsageLimitMb;				// -lmb=max_drive_limit_mb, 0 for disabled
     uint32_t maxLogFileSize; 				// -lmf=max_file_size
     std::string logSubFolder; 				// -lts=1
+    std::string logFilterFile; 				// -lf=filter.yaml
+    bool logDeltaEncoding;					// -ldelta
     int baudRate; 							// -baud=3000000
     bool disableBroadcastsOnClose;	
     
@@ -148,6 +150,16 @@ typedef struct cmd_options_s // we need to name this to make MSVC happy, since w
     EVFContainer_t evFCont = {0};
     EVMContainer_t evMCont = {0};
     EVOContainer_t evOCont;
+    std::string rinexOutputDir;				// -rinex OUT_DIR LOG_PATH [LOG_PATH ...]
+    std::vector<std::string> rinexLogPaths;
+    std::vector<std::string> inventoryLogPaths;	// -inventory LOG_PATH [LOG_PATH ...]
+    std::string compareLogPathA;			// -logcmp LOG_PATH_A LOG_PATH_B
+    std::string compareLogPathB;
+    double compareLogTolerance = 0.0;		// -logcmptol=ABS
+    std::vector<std::string> magCalLogPaths;	// -magcal LOG_PATH [LOG_PATH ...]
+    std::string mcapOutputFile;				// -mcap OUT_FILE LOG_PATH
+    std::string mcapLogPath;
+    bool mcapLz4 = false;
 
     bool disableDeviceValidation = false;	// Keep port(s) open even if no devices response is received.
     bool listenMode = false;				// Disable device verification and don't send stop-broadcast command on start.
@@ -166,6 +178,11 @@ bool cltool_setupLogger(InertialSense& inertialSenseInterface);
 bool cltool_parseCommandLine(int argc, char* argv[]);
 bool cltool_replayDataLog();
 bool cltool_extractEventData();
+bool cltool_exportRinex();
+bool cltool_logInventory();
+bool cltool_compareLogs();
+bool cltool_magCal();
+bool cltool_exportMcap();
 void cltool_outputUsage();
 void cltool_outputHelp();
 void cltool_firmwareUpdateWaiter();
@@ -910,21 +910,21 @@ static int cltool_dataStreaming()
         };
         std::map<std::string, std::string, nat_cmp> portDevices;
         int maxPortLen = 0;
-        for (auto d : inertialSenseInterface.getDevices()) {
-            if (ENCODE_DEV_INFO_TO_HDW_ID(d.devInfo) != 0) {
+        for (auto& d : inertialSenseInterface.getDevices()) {
+            if (ENCODE_DEV_INFO_TO_HDW_ID(d.config->devInfo) != 0) {
                 std::string port(d.serialPort.port);
-                if (d.devInfo.firmwareVer[3] == 0) {
+                if (d.config->devInfo.firmwareVer[3] == 0) {
                     portDevices[port] = utils::string_format("SN%u, %s-%d.%d (fw%d.%d.%d %d%c)",
-                                                                          d.devInfo.serialNumber,
-                                                                          g_isHardwareTypeNames[d.devInfo.hardwareType], d.devInfo.hardwareVer[0], d.devInfo.hardwareVer[1],
-                                                                          d.devInfo.firmwareVer[0], d.devInfo.firmwareVer[1], d.devInfo.firmwareVer[2],
-                                                                          d.devInfo.buildNumber, d.devInfo.buildType);
+                                                                          d.config->devInfo.serialNumber,
+                                                                          g_isHardwareTypeNames[d.config->devInfo.hardwareType], d.config->devInfo.hardwareVer[0], d.config->devInfo.hardwareVer[1],
+                                                                          d.config->devInfo.firmwareVer[0], d.config->devInfo.firmwareVer[1], d.config->devInfo.firmwareVer[2],
+                                                                          d.config->devInfo.buildNumber, d.config->devInfo.buildType);
                 } else {
                     portDevices[port] = utils::string_format("SN%u, %s-%d.%d (fw%d.%d.%d.%d %d%c)",
-                                                                          d.devInfo.serialNumber,
-                                                                          g_isHardwareTypeNames[d.devInfo.hardwareType], d.devInfo.hardwareVer[0], d.devInfo.hardwareVer[1],
-                                                                          d.devInfo.firmwareVer[0], d.devInfo.firmwareVer[1], d.devInfo.firmwareVer[2], d.devInfo.firmwareVer[3],
-                                                                          d.devInfo.buildNumber, d.devInfo.buildType);
+                                                                          d.config->devInfo.serialNumber,
+                                                                          g_isHardwareTypeNames[d.config->devInfo.hardwareType], d.config->devInfo.hardwareVer[0], d.config->devInfo.hardwareVer[1],
+                                                                          d.config->devInfo.firmwareVer[0], d.config->devInfo.firmwareVer[1], d.config->devInfo.firmwareVer[2], d.config->devInfo.firmwareVer[3],
+                                                                          d.config->devInfo.buildNumber, d.config->devInfo.buildType);
                 }
                 maxPortLen = std::max<int>(maxPortLen, (int)strlen(d.serialPort.port));
             }
@@ -1058,7 +1058,7 @@ static int cltool_dataStreaming()
     //If Firmware Update is specified return an error code based on the Status of the Firmware Update
     if ((g_commandLineOptions.updateFirmwareTarget != fwUpdate::TARGET_HOST) && g_commandLineOptions.updateAppFirmwareFilename.empty()) {
         for (auto& device : inertialSenseInterface.getDevices()) {
-            if (device.fwUpdate.hasError) {
+            if (device.config->fwUpdate.hasError) {
                 exitCode = EXIT_CODE_FIRMWARE_UPDATE_FAILED;
                 break;
             }
@@ -1110,6 +1110,36 @@ static int inertialSenseMain()
         return cltool_extractEventData();
     }
 
+    // if RINEX export, return after completing
+    else if (g_commandLineOptions.rinexLogPaths.size())
+    {
+        return cltool_exportRinex();
+    }
+
+    // if MCAP export, return after completing
+    else if (g_commandLineOptions.mcapOutputFile.size())
+    {
+        return cltool_exportMcap();
+    }
+
+    // if log inventory, return after completing
+    else if (g_commandLineOptions.inventoryLogPaths.size())
+    {
+        return cltool_logInventory();
+    }
+
+    // if log compare, return after completing
+    else if (g_commandLineOptions.compareLogPathA.size())
+    {
+        return cltool_compareLogs();
+    }
+
+    // if magnetometer calibration from logs, return after completing
+    else if (g_commandLineOptions.magCalLogPaths.size())
+    {
+        return cltool_magCal();
+    }
+
     // if app firmware was specified on the command line, do that now and return
     else if ((g_commandLineOptions.updateFirmwareTarget == fwUpdate::TARGET_HOST) && (g_commandLineOptions.updateAppFirmwareFilename.length() != 0))
     {
@@ -70,6 +70,14 @@
 #define PRINTF_SUPPORT_EXPONENTIAL
 #endif
 
+// exact decimal rounding of %f/%e/%g using 64 bit integer arithmetic instead of
+// floating point multiply and divide, which can be off in the last digit and limit
+// %f to 9 decimals.  Values out of its range use the floating point method.
+// default: activated
+#ifndef PRINTF_DISABLE_EXACT_FLOAT
+#define PRINTF_EXACT_FLOAT
+#endif
+
 // define the default floating point precision
 // default: 6 digits
 #ifndef PRINTF_DEFAULT_FLOAT_PRECISION
@@ -335,16 +343,227 @@ static size_t _etoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, d
 #endif
 
 
-// internal ftoa for fixed decimal floating point
-static size_t _ftoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags)
+// largest precision of the decimals computed by _ftoa, the rest are padded with 0s
+#if defined(PRINTF_EXACT_FLOAT)
+#define PRINTF_FTOA_MAX_PRECISION  19U
+#else
+#define PRINTF_FTOA_MAX_PRECISION  9U
+#endif
+
+
+#if defined(PRINTF_EXACT_FLOAT)
+// powers of 10 that fit in 64 bits
+static const uint64_t _pow10_u64[] = { 1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+  10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL, 1000000000000000ULL,
+  10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL };
+
+
+// 64 x 64 bit multiply with 128 bit result
+static inline void _mul_64x64(uint64_t a, uint64_t b, uint64_t* hi, uint64_t* lo)
+{
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 p = (unsigned __int128)a * b;
+  *hi = (uint64_t)(p >> 64U);
+  *lo = (uint64_t)p;
+#else
+  const uint64_t p00 = (a & 0xFFFFFFFFU) * (b & 0xFFFFFFFFU);
+  const uint64_t p01 = (a & 0xFFFFFFFFU) * (b >> 32U);
+  const uint64_t p10 = (a >> 32U) * (b & 0xFFFFFFFFU);
+  const uint64_t p11 = (a >> 32U) * (b >> 32U);
+  const uint64_t mid = (p00 >> 32U) + (p01 & 0xFFFFFFFFU) + (p10 & 0xFFFFFFFFU);
+  *lo = (mid << 32U) | (p00 & 0xFFFFFFFFU);
+  *hi = p11 + (p01 >> 32U) + (p10 >> 32U) + (mid >> 32U);
+#endif
+}
+
+
+// split value >= 0 into its whole part and binary fraction: value = whole + frac / 2^k, with frac < 2^k
+// \return false if the whole part doesn't fit in 63 bits
+static bool _split_double(double value, uint64_t* whole, uint64_t* frac, unsigned int* k)
+{
+  union {
+    uint64_t U;
+    double   F;
+  } conv;
+
+  conv.F = value;
+  const int exp2 = (int)((conv.U >> 52U) & 0x07FFU);
+  uint64_t mantissa = conv.U & ((1ULL << 52U) - 1U);
+  int e = -1074;  // subnormal
+  if (exp2) {
+    mantissa |= 1ULL << 52U;
+    e = exp2 - 1075;
+  }
+
+  if (e >= 0) {
+    if (e > 10) {
+      return false;
+    }
+    *whole = mantissa << e;
+    *frac  = 0U;
+    *k     = 0U;
+  }
+  else {
+    *k = (unsigned int)-e;
+    if (*k < 64U) {
+      *whole = mantissa >> *k;
+      *frac  = mantissa & ((1ULL << *k) - 1U);
+    }
+    else {
+      *whole = 0U;
+      *frac  = mantissa;
+    }
+  }
+  return true;
+}
+
+
+// *q = floor(frac / 2^k * 10^shift), for frac < 2^k and shift <= 38
+// \return -1, 0 or 1 if the remainder is below, exactly or above one half, 2 if q doesn't fit in 64 bits
+static int _scale_fraction(uint64_t frac, unsigned int k, unsigned int shift, uint64_t* q)
+{
+  *q = 0U;
+  if (!frac || (k > 181U)) {
+    // frac * 10^shift < 2^181, so below half of 2^k
+    return -1;
+  }
+
+  // frac * 10^shift, least significant word first
+  uint64_t p[3] = { 0U, 0U, 0U };
+  _mul_64x64(frac, _pow10_u64[(shift > 19U) ? 19U : shift], &p[1], &p[0]);
+  if (shift > 19U) {
+    uint64_t hi, lo;
+    _mul_64x64(p[1], _pow10_u64[shift - 19U], &p[2], &p[1]);
+    _mul_64x64(p[0], _pow10_u64[shift - 19U], &hi, &lo);
+    p[0] = lo;
+    p[1] += hi;
+    p[2] += (p[1] < hi);
+  }
+
+  // q is bits [k, k + 64)
+  const unsigned int w = k / 64U, b = k % 64U;
+  uint64_t above = (w < 1U) ? p[2] : 0U;
+  *q = p[w] >> b;
+  if (w < 2U) {
+    *q    |= b ? (p[w + 1U] << (64U - b)) : 0U;
+    above |= b ? (p[w + 1U] >> b) : p[w + 1U];
+  }
+  if (above) {
+    return 2;
+  }
+
+  // remainder, bits [0, k), against one half
+  const unsigned int hw = (k - 1U) / 64U, hb = (k - 1U) % 64U;
+  bool below = (p[hw] & ((1ULL << hb) - 1U)) != 0U;
+  for (unsigned int i = 0U; i < hw; i++) {
+    below |= (p[i] != 0U);
+  }
+  return ((p[hw] >> hb) & 1U) ? (below ? 1 : 0) : -1;
+}
+
+
+// round value >= 0 to prec decimals, exactly and half to even: value ~= whole + frac / 10^prec
+static bool _ftoa_exact(double value, unsigned int prec, uint64_t* whole, uint64_t* frac)
+{
+  uint64_t bits;
+  unsigned int k;
+  if (!_split_double(value, whole, &bits, &k)) {
+    return false;
+  }
+
+  const int half = _scale_fraction(bits, k, prec, frac);
+  if ((half > 0) || ((half == 0) && ((prec ? *frac : *whole) & 1U))) {
+    // handle rollover, e.g. case 0.99 with prec 1 is 1.0
+    if (prec && (++(*frac) < _pow10_u64[prec])) {
+      return true;
+    }
+    *frac = 0U;
+    ++(*whole);
+  }
+  return true;
+}
+#endif  // PRINTF_EXACT_FLOAT
+
+
+// append the decimal digits of value in reverse, at least count of them
+static size_t _ftoa_digits(char* buf, size_t len, uint64_t value, unsigned int count)
+{
+  // 64 bit division is slow on 32 bit targets, only use it for the upper digits
+  while ((len < PRINTF_FTOA_BUFFER_SIZE) && (value > 0xFFFFFFFFU)) {
+    buf[len++] = (char)(48U + (unsigned int)(value % 10U));
+    value /= 10U;
+    if (count) {
+      count--;
+    }
+  }
+  uint32_t v = (uint32_t)value;
+  while (len < PRINTF_FTOA_BUFFER_SIZE) {
+    buf[len++] = (char)(48U + (v % 10U));
+    v /= 10U;
+    if (count) {
+      count--;
+    }
+    if (!v && !count) {
+      break;
+    }
+  }
+  return len;
+}
+
+
+// internal ftoa format, whole.frac with prec decimals followed by zeros 0s
+static size_t _ftoa_format(out_fct_type out, char* buffer, size_t idx, size_t maxlen, uint64_t whole, uint64_t frac, bool negative, unsigned int prec, unsigned int zeros, unsigned int width, unsigned int flags)
 {
   char buf[PRINTF_FTOA_BUFFER_SIZE];
-  size_t len  = 0U;
-  double diff = 0.0;
+  size_t len = 0U;
 
-  // powers of 10
-  static const double pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+  // number is reversed, so start with the extra 0s
+  while ((len < PRINTF_FTOA_BUFFER_SIZE) && zeros) {
+    buf[len++] = '0';
+    zeros--;
+  }
 
+  if (prec) {
+    // fractional part, as an unsigned number
+    len = _ftoa_digits(buf, len, frac, prec);
+    if (len < PRINTF_FTOA_BUFFER_SIZE) {
+      // add decimal
+      buf[len++] = '.';
+    }
+  }
+
+  // do whole part
+  len = _ftoa_digits(buf, len, whole, 1U);
+
+  // pad leading zeros
+  if (!(flags & FLAGS_LEFT) && (flags & FLAGS_ZEROPAD)) {
+    if (width && (negative || (flags & (FLAGS_PLUS | FLAGS_SPACE)))) {
+      width--;
+    }
+    while ((len < width) && (len < PRINTF_FTOA_BUFFER_SIZE)) {
+      buf[len++] = '0';
+    }
+  }
+
+  if (len < PRINTF_FTOA_BUFFER_SIZE) {
+    if (negative) {
+      buf[len++] = '-';
+    }
+    else if (flags & FLAGS_PLUS) {
+      buf[len++] = '+';  // ignore the space if the '+' exists
+    }
+    else if (flags & FLAGS_SPACE) {
+      buf[len++] = ' ';
+    }
+  }
+
+  return _out_rev(out, buffer, idx, maxlen, buf, len, width, flags);
+}
+
+
+// internal ftoa for fixed decimal floating point
+static size_t _ftoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags)
+{
   // test for special values
   if (value != value)
     return _out_rev(out, buffer, idx, maxlen, "nan", 3, width, flags);
@@ -374,95 +593,131 @@ static size_t _ftoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, d
   if (!(flags & FLAGS_PRECISION)) {
     prec = PRINTF_DEFAULT_FLOAT_PRECISION;
   }
-  // limit precision to 9, cause a prec >= 10 can lead to overflow errors
-  while ((len < PRINTF_FTOA_BUFFER_SIZE) && (prec > 9U)) {
-    buf[len++] = '0';
-    prec--;
+  // limit precision, cause a higher prec can lead to overflow errors
+  unsigned int zeros = 0U;
+  if (prec > PRINTF_FTOA_MAX_PRECISION) {
+    zeros = prec - PRINTF_FTOA_MAX_PRECISION;
+    prec  = PRINTF_FTOA_MAX_PRECISION;
   }
 
-  int whole = (int)value;
-  double tmp = (value - whole) * pow10[prec];
-  unsigned long frac = (unsigned long)tmp;
-  diff = tmp - frac;
+  uint64_t whole, frac;
+#if defined(PRINTF_EXACT_FLOAT)
+  if (!_ftoa_exact(value, prec, &whole, &frac))
+#endif
+  {
+    // powers of 10
+    static const double pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
 
-  if (diff > 0.5) {
-    ++frac;
-    // handle rollover, e.g. case 0.99 with prec 1 is 1.0
-    if (frac >= pow10[prec]) {
-      frac = 0;
-      ++whole;
+    while (prec > 9U) {
+      zeros++;
+      prec--;
     }
-  }
-  else if (diff < 0.5) {
-  }
-  else if ((frac == 0U) || (frac & 1U)) {
-    // if halfway, round up if odd OR if last digit is 0
-    ++frac;
-  }
 
-  if (prec == 0U) {
-    diff = value - (double)whole;
-    if ((!(diff < 0.5) || (diff > 0.5)) && (whole & 1)) {
-      // exactly 0.5 and ODD, then round up
-      // 1.5 -> 2, but 2.5 -> 2
-      ++whole;
-    }
-  }
-  else {
-    unsigned int count = prec;
-    // now do fractional part, as an unsigned number
-    while (len < PRINTF_FTOA_BUFFER_SIZE) {
-      --count;
-      buf[len++] = (char)(48U + (frac % 10U));
-      if (!(frac /= 10U)) {
-        break;
+    whole = (uint64_t)value;
+    double tmp = (value - (double)whole) * pow10[prec];
+    frac = (uint64_t)tmp;
+    double diff = tmp - (double)frac;
+
+    if (diff > 0.5) {
+      ++frac;
+      // handle rollover, e.g. case 0.99 with prec 1 is 1.0
+      if (frac >= pow10[prec]) {
+        frac = 0;
+        ++whole;
       }
     }
-    // add extra 0s
-    while ((len < PRINTF_FTOA_BUFFER_SIZE) && (count-- > 0U)) {
-      buf[len++] = '0';
+    else if (diff < 0.5) {
     }
-    if (len < PRINTF_FTOA_BUFFER_SIZE) {
-      // add decimal
-      buf[len++] = '.';
+    else if ((frac == 0U) || (frac & 1U)) {
+      // if halfway, round up if odd OR if last digit is 0
+      ++frac;
     }
-  }
 
-  // do whole part, number is reversed
-  while (len < PRINTF_FTOA_BUFFER_SIZE) {
-    buf[len++] = (char)(48 + (whole % 10));
-    if (!(whole /= 10)) {
-      break;
+    if (prec == 0U) {
+      diff = value - (double)whole;
+      if ((!(diff < 0.5) || (diff > 0.5)) && (whole & 1)) {
+        // exactly 0.5 and ODD, then round up
+        // 1.5 -> 2, but 2.5 -> 2
+        ++whole;
+      }
     }
   }
 
-  // pad leading zeros
-  if (!(flags & FLAGS_LEFT) && (flags & FLAGS_ZEROPAD)) {
-    if (width && (negative || (flags & (FLAGS_PLUS | FLAGS_SPACE)))) {
-      width--;
+  return _ftoa_format(out, buffer, idx, maxlen, whole, frac, negative, prec, zeros, width, flags);
+}
+
+
+#if defined(PRINTF_SUPPORT_EXPONENTIAL)
+#if defined(PRINTF_EXACT_FLOAT)
+// round value >= 0 to prec + 1 significant digits, exactly and half to even: value ~= digits * 10^(exp10 - prec)
+// *exp10 is the estimated decimal exponent on input and the one of the rounded value on output
+static bool _etoa_exact(double value, unsigned int prec, int* exp10, uint64_t* digits)
+{
+  uint64_t whole, frac;
+  unsigned int k;
+  if ((prec > 17U) || !_split_double(value, &whole, &frac, &k)) {
+    return false;
+  }
+  if (value == 0.0) {
+    *exp10  = 0;
+    *digits = 0U;
+    return true;
+  }
+
+  // the estimate may be off by one
+  for (int i = 0; i < 4; i++) {
+    const int shift = (int)prec - *exp10;
+    uint64_t q;
+    int half;
+    if (shift >= 0) {
+      // value * 10^shift
+      if ((shift > 38) || (whole && (shift > 19))) {
+        return false;
+      }
+      uint64_t hi = 0U, lo = 0U;
+      if (whole) {
+        _mul_64x64(whole, _pow10_u64[shift], &hi, &lo);
+      }
+      half = _scale_fraction(frac, k, (unsigned int)shift, &q);
+      q += lo;
+      if (hi || (q < lo) || (half > 1)) {
+        return false;
+      }
     }
-    while ((len < width) && (len < PRINTF_FTOA_BUFFER_SIZE)) {
-      buf[len++] = '0';
+    else {
+      // value / 10^-shift
+      if (shift < -19) {
+        return false;
+      }
+      const uint64_t p = _pow10_u64[-shift];
+      const uint64_t rem = whole % p;
+      q = whole / p;
+      half = (rem > p / 2U) ? 1 : ((rem < p / 2U) ? -1 : (frac ? 1 : 0));
     }
-  }
 
-  if (len < PRINTF_FTOA_BUFFER_SIZE) {
-    if (negative) {
-      buf[len++] = '-';
+    if (q >= _pow10_u64[prec + 1U]) {
+      ++(*exp10);
     }
-    else if (flags & FLAGS_PLUS) {
-      buf[len++] = '+';  // ignore the space if the '+' exists
+    else if (q < _pow10_u64[prec]) {
+      --(*exp10);
     }
-    else if (flags & FLAGS_SPACE) {
-      buf[len++] = ' ';
+    else {
+      if ((half > 0) || ((half == 0) && (q & 1U))) {
+        // handle rollover, e.g. case 9.96 with prec 1 is 1.0e+01
+        if (++q == _pow10_u64[prec + 1U]) {
+          q = _pow10_u64[prec];
+          ++(*exp10);
+        }
+      }
+      *digits = q;
+      return true;
     }
   }
-
-  return _out_rev(out, buffer, idx, maxlen, buf, len, width, flags);
+  return false;
 }
+#endif  // PRINTF_EXACT_FLOAT
 
 
-#if defined(PRINTF_SUPPORT_EXPONENTIAL)
 // internal ftoa variant for exponential floating-point type, contributed by Martijn Jasperse <m.jasperse@gmail.com>
 static size_t _etoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags)
 {
@@ -533,6 +788,17 @@ static size_t _etoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, d
     }
   }
 
+#if defined(PRINTF_EXACT_FLOAT)
+  // exact significant digits, rounding may carry into the next exponent
+  uint64_t digits = 0U;
+  int exp10 = expval;
+  const bool exact = minwidth && _etoa_exact(value, prec, &exp10, &digits);
+  if (exact) {
+    expval   = exp10;
+    minwidth = ((expval < 100) && (expval > -100)) ? 4U : 5U;
+  }
+#endif
+
   // will everything fit?
   unsigned int fwidth = width;
   if (width > minwidth) {
@@ -547,14 +813,21 @@ static size_t _etoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, d
     fwidth = 0U;
   }
 
-  // rescale the float value
-  if (expval) {
-    value /= conv.F;
-  }
-
   // output the floating part
   const size_t start_idx = idx;
-  idx = _ftoa(out, buffer, idx, maxlen, negative ? -value : value, prec, fwidth, flags & ~FLAGS_ADAPT_EXP);
+#if defined(PRINTF_EXACT_FLOAT)
+  if (exact) {
+    idx = _ftoa_format(out, buffer, idx, maxlen, digits / _pow10_u64[prec], digits % _pow10_u64[prec], negative, prec, 0U, fwidth, flags);
+  }
+  else
+#endif
+  {
+    // rescale the float value
+    if (expval) {
+      value /= conv.F;
+    }
+    idx = _ftoa(out, buffer, idx, maxlen, negative ? -value : value, prec, fwidth, flags & ~FLAGS_ADAPT_EXP);
+  }
 
   // output the exponent part
   if (minwidth) {
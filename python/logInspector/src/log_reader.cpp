@@ -32,10 +32,9 @@ void LogReader::log_message(int did, uint8_t* msg, std::vector<gps_raw_wrapper_t
   {
   case raw_data_type_observation:
   {
-    std::vector<obsd_t> obs{raw_msg->obsCount};
-    for (int i = 0; i < raw_msg->obsCount; i++)
-      obs.push_back(raw_msg->data.obs[i]);
-    vec[0].obs.push_back(obs);
+    int count = std::min<int>(raw_msg->obsCount, MAX_OBSERVATION_COUNT_IN_RTK_MESSAGE);
+    std::vector<obsd_t> obs(raw_msg->data.obs, raw_msg->data.obs + count);
+    vec[0].obs.push_back(std::move(obs));
     break;
   }
   case raw_data_type_ephemeris:
@@ -44,7 +44,7 @@ cDataChunk::cDataChunk()
 	m_dataHead = m_buffHead;
 	m_dataTail = m_buffHead;
 
-	SetName("PDAT");
+	SetName(DATA_CHUNK_NAME);
 }
 
 
@@ -157,17 +157,39 @@ int32_t cDataChunk::WriteToFile(cISLogFileBase* pFile, int groupNumber, bool wri
 	m_hdr.grpNum = groupNumber;
 
 	int32_t nBytes = 0;
-	if (writeHeader)
+	int32_t dataSize = m_hdr.dataSize;
+	if (writeHeader && m_deltaEncoding)
 	{
-		// Write chunk header to file
-		nBytes += static_cast<int32_t>(pFile->write(&m_hdr, sizeof(sChunkHeader)));
+		m_encoded.resize(DeltaEncodeBound(dataSize));
+		dataSize = DeltaEncode(m_dataHead, dataSize, m_encoded.data());
 
-		// Write any additional chunk header
+		// Header describes the encoded data.  m_hdr is left as is for the next chunk.
+		sChunkHeader hdr = m_hdr;
+		memcpy(hdr.name, DATA_CHUNK_NAME_DELTA, 4);
+		for (int i = 0; i < 4; i++)
+		{
+			hdr.invName[i] = ~hdr.name[i];
+		}
+		hdr.dataSize = dataSize;
+		hdr.invDataSize = ~hdr.dataSize;
+		nBytes += static_cast<int32_t>(pFile->write(&hdr, sizeof(sChunkHeader)));
 		nBytes += WriteAdditionalChunkHeader(pFile);
+		nBytes += static_cast<int32_t>(pFile->write(m_encoded.data(), dataSize));
 	}
+	else
+	{
+		if (writeHeader)
+		{
+			// Write chunk header to file
+			nBytes += static_cast<int32_t>(pFile->write(&m_hdr, sizeof(sChunkHeader)));
+
+			// Write any additional chunk header
+			nBytes += WriteAdditionalChunkHeader(pFile);
+		}
 
-	// Write chunk data to file
-	nBytes += static_cast<int32_t>(pFile->write(m_dataHead, m_hdr.dataSize));
+		// Write chunk data to file
+		nBytes += static_cast<int32_t>(pFile->write(m_dataHead, m_hdr.dataSize));
+	}
 
 #if LOG_DEBUG_CHUNK_WRITE
 	static int totalBytes = 0;
@@ -179,7 +201,7 @@ int32_t cDataChunk::WriteToFile(cISLogFileBase* pFile, int groupNumber, bool wri
 #endif
 
 	// Error writing to file
-	if (writeHeader && (nBytes != GetHeaderSize() + (int)m_hdr.dataSize))
+	if (writeHeader && (nBytes != GetHeaderSize() + dataSize))
 	{
 		return -1;
 	}
@@ -225,6 +247,24 @@ int32_t cDataChunk::ReadFromFile(cISLogFileBase* pFile, bool readHeader)
 	}
 
 	// Read chunk data
+	if (readHeader && memcmp(m_hdr.name, DATA_CHUNK_NAME_DELTA, 4) == 0)
+	{
+		m_encoded.resize(m_hdr.dataSize);
+		int32_t encodedSize = static_cast<int32_t>(pFile->read(m_encoded.data(), m_hdr.dataSize));
+		int32_t dataSize = DeltaDecode(m_encoded.data(), encodedSize, m_buffHead, GetBuffSize());
+		if (encodedSize != (int32_t)m_hdr.dataSize || dataSize < 0)
+		{
+			Clear();
+			return -1;
+		}
+		nBytes += encodedSize;
+
+		// Chunk now holds the decoded records
+		m_dataTail += dataSize;
+		m_hdr.dataSize = dataSize;
+		m_hdr.invDataSize = ~m_hdr.dataSize;
+		return (m_hdr.marker == DATA_CHUNK_MARKER ? nBytes : -1);
+	}
 	m_dataTail += static_cast<int32_t>(pFile->read(m_buffHead, m_hdr.dataSize));
 	nBytes += GetDataSize();
 
@@ -296,6 +336,204 @@ int32_t cDataChunk::ReadFromFile(cISLogFileBase* pFile, bool readHeader)
 }
 
 
+static inline uint8_t* putVarint(uint8_t* p, uint32_t v)
+{
+	while (v >= 0x80)
+	{
+		*p++ = (uint8_t)(v | 0x80);
+		v >>= 7;
+	}
+	*p++ = (uint8_t)v;
+	return p;
+}
+
+static inline bool getVarint(const uint8_t*& p, const uint8_t* end, uint32_t& v)
+{
+	v = 0;
+	for (int shift = 0; p < end && shift < 32; shift += 7)
+	{
+		uint8_t b = *p++;
+		v |= (uint32_t)(b & 0x7F) << shift;
+		if (!(b & 0x80))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Length of the run of equal bytes starting at a and b
+static inline uint32_t equalRun(const uint8_t* a, const uint8_t* b, uint32_t size)
+{
+	uint32_t n = 0;
+	for (; n + 8 <= size; n += 8)
+	{
+		uint64_t x, y;
+		memcpy(&x, a + n, 8);
+		memcpy(&y, b + n, 8);
+		if (x != y)
+		{
+			break;
+		}
+	}
+	while (n < size && a[n] == b[n])
+	{
+		n++;
+	}
+	return n;
+}
+
+enum eDeltaRecord
+{
+	DELTA_RECORD_LITERAL = 0,		// p_data_hdr_t size, offset and data follow the id
+	DELTA_RECORD_DELTA = 1,			// Runs against the prior record of this id follow the id
+};
+
+// Equal runs shorter than this are cheaper to copy than to split into another run pair
+#define DELTA_MIN_EQUAL_RUN		3
+
+int32_t cDataChunk::DeltaEncode(const uint8_t* src, int32_t size, uint8_t* dst)
+{
+	const p_data_hdr_t* prior[256] = {};
+	const uint8_t* end = src + size;
+	uint8_t* op = dst;
+
+	while (src + sizeof(p_data_hdr_t) <= end)
+	{
+		const p_data_hdr_t* hdr = (const p_data_hdr_t*)src;
+		const uint8_t* data = src + sizeof(p_data_hdr_t);
+		if (data + hdr->size > end)
+		{	// Truncated record
+			break;
+		}
+
+		const p_data_hdr_t* prev = prior[hdr->id];
+		uint8_t* rec = op;
+		bool literal = true;
+		if (prev && prev->size == hdr->size && prev->offset == hdr->offset && hdr->size)
+		{
+			const uint8_t* prevData = (const uint8_t*)(prev + 1);
+			uint8_t* limit = rec + sizeof(p_data_hdr_t) + hdr->size;	// Not worth it beyond the literal size
+			*op++ = hdr->id;
+			*op++ = DELTA_RECORD_DELTA;
+			uint32_t pos = 0;
+			while (pos < hdr->size && op < limit)
+			{
+				uint32_t equal = equalRun(data + pos, prevData + pos, hdr->size - pos);
+				uint32_t start = pos + equal;
+				uint32_t changed = start;
+				while (changed < hdr->size)
+				{
+					uint32_t run = equalRun(data + changed, prevData + changed, _MIN(hdr->size - changed, (uint32_t)DELTA_MIN_EQUAL_RUN));
+					if (run == DELTA_MIN_EQUAL_RUN || changed + run == hdr->size)
+					{
+						break;
+					}
+					changed += run + 1;
+				}
+				op = putVarint(op, equal);
+				op = putVarint(op, changed - start);
+				if (op + (changed - start) > limit)
+				{
+					break;
+				}
+				memcpy(op, data + start, changed - start);
+				op += changed - start;
+				pos = changed;
+			}
+			literal = (pos < hdr->size || op > limit);
+		}
+
+		if (literal)
+		{
+			op = rec;
+			*op++ = hdr->id;
+			*op++ = DELTA_RECORD_LITERAL;
+			memcpy(op, &hdr->size, sizeof(hdr->size));
+			op += sizeof(hdr->size);
+			memcpy(op, &hdr->offset, sizeof(hdr->offset));
+			op += sizeof(hdr->offset);
+			memcpy(op, data, hdr->size);
+			op += hdr->size;
+		}
+
+		prior[hdr->id] = hdr;
+		src = data + hdr->size;
+	}
+
+	return (int32_t)(op - dst);
+}
+
+int32_t cDataChunk::DeltaDecode(const uint8_t* src, int32_t size, uint8_t* dst, int32_t dstSize)
+{
+	const p_data_hdr_t* prior[256] = {};
+	const uint8_t* end = src + size;
+	uint8_t* op = dst;
+	uint8_t* oend = dst + dstSize;
+
+	while (src < end)
+	{
+		if (end - src < 2 || oend - op < (ptrdiff_t)sizeof(p_data_hdr_t))
+		{
+			return -1;
+		}
+		p_data_hdr_t* hdr = (p_data_hdr_t*)op;
+		hdr->id = *src++;
+		uint8_t* data = op + sizeof(p_data_hdr_t);
+
+		if (*src++ == DELTA_RECORD_LITERAL)
+		{
+			if (end - src < 4)
+			{
+				return -1;
+			}
+			memcpy(&hdr->size, src, sizeof(hdr->size));
+			memcpy(&hdr->offset, src + 2, sizeof(hdr->offset));
+			src += 4;
+			if (end - src < hdr->size || oend - data < hdr->size)
+			{
+				return -1;
+			}
+			memcpy(data, src, hdr->size);
+			src += hdr->size;
+		}
+		else
+		{
+			const p_data_hdr_t* prev = prior[hdr->id];
+			if (prev == NULLPTR)
+			{
+				return -1;
+			}
+			hdr->size = prev->size;
+			hdr->offset = prev->offset;
+			if (oend - data < hdr->size)
+			{
+				return -1;
+			}
+			memcpy(data, prev + 1, hdr->size);
+			for (uint32_t pos = 0; pos < hdr->size; )
+			{
+				uint32_t equal, changed;
+				if (!getVarint(src, end, equal) || !getVarint(src, end, changed) ||
+					equal > hdr->size - pos || changed > hdr->size - pos - equal || (uint32_t)(end - src) < changed)
+				{
+					return -1;
+				}
+				pos += equal;
+				memcpy(data + pos, src, changed);
+				src += changed;
+				pos += changed;
+			}
+		}
+
+		prior[hdr->id] = hdr;
+		op = data + hdr->size;
+	}
+
+	return (int32_t)(op - dst);
+}
+
+
 int32_t cDataChunk::WriteAdditionalChunkHeader(cISLogFileBase* /*pFile*/)
 {
 	return 0;
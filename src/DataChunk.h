@@ -21,8 +21,11 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #endif
 
 #define DATA_CHUNK_MARKER           0xFC05EA32
+#define DATA_CHUNK_NAME             "PDAT"
+#define DATA_CHUNK_NAME_DELTA       "PDLT"          // Records delta encoded against the prior record of the same DID (see cDataChunk::DeltaEncode)
 
 #include <stdint.h>
+#include <vector>
 
 #include "com_manager.h"
 #include "ISLogFileBase.h"
@@ -129,6 +132,20 @@ public:
     int32_t WriteToFile(cISLogFileBase* pFile, int groupNumber = 0, bool writeHeader = true); // Returns number of bytes written to file and clears the chunk
 	int32_t ReadFromFile(cISLogFileBase* pFile, bool readHeader = true);
 	int32_t PushBack(uint8_t* d1, int32_t d1Size, uint8_t* d2 = NULL, int32_t d2Size = 0);
+    void SetDeltaEncoding(bool enable) { m_deltaEncoding = enable; }
+    bool DeltaEncoding() { return m_deltaEncoding; }
+
+    /**
+     * Delta encode a buffer of p_data_hdr_t + data records.  A record with the same id, size and offset as the prior
+     * record of that id is stored as varint (unchanged, changed) byte run lengths followed by the changed bytes.  Other
+     * records are stored literally.  Each chunk is encoded independently.  dst must hold DeltaEncodeBound(size) bytes.
+     * @return encoded size
+     */
+    static int32_t DeltaEncode(const uint8_t* src, int32_t size, uint8_t* dst);
+    static int32_t DeltaEncodeBound(int32_t size) { return size + size / (int32_t)sizeof(p_data_hdr_t) + 16; }
+
+    /** @return decoded size, or -1 if src is corrupt or the records don't fit in dstSize */
+    static int32_t DeltaDecode(const uint8_t* src, int32_t size, uint8_t* dst, int32_t dstSize);
 
 	virtual void Clear();
 
@@ -153,6 +170,8 @@ private:
     uint8_t* m_buffTail;    // End of buffer
     uint8_t* m_dataHead;    // Front of data in buffer.  This moves as data is read.
     uint8_t* m_dataTail;    // End of data in buffer.  This moves as data is written.
+    bool m_deltaEncoding = false;
+    std::vector<uint8_t> m_encoded;
 };
 
 
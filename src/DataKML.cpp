@@ -57,7 +57,7 @@ std::string cDataKML::GetDatasetName(int kid)
 	}
 }
 
-int cDataKML::WriteDataToFile(std::vector<sKmlLogData>& list, const p_data_hdr_t* dataHdr, const uint8_t* dataBuf)
+int cDataKML::WriteDataToFile(kml_log_data_t& list, const p_data_hdr_t* dataHdr, const uint8_t* dataBuf)
 {
 	uDatasets& d = (uDatasets&)(*dataBuf);
 	ixEuler theta;
@@ -98,6 +98,16 @@ int cDataKML::WriteDataToFile(std::vector<sKmlLogData>& list, const p_data_hdr_t
         break;
 	}
 
+    if (!cISMemory::Available(cISMemory::KML, cISMemory::GrowthBytes(list)))
+    {   // Memory cap reached, halve the track resolution instead of growing
+        size_t n = list.size(), j = 0;
+        for (size_t i = 0; i < n; i += 2)
+        {
+            list[j++] = list[i];
+        }
+        list.resize(j);
+        cISMemory::Shed(cISMemory::KML, n - j);
+    }
     list.push_back(data);
 
     return 0;
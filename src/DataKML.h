@@ -19,6 +19,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include "tinyxml.h"
 #include "com_manager.h"
+#include "ISMemory.h"
 
 #ifdef USE_IS_INTERNAL
 #	include "../../cpp/libs/families/imx/IS_internal.h"
@@ -54,6 +55,8 @@ struct sKmlLogData
 	}
 };
 
+typedef is_counted_vector<sKmlLogData, cISMemory::KML> kml_log_data_t;
+
 
 class cDataKML
 {
@@ -102,7 +105,7 @@ public:
 	
 	cDataKML();
 	std::string GetDatasetName(int kid);
-    int WriteDataToFile(std::vector<sKmlLogData>& list, const p_data_hdr_t* dataHdr, const uint8_t* dataBuf);
+    int WriteDataToFile(kml_log_data_t& list, const p_data_hdr_t* dataHdr, const uint8_t* dataBuf);
 };
 
 #endif // DATA_KML_H
@@ -22,12 +22,14 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <stddef.h>
 
 #include "ISDevice.h"
+#include "ISClock.h"
 #include "DeviceLog.h"
 #include "ISFileManager.h"
 #include "ISConstants.h"
 #include "ISDataMappings.h"
 #include "ISLogFileFactory.h"
 #include "util/util.h"
+#include "time_conversion.h"
 
 using namespace std;
 
@@ -38,8 +40,8 @@ cDeviceLog::cDeviceLog() {
 cDeviceLog::cDeviceLog(const ISDevice* dev) : device(dev)  {
     if (dev == nullptr)
         throw std::invalid_argument("cDeviceLog() must be passed a valid ISDevice instance.");
-    m_devHdwId = ENCODE_DEV_INFO_TO_HDW_ID(dev->devInfo);
-    m_devSerialNo = dev->devInfo.serialNumber;
+    m_devHdwId = ENCODE_DEV_INFO_TO_HDW_ID(dev->config->devInfo);
+    m_devSerialNo = dev->config->devInfo.serialNumber;
     m_logStats.Clear();
 }
 
@@ -62,6 +64,7 @@ void cDeviceLog::InitDeviceForWriting(std::string timestamp, std::string directo
 	m_maxDiskSpace = maxDiskSpace;
 	m_maxFileSize = maxFileSize;
 	m_logSize = 0;
+	m_fileStartTime = m_fileEndTime = 0.0;
 	m_writeMode = true;
 	m_logStats.Clear();
 }
@@ -151,6 +154,24 @@ bool cDeviceLog::SetupReadInfo(const string& directory, const string& serialNum,
 }
 
 
+void cDeviceLog::SetupReadInfo(const string& directory, uint32_t serialNo, const vector<cISLogCatalog::sFile>& files)
+{
+	m_directory = directory;
+	m_fileCount = 0;
+	m_fileNames.clear();
+	SetSerialNumber(serialNo);
+
+	for (const cISLogCatalog::sFile& file : files)
+	{
+		m_fileNames.push_back(directory + "/" + file.name);
+	}
+	if (m_fileNames.size())
+	{
+		m_fileName = m_fileNames[0];
+	}
+}
+
+
 bool cDeviceLog::OpenNewSaveFile()
 {
 	// Close existing file
@@ -167,31 +188,113 @@ bool cDeviceLog::OpenNewSaveFile()
 
 	// Open new file
 	m_fileCount++;
-	uint32_t serNum = (device != nullptr ? device->devInfo.serialNumber : SerialNumber());
+	uint32_t serNum = (device != nullptr ? device->config->devInfo.serialNumber : SerialNumber());
 	if (!serNum)
 		return false;
 
-	string fileName = GetNewFileName(serNum, m_fileCount, NULL);
-	m_pFile = CreateISLogFile(fileName, "wb");
+	m_fileName = GetNewFileName(serNum, m_fileCount, NULL);
+	m_pFile = m_rotator.Take(m_fileName);
+	if (m_pFile == NULLPTR)
+	{
+		m_pFile = CreateISLogFile(m_fileName, "wb");
+	}
 	m_fileSize = 0;
 
+	// Create the following file in the background so rotation doesn't wait on the file system
+	m_rotator.Prepare(GetNewFileName(serNum, m_fileCount + 1, NULL), m_maxFileSize);
+
 	if (m_pFile && m_pFile->isOpened())
 	{
 #if LOG_DEBUG_FILE_WRITE
-		printf("cDeviceLog::OpenNewSaveFile %s\n", fileName.c_str());
+		printf("cDeviceLog::OpenNewSaveFile %s\n", m_fileName.c_str());
 #endif
 		return true;
 	}
 	else
 	{
 #if LOG_DEBUG_FILE_WRITE
-		printf("cDeviceLog::OpenNewSaveFile FAILED %s\n", fileName.c_str());
+		printf("cDeviceLog::OpenNewSaveFile FAILED %s\n", m_fileName.c_str());
 #endif
 		return false;
 	}
 }
 
 
+// Returns true when the time period containing this data differs from the previous data
+bool cDeviceLog::RotationTimeDue(const p_data_hdr_t* dataHdr, const uint8_t* dataBuf)
+{
+	if (m_rotatePeriodSec == 0)
+	{
+		return false;
+	}
+
+	double timeSec;
+	if (m_rotateGpsTime)
+	{
+		if (dataHdr == NULL || dataBuf == NULL ||
+			(dataHdr->id != DID_GPS1_POS && dataHdr->id != DID_GPS2_POS) ||
+			dataHdr->offset != 0 || dataHdr->size < offsetof(gps_pos_t, status))
+		{
+			return false;
+		}
+		const gps_pos_t* pos = (const gps_pos_t*)dataBuf;
+		if (pos->week == 0)
+		{	// No GPS time yet
+			return false;
+		}
+		timeSec = pos->week * (double)C_SECONDS_PER_WEEK + pos->timeOfWeekMs * 0.001;
+	}
+	else
+	{
+		timeSec = 0.001 * (double)(cISClock::Get().TimeUs() / 1000);
+	}
+
+	int64_t index = (int64_t)(timeSec / m_rotatePeriodSec);
+	if (index == m_rotateIndex)
+	{
+		return false;
+	}
+
+	bool due = (m_rotateIndex >= 0);
+	m_rotateIndex = index;
+	return due;
+}
+
+// Switch to the next file.  The previous file is synced and closed in the background.
+bool cDeviceLog::RotateSaveFile()
+{
+	if (m_pFile == NULLPTR)
+	{	// Nothing written yet, first file is opened on first write
+		return false;
+	}
+
+	CatalogFile();
+	if (m_catalog)
+	{
+		m_catalog->Write();
+	}
+	m_fileStartTime = m_fileEndTime = 0.0;
+
+	m_rotator.Retire(m_pFile);
+	m_pFile = NULLPTR;
+	return OpenNewSaveFile();
+}
+
+void cDeviceLog::CatalogFile()
+{
+	if (m_catalog == nullptr || !m_writeMode || m_pFile == NULLPTR || m_fileSize == 0)
+	{
+		return;
+	}
+
+	cISLogCatalog::sFile file;
+	file.name = ISFileManager::GetFileName(m_fileName);
+	file.size = m_fileSize;
+	file.startTime = m_fileStartTime;
+	file.endTime = m_fileEndTime;
+	m_catalog->Update((device != nullptr ? device->config->devInfo.serialNumber : SerialNumber()), file);
+}
+
 bool cDeviceLog::OpenNextReadFile()
 {
 	// Close file if open
@@ -250,6 +353,6 @@ ISDevice* cDeviceLog::Device() {
     return (ISDevice*)device;
 }
 const dev_info_t* cDeviceLog::DeviceInfo() {
-    return (dev_info_t*)&(device->devInfo);
+    return (dev_info_t*)&(device->config->devInfo);
 }
 
@@ -13,10 +13,13 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #ifndef DEVICE_LOG_H
 #define DEVICE_LOG_H
 
+#include <memory>
 #include <stdio.h>
 #include <string.h>
 #include <vector>
+#include "ISLogCatalog.h"
 #include "ISLogFileBase.h"
+#include "ISLogFileRotator.h"
 #include "ISLogStats.h"
 
 extern "C"
@@ -44,6 +47,19 @@ public:
 
     virtual void InitDeviceForReading();
 
+    /**
+     * Start a new file each time a time period boundary is crossed, in addition to the maxFileSize limit.
+     * @param periodSec period in seconds, 0 to disable
+     * @param gpsTime true to use GPS time from DID_GPS1_POS/DID_GPS2_POS in the logged data, false for system wall time
+     */
+    void SetRotation(uint32_t periodSec, bool gpsTime) { m_rotatePeriodSec = periodSec; m_rotateGpsTime = gpsTime; m_rotateIndex = -1; }
+
+    /** Delta encode same-DID records in written chunks.  DAT logs only. */
+    virtual void SetDeltaEncoding(bool /*enable*/) {}
+
+    /** Record each finished file in catalog, written on rotation and close.  DAT and RAW logs only. */
+    void SetCatalog(const std::shared_ptr<cISLogCatalog>& catalog) { m_catalog = catalog; }
+
     virtual bool CloseAllFiles();
 
     virtual bool FlushToFile() { return true; };
@@ -64,6 +80,9 @@ public:
 
     bool SetupReadInfo(const std::string &directory, const std::string &deviceName, const std::string &timeStamp);
 
+    /** Read the files listed in a log catalog, in order, instead of searching directory */
+    void SetupReadInfo(const std::string &directory, uint32_t serialNo, const std::vector<cISLogCatalog::sFile> &files);
+
     ISDevice* Device();
 
     const dev_info_t *DeviceInfo();
@@ -76,6 +95,9 @@ public:
 
     uint64_t LogSize() { return m_logSize; }
 
+    /** Bytes not written because DID_GPS*_SAT/SIG arrays were trimmed to numSats/numSigs.  DAT logs only. */
+    uint64_t GnssTrimBytes() { return m_gnssTrimBytes; }
+
     uint32_t FileCount() { return m_fileCount; }
 
     std::string GetNewFileName(uint32_t serialNumber, uint32_t fileCount, const char *suffix);
@@ -100,8 +122,22 @@ public:
 protected:
     bool OpenNewSaveFile();
 
+    bool RotationTimeDue(const p_data_hdr_t* dataHdr, const uint8_t* dataBuf);
+
+    bool RotateSaveFile();
+
     bool OpenNextReadFile();
 
+    void UpdateFileTime(double timestamp)
+    {
+        if (timestamp == 0.0) { return; }
+        if (m_fileStartTime == 0.0 || timestamp < m_fileStartTime) { m_fileStartTime = timestamp; }
+        if (timestamp > m_fileEndTime) { m_fileEndTime = timestamp; }
+    }
+
+    /** Add the current file to the catalog */
+    void CatalogFile();
+
     const ISDevice *device = nullptr;               //! ISDevice reference to source of data
 
     uint16_t m_devHdwId = 0;                          //! used when reading a file and no ISDevice is available
@@ -116,6 +152,7 @@ protected:
     bool m_showParseErrors = false;
     uint64_t m_fileSize = 0;
     uint64_t m_logSize = 0;
+    uint64_t m_gnssTrimBytes = 0;
     uint32_t m_fileCount = 0;
     uint64_t m_maxDiskSpace;
     uint32_t m_maxFileSize;
@@ -126,6 +163,13 @@ protected:
     bool m_showPointTimestamps = true;
     double m_pointUpdatePeriodSec = 1.0f;
     cLogStats m_logStats;
+    cISLogFileRotator m_rotator;
+    uint32_t m_rotatePeriodSec = 0;
+    bool m_rotateGpsTime = false;
+    int64_t m_rotateIndex = -1;                     //! Current time period, -1 until the first time is known
+    std::shared_ptr<cISLogCatalog> m_catalog;
+    double m_fileStartTime = 0.0;                   //! Data time span of the current file
+    double m_fileEndTime = 0.0;
 };
 
 #endif // DEVICE_LOG_H
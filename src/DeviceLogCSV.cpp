@@ -123,7 +123,7 @@ bool cDeviceLogCSV::OpenNewFile(cCsvLog& log, bool readonly)
 	_MKDIR(m_directory.c_str());
 
 	// Open new file
-	uint32_t serNum = (device != nullptr ? device->devInfo.serialNumber : SerialNumber());
+	uint32_t serNum = (device != nullptr ? device->config->devInfo.serialNumber : SerialNumber());
 	if (!serNum)
 		return false;
 
@@ -225,7 +225,7 @@ bool cDeviceLogCSV::SaveData(p_data_hdr_t* dataHdr, const uint8_t* dataBuf, prot
 	}
 	else if (dataHdr->id == DID_DEV_INFO && device)
 	{
-		memcpy((void *)&(device->devInfo), dataBuf, sizeof(dev_info_t));
+		memcpy((void *)&(device->config->devInfo), dataBuf, sizeof(dev_info_t));
 	}
 
 	// Write date to file
@@ -301,7 +301,7 @@ p_data_buf_t* cDeviceLogCSV::ReadDataFromFile(cCsvLog& log)
 	{
 		if (m_data.hdr.id == DID_DEV_INFO)
 		{
-			memcpy((void *)&(device->devInfo), m_data.buf, sizeof(dev_info_t));
+			memcpy((void *)&(device->config->devInfo), m_data.buf, sizeof(dev_info_t));
 		}
 		log.nextLine.clear();
 		while (!GetNextLineForFile(log) && OpenNewFile(log, true)) {}
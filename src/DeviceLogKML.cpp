@@ -98,7 +98,7 @@ bool cDeviceLogKML::CloseWriteFile(int kid, sKmlLog &log)
 
 	// Create filename
 	log.fileCount++;
-	uint32_t serNum = (device != nullptr ? device->devInfo.serialNumber : SerialNumber());
+	uint32_t serNum = (device != nullptr ? device->config->devInfo.serialNumber : SerialNumber());
 	if (!serNum)
 		return false;
 
@@ -28,7 +28,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 struct sKmlLog
 {
-	std::vector<sKmlLogData> data;
+	kml_log_data_t data;
 
 	std::string				fileName;
 	uint32_t				fileCount;
@@ -62,9 +62,15 @@ bool cDeviceLogRaw::CloseAllFiles()
 
     // Write remaining data to file
     FlushToFile();
+    CatalogFile();
+    if (m_catalog)
+    {
+        m_catalog->Write();
+    }
 
     // Close file
     CloseISLogFile(m_pFile);
+    m_rotator.Finish();
 
     return true;
 }
@@ -86,6 +92,9 @@ bool cDeviceLogRaw::FlushToFile()
 
 bool cDeviceLogRaw::SaveData(int dataSize, const uint8_t* dataBuf, cLogStats &globalLogStats)
 {
+    bool rotate = RotationTimeDue(NULL, NULL);
+    double firstTime = 0.0, lastTime = 0.0;             // Data time span of this buffer
+
     // Parse messages for statistics and DID_DEV_INFO
     for (const uint8_t *dPtr = dataBuf; dPtr < dataBuf+dataSize; dPtr++)
     {
@@ -113,7 +122,20 @@ bool cDeviceLogRaw::SaveData(int dataSize, const uint8_t* dataBuf, cLogStats &gl
             case _PTYPE_INERTIAL_SENSE_DATA:
             case _PTYPE_INERTIAL_SENSE_CMD:
                 {
-                    timestamp = cISDataMappings::TimestampOrCurrentTime(&m_comm.rxPkt.dataHdr, m_comm.rxPkt.data.ptr);
+                    timestamp = cISDataMappings::Timestamp(&m_comm.rxPkt.dataHdr, m_comm.rxPkt.data.ptr);
+                    if (timestamp == 0.0)
+                    {
+                        timestamp = current_timeSecD();
+                    }
+                    else
+                    {
+                        if (firstTime == 0.0) { firstTime = timestamp; }
+                        lastTime = timestamp;
+                    }
+                    if (m_rotateGpsTime)
+                    {
+                        rotate |= RotationTimeDue(&m_comm.rxPkt.dataHdr, m_comm.rxPkt.data.ptr);
+                    }
 
                     dev_info_t tmpInfo = {};
                     dev_info_t* devInfo = &tmpInfo;
@@ -121,7 +143,7 @@ bool cDeviceLogRaw::SaveData(int dataSize, const uint8_t* dataBuf, cLogStats &gl
                     if (m_comm.rxPkt.dataHdr.id == DID_DEV_INFO) {
                         // if we have a device struct, let's use it, otherwise we'll just copy into our local copy
                         if (device != nullptr)
-                            devInfo = (dev_info_t *) &(device->devInfo);
+                            devInfo = (dev_info_t *) &(device->config->devInfo);
 
                         // Record the serial number in the chunk header if available
                         if (!copyDataPToStructP2((void *) devInfo, &m_comm.rxPkt.dataHdr, m_comm.rxPkt.data.ptr, sizeof(dev_info_t)))
@@ -146,6 +168,13 @@ bool cDeviceLogRaw::SaveData(int dataSize, const uint8_t* dataBuf, cLogStats &gl
         }
     }
 
+    // Start a new file at time period boundaries
+    if (rotate)
+    {
+        WriteChunkToFile();
+        RotateSaveFile();
+    }
+
     // Ensure data will fit in chunk.  If not, create new chunk
     if (dataSize > m_chunk.GetBuffFree())
     {
@@ -156,12 +185,14 @@ bool cDeviceLogRaw::SaveData(int dataSize, const uint8_t* dataBuf, cLogStats &gl
         }
         else if (m_fileSize >= m_maxFileSize)
         {
-            // Close existing file
-            CloseAllFiles();
+            // Switch to next file
+            RotateSaveFile();
         }
     }
 
     // Add data header and data buffer to chunk
+    UpdateFileTime(firstTime);
+    UpdateFileTime(lastTime);
     m_logSize += dataSize;
     if (!m_chunk.PushBack((unsigned char*)dataBuf, dataSize))
     {
@@ -269,6 +300,7 @@ p_data_buf_t* cDeviceLogRaw::ReadDataFromChunk()
 
                 m_pData.hdr = m_comm.rxPkt.dataHdr;
                 memcpy(m_pData.buf, m_comm.rxPkt.data.ptr + m_comm.rxPkt.dataHdr.offset, m_comm.rxPkt.dataHdr.size);
+                m_pData.hdr.size = gnssArrayZeroFill(m_pData.hdr.id, m_pData.buf, m_pData.hdr.size, m_pData.hdr.offset);
                 return &m_pData;
             }
         }
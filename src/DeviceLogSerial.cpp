@@ -22,6 +22,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <stddef.h>
 
 #include "DeviceLogSerial.h"
+#include "ISDataMappings.h"
 #include "ISLogger.h"
 #include "ISLogFileFactory.h"
 
@@ -33,7 +34,7 @@ cDeviceLogSerial::cDeviceLogSerial() : cDeviceLog() {
 
 cDeviceLogSerial::cDeviceLogSerial(const ISDevice *dev) : cDeviceLog(dev) {
     m_chunk.Clear();
-    m_chunk.SetDevInfo(dev->devInfo);
+    m_chunk.SetDevInfo(dev->config->devInfo);
     m_chunk.m_hdr.devSerialNum = SerialNumber();    // set this seperately, in case the devInfo above doesn't contain it
 }
 
@@ -45,7 +46,7 @@ cDeviceLogSerial::cDeviceLogSerial(uint16_t hdwId, uint32_t serialNo) : cDeviceL
 void cDeviceLogSerial::InitDeviceForWriting(std::string timestamp, std::string directory, uint64_t maxDiskSpace, uint32_t maxFileSize) {
     m_chunk.Clear();
     if (device != nullptr) {
-        m_chunk.m_hdr.devSerialNum = device->devInfo.serialNumber;
+        m_chunk.m_hdr.devSerialNum = device->config->devInfo.serialNumber;
         m_chunk.m_hdr.pHandle = device->portHandle;
     }
 
@@ -58,9 +59,15 @@ bool cDeviceLogSerial::CloseAllFiles() {
 
     // Write remaining data to file
     FlushToFile();
+    CatalogFile();
+    if (m_catalog)
+    {
+        m_catalog->Write();
+    }
 
     // Close file
     CloseISLogFile(m_pFile);
+    m_rotator.Finish();
 
     return true;
 }
@@ -88,7 +95,7 @@ bool cDeviceLogSerial::SaveData(p_data_hdr_t *dataHdr, const uint8_t *dataBuf, p
     if (dataHdr->id == DID_DEV_INFO) {
         // if we have a device struct, let's use it, otherwise we'll just copy into our local copy
         if (device != nullptr)
-            devInfo = (dev_info_t *) &(device->devInfo);
+            devInfo = (dev_info_t *) &(device->config->devInfo);
 
         // Record the serial number in the chunk header if available
         if (!copyDataPToStructP2((void *) devInfo, dataHdr, dataBuf, sizeof(dev_info_t))) {
@@ -104,6 +111,18 @@ bool cDeviceLogSerial::SaveData(p_data_hdr_t *dataHdr, const uint8_t *dataBuf, p
     } else
         m_chunk.m_hdr.devSerialNum = m_devSerialNo;
 
+    // Start a new file at time period boundaries
+    if (RotationTimeDue(dataHdr, dataBuf)) {
+        WriteChunkToFile();
+        RotateSaveFile();
+    }
+
+    // Don't log unused sat/sig array entries.  These are zero filled on read.
+    p_data_hdr_t hdr = *dataHdr;
+    hdr.size = gnssArrayTrimSize(hdr.id, dataBuf, hdr.size, hdr.offset);
+    m_gnssTrimBytes += dataHdr->size - hdr.size;
+    dataHdr = &hdr;
+
     // Ensure data will fit in chunk.  If not, create new chunk
     int32_t dataBytes = sizeof(p_data_hdr_t) + dataHdr->size;
     int32_t buffFree = m_chunk.GetBuffFree();
@@ -112,12 +131,13 @@ bool cDeviceLogSerial::SaveData(p_data_hdr_t *dataHdr, const uint8_t *dataBuf, p
         if (!WriteChunkToFile()) {
             return false;
         } else if (m_fileSize >= m_maxFileSize) {
-            // Close existing file
-            CloseAllFiles();
+            // Switch to next file
+            RotateSaveFile();
         }
     }
 
     // Add data header and data buffer to chunk
+    UpdateFileTime(cISDataMappings::Timestamp(dataHdr, dataBuf));
     m_logSize += dataHdr->size;
     if (!m_chunk.PushBack((unsigned char *) dataHdr, sizeof(p_data_hdr_t), (unsigned char *) dataBuf, dataHdr->size)) {
         return false;
@@ -181,11 +201,18 @@ p_data_buf_t *cDeviceLogSerial::ReadDataFromChunk() {
 
     p_data_buf_t *data = (p_data_buf_t *) m_chunk.GetDataPtr();
     int size = data->hdr.size + sizeof(p_data_hdr_t);
-    if (m_chunk.PopFront(size)) {
-        return data;
-    } else {
+    if (!m_chunk.PopFront(size)) {
         return NULL;
     }
+
+    if (gnssArrayIsTrimmed(data->hdr.id, data->buf, data->hdr.size, data->hdr.offset)) {
+        // Restore full size sat/sig array
+        m_pData.hdr = data->hdr;
+        memcpy(m_pData.buf, data->buf, data->hdr.size);
+        m_pData.hdr.size = gnssArrayZeroFill(data->hdr.id, m_pData.buf, data->hdr.size, data->hdr.offset);
+        return &m_pData;
+    }
+    return data;
 }
 
 
@@ -46,6 +46,8 @@ public:
 
     void Flush() OVERRIDE;
 
+    void SetDeltaEncoding(bool enable) OVERRIDE { m_chunk.SetDeltaEncoding(enable); }
+
     cDataChunk m_chunk;
 
 private:
@@ -54,6 +56,8 @@ private:
     bool ReadChunkFromFile();
 
     bool WriteChunkToFile();
+
+    p_data_buf_t m_pData;
 };
 
 #endif // DEVICE_LOG_SERIAL_H
@@ -0,0 +1,201 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <cstring>
+
+#include "ISBlackBox.h"
+#include "data_sets.h"
+
+using namespace std;
+
+void cISBlackBoxRing::Init(size_t capacity)
+{
+    m_buf.assign(capacity & ~(size_t)7, 0);
+    m_evicted = 0;
+    Clear();
+}
+
+bool cISBlackBoxRing::Push(uint32_t timeMs, const void* data1, uint32_t size1, const void* data2, uint32_t size2)
+{
+    size_t total = RecordSize(size1 + size2);
+    size_t capacity = m_buf.size();
+    if (total > capacity)
+    {
+        return false;
+    }
+
+    // Find contiguous space at m_head, evicting the oldest records as needed
+    while (true)
+    {
+        if (m_count == 0)
+        {
+            m_head = m_tail = 0;
+            break;
+        }
+
+        if (m_head > m_tail)
+        {   // Free space is [head, end) and [0, tail)
+            if (capacity - m_head >= total)
+            {
+                break;
+            }
+            if (m_tail >= total)
+            {   // Wrap, marking the unused end
+                if (capacity - m_head >= sizeof(sRecord))
+                {
+                    ((sRecord*)&m_buf[m_head])->size = REC_WRAP;
+                }
+                m_head = 0;
+                break;
+            }
+        }
+        else if (m_tail - m_head >= total)
+        {   // Free space is [head, tail)
+            break;
+        }
+
+        Evict();
+    }
+
+    sRecord* rec = (sRecord*)&m_buf[m_head];
+    rec->size = size1 + size2;
+    rec->timeMs = timeMs;
+    uint8_t* ptr = (uint8_t*)(rec + 1);
+    if (size1)
+    {
+        memcpy(ptr, data1, size1);
+    }
+    if (size2)
+    {
+        memcpy(ptr + size1, data2, size2);
+    }
+    m_head += total;
+    m_count++;
+    return true;
+}
+
+size_t cISBlackBoxRing::Normalize(size_t offset)
+{
+    if (offset + sizeof(sRecord) > m_buf.size() || ((sRecord*)&m_buf[offset])->size == REC_WRAP)
+    {
+        return 0;
+    }
+    return offset;
+}
+
+void cISBlackBoxRing::Evict()
+{
+    m_tail = Normalize(m_tail);
+    m_tail += RecordSize(((sRecord*)&m_buf[m_tail])->size);
+    m_count--;
+    m_evicted++;
+    if (m_count == 0)
+    {
+        m_head = m_tail = 0;
+    }
+}
+
+void cISBlackBoxRing::ForEach(const pfnVisit& visit)
+{
+    size_t offset = m_tail;
+    for (size_t i = 0; i < m_count; i++)
+    {
+        offset = Normalize(offset);
+        const sRecord* rec = (const sRecord*)&m_buf[offset];
+        visit((const uint8_t*)(rec + 1), rec->size, rec->timeMs);
+        offset += RecordSize(rec->size);
+    }
+}
+
+void cISBlackBox::Init(size_t capacity, uint32_t preTriggerMs, uint32_t postTriggerMs)
+{
+    m_ring.Init(capacity);
+    m_preTriggerMs = preTriggerMs;
+    m_postTriggerMs = postTriggerMs;
+    m_recordUntilMs = 0;
+    m_genFaultCode = 0;
+    m_stats = {};
+    m_commBuf.resize(PKT_BUF_SIZE);
+    is_comm_init(&m_comm, m_commBuf.data(), (int)m_commBuf.size());
+}
+
+bool cISBlackBox::IsTrigger(const p_data_hdr_t* dataHdr, const uint8_t* dataBuf)
+{
+    switch (dataHdr->id)
+    {
+    case DID_EVENT:
+        return true;
+
+    case DID_SYS_FAULT:
+        if (dataHdr->offset == 0 && dataHdr->size >= sizeof(uint32_t))
+        {
+            uint32_t status;
+            memcpy(&status, dataBuf, sizeof(status));
+            return status != 0;
+        }
+        break;
+
+    case DID_SYS_PARAMS:
+        {
+            uint32_t offset = offsetof(sys_params_t, genFaultCode);
+            if (dataHdr->offset <= offset && dataHdr->offset + dataHdr->size >= offset + sizeof(uint32_t))
+            {   // Trigger on new fault bits only, not on every periodic message while a fault persists
+                uint32_t genFaultCode;
+                memcpy(&genFaultCode, dataBuf + offset - dataHdr->offset, sizeof(genFaultCode));
+                bool trigger = (genFaultCode & ~m_genFaultCode) != 0;
+                m_genFaultCode = genFaultCode;
+                return trigger;
+            }
+        }
+        break;
+    }
+
+    return false;
+}
+
+bool cISBlackBox::IsTrigger(const uint8_t* data, int size)
+{
+    bool trigger = false;
+    for (const uint8_t* ptr = data; ptr < data + size; ptr++)
+    {
+        if (is_comm_parse_byte(&m_comm, *ptr) == _PTYPE_INERTIAL_SENSE_DATA)
+        {
+            trigger |= IsTrigger(&m_comm.rxPkt.dataHdr, m_comm.rxPkt.data.ptr);
+        }
+    }
+    return trigger;
+}
+
+void cISBlackBox::Trigger(uint32_t timeMs, const pfnWrite& write)
+{
+    m_stats.triggers++;
+
+    if (!Recording(timeMs))
+    {   // Write the pre-trigger window.  Older records are discarded.
+        m_ring.ForEach([&](const uint8_t* data, uint32_t size, uint32_t recTimeMs)
+        {
+            if (timeMs - recTimeMs <= m_preTriggerMs)
+            {
+                write(data, size);
+                m_stats.flushedRecords++;
+            }
+        });
+        m_ring.Clear();
+    }
+
+    m_recordUntilMs = timeMs + m_postTriggerMs;
+    if (m_recordUntilMs == 0)
+    {   // Zero means not recording
+        m_recordUntilMs = 1;
+    }
+}
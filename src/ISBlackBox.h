@@ -0,0 +1,118 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef IS_BLACK_BOX_H
+#define IS_BLACK_BOX_H
+
+#include <functional>
+#include <vector>
+
+#include "ISConstants.h"
+#include "ISComm.h"
+
+#define BLACK_BOX_DEFAULT_PRE_TRIGGER_MS    60000
+#define BLACK_BOX_DEFAULT_POST_TRIGGER_MS   30000
+#define BLACK_BOX_DEFAULT_SIZE              (32 * 1024 * 1024)      // Ring size per device
+
+/**
+ * Fixed size ring of variable length timestamped records.  Memory is allocated once in Init(); Push() evicts the
+ * oldest records to make room and never allocates.
+ */
+class cISBlackBoxRing
+{
+public:
+    typedef std::function<void(const uint8_t* data, uint32_t size, uint32_t timeMs)> pfnVisit;
+
+    void Init(size_t capacity);
+
+    /** Append a record made of two concatenated buffers (either may be empty).  @return false if larger than the ring */
+    bool Push(uint32_t timeMs, const void* data1, uint32_t size1, const void* data2 = NULLPTR, uint32_t size2 = 0);
+
+    /** Visit records oldest first */
+    void ForEach(const pfnVisit& visit);
+
+    void Clear() { m_head = m_tail = 0; m_count = 0; }
+    size_t Count() { return m_count; }
+    size_t Capacity() { return m_buf.size(); }
+    uint32_t Evicted() { return m_evicted; }
+
+private:
+    struct sRecord
+    {
+        uint32_t size;          // Payload bytes, REC_WRAP marks unused space at the end of the buffer
+        uint32_t timeMs;
+    };
+    static const uint32_t REC_WRAP = 0xFFFFFFFF;
+
+    static size_t RecordSize(uint32_t payloadSize) { return (sizeof(sRecord) + payloadSize + 7) & ~(size_t)7; }
+    size_t Normalize(size_t offset);
+    void Evict();
+
+    std::vector<uint8_t> m_buf;
+    size_t m_head = 0;          // Next write offset
+    size_t m_tail = 0;          // Oldest record offset
+    size_t m_count = 0;
+    uint32_t m_evicted = 0;
+};
+
+/**
+ * Per device pre/post-trigger ("black box") capture.  Packets are kept in memory until a trigger, then the
+ * pre-trigger window is written out followed by live data until the post-trigger window ends.  Triggers during the
+ * post-trigger window extend it.
+ */
+class cISBlackBox
+{
+public:
+    struct sStats
+    {
+        uint32_t triggers;
+        uint32_t flushedRecords;    // Pre-trigger records written on trigger
+        uint32_t evictedRecords;    // Records that aged out of the ring without a trigger
+    };
+
+    typedef std::function<void(const uint8_t* data, uint32_t size)> pfnWrite;
+
+    void Init(size_t capacity, uint32_t preTriggerMs, uint32_t postTriggerMs);
+
+    /** @return true while inside a post-trigger window, where data is written directly instead of buffered */
+    bool Recording(uint32_t timeMs) { return m_recordUntilMs != 0 && (int32_t)(m_recordUntilMs - timeMs) > 0; }
+
+    void Push(uint32_t timeMs, const p_data_hdr_t* dataHdr, const uint8_t* dataBuf) { m_ring.Push(timeMs, dataHdr, sizeof(p_data_hdr_t), dataBuf, dataHdr->size); }
+    void Push(uint32_t timeMs, const uint8_t* data, int size) { m_ring.Push(timeMs, data, size); }
+
+    /** @return true if the packet is a trigger: DID_EVENT, DID_SYS_FAULT with status set, or a new DID_SYS_PARAMS genFaultCode */
+    bool IsTrigger(const p_data_hdr_t* dataHdr, const uint8_t* dataBuf);
+
+    /** Parse raw stream data for trigger packets */
+    bool IsTrigger(const uint8_t* data, int size);
+
+    /**
+     * Start or extend the post-trigger window and write buffered records from the pre-trigger window.  Records are
+     * passed to write as stored: p_data_hdr_t followed by data for Push(hdr), or raw bytes for Push(raw).
+     */
+    void Trigger(uint32_t timeMs, const pfnWrite& write);
+
+    const sStats& Stats() { m_stats.evictedRecords = m_ring.Evicted(); return m_stats; }
+
+private:
+    cISBlackBoxRing m_ring;
+    uint32_t m_preTriggerMs = 0;
+    uint32_t m_postTriggerMs = 0;
+    uint32_t m_recordUntilMs = 0;
+    uint32_t m_genFaultCode = 0;
+    std::vector<uint8_t> m_commBuf;
+    is_comm_instance_t m_comm = {};
+    sStats m_stats = {};
+};
+
+#endif // IS_BLACK_BOX_H
@@ -0,0 +1,106 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef IS_CLOCK_H
+#define IS_CLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+
+#include "ISConstants.h"
+
+/**
+ * Time source for the SDK.  current_timeMs(), current_timeUs(), current_timeSec(), current_timeSecD() and
+ * getTickCount() read the installed clock, so timeouts, retries, broadcast scheduling, stale detection and log
+ * rotation all follow it.  With no clock installed they read the platform time as before.  This base class is the
+ * system clock.
+ */
+class cISClock
+{
+public:
+    virtual ~cISClock() {}
+
+    /** Wall time in microseconds since the Unix epoch */
+    virtual uint64_t TimeUs();
+
+    /** Monotonic time in milliseconds, getTickCount() time base */
+    virtual uint64_t TickMs();
+
+    /** Wait for timeMs of this clock's time */
+    virtual void SleepMs(uint32_t timeMs);
+
+    /** @return installed clock, or NULLPTR when using the platform time */
+    static cISClock* Installed() { return s_installed.load(std::memory_order_acquire); }
+
+    /** Install a clock for the whole process.  NULLPTR restores the platform time.  The clock must outlive its use. */
+    static void Install(cISClock* clock) { s_installed.store(clock, std::memory_order_release); }
+
+    /** Installed clock or the system clock */
+    static cISClock& Get();
+
+    /** Unix time in seconds */
+    static time_t UnixTime() { return (time_t)(Get().TimeUs() / 1000000); }
+
+    /** Sleep in a loop that polls the time, i.e. waiting on a timeout.  Returns immediately on a virtual clock. */
+    static void Sleep(uint32_t timeMs) { Get().SleepMs(timeMs); }
+
+private:
+    static std::atomic<cISClock*> s_installed;
+};
+
+/**
+ * Clock that only moves when advanced, so hours of timeouts, retransmits and log rotation can be simulated in
+ * seconds with the same results every run.  Sleeping advances the clock instead of blocking.  Thread safe, but
+ * deterministic only when a single thread drives both the clock and the SDK.
+ */
+class cISVirtualClock : public cISClock
+{
+public:
+    static const uint64_t DEFAULT_START_US = 1700000000000000ULL;      // 2023-11-14 22:13:20 UTC
+
+    explicit cISVirtualClock(uint64_t startUs = DEFAULT_START_US) : m_timeUs(startUs), m_tickUs(1000) {}
+
+    uint64_t TimeUs() OVERRIDE { return m_timeUs.load(std::memory_order_acquire); }
+    uint64_t TickMs() OVERRIDE { return m_tickUs.load(std::memory_order_acquire) / 1000; }
+    void SleepMs(uint32_t timeMs) OVERRIDE { AdvanceUs((uint64_t)timeMs * 1000); }
+
+    void AdvanceUs(uint64_t timeUs)
+    {
+        m_tickUs.fetch_add(timeUs, std::memory_order_acq_rel);
+        m_timeUs.fetch_add(timeUs, std::memory_order_acq_rel);
+    }
+    void AdvanceMs(uint64_t timeMs) { AdvanceUs(timeMs * 1000); }
+
+    /** Jump the wall time, i.e. a time sync.  May go backwards.  TickMs() is not affected. */
+    void SetTimeUs(uint64_t timeUs) { m_timeUs.store(timeUs, std::memory_order_release); }
+
+private:
+    std::atomic<uint64_t> m_timeUs;
+    std::atomic<uint64_t> m_tickUs;         // Starts at 1 ms, as 0 is often used for "not set"
+};
+
+/**
+ * Installs a clock for the lifetime of the scope, then restores the previous one.
+ */
+class cISClockScope
+{
+public:
+    explicit cISClockScope(cISClock* clock) : m_previous(cISClock::Installed()) { cISClock::Install(clock); }
+    ~cISClockScope() { cISClock::Install(m_previous); }
+
+private:
+    cISClock* m_previous;
+};
+
+#endif // IS_CLOCK_H
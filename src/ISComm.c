@@ -128,12 +128,39 @@ uint16_t is_comm_xor16(uint16_t cksum_init, const void* data, uint32_t size)
 */
 unsigned int getBitsAsUInt32(const unsigned char* buffer, unsigned int pos, unsigned int len)
 {
-    unsigned int bits = 0;
-    for (unsigned int i = pos; i < pos + len; i++)
+    if (len == 0)
     {
-        bits = (bits << 1) + ((buffer[i / 8] >> (7 - i % 8)) & 1u);
+        return 0;
+    }
+
+    // Gather only the bytes spanned by the field (at most 5), then shift and mask
+    const unsigned char* ptr = buffer + (pos >> 3);
+    unsigned int end = (pos & 7) + len;
+    unsigned int byteCount = (end + 7) >> 3;
+    uint64_t bits = 0;
+    for (unsigned int i = 0; i < byteCount; i++)
+    {
+        bits = (bits << 8) | ptr[i];
     }
-    return bits;
+    bits >>= (byteCount << 3) - end;
+    return (unsigned int)(bits & ((((uint64_t)1) << len) - 1));
+}
+
+/**
+* Retrieve the 32 bit signed (two's complement) integer value of the specified bits - note that no bounds checking is done on buffer
+* @param buffer the buffer containing the bits
+* @param pos the start bit position in buffer to read at
+* @param len the number of bits to read
+* @return the 32 bit signed integer value
+*/
+int getBitsAsInt32(const unsigned char* buffer, unsigned int pos, unsigned int len)
+{
+    unsigned int bits = getBitsAsUInt32(buffer, pos, len);
+    if (len == 0 || len >= 32 || !(bits & (1u << (len - 1))))
+    {
+        return (int)bits;
+    }
+    return (int)(bits | (~0u << len));     // Sign extend
 }
 
 int validateBaudRate(unsigned int baudRate)
@@ -1249,6 +1276,67 @@ int is_comm_write_isb_precomp_to_port(pfnIsCommPortWrite portWrite, unsigned int
     return (n == pkt->size) ? n : -1;
 }
 
+int is_comm_template_init(is_comm_pkt_template_t* tmpl, uint8_t* buf, uint32_t buf_size, uint8_t flags, uint16_t did, uint16_t data_size, uint16_t offset)
+{
+    packet_t pkt;
+
+    // Encode header and header checksum
+    is_comm_encode_hdr(&pkt, flags, did, data_size, offset, NULL);
+    if (pkt.size > buf_size)
+    {	// Packet doesn't fit in buffer
+        return -1;
+    }
+
+    uint8_t *ptr = buf;
+    MEMCPY_INC(ptr, (uint8_t*)&(pkt.hdr), sizeof(packet_hdr_t));                                                    // Header
+    if (offset)
+    {
+        memcpyIncUpdateChecksum(&ptr, (uint8_t*)&(pkt.offset), 2, &(pkt.hdrCksum));                                // Offset (optional)
+    }
+
+    tmpl->buf = buf;
+    tmpl->payload = ptr;
+    tmpl->payloadSize = data_size;
+    tmpl->size = pkt.size;
+    tmpl->hdrCksum = pkt.hdrCksum;
+    memset(tmpl->payload, 0, data_size);
+    is_comm_template_update(tmpl, NULL);
+    return tmpl->size;
+}
+
+void is_comm_template_update(is_comm_pkt_template_t* tmpl, const void* data)
+{
+    if (data)
+    {
+        memcpy(tmpl->payload, data, tmpl->payloadSize);
+    }
+
+    checksum16_u cksum;
+    cksum.ck = is_comm_isb_checksum16(tmpl->hdrCksum, tmpl->payload, tmpl->payloadSize);
+    tmpl->payload[tmpl->payloadSize]     = cksum.a;                                                                 // Footer (checksum)
+    tmpl->payload[tmpl->payloadSize + 1] = cksum.b;
+}
+
+int is_comm_template_write(pfnIsCommPortWrite portWrite, unsigned int port, is_comm_instance_t* comm, is_comm_pkt_template_t* tmpl, const void* data)
+{
+    if (portWrite == NULL || tmpl->buf == NULL)
+    {
+        return -1;
+    }
+
+    is_comm_template_update(tmpl, data);
+
+    // Write entire packet to port (all at once)
+    int n = portWrite(port, tmpl->buf, tmpl->size);
+
+    if (comm)
+    {   // Increment Tx count
+        comm->txPktCount++;
+    }
+
+    return (n == tmpl->size) ? n : -1;
+}
+
 int is_comm_write_to_buf(uint8_t* buf, uint32_t buf_size, is_comm_instance_t* comm, uint8_t flags, uint16_t did, uint16_t data_size, uint16_t offset, void* data)
 {
     packet_t txPkt;
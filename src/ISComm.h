@@ -938,8 +938,59 @@ void is_comm_encode_hdr(packet_t *pkt, uint8_t flags, uint16_t did, uint16_t dat
  */
 int is_comm_write_isb_precomp_to_port(pfnIsCommPortWrite portWrite, unsigned int port, is_comm_instance_t* comm, packet_t *pkt);
 
+/** Persistent, fully encoded InertialSense binary (ISB) packet for sending the same DID repeatedly.  Header, offset and header checksum are encoded once. */
+typedef struct
+{
+    /** Complete packet: header, offset (optional), payload and checksum */
+    uint8_t*            buf;
+
+    /** Payload location in buf */
+    uint8_t*            payload;
+
+    /** Payload size */
+    uint16_t            payloadSize;
+
+    /** Packet size including header and checksum */
+    uint16_t            size;
+
+    /** Checksum of header and offset */
+    uint16_t            hdrCksum;
+} is_comm_pkt_template_t;
+
+/**
+ * @brief Encode an ISB packet template into caller provided storage.  The buffer must stay valid for the life of the template.
+ * @param tmpl Template to initialize
+ * @param buf Packet storage.  Must hold data_size + 10 bytes.
+ * @param buf_size Size of buf
+ * @param flags ISB packet flags which includes the packet type (see eISBPacketFlags).
+ * @param did ISB data ID
+ * @param data_size Size in bytes of the payload data.
+ * @param offset Offset of the payload data into the data set structure.
+ * @return int Packet size on success or -1 if the packet does not fit.
+ */
+int is_comm_template_init(is_comm_pkt_template_t* tmpl, uint8_t* buf, uint32_t buf_size, uint8_t flags, uint16_t did, uint16_t data_size, uint16_t offset);
+
+/**
+ * @brief Copy payload into the template and update the packet checksum, continuing from the precomputed header checksum.
+ * @param tmpl Initialized template
+ * @param data Payload data (tmpl->payloadSize bytes).  NULL if payload was written in place through tmpl->payload.
+ */
+void is_comm_template_update(is_comm_pkt_template_t* tmpl, const void* data);
+
+/**
+ * @brief Update template payload and write the packet to the port in a single write call.
+ * @param portWrite Callback function for serial port write
+ * @param port Port number for serial port
+ * @param comm IS comm instance used to increment Tx packet counter statistic.  May be NULL, i.e. when called from a thread other than the one parsing this port.
+ * @param tmpl Initialized template
+ * @param data Payload data or NULL if updated in place.
+ * @return int Number of bytes written on success or -1 on failure
+ */
+int is_comm_template_write(pfnIsCommPortWrite portWrite, unsigned int port, is_comm_instance_t* comm, is_comm_pkt_template_t* tmpl, const void* data);
+
 unsigned int calculate24BitCRCQ(unsigned char* buffer, unsigned int len);
 unsigned int getBitsAsUInt32(const unsigned char* buffer, unsigned int pos, unsigned int len);
+int getBitsAsInt32(const unsigned char* buffer, unsigned int pos, unsigned int len);
 
 int validateBaudRate(unsigned int baudRate);
 
@@ -3,23 +3,15 @@
 #include "ISFileManager.h"
 
 #include <stdio.h>
-#include <sstream>
+#include <string.h>
 
 using namespace std;
 
-#define MAX_ITEM_HISTORY 2048
-
 cComDataBuffer g_comDataBuffer;
 
 cComDataBuffer::cComDataBuffer()
 {
     m_lastTimestamp = 0.0;
-    basePath = tempPath();
-    _MKDIR(basePath.c_str());
-    basePath += "InertialSense/";
-    _MKDIR(basePath.c_str());
-    basePath += "ComDataBuffer/";
-    Reset();
 }
 
 
@@ -31,92 +23,161 @@ cComDataBuffer::~cComDataBuffer()
 
 void cComDataBuffer::Reset()
 {
-    for (size_t i = 0; i < m_buffers.size(); i++)
+    cMutexLocker lock(&m_mutex);
+
+    for (auto& handle : m_rings)
     {
-        for (size_t j = 0; j < m_buffers[i].size(); j++)
+        for (auto& ring : handle)
         {
-            fclose(m_buffers[i][j].file);
-            fclose(m_timestamps[i][j].file);
+            if (ring && ring->spill)
+            {
+                fclose(ring->spill);
+                ISFileManager::DeleteFile(ring->spillPath);
+            }
         }
     }
-    m_buffers.clear();
-    m_timestamps.clear();
+    m_rings.clear();
     m_lastTimestamp = 0.0;
-    ISFileManager::DeleteDirectory(basePath);
-    _MKDIR(basePath.c_str());
 }
 
 
-int cComDataBuffer::PushData(int pHandle, const p_data_t* data)
+bool cComDataBuffer::EnableSpill(const string& directory)
 {
-    if (data->hdr.id == 0 || data->hdr.id >= DID_COUNT)
-    {
-        return -1;
-    }
-
     cMutexLocker lock(&m_mutex);
 
-    EnsureBuffers(pHandle);
-    float timestamp = (float)cISDataMappings::Timestamp(&data->hdr, data->ptr);
-    if (timestamp != 0.0f)
+    m_spillDirectory = directory;
+    if (directory.empty())
     {
-        m_lastTimestamp = timestamp;
+        return true;
     }
+    if (m_spillDirectory.back() != '/' && m_spillDirectory.back() != '\\')
+    {
+        m_spillDirectory += "/";
+    }
+    _MKDIR(m_spillDirectory.c_str());
+    return ISFileManager::PathIsDir(m_spillDirectory);
+}
 
-    uint32_t structSize = cISDataMappings::DataSize(data->hdr.id);
-    vector<uint8_t> dataBuffer;
-    dataBuffer.reserve(structSize);
 
-    if (data->hdr.offset + data->hdr.size > structSize)
+cComDataBuffer::sRing* cComDataBuffer::Ring(int pHandle, uint32_t dataId, bool create)
+{
+    if (pHandle < 0 || dataId == 0 || dataId >= DID_COUNT)
+    {
+        return NULLPTR;
+    }
+    if ((size_t)pHandle >= m_rings.size())
     {
-        // push a completely zeroed out data struct, out of bounds / corrupt data
-        for (size_t i = 0; i < structSize; i++)
+        if (!create)
         {
-            dataBuffer.push_back(0);
+            return NULLPTR;
         }
+        m_rings.resize(pHandle + 1);
     }
-    else
+
+    vector<unique_ptr<sRing>>& handle = m_rings[pHandle];
+    if (handle.empty())
     {
-        // add 0 for every byte before offset
-        for (size_t i = 0; i < data->hdr.offset; i++)
+        if (!create)
         {
-            dataBuffer.push_back(0);
+            return NULLPTR;
         }
-        // add the actual data bytes
-        for (size_t i = 0; i < data->hdr.size; i++)
+        handle.resize(DID_COUNT);
+    }
+
+    unique_ptr<sRing>& ring = handle[dataId];
+    if (!ring && create)
+    {   // Whole ring is allocated once, so pushes never allocate
+        uint32_t structSize = cISDataMappings::DataSize(dataId);
+        if (structSize == 0)
         {
-            dataBuffer.push_back(data->ptr[i]);
+            return NULLPTR;
         }
-        // add 0 for every byte after offset + size but before total size
-        for (size_t i = 0; i < structSize - data->hdr.size; i++)
+        ring.reset(new sRing());
+        ring->itemSize = structSize;
+        ring->capacity = m_capacity;
+        ring->items.reset(new uint8_t[m_capacity * structSize]);
+        ring->times.reset(new float[m_capacity]);
+    }
+    return ring.get();
+}
+
+
+bool cComDataBuffer::Spill(sRing& ring, size_t index)
+{
+    if (m_spillDirectory.empty())
+    {
+        return false;
+    }
+
+    if (ring.spill == NULLPTR)
+    {
+        size_t pHandle = 0, dataId = 0;
+        for (pHandle = 0; pHandle < m_rings.size(); pHandle++)
+        {
+            for (dataId = 0; dataId < m_rings[pHandle].size() && m_rings[pHandle][dataId].get() != &ring; dataId++) {}
+            if (dataId < m_rings[pHandle].size())
+            {
+                break;
+            }
+        }
+        ring.spillPath = m_spillDirectory + "databuffer_" + to_string(pHandle) + "_" + to_string(dataId) + ".buf";
+        ring.spill = openFile(ring.spillPath.c_str(), "wb+");
+        if (ring.spill == NULLPTR)
         {
-            dataBuffer.push_back(0);
+            return false;
         }
     }
 
-    // write timestamp and increment write offset
-    size_t written = fwrite(&timestamp, 1, sizeof(float), m_timestamps[pHandle][data->hdr.id].file);
-    if (written != sizeof(float))
+    fwrite(&ring.times[index], 1, sizeof(float), ring.spill);
+    return fwrite(&ring.items[index * ring.itemSize], 1, ring.itemSize, ring.spill) == ring.itemSize;
+}
+
+
+int cComDataBuffer::PushData(int pHandle, const p_data_t* data)
+{
+    if (data->hdr.id == 0 || data->hdr.id >= DID_COUNT)
     {
         return -1;
     }
-    else if ((m_timestamps[pHandle][data->hdr.id].writeOffset += sizeof(float)) / sizeof(float) >= MAX_ITEM_HISTORY)
+
+    cMutexLocker lock(&m_mutex);
+
+    sRing* ring = Ring(pHandle, data->hdr.id, true);
+    if (ring == NULLPTR)
     {
-        m_timestamps[pHandle][data->hdr.id].writeOffset = 0;
-        fseek(m_timestamps[pHandle][data->hdr.id].file, 0, SEEK_SET);
+        return -1;
     }
 
-    // write data and increment offset
-    written = fwrite(&dataBuffer[0], 1, dataBuffer.size(), m_buffers[pHandle][data->hdr.id].file);
-    if (written != dataBuffer.size())
+    float timestamp = (float)cISDataMappings::Timestamp(&data->hdr, data->ptr);
+    if (timestamp != 0.0f)
     {
-        return -1;
+        m_lastTimestamp = timestamp;
     }
-    else if ((m_buffers[pHandle][data->hdr.id].writeOffset += structSize) / structSize >= MAX_ITEM_HISTORY)
+
+    // Drop (or spill) the oldest item when full
+    size_t index;
+    if (ring->count < ring->capacity)
     {
-        m_buffers[pHandle][data->hdr.id].writeOffset = 0;
-        fseek(m_buffers[pHandle][data->hdr.id].file, 0, SEEK_SET);
+        index = ring->Physical(ring->count++);
     }
+    else
+    {
+        index = ring->head;
+        if (!Spill(*ring, index))
+        {
+            ring->dropped++;
+        }
+        ring->head = ring->Physical(1);
+    }
+
+    // Partial data is zero filled.  Out of bounds / corrupt data is pushed as a completely zeroed out data struct.
+    uint8_t* item = &ring->items[index * ring->itemSize];
+    memset(item, 0, ring->itemSize);
+    if ((uint32_t)data->hdr.offset + data->hdr.size <= ring->itemSize)
+    {
+        memcpy(item + data->hdr.offset, data->ptr, data->hdr.size);
+    }
+    ring->times[index] = m_lastTimestamp;       // Data sets without a timestamp take the last one received
 
     return 0;
 }
@@ -126,79 +187,105 @@ int cComDataBuffer::ReadData(int pHandle, uint32_t dataId, vector<uint8_t>& data
 {
     data.clear();
 
-    if (dataId == 0 || dataId >= DID_COUNT || dataId >= m_buffers[pHandle].size())
-    {
-        return -1;
-    }
-
     cMutexLocker lock(&m_mutex);
 
-    struct stat buf;
-    FILE* file = m_buffers[pHandle][dataId].file;
-    fflush(file);
-#ifdef __linux__
-    fstat(fileno(file), &buf);
-#else
-    fstat(_fileno(file), &buf);
-#endif
-    size_t size = buf.st_size;
-    size_t pos = ftell(file);
-    size_t afterWriteOffset = size - pos;
-    size_t read = 0;
-
-    // read everything after write offset
-    data.resize(size);
-    if (pos < size)
+    sRing* ring = Ring(pHandle, dataId, false);
+    if (ring == NULLPTR)
     {
-        read += fread(&data[0], 1, afterWriteOffset, file);
+        return -1;
     }
 
-    // read in anything before write offset
-    if (pos != 0)
-    {
-        fseek(file, 0, SEEK_SET);
-        read += fread(&data[afterWriteOffset], 1, pos, file);
+    if (ring->spill)
+    {   // Spilled items first, without their timestamps
+        fflush(ring->spill);
+        fseek(ring->spill, 0, SEEK_SET);
+        vector<uint8_t> record(sizeof(float) + ring->itemSize);
+        while (fread(record.data(), 1, record.size(), ring->spill) == record.size())
+        {
+            data.insert(data.end(), record.begin() + sizeof(float), record.end());
+        }
+        fseek(ring->spill, 0, SEEK_END);
     }
 
-    if (read != size)
+    // Oldest to newest, at most two copies
+    size_t offset = data.size();
+    data.resize(offset + ring->count * ring->itemSize);
+    size_t first = _MIN(ring->count, ring->capacity - ring->head);
+    memcpy(&data[offset], &ring->items[ring->head * ring->itemSize], first * ring->itemSize);
+    if (ring->count > first)
     {
-        return ferror(file);
+        memcpy(&data[offset + first * ring->itemSize], &ring->items[0], (ring->count - first) * ring->itemSize);
     }
 
-    // reset file pointer to correct location for next read or write
-    fseek(file, (long)m_buffers[pHandle][dataId].writeOffset, SEEK_SET);
-
     return 0;
 }
 
 
-void cComDataBuffer::EnsureBuffers(int pHandle)
+size_t cComDataBuffer::Count(int pHandle, uint32_t dataId)
+{
+    cMutexLocker lock(&m_mutex);
+
+    sRing* ring = Ring(pHandle, dataId, false);
+    return (ring ? ring->count : 0);
+}
+
+
+uint64_t cComDataBuffer::Dropped(int pHandle, uint32_t dataId)
 {
-    while (m_buffers.size() <= (size_t)pHandle)
+    cMutexLocker lock(&m_mutex);
+
+    sRing* ring = Ring(pHandle, dataId, false);
+    return (ring ? ring->dropped : 0);
+}
+
+
+int cComDataBuffer::ReadItem(int pHandle, uint32_t dataId, size_t index, vector<uint8_t>& data, float* timestamp)
+{
+    cMutexLocker lock(&m_mutex);
+
+    sRing* ring = Ring(pHandle, dataId, false);
+    if (ring == NULLPTR || index >= ring->count)
+    {
+        return -1;
+    }
+
+    size_t i = ring->Physical(index);
+    data.assign(&ring->items[i * ring->itemSize], &ring->items[(i + 1) * ring->itemSize]);
+    if (timestamp)
     {
-        size_t i = m_buffers.size();
-        m_buffers.push_back(vector<buffer_file_t>());
-        m_timestamps.push_back(vector<buffer_file_t>());
+        *timestamp = ring->times[i];
+    }
+    return 0;
+}
 
-        stringstream out;
-        out << i;
-        string num = out.str();
 
-        for (uint32_t dataIndex = 1; dataIndex < DID_COUNT; dataIndex++)
-        {
-            stringstream out2;
-            out2 << dataIndex;
-            string num2 = out2.str();
+void cComDataBuffer::FindTimeRange(int pHandle, uint32_t dataId, float startTime, float endTime, size_t& first, size_t& last)
+{
+    cMutexLocker lock(&m_mutex);
 
-            buffer_file_t file = { 0 };
+    first = last = 0;
+    sRing* ring = Ring(pHandle, dataId, false);
+    if (ring == NULLPTR)
+    {
+        return;
+    }
 
-            file.path = basePath + "databuffer_" + num + "_" + num2 + string(".buf");
-            file.file = openFile(file.path.c_str(), "wb+");
-            m_buffers[i].push_back(file);
+    // Lower bound of startTime, then upper bound of endTime
+    size_t lo = 0, hi = ring->count;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (ring->times[ring->Physical(mid)] < startTime) { lo = mid + 1; }
+        else                                              { hi = mid; }
+    }
+    first = lo;
 
-            file.path = basePath + "timebuffer_" + num + "_" + num2 + string(".buf");
-            file.file = openFile(file.path.c_str(), "wb+");
-            m_timestamps[i].push_back(file);
-        }
+    hi = ring->count;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (ring->times[ring->Physical(mid)] <= endTime) { lo = mid + 1; }
+        else                                             { hi = mid; }
     }
+    last = lo;
 }
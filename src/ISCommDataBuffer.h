@@ -1,11 +1,23 @@
 #ifndef CCOMDATABUFFER_H
 #define CCOMDATABUFFER_H
 
+#include <memory>
+#include <string>
 #include <vector>
 #include <inttypes.h>
 #include "com_manager.h"
 #include "ISUtilities.h"
 
+#define COM_DATA_BUFFER_DEFAULT_HISTORY     2048        // Items kept per pHandle and data id
+
+/**
+ * History of received data sets per pHandle and data id.  Each pHandle and data id has a fixed capacity ring of full
+ * size data sets (partial data is zero filled) and their timestamps, allocated on first use.  When the ring is full the
+ * oldest item is dropped, or appended to a spill file if spill is enabled so long captures are not lost.
+ *
+ * History is limited to COM_DATA_BUFFER_DEFAULT_HISTORY items per pHandle and data id unless SetCapacity() or
+ * EnableSpill() is used.  Dropped() counts the items lost to the limit.
+ */
 class cComDataBuffer
 {
 public:
@@ -15,32 +27,57 @@ public:
     // add data to the data buffer for the pHandle using the data id in data, return 0 if success, otherwise error code
     int PushData(int pHandle, const p_data_t* data);
 
-    // reads the entire data for a pHandle and data id into a vector of bytes - data will be cleared first, return 0 if success, otherwise error code
+    // reads the data for a pHandle and data id into a vector of bytes - data will be cleared first, return 0 if success, otherwise error code.
+    // Only the last SetCapacity() items are held unless spill is enabled, check Dropped() for missing history.
     int ReadData(int pHandle, uint32_t dataId, std::vector<uint8_t>& data);
 
-    // clear all data from memory and remove all temp files
+    // clear all data from memory and remove all spill files
     void Reset();
 
+    // number of items held in memory for the pHandle and data id
+    size_t Count(int pHandle, uint32_t dataId);
+
+    // number of items for the pHandle and data id dropped when the buffer was full, not including spilled items
+    uint64_t Dropped(int pHandle, uint32_t dataId);
+
+    // copy one item, 0 being the oldest held in memory, return 0 if success, otherwise error code
+    int ReadItem(int pHandle, uint32_t dataId, size_t index, std::vector<uint8_t>& data, float* timestamp = NULLPTR);
+
+    // index range [first, last) of items held in memory with timestamp in [startTime, endTime].  Timestamps are expected to be non-decreasing.
+    void FindTimeRange(int pHandle, uint32_t dataId, float startTime, float endTime, size_t& first, size_t& last);
+
+    // items per pHandle and data id.  Applies to buffers created after this call.
+    void SetCapacity(size_t items) { m_capacity = (items ? items : 1); }
+
+    // append items dropped from full buffers to files in directory, included by ReadData.  Empty directory disables spill.
+    bool EnableSpill(const std::string& directory);
+
 private:
-    typedef struct
+    struct sRing
     {
-        FILE* file;
-        long writeOffset;
-        std::string path;
-    } buffer_file_t;
+        uint32_t itemSize = 0;
+        size_t capacity = 0;
+        size_t head = 0;                    // Oldest item
+        size_t count = 0;
+        uint64_t dropped = 0;               // Items lost when full and not spilled
+        std::unique_ptr<uint8_t[]> items;
+        std::unique_ptr<float[]> times;
+        FILE* spill = NULLPTR;              // Spilled items, each timestamp followed by the data set
+        std::string spillPath;
 
-    void EnsureBuffers(int pHandle);
+        size_t Physical(size_t index) { size_t i = head + index; return (i >= capacity ? i - capacity : i); }
+    };
 
-    // for each pHandle, a vector for each data id containing a file of the raw data
-    std::vector<std::vector<buffer_file_t>> m_buffers;
+    sRing* Ring(int pHandle, uint32_t dataId, bool create);
+    bool Spill(sRing& ring, size_t index);
 
-    // for each pHandle, a vector for each data id containing the a file with the timestamp for that data
-    std::vector<std::vector<buffer_file_t>> m_timestamps;
+    // for each pHandle, a ring for each data id, created on first push
+    std::vector<std::vector<std::unique_ptr<sRing>>> m_rings;
 
+    size_t m_capacity = COM_DATA_BUFFER_DEFAULT_HISTORY;
+    std::string m_spillDirectory;
     float m_lastTimestamp;
     cMutex m_mutex;
-    std::string basePath;
-
 };
 
 extern cComDataBuffer g_comDataBuffer;
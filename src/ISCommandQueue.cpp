@@ -0,0 +1,124 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "ISCommandQueue.h"
+
+using namespace std;
+
+cISCommandQueue::~cISCommandQueue()
+{
+    Clear();
+}
+
+future<cISCommandQueue::eStatus> cISCommandQueue::Push(int pHandle, uint8_t pktType, uint16_t did, const void* data, uint16_t size, uint16_t offset, uint32_t deadlineMs, pfnCompletion callback)
+{
+    sCommand* cmd = new sCommand();
+    cmd->pHandle = pHandle;
+    cmd->pktType = pktType;
+    cmd->did = did;
+    cmd->offset = offset;
+    if (data && size)
+    {
+        cmd->data.assign((const uint8_t*)data, (const uint8_t*)data + size);
+    }
+    cmd->deadlineMs = deadlineMs;
+    cmd->callback = callback;
+    future<eStatus> result = cmd->promise.get_future();
+    m_queue.Push(cmd);
+    return result;
+}
+
+void cISCommandQueue::Step(uint32_t timeMs, const pfnSend& send)
+{
+    // Expire commands waiting for ACK
+    for (auto it = m_pending.begin(); it != m_pending.end(); )
+    {
+        if ((int32_t)(timeMs - (*it)->deadlineMs) >= 0)
+        {
+            Complete(*it, STATUS_TIMEOUT);
+            it = m_pending.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // Send queued commands in submission order
+    sCommand* cmd;
+    while ((cmd = m_queue.Pop()) != NULLPTR)
+    {
+        if ((int32_t)(timeMs - cmd->deadlineMs) >= 0)
+        {   // Expired while queued
+            Complete(cmd, STATUS_TIMEOUT);
+            continue;
+        }
+
+        if (!send(cmd->pHandle, cmd->pktType, cmd->did, cmd->data.data(), (uint16_t)cmd->data.size(), cmd->offset))
+        {
+            Complete(cmd, STATUS_FAILED);
+        }
+        else if (cmd->pktType == PKT_TYPE_SET_DATA)
+        {   // Wait for ACK
+            m_pending.push_back(cmd);
+        }
+        else
+        {
+            Complete(cmd, STATUS_ACK);
+        }
+    }
+}
+
+void cISCommandQueue::OnAck(int pHandle, const p_ack_t* ack, uint8_t packetIdentifier)
+{
+    if ((ack->hdr.pktInfo.flags & PKT_TYPE_MASK) != PKT_TYPE_SET_DATA)
+    {
+        return;
+    }
+
+    const p_data_hdr_t& hdr = ack->body.dataHdr;
+    for (auto it = m_pending.begin(); it != m_pending.end(); ++it)
+    {
+        sCommand* cmd = *it;
+        if (cmd->pHandle == pHandle && cmd->did == hdr.id && cmd->offset == hdr.offset)
+        {
+            m_pending.erase(it);
+            Complete(cmd, packetIdentifier == PKT_TYPE_ACK ? STATUS_ACK : STATUS_NACK);
+            return;
+        }
+    }
+}
+
+void cISCommandQueue::Clear()
+{
+    for (sCommand* cmd : m_pending)
+    {
+        Complete(cmd, STATUS_FAILED);
+    }
+    m_pending.clear();
+
+    sCommand* cmd;
+    while ((cmd = m_queue.Pop()) != NULLPTR)
+    {
+        Complete(cmd, STATUS_FAILED);
+    }
+}
+
+void cISCommandQueue::Complete(sCommand* cmd, eStatus status)
+{
+    if (cmd->callback)
+    {
+        cmd->callback(status);
+    }
+    cmd->promise.set_value(status);
+    delete cmd;
+}
@@ -0,0 +1,149 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef IS_COMMAND_QUEUE_H
+#define IS_COMMAND_QUEUE_H
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <vector>
+
+#include "ISConstants.h"
+#include "ISComm.h"
+
+/**
+ * Intrusive multiple producer, single consumer queue (Vyukov).  Push() is wait-free and may be called from any thread.
+ * Pop() must only be called from one consumer thread.  T must have a member "std::atomic<T*> next".
+ */
+template <typename T>
+class cMpscQueue
+{
+public:
+    cMpscQueue() : m_head(&m_stub), m_tail(&m_stub) { m_stub.next.store(NULLPTR, std::memory_order_relaxed); }
+
+    void Push(T* node)
+    {
+        node->next.store(NULLPTR, std::memory_order_relaxed);
+        T* prev = m_head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    /** @return oldest node or NULLPTR if empty, or if a producer has not finished linking its node */
+    T* Pop()
+    {
+        T* tail = m_tail;
+        T* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &m_stub)
+        {
+            if (next == NULLPTR)
+            {
+                return NULLPTR;
+            }
+            m_tail = tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next)
+        {
+            m_tail = next;
+            return tail;
+        }
+        if (tail != m_head.load(std::memory_order_acquire))
+        {
+            return NULLPTR;
+        }
+        Push(&m_stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next)
+        {
+            m_tail = next;
+            return tail;
+        }
+        return NULLPTR;
+    }
+
+private:
+    std::atomic<T*> m_head;
+    T* m_tail;
+    T m_stub;
+};
+
+/**
+ * Commands submitted from any thread and sent by the thread running InertialSense::Update(), which owns com_manager.
+ * Set data commands complete when the device ACKs or NACKs them, other commands when written to the port.  Each
+ * command has a deadline covering both the time waiting in the queue and waiting for the ACK.
+ */
+class cISCommandQueue
+{
+public:
+    enum eStatus
+    {
+        STATUS_ACK = 0,             // Device acknowledged (set data) or command was written (get data, etc.)
+        STATUS_NACK,                // Device rejected the command
+        STATUS_TIMEOUT,             // Deadline passed before sending or before the ACK
+        STATUS_FAILED,              // Port write failed, invalid port or queue shut down
+    };
+
+    typedef std::function<void(eStatus status)> pfnCompletion;
+    typedef std::function<bool(int pHandle, uint8_t pktType, uint16_t did, const void* data, uint16_t size, uint16_t offset)> pfnSend;
+
+    struct sCommand
+    {
+        std::atomic<sCommand*> next;
+        int pHandle;
+        uint8_t pktType;
+        uint16_t did;
+        uint16_t offset;
+        std::vector<uint8_t> data;
+        uint32_t deadlineMs;
+        std::promise<eStatus> promise;
+        pfnCompletion callback;
+    };
+
+    cISCommandQueue() {}
+    ~cISCommandQueue();
+
+    /**
+     * Queue a command.  Thread safe and non-blocking.
+     * @param pHandle device port handle
+     * @param pktType ISB packet type (PKT_TYPE_SET_DATA, PKT_TYPE_GET_DATA, ...)
+     * @param did data ID
+     * @param data payload, copied
+     * @param size payload size
+     * @param offset offset into data set
+     * @param deadlineMs time (current_timeMs() time base) by which the command must be sent and acknowledged
+     * @param callback optional completion callback, called from the Step() thread
+     * @return future receiving the completion status
+     */
+    std::future<eStatus> Push(int pHandle, uint8_t pktType, uint16_t did, const void* data, uint16_t size, uint16_t offset, uint32_t deadlineMs, pfnCompletion callback = NULLPTR);
+
+    /** Consumer: send queued commands and expire deadlines.  Call from the thread owning com_manager. */
+    void Step(uint32_t timeMs, const pfnSend& send);
+
+    /** Consumer: complete the oldest command of the same port, DID and offset waiting for this ACK or NACK */
+    void OnAck(int pHandle, const p_ack_t* ack, uint8_t packetIdentifier);
+
+    /** Consumer: fail all queued and pending commands */
+    void Clear();
+
+    /** Consumer: commands sent and waiting for ACK */
+    size_t PendingCount() { return m_pending.size(); }
+
+private:
+    void Complete(sCommand* cmd, eStatus status);
+
+    cMpscQueue<sCommand> m_queue;
+    std::deque<sCommand*> m_pending;
+};
+
+#endif // IS_COMMAND_QUEUE_H
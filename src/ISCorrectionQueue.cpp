@@ -0,0 +1,119 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "ISCorrectionQueue.h"
+
+using namespace std;
+
+cISCorrectionQueue::cISCorrectionQueue(uint32_t maxAgeMs, uint32_t maxBytes) : m_maxAgeMs(maxAgeMs), m_maxBytes(maxBytes)
+{
+}
+
+void cISCorrectionQueue::Push(const uint8_t* data, int size, uint32_t timeMs)
+{
+    if (data == NULLPTR || size <= 0)
+    {
+        return;
+    }
+
+    m_pkts.push_back({ timeMs, vector<uint8_t>(data, data + size) });
+    m_bytes += size;
+    m_stats.queuedPkts++;
+
+    // Drop oldest whole packets to bound memory, keeping any packet already started on the wire
+    while (m_bytes > m_maxBytes && m_pkts.size() > 1 && m_frontWritten == 0)
+    {
+        DropFront();
+    }
+}
+
+bool cISCorrectionQueue::Drain(uint32_t timeMs, const pfnWrite& write)
+{
+    while (!m_pkts.empty())
+    {
+        sPacket& pkt = m_pkts.front();
+        if (m_frontWritten == 0 && (uint32_t)(timeMs - pkt.timeMs) > m_maxAgeMs)
+        {   // Stale
+            DropFront();
+            continue;
+        }
+
+        int remaining = (int)(pkt.data.size() - m_frontWritten);
+        int n = write(pkt.data.data() + m_frontWritten, remaining);
+        if (n < 0)
+        {
+            return false;
+        }
+        m_frontWritten += n;
+        m_bytes -= n;
+        if (n < remaining)
+        {   // Port busy, try again next call
+            return true;
+        }
+
+        PopSent(timeMs);
+    }
+
+    return true;
+}
+
+bool cISCorrectionQueue::FinishPartial(uint32_t timeMs, const pfnWrite& write)
+{
+    while (m_frontWritten > 0)
+    {
+        sPacket& pkt = m_pkts.front();
+        int remaining = (int)(pkt.data.size() - m_frontWritten);
+        int n = write(pkt.data.data() + m_frontWritten, remaining);
+        if (n <= 0)
+        {   // Port won't take the rest, the device has to resync
+            DropFront();
+            return false;
+        }
+        m_frontWritten += n;
+        m_bytes -= n;
+        if (n == remaining)
+        {
+            PopSent(timeMs);
+        }
+    }
+
+    return true;
+}
+
+void cISCorrectionQueue::Clear()
+{
+    m_pkts.clear();
+    m_bytes = 0;
+    m_frontWritten = 0;
+}
+
+void cISCorrectionQueue::PopSent(uint32_t timeMs)
+{
+    uint32_t latencyMs = timeMs - m_pkts.front().timeMs;
+    m_stats.sentPkts++;
+    m_stats.lastLatencyMs = latencyMs;
+    m_stats.maxLatencyMs = _MAX(m_stats.maxLatencyMs, latencyMs);
+    m_stats.totalLatencyMs += latencyMs;
+    m_frontWritten = 0;
+    m_pkts.pop_front();
+}
+
+void cISCorrectionQueue::DropFront()
+{
+    size_t size = m_pkts.front().data.size() - m_frontWritten;
+    m_stats.droppedPkts++;
+    m_stats.droppedBytes += (uint32_t)size;
+    m_bytes -= size;
+    m_frontWritten = 0;
+    m_pkts.pop_front();
+}
@@ -0,0 +1,96 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef IS_CORRECTION_QUEUE_H
+#define IS_CORRECTION_QUEUE_H
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "ISConstants.h"
+
+#define CORRECTION_QUEUE_MAX_AGE_MS     2000        // Packets waiting longer than this are stale and dropped
+#define CORRECTION_QUEUE_MAX_BYTES      16384       // Oldest packets are dropped when the queue exceeds this size
+
+/**
+ * Per-port queue of correction packets (i.e. RTCM3) forwarded from one base stream to many devices.  Writes never wait
+ * on the port; bytes the port can't accept stay queued for the next Drain().  Whole packets are dropped when they age
+ * out, so a stalled device loses stale epochs instead of delaying other devices.  A packet partially written is always
+ * completed so the device never sees a truncated frame.
+ */
+class cISCorrectionQueue
+{
+public:
+    struct sStats
+    {
+        uint32_t queuedPkts;        // Packets pushed
+        uint32_t sentPkts;          // Packets completely written
+        uint32_t droppedPkts;       // Packets dropped for age or queue size
+        uint32_t droppedBytes;
+        uint32_t lastLatencyMs;     // (ms) push to write complete
+        uint32_t maxLatencyMs;
+        uint64_t totalLatencyMs;
+    };
+
+    /**
+     * Write callback.  Returns the number of bytes accepted (may be less than size, including 0) or -1 on port error.
+     */
+    typedef std::function<int(const uint8_t* data, int size)> pfnWrite;
+
+    cISCorrectionQueue(uint32_t maxAgeMs = CORRECTION_QUEUE_MAX_AGE_MS, uint32_t maxBytes = CORRECTION_QUEUE_MAX_BYTES);
+
+    void SetMaxAge(uint32_t maxAgeMs) { m_maxAgeMs = maxAgeMs; }
+    uint32_t MaxAge() { return m_maxAgeMs; }
+
+    /** Queue a copy of a packet received at timeMs */
+    void Push(const uint8_t* data, int size, uint32_t timeMs);
+
+    /**
+     * Drop stale packets and write queued data until the port stops accepting it.
+     * @return false on port error
+     */
+    bool Drain(uint32_t timeMs, const pfnWrite& write);
+
+    /**
+     * Write the rest of a packet already started on the wire, so another writer can use the port without splitting
+     * the frame.  The packet is dropped if the port stops accepting data.
+     * @return false on port error
+     */
+    bool FinishPartial(uint32_t timeMs, const pfnWrite& write);
+
+    void Clear();
+    bool Empty() { return m_pkts.empty(); }
+    bool Partial() { return m_frontWritten > 0; }
+    size_t PendingBytes() { return m_bytes; }
+    const sStats& Stats() { return m_stats; }
+
+private:
+    struct sPacket
+    {
+        uint32_t timeMs;
+        std::vector<uint8_t> data;
+    };
+
+    void DropFront();
+    void PopSent(uint32_t timeMs);
+
+    std::deque<sPacket> m_pkts;
+    size_t m_bytes = 0;             // Unwritten bytes in queue
+    size_t m_frontWritten = 0;      // Bytes of the front packet already written
+    uint32_t m_maxAgeMs;
+    uint32_t m_maxBytes;
+    sStats m_stats = {};
+};
+
+#endif // IS_CORRECTION_QUEUE_H
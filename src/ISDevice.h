@@ -9,9 +9,12 @@
 #ifndef INERTIALSENSESDK_ISDEVICE_H
 #define INERTIALSENSESDK_ISDEVICE_H
 
+#include <map>
 #include <memory>
 
 #include "DeviceLog.h"
+#include "ISCorrectionQueue.h"
+#include "ISMemory.h"
 #include "protocol/FirmwareUpdate.h"
 // #include "ISFirmwareUpdater.h"
 
@@ -44,12 +47,12 @@ public:
     // void getErrors() { return (fwUpdater != NULL ? fwUpdater->hasErrors() : hasError); }
 };
 
-class ISDevice {
+/**
+ * Device configuration and status that is only touched when DID data is received or requested.  Kept in a separate
+ * allocation so ISDevice stays small and the per-packet path doesn't pull several KB into cache.
+ */
+class ISDeviceConfig {
 public:
-    int portHandle = 0;
-    serial_port_t serialPort = { };
-    // libusb_device* usbDevice = nullptr; // reference to the USB device (if using a USB connection), otherwise should be nullptr.
-
     dev_info_t devInfo = { };                   // Populated with IMX info if present, otherwise GPX info if present
     dev_info_t gpxDevInfo = { };                // Only populated if a GPX device is present
     sys_params_t sysParams = { };
@@ -63,20 +66,64 @@ public:
     evb_flash_cfg_t evbFlashCfg = { };
     system_command_t sysCmd = { };
 
-    std::shared_ptr<cDeviceLog> devLogger;
     fwUpdate::update_status_e closeStatus = { };
     ISDeviceUpdater fwUpdate = { };
 
-    static ISDevice invalidRef;
+    // Broadcast configuration requested through InertialSense, restored on hot-plug reconnect.
+    uint64_t rmcPreset = 0;
+    uint32_t rmcOptions = 0;
+    std::map<uint32_t, int> broadcastPeriods;   // DID, period multiple
 
-    ISDevice() 
-    { 
+    ISDeviceConfig()
+    {
         sysParams.flashCfgChecksum = 0xFFFFFFFF;		// Set invalid checksum to trigger synchronization
         gpxStatus.flashCfgChecksum = 0xFFFFFFFF;		// Set invalid checksum to trigger synchronization
         imxFlashCfg.checksum = 0xFFFFFFFF;			    // Set invalid checksum to trigger synchronization
         gpxFlashCfg.checksum = 0xFFFFFFFF;			    // Set invalid checksum to trigger synchronization
     };
 
+    // Counted as cISMemory::DEVICE
+    static void* operator new(size_t size)
+    {
+        void* p = ::operator new(size);
+        cISMemory::Allocate(cISMemory::DEVICE, size);
+        return p;
+    }
+    static void operator delete(void* p, size_t size)
+    {
+        cISMemory::Free(cISMemory::DEVICE, size);
+        ::operator delete(p);
+    }
+};
+
+/**
+ * Per-port state used on every received packet.  Devices are not copyable; pass ISDevice& or ISDevice* (i.e. from
+ * InertialSense::getDevice()) as a handle.  The config pointer remains valid for the lifetime of the device, including
+ * when the owning container reallocates.
+ */
+class ISDevice {
+public:
+    int portHandle = 0;
+    serial_port_t serialPort = { };
+    // libusb_device* usbDevice = nullptr; // reference to the USB device (if using a USB connection), otherwise should be nullptr.
+
+    std::shared_ptr<cDeviceLog> devLogger;
+    cISCorrectionQueue corrections;             // Client corrections waiting to be written to this port
+
+    // Hot-plug recovery
+    unsigned int disconnectTimeMs = 0;          // (ms) non-zero while the port is lost
+    unsigned int reopenTimeMs = 0;              // (ms) non-zero after reopen until first data is received
+    unsigned int reopenRetryTimeMs = 0;
+
+    std::unique_ptr<ISDeviceConfig> config;
+
+    static ISDevice invalidRef;
+
+    ISDevice() : config(new ISDeviceConfig()) { };
+    ISDevice(ISDevice&&) = default;
+    ISDevice& operator=(ISDevice&&) = default;
+    ISDevice(const ISDevice&) = delete;
+    ISDevice& operator=(const ISDevice&) = delete;
 };
 
 
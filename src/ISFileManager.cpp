@@ -37,6 +37,13 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <unistd.h>
 #endif
 
+#if PLATFORM_IS_LINUX
+#include <atomic>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <thread>
+#endif
+
 #if 0
     #define DEBUG_PRINT(x) std::cout << x ;
 #else
@@ -53,6 +60,330 @@ namespace ISFileManager {
     const char* path_seperator = nullptr;
     #endif
 
+    // Glob tokens.  Other characters are literal, lower case.
+    #define GLOB_ANY_SEQ    '\x01'
+    #define GLOB_ANY_CHAR   '\x02'
+    #define GLOB_SEPARATOR  '\x03'
+
+    struct cPathPattern::sRegex
+    {
+        std::regex re;
+    };
+
+    cPathPattern::cPathPattern(const std::string& regexPattern)
+    {
+        if (regexPattern.empty())
+        {
+            return;
+        }
+        if (!Compile(regexPattern))
+        {
+            m_globs.clear();
+            m_regex = std::make_shared<sRegex>();
+            m_regex->re = std::regex(regexPattern, std::regex::icase);
+        }
+    }
+
+    static bool globLiteral(char c)
+    {
+        return isalnum((unsigned char)c) || (c != 0 && strchr(" _-.,:;@#%&=~!'\"<>/\\", c) != NULLPTR);
+    }
+
+    bool cPathPattern::Compile(const std::string& re)
+    {
+        std::vector<std::string> globs = { "" };
+        bool anchorStart = false, anchorEnd = false;
+        auto append = [&globs](char c) { for (std::string& g : globs) { g += c; } };
+
+        for (size_t i = 0; i < re.size(); i++)
+        {
+            char c = re[i];
+            if (anchorEnd)
+            {   // Only allowed at the end
+                return false;
+            }
+
+            if (c == '^' && i == 0)
+            {
+                anchorStart = true;
+            }
+            else if (c == '$')
+            {
+                anchorEnd = true;
+            }
+            else if (c == '\\')
+            {   // Escaped punctuation is literal.  Classes like \d are not supported.
+                if (++i >= re.size() || isalnum((unsigned char)re[i]))
+                {
+                    return false;
+                }
+                append((char)tolower((unsigned char)re[i]));
+            }
+            else if (c == '.')
+            {
+                if (i + 1 < re.size() && re[i + 1] == '*')
+                {   // .* or lazy .*? are the same when searching
+                    i += (i + 2 < re.size() && re[i + 2] == '?') ? 2 : 1;
+                    append(GLOB_ANY_SEQ);
+                }
+                else
+                {
+                    append(GLOB_ANY_CHAR);
+                }
+            }
+            else if (c == '[')
+            {   // Only the path separator class [\/\\]
+                size_t end = re.find(']', i + 1);
+                if (end == std::string::npos)
+                {
+                    return false;
+                }
+                bool slash = false, backslash = false;
+                for (size_t j = i + 1; j < end; j++)
+                {
+                    if (re[j] == '\\' && j + 1 < end) { j++; }
+                    if (re[j] == '/')       { slash = true; }
+                    else if (re[j] == '\\') { backslash = true; }
+                    else                    { return false; }
+                }
+                if (!slash || !backslash)
+                {
+                    return false;
+                }
+                append(GLOB_SEPARATOR);
+                i = end;
+            }
+            else if (c == '(')
+            {   // Literal alternatives, expanded into separate globs
+                size_t end = re.find(')', i + 1);
+                if (end == std::string::npos)
+                {
+                    return false;
+                }
+                std::vector<std::string> options = { "" };
+                for (size_t j = i + 1; j < end; j++)
+                {
+                    if (re[j] == '|')               { options.push_back(""); }
+                    else if (globLiteral(re[j]) && re[j] != '.' && re[j] != '\\') { options.back() += (char)tolower((unsigned char)re[j]); }
+                    else                            { return false; }
+                }
+                std::vector<std::string> expanded;
+                for (const std::string& g : globs)
+                {
+                    for (const std::string& o : options)
+                    {
+                        expanded.push_back(g + o);
+                    }
+                }
+                globs.swap(expanded);
+                i = end;
+            }
+            else if (globLiteral(c))
+            {
+                append((char)tolower((unsigned char)c));
+            }
+            else
+            {   // Quantifiers and other syntax
+                return false;
+            }
+        }
+
+        for (std::string& g : globs)
+        {
+            m_globs.push_back((anchorStart ? "" : std::string(1, GLOB_ANY_SEQ)) + g + (anchorEnd ? "" : std::string(1, GLOB_ANY_SEQ)));
+        }
+        return true;
+    }
+
+    // Wildcard match, backtracking to the last GLOB_ANY_SEQ only
+    static bool globMatch(const std::string& glob, const std::string& path)
+    {
+        size_t g = 0, p = 0, starG = std::string::npos, starP = 0;
+        while (p < path.size())
+        {
+            char pc = path[p];
+            if (g < glob.size())
+            {
+                char gc = glob[g];
+                if (gc == GLOB_ANY_SEQ)
+                {
+                    starG = g++;
+                    starP = p;
+                    continue;
+                }
+                if (gc == GLOB_ANY_CHAR ||
+                    (gc == GLOB_SEPARATOR ? (pc == '/' || pc == '\\') : gc == (char)tolower((unsigned char)pc)))
+                {
+                    g++;
+                    p++;
+                    continue;
+                }
+            }
+            if (starG == std::string::npos)
+            {
+                return false;
+            }
+            g = starG + 1;
+            p = ++starP;
+        }
+        while (g < glob.size() && glob[g] == GLOB_ANY_SEQ)
+        {
+            g++;
+        }
+        return g == glob.size();
+    }
+
+    bool cPathPattern::Match(const std::string& path) const
+    {
+        if (m_regex)
+        {
+            return std::regex_search(path, m_regex->re);
+        }
+        if (m_globs.empty())
+        {
+            return true;
+        }
+        for (const std::string& glob : m_globs)
+        {
+            if (globMatch(glob, path))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+#if PLATFORM_IS_LINUX
+
+    struct sLinuxDirent64
+    {
+        uint64_t        d_ino;
+        int64_t         d_off;
+        unsigned short  d_reclen;
+        unsigned char   d_type;
+        char            d_name[1];
+    };
+
+    #define DIRENT_BUFFER_SIZE      (64 * 1024)
+
+    /**
+     * List directory fd with getdents64, a few system calls per thousands of entries.  Entries are only stat'd (fstatat
+     * relative to fd, no path lookup) when the type is unknown or size and time are wanted.  Like the portable code,
+     * the pattern is applied to directories as well as files.  With parallel, the subdirectories of this directory are
+     * walked by a pool of threads and their files appended in directory order.
+     */
+    static void walkDirectory(int fd, const std::string& path, bool recursive, const cPathPattern& pattern, bool wantStat,
+        bool skipHidden, bool parallel, std::vector<file_info_t>& files)
+    {
+        std::vector<std::string> subdirs;
+        std::unique_ptr<char[]> buf(new char[DIRENT_BUFFER_SIZE]);
+        long n;
+        while ((n = syscall(SYS_getdents64, fd, buf.get(), DIRENT_BUFFER_SIZE)) > 0)
+        {
+            for (long pos = 0; pos < n; )
+            {
+                const sLinuxDirent64* ent = (const sLinuxDirent64*)(buf.get() + pos);
+                pos += ent->d_reclen;
+                const char* name = ent->d_name;
+                if ((name[0] == '.' && (skipHidden || name[1] == 0 || (name[1] == '.' && name[2] == 0))))
+                {
+                    continue;
+                }
+
+                std::string fullName = path + "/" + name;
+                if (!pattern.Match(fullName))
+                {
+                    continue;
+                }
+
+                unsigned char type = ent->d_type;
+                struct stat st;
+                bool haveStat = false;
+                if (type == DT_UNKNOWN || type == DT_LNK || (wantStat && type != DT_DIR))
+                {
+                    if (fstatat(fd, name, &st, 0) != 0)
+                    {   // Broken link or removed
+                        continue;
+                    }
+                    haveStat = true;
+                    type = (S_ISDIR(st.st_mode) ? DT_DIR : DT_REG);
+                }
+
+                if (type == DT_DIR)
+                {
+                    if (recursive)
+                    {
+                        subdirs.push_back(name);
+                    }
+                    continue;
+                }
+
+                file_info_t info;
+                info.name = std::move(fullName);
+                info.size = (haveStat ? (uint64_t)st.st_size : 0);
+                info.lastModificationDate = (haveStat ? st.st_mtime : 0);
+                files.push_back(std::move(info));
+            }
+        }
+
+        auto walkSubdir = [&](const std::string& name, std::vector<file_info_t>& out)
+        {
+            int subFd = openat(fd, name.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (subFd >= 0)
+            {
+                walkDirectory(subFd, path + "/" + name, true, pattern, wantStat, skipHidden, false, out);
+                close(subFd);
+            }
+        };
+
+        size_t threadCount = _MIN((size_t)std::thread::hardware_concurrency(), subdirs.size());
+        if (!parallel || threadCount < 2)
+        {
+            for (const std::string& name : subdirs)
+            {
+                walkSubdir(name, files);
+            }
+            return;
+        }
+
+        std::vector<std::vector<file_info_t>> results(subdirs.size());
+        std::atomic<size_t> next(0);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([&]()
+            {
+                for (size_t i; (i = next++) < subdirs.size(); )
+                {
+                    walkSubdir(subdirs[i], results[i]);
+                }
+            });
+        }
+        for (std::thread& t : threads)
+        {
+            t.join();
+        }
+        for (std::vector<file_info_t>& r : results)
+        {
+            files.insert(files.end(), std::make_move_iterator(r.begin()), std::make_move_iterator(r.end()));
+        }
+    }
+
+    static bool walkDirectory(const std::string& directory, bool recursive, const cPathPattern& pattern, bool wantStat,
+        bool skipHidden, std::vector<file_info_t>& files)
+    {
+        int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return false;
+        }
+        walkDirectory(fd, directory, recursive, pattern, wantStat, skipHidden, recursive, files);
+        close(fd);
+        return true;
+    }
+
+#endif
+
     bool PathIsDir(const std::string& path)
     {
     #if PLATFORM_IS_EVB_2
@@ -68,13 +399,7 @@ namespace ISFileManager {
     bool GetAllFilesInDirectory(const std::string& directory, bool recursive, const std::string& regexPattern, std::vector<std::string>& files)
     {
         size_t startSize = files.size();
-        std::regex* rePtr = NULL;
-        std::regex re;
-        if (regexPattern.length() != 0)
-        {
-            re = std::regex(regexPattern, std::regex::icase);
-            rePtr = &re;
-        }
+        cPathPattern pattern(regexPattern);
 
     #if PLATFORM_IS_EVB_2
 
@@ -106,7 +431,7 @@ namespace ISFileManager {
                     std::string full_file_name = directory + "/" + file_name;
 
 
-                    if (file_name[0] == '.' || (rePtr != NULL && !regex_search(full_file_name, re)))
+                    if (file_name[0] == '.' || !pattern.Match(full_file_name))
                     {
                         continue;
                     }
@@ -135,7 +460,7 @@ namespace ISFileManager {
         {
             std::string file_name = file_data.cFileName;
             std::string full_file_name = directory + "/" + file_name;
-            if (file_name[0] == '.' || (rePtr != NULL && !regex_search(full_file_name, re)))
+            if (file_name[0] == '.' || !pattern.Match(full_file_name))
             {
                 continue;
             }
@@ -151,7 +476,20 @@ namespace ISFileManager {
         } while (FindNextFileA(dir, &file_data));
         FindClose(dir);
 
-    #else // Linux
+    #elif PLATFORM_IS_LINUX
+
+        std::vector<file_info_t> infos;
+        if (!walkDirectory(directory, recursive, pattern, false, true, infos))
+        {
+            return false;
+        }
+        files.reserve(files.size() + infos.size());
+        for (file_info_t& info : infos)
+        {
+            files.push_back(std::move(info.name));
+        }
+
+    #else
 
         class dirent* ent;
         class stat st;
@@ -167,7 +505,7 @@ namespace ISFileManager {
 
             // if file is current path or does not exist (-1) then continue
             if (file_name[0] == '.' || stat(full_file_name.c_str(), &st) == -1 ||
-                (rePtr != NULL && !regex_search(full_file_name, re))) {
+                !pattern.Match(full_file_name)) {
                 continue;
             }
             else if ((st.st_mode & S_IFDIR) != 0) {
@@ -286,9 +624,18 @@ namespace ISFileManager {
         static_assert((sizeof(time_t) >= 2 * sizeof(WORD)), "time_t must be at least 2* DWORD, since we store the FatFs date/time (DWORD) in a time_t here.");
     #endif
 
+        uint64_t spaceUsed = 0;
+    #if PLATFORM_IS_LINUX
+        // Size and time come from the walk, one fstatat per file
+        size_t startSize = files.size();
+        walkDirectory(directory, recursive, cPathPattern(regexPattern), true, true, files);
+        for (size_t i = startSize; i < files.size(); i++)
+        {
+            spaceUsed += files[i].size;
+        }
+    #else
         std::vector<std::string> fileNames;
         ISFileManager::GetAllFilesInDirectory(directory, recursive, regexPattern, fileNames);
-        uint64_t spaceUsed = 0;
         for (unsigned int i = 0; i < fileNames.size(); i++)
         {
             file_info_t info;
@@ -308,6 +655,7 @@ namespace ISFileManager {
             files.push_back(info);
             spaceUsed += info.size;
         }
+    #endif
 
         if (sortByDate) {
             struct
@@ -741,6 +1089,16 @@ namespace ISFileManager {
         } while (FindNextFile(hFind, &find_file_data) != 0);
 
         FindClose(hFind);
+#elif PLATFORM_IS_LINUX
+        std::vector<file_info_t> infos;
+        if (!walkDirectory(directory, true, cPathPattern(), true, false, infos)) {
+            std::cerr << "Error: Could not open directory " << directory << std::endl;
+            return;
+        }
+        files.reserve(files.size() + infos.size());
+        for (file_info_t& info : infos) {
+            files.push_back({ std::move(info.name), info.size, info.lastModificationDate });
+        }
 #else
         DIR* dir = opendir(directory.c_str());
         if (!dir) {
@@ -14,6 +14,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #define IS_SDK_IS_FILE_MANAGER_H_
 
 #include "ISConstants.h"
+#include <memory>
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -27,6 +28,27 @@ namespace ISFileManager
         time_t lastModificationDate;
     } file_info_t;
 
+    /**
+     * File path regular expression, compiled once.  Expressions made of literal text, ".", ".*", a "[\/\\]" path
+     * separator class, "^" and "$" anchors and "(a|b)" literal alternatives (all of the log file patterns) are matched as
+     * globs, which is much faster than std::regex per file.  Anything else falls back to std::regex.  Case insensitive
+     * and, like regex_search, matches anywhere in the path unless anchored.  An empty expression matches everything.
+     */
+    class cPathPattern
+    {
+    public:
+        explicit cPathPattern(const std::string& regexPattern = "");
+        bool Match(const std::string& path) const;
+        bool IsGlob() const { return m_regex == nullptr; }
+
+    private:
+        bool Compile(const std::string& regexPattern);
+
+        std::vector<std::string> m_globs;       // Alternatives, any of which may match
+        struct sRegex;
+        std::shared_ptr<sRegex> m_regex;        // Fallback
+    };
+
     /**
      * Is this path directory?
      * @param path the path to check
@@ -107,7 +107,7 @@ public:
      */
     ISFirmwareUpdater(int portHandle, const char *portName, const dev_info_t *devInfo) : FirmwareUpdateHost(), pHandle(portHandle), portName(portName), devInfo(devInfo) { };
 
-    ISFirmwareUpdater(ISDevice device) : FirmwareUpdateHost(), pHandle(device.portHandle), portName(device.serialPort.port), devInfo(&device.devInfo) { };
+    ISFirmwareUpdater(const ISDevice& device) : FirmwareUpdateHost(), pHandle(device.portHandle), portName(device.serialPort.port), devInfo(&device.config->devInfo) { };
 
     ~ISFirmwareUpdater() override {};
 
@@ -0,0 +1,152 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sys/stat.h>
+
+#include "ISHotplugMonitor.h"
+
+#if PLATFORM_IS_LINUX
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <limits.h>
+#endif
+
+using namespace std;
+
+static bool pathExists(const string& path)
+{
+    struct stat sb;
+    return stat(path.c_str(), &sb) == 0;
+}
+
+cISHotplugMonitor::cISHotplugMonitor() : m_fd(-1)
+{
+}
+
+cISHotplugMonitor::~cISHotplugMonitor()
+{
+    Close();
+}
+
+bool cISHotplugMonitor::Watch(const string& path)
+{
+    for (const sPath& p : m_paths)
+    {
+        if (p.path == path)
+        {
+            return true;
+        }
+    }
+
+    sPath p;
+    p.path = path;
+    size_t slash = path.find_last_of('/');
+    p.dir = (slash == string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash)));
+    p.name = (slash == string::npos ? path : path.substr(slash + 1));
+    p.watch = -1;
+    p.exists = pathExists(path);
+
+#if PLATFORM_IS_LINUX
+    if (m_fd < 0)
+    {
+        m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_fd < 0)
+        {
+            return false;
+        }
+    }
+
+    // Adding the same directory again returns the existing watch descriptor
+    p.watch = inotify_add_watch(m_fd, p.dir.c_str(), IN_CREATE | IN_DELETE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO);
+    if (p.watch < 0)
+    {
+        return false;
+    }
+#endif
+
+    m_paths.push_back(p);
+    return true;
+}
+
+void cISHotplugMonitor::Close()
+{
+#if PLATFORM_IS_LINUX
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+        m_fd = -1;
+    }
+#endif
+    m_paths.clear();
+}
+
+int cISHotplugMonitor::Poll(vector<sEvent>& events)
+{
+    size_t count = events.size();
+
+#if PLATFORM_IS_LINUX
+    if (m_fd < 0)
+    {
+        return 0;
+    }
+
+    alignas(struct inotify_event) char buf[16 * (sizeof(struct inotify_event) + NAME_MAX + 1)];
+    ssize_t len;
+    while ((len = read(m_fd, buf, sizeof(buf))) > 0)
+    {
+        for (char* ptr = buf; ptr < buf + len; )
+        {
+            const struct inotify_event* ev = (const struct inotify_event*)ptr;
+            ptr += sizeof(struct inotify_event) + ev->len;
+            if (ev->len == 0)
+            {
+                continue;
+            }
+
+            for (sPath& p : m_paths)
+            {
+                if (p.watch != ev->wd || p.name != ev->name)
+                {
+                    continue;
+                }
+
+                if (ev->mask & (IN_DELETE | IN_MOVED_FROM))
+                {
+                    p.exists = false;
+                    events.push_back({ EVENT_REMOVED, p.path });
+                }
+                else if (ev->mask & (IN_CREATE | IN_MOVED_TO))
+                {
+                    p.exists = true;
+                    events.push_back({ EVENT_ADDED, p.path });
+                }
+                else if (ev->mask & IN_ATTRIB)
+                {
+                    events.push_back({ EVENT_CHANGED, p.path });
+                }
+            }
+        }
+    }
+#else
+    for (sPath& p : m_paths)
+    {
+        bool exists = pathExists(p.path);
+        if (exists != p.exists)
+        {
+            p.exists = exists;
+            events.push_back({ exists ? EVENT_ADDED : EVENT_REMOVED, p.path });
+        }
+    }
+#endif
+
+    return (int)(events.size() - count);
+}
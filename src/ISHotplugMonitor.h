@@ -0,0 +1,76 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef IS_HOTPLUG_MONITOR_H
+#define IS_HOTPLUG_MONITOR_H
+
+#include <string>
+#include <vector>
+
+#include "ISConstants.h"
+
+/**
+ * Non-blocking monitor for device node (i.e. /dev/ttyACM0) removal and reappearance.  On Linux the parent directory
+ * of each watched path is monitored with inotify, so events arrive as soon as udev creates or deletes the node.
+ * Other platforms fall back to checking whether the watched paths exist on each Poll().
+ */
+class cISHotplugMonitor
+{
+public:
+    enum eEventType
+    {
+        EVENT_ADDED,            // Node created
+        EVENT_REMOVED,          // Node deleted
+        EVENT_CHANGED,          // Node attributes changed, i.e. udev applied permissions after creating the node
+    };
+
+    struct sEvent
+    {
+        eEventType type;
+        std::string path;
+    };
+
+    cISHotplugMonitor();
+    ~cISHotplugMonitor();
+
+    /**
+     * Start watching a device path.  Symbolic link paths (i.e. /dev/serial/by-id/...) are watched by link name.
+     * @return true if the path can be watched
+     */
+    bool Watch(const std::string& path);
+
+    /** Stop watching all paths */
+    void Close();
+
+    bool IsOpen() { return !m_paths.empty(); }
+
+    /**
+     * Collect events for watched paths since the last call.  Does not block.
+     * @return number of events appended
+     */
+    int Poll(std::vector<sEvent>& events);
+
+private:
+    struct sPath
+    {
+        std::string path;
+        std::string dir;
+        std::string name;
+        int watch;
+        bool exists;
+    };
+
+    std::vector<sPath> m_paths;
+    int m_fd;
+};
+
+#endif // IS_HOTPLUG_MONITOR_H
@@ -0,0 +1,248 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <ctype.h>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "ISLogCatalog.h"
+#include "DeviceLog.h"
+#include "ISFileManager.h"
+
+using namespace std;
+
+#define CATALOG_VERSION     1
+
+static bool fileSize(const string& path, uint64_t& size)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+    {
+        return false;
+    }
+    size = (uint64_t)st.st_size;
+    return true;
+}
+
+void cISLogCatalog::Clear(const string& directory, const string& extension)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_directory = directory;
+    m_extension = extension;
+    m_devices.clear();
+}
+
+void cISLogCatalog::Update(uint32_t serialNo, const sFile& file)
+{
+    lock_guard<mutex> lock(m_mutex);
+    vector<sFile>& files = m_devices[serialNo];
+    if (!files.empty() && files.back().name == file.name)
+    {
+        files.back() = file;
+    }
+    else
+    {
+        files.push_back(file);
+    }
+}
+
+bool cISLogCatalog::Write()
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (m_directory.empty() || m_devices.empty())
+    {
+        return false;
+    }
+
+    string path = Path(m_directory, m_extension);
+    string tmpPath = path + ".tmp";
+    FILE* file = fopen(tmpPath.c_str(), "w");
+    if (file == NULLPTR)
+    {
+        return false;
+    }
+
+    fprintf(file, "version %d\nextension %s\n", CATALOG_VERSION, m_extension.c_str());
+    for (auto& device : m_devices)
+    {
+        fprintf(file, "device %u %d\n", device.first, (int)device.second.size());
+        for (sFile& f : device.second)
+        {
+            fprintf(file, "%llu %.6f %.6f %s\n", (unsigned long long)f.size, f.startTime, f.endTime, f.name.c_str());
+        }
+    }
+    fprintf(file, "end\n");
+    bool ok = (fflush(file) == 0);
+    ok &= (fclose(file) == 0);
+
+#if PLATFORM_IS_WINDOWS
+    remove(path.c_str());       // rename() doesn't replace on Windows
+#endif
+    if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool cISLogCatalog::Read(const string& directory, const string& extension)
+{
+    Clear(directory, extension);
+
+    ifstream in(Path(directory, extension));
+    if (!in.is_open())
+    {
+        return false;
+    }
+
+    lock_guard<mutex> lock(m_mutex);
+    string line, key, value;
+    int version = 0;
+    if (!getline(in, line) || !(istringstream(line) >> key >> version) || key != "version" || version != CATALOG_VERSION ||
+        !getline(in, line) || !(istringstream(line) >> key >> value) || key != "extension" || value != extension)
+    {
+        return false;
+    }
+
+    while (getline(in, line))
+    {
+        istringstream ss(line);
+        uint32_t serialNo;
+        int count;
+        if (!(ss >> key))
+        {
+            break;
+        }
+        if (key == "end")
+        {   // Complete catalog
+            return !m_devices.empty();
+        }
+        if (key != "device" || !(ss >> serialNo >> count) || count <= 0)
+        {
+            break;
+        }
+
+        vector<sFile>& files = m_devices[serialNo];
+        files.resize(count);
+        for (sFile& f : files)
+        {
+            unsigned long long size;
+            if (!getline(in, line) || !(istringstream(line) >> size >> f.startTime >> f.endTime >> f.name))
+            {
+                m_devices.clear();
+                return false;
+            }
+            f.size = size;
+        }
+    }
+
+    m_devices.clear();
+    return false;
+}
+
+bool cISLogCatalog::IsCurrent()
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (m_devices.empty())
+    {
+        return false;
+    }
+
+    for (auto& device : m_devices)
+    {
+        const vector<sFile>& files = device.second;
+        uint64_t size;
+        string next = NextFileName(files.back().name);
+        if (!fileSize(m_directory + "/" + files.front().name, size) ||
+            !fileSize(m_directory + "/" + files.back().name, size) || size != files.back().size ||
+            (!next.empty() && fileSize(m_directory + "/" + next, size) && size > 0))
+        {
+            return false;
+        }
+    }
+
+    // Devices that appeared since the catalog was written
+    vector<string> paths;
+    ISFileManager::GetAllFilesInDirectory(m_directory, false, paths);
+    set<uint32_t> serials;
+    size_t prefixLen = strlen(IS_LOG_FILE_PREFIX);
+    for (const string& path : paths)
+    {
+        string name = ISFileManager::GetFileName(path);
+        if (name.size() <= prefixLen + m_extension.size() || name.compare(0, prefixLen, IS_LOG_FILE_PREFIX) != 0 ||
+            name.compare(name.size() - m_extension.size(), m_extension.size(), m_extension) != 0)
+        {
+            continue;
+        }
+        char* end;
+        unsigned long serialNo = strtoul(name.c_str() + prefixLen, &end, 10);
+        if (*end == '_')
+        {
+            serials.insert((uint32_t)serialNo);
+        }
+    }
+    if (serials.size() != m_devices.size())
+    {
+        return false;
+    }
+    for (uint32_t serialNo : serials)
+    {
+        if (!m_devices.count(serialNo))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+map<uint32_t, vector<cISLogCatalog::sFile>> cISLogCatalog::Devices()
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_devices;
+}
+
+string cISLogCatalog::Path(const string& directory, const string& extension)
+{
+    return directory + "/" IS_LOG_CATALOG_PREFIX + (extension.size() && extension[0] == '.' ? extension.substr(1) : extension) + ".txt";
+}
+
+string cISLogCatalog::NextFileName(const string& name)
+{
+    // LOG_SN<serial>_<date>_<time>_<index>.<ext>
+    size_t dot = name.rfind('.');
+    size_t underscore = name.rfind('_', dot);
+    if (dot == string::npos || underscore == string::npos || dot - underscore != 5)
+    {
+        return "";
+    }
+
+    int index = 0;
+    for (size_t i = underscore + 1; i < dot; i++)
+    {
+        if (!isdigit((unsigned char)name[i]))
+        {
+            return "";
+        }
+        index = index * 10 + (name[i] - '0');
+    }
+
+    char buf[8];
+    SNPRINTF(buf, sizeof(buf), "%04d", (index + 1) % 10000);
+    return name.substr(0, underscore + 1) + buf + name.substr(dot);
+}
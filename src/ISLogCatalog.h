@@ -0,0 +1,76 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef IS_LOG_CATALOG_H
+#define IS_LOG_CATALOG_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ISConstants.h"
+
+#define IS_LOG_CATALOG_PREFIX       "log_catalog_"  // i.e. log_catalog_dat.txt
+
+/**
+ * Index of a log directory: the files of each device in write order with their sizes and data time spans.  The logger
+ * rewrites it (temporary file then rename) on each file rotation and on close, so LoadFromDirectory can open a log
+ * without listing, regex matching and sorting the directory.  A catalog is only used while IsCurrent(), otherwise the
+ * directory is scanned as before.
+ */
+class cISLogCatalog
+{
+public:
+    struct sFile
+    {
+        std::string name;               // File name without directory
+        uint64_t size = 0;              // (bytes)
+        double startTime = 0;           // (s) First and last non-zero data timestamp
+        double endTime = 0;
+    };
+
+    /** Start an empty catalog for files with extension (i.e. ".dat") in directory */
+    void Clear(const std::string& directory, const std::string& extension);
+
+    /** Append a file to a device, or update it if it is already the last file of the device */
+    void Update(uint32_t serialNo, const sFile& file);
+
+    /** Atomically replace the catalog file */
+    bool Write();
+
+    /** Load the catalog for extension from directory */
+    bool Read(const std::string& directory, const std::string& extension);
+
+    /**
+     * True if the catalog still describes the directory: the first and last file of each device exist, the last file
+     * has its catalogued size and no non-empty file follows it, and the directory has log files of no other device.  One
+     * directory listing and a few stat calls per device.
+     */
+    bool IsCurrent();
+
+    std::map<uint32_t, std::vector<sFile>> Devices();
+
+    static std::string Path(const std::string& directory, const std::string& extension);
+
+    /** Name of the file following name in a rotated log (index + 1), empty if name has no index */
+    static std::string NextFileName(const std::string& name);
+
+private:
+    std::mutex m_mutex;
+    std::string m_directory;
+    std::string m_extension;
+    std::map<uint32_t, std::vector<sFile>> m_devices;
+};
+
+#endif // IS_LOG_CATALOG_H
@@ -0,0 +1,435 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <string.h>
+#include <thread>
+
+#include "ISLogCompare.h"
+#include "ISDataMappings.h"
+#include "yaml-cpp/yaml.h"
+
+using namespace std;
+
+namespace
+{
+    // One field, or one element of an array field
+    struct sField
+    {
+        const data_info_t* info;
+        uint32_t index;
+        cISLogCompare::sTolerance tolerance;
+    };
+
+    bool fieldValue(const data_info_t& info, const uint8_t* ptr, double& value)
+    {
+        switch (info.type)
+        {
+        case DATA_TYPE_INT8:    { int8_t v;   memcpy(&v, ptr, sizeof(v)); value = v; return true; }
+        case DATA_TYPE_UINT8:   { uint8_t v;  memcpy(&v, ptr, sizeof(v)); value = v; return true; }
+        case DATA_TYPE_INT16:   { int16_t v;  memcpy(&v, ptr, sizeof(v)); value = v; return true; }
+        case DATA_TYPE_UINT16:  { uint16_t v; memcpy(&v, ptr, sizeof(v)); value = v; return true; }
+        case DATA_TYPE_INT32:   { int32_t v;  memcpy(&v, ptr, sizeof(v)); value = v; return true; }
+        case DATA_TYPE_UINT32:  { uint32_t v; memcpy(&v, ptr, sizeof(v)); value = v; return true; }
+        case DATA_TYPE_INT64:   { int64_t v;  memcpy(&v, ptr, sizeof(v)); value = (double)v; return true; }
+        case DATA_TYPE_UINT64:  { uint64_t v; memcpy(&v, ptr, sizeof(v)); value = (double)v; return true; }
+        case DATA_TYPE_F32:     { float v;    memcpy(&v, ptr, sizeof(v)); value = v; return true; }
+        case DATA_TYPE_F64:     { memcpy(&value, ptr, sizeof(value)); return true; }
+        default:                return false;
+        }
+    }
+
+    vector<sField> fieldList(uint32_t did, const cISLogCompare::sOptions& options, vector<cISLogCompare::sFieldStats>& stats)
+    {
+        vector<sField> fields;
+        const map_index_to_info_t* infos = cISDataMappings::IndexToInfoMap(did);
+        if (infos == NULLPTR)
+        {
+            return fields;
+        }
+        const char* didName = cISDataMappings::DataName(did);
+        string prefix = (didName ? string(didName) : to_string(did)) + ".";
+        for (auto& it : *infos)
+        {
+            const data_info_t* info = it.second;
+            cISLogCompare::sTolerance tolerance = options.tolerance;
+            auto tol = options.fieldTolerances.find(prefix + info->name);
+            if (tol == options.fieldTolerances.end())
+            {
+                tol = options.fieldTolerances.find(info->name);
+            }
+            if (tol != options.fieldTolerances.end())
+            {
+                tolerance = tol->second;
+            }
+
+            // Strings and binary are compared whole
+            bool whole = (info->type == DATA_TYPE_STRING || info->type == DATA_TYPE_BINARY);
+            uint32_t elements = (info->arraySize && !whole ? info->arraySize : 1);
+            for (uint32_t i = 0; i < elements; i++)
+            {
+                fields.push_back({ info, i, tolerance });
+                cISLogCompare::sFieldStats s;
+                s.name = (info->arraySize && !whole ? info->name + "[" + to_string(i) + "]" : info->name);
+                stats.push_back(s);
+            }
+        }
+        return fields;
+    }
+
+    // Returns the error of field f between two full size records
+    double fieldError(const sField& f, const uint8_t* a, const uint8_t* b, double& limit)
+    {
+        const data_info_t& info = *f.info;
+        limit = 0.0;
+        if (info.type == DATA_TYPE_STRING || info.type == DATA_TYPE_BINARY)
+        {
+            return (memcmp(a + info.offset, b + info.offset, info.size) ? 1.0 : 0.0);
+        }
+
+        const uint8_t* pa = cISDataMappings::FieldData(info, f.index, NULLPTR, a);
+        const uint8_t* pb = cISDataMappings::FieldData(info, f.index, NULLPTR, b);
+        double va, vb;
+        if (pa == NULLPTR || pb == NULLPTR || !fieldValue(info, pa, va) || !fieldValue(info, pb, vb))
+        {
+            return 0.0;
+        }
+        if (isnan(va) || isnan(vb))
+        {
+            return (isnan(va) && isnan(vb) ? 0.0 : INFINITY);
+        }
+        if (va == vb)
+        {   // Includes equal infinities
+            return 0.0;
+        }
+        limit = f.tolerance.abs + f.tolerance.rel * fabs(va);
+        return fabs(va - vb);
+    }
+}
+
+void cISLogCompare::sRecords::Push(const p_data_hdr_t& hdr, const uint8_t* buf)
+{
+    if (size == 0)
+    {
+        size = cISDataMappings::DataSize(hdr.id);
+    }
+
+    // Partial data is zero filled.  Out of bounds data is pushed as a zeroed out data set.
+    size_t offset = data.size();
+    data.resize(offset + size, 0);
+    if ((uint32_t)hdr.offset + hdr.size <= size)
+    {
+        memcpy(&data[offset + hdr.offset], buf, hdr.size);
+    }
+    times.push_back(cISDataMappings::Timestamp(&hdr, buf));
+}
+
+void cISLogCompare::Load(cISLogger& log, const sOptions& options, records_t& records)
+{
+    for (auto& devLog : log.DeviceLogs())
+    {
+        map<uint32_t, sRecords>& dids = records[devLog->SerialNumber()];
+        p_data_buf_t* data;
+        while ((data = log.ReadData(devLog)) != NULLPTR)
+        {
+            uint32_t did = data->hdr.id;
+            if (cISDataMappings::DataSize(did) == 0 ||
+                (!options.dids.empty() && find(options.dids.begin(), options.dids.end(), did) == options.dids.end()))
+            {
+                continue;
+            }
+            dids[did].Push(data->hdr, data->buf);
+        }
+    }
+}
+
+void cISLogCompare::CompareDid(uint32_t did, const sRecords& a, const sRecords& b, const sOptions& options, sDidResult& result)
+{
+    result.did = did;
+    result.countA = a.Count();
+    result.countB = b.Count();
+    result.paired = 0;
+    result.violations = 0;
+    result.fields.clear();
+    result.firstFailure = sFailure();
+    vector<sField> fields = fieldList(did, options, result.fields);
+    if (a.Count() == 0 || b.Count() == 0 || a.size != b.size)
+    {
+        return;
+    }
+
+    // Pair in time order, or log order if the DID has no timestamp
+    const data_set_t* ds = cISDataMappings::DataSet(did);
+    bool timed = (ds && ds->timestampFields != NULLPTR);
+    auto timeOrder = [timed](const sRecords& r)
+    {
+        vector<size_t> order(r.Count());
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            order[i] = i;
+        }
+        if (timed)
+        {
+            stable_sort(order.begin(), order.end(), [&r](size_t x, size_t y) { return r.times[x] < r.times[y]; });
+        }
+        return order;
+    };
+    vector<size_t> orderA = timeOrder(a);
+    vector<size_t> orderB = timeOrder(b);
+
+    size_t i = 0, j = 0;
+    while (i < orderA.size() && j < orderB.size())
+    {
+        size_t ia = orderA[i], ib = orderB[j];
+        if (timed)
+        {
+            double dt = b.times[ib] - a.times[ia];
+            if (dt > options.timeTolerance)         { i++; continue; }     // Unpaired in A
+            else if (dt < -options.timeTolerance)   { j++; continue; }     // Unpaired in B
+        }
+        i++;
+        j++;
+        result.paired++;
+
+        const uint8_t* ra = a.Record(ia);
+        const uint8_t* rb = b.Record(ib);
+        if (memcmp(ra, rb, a.size) == 0)
+        {   // Identical records are the common case
+            for (sFieldStats& s : result.fields)
+            {
+                s.count++;
+            }
+            continue;
+        }
+
+        for (size_t f = 0; f < fields.size(); f++)
+        {
+            sFieldStats& s = result.fields[f];
+            double limit;
+            double error = fieldError(fields[f], ra, rb, limit);
+            s.count++;
+            if (error == 0.0)
+            {
+                continue;
+            }
+            s.sumAbsError += error;
+            s.sumSqError += error * error;
+            s.maxAbsError = _MAX(s.maxAbsError, error);
+            if (error <= limit)
+            {
+                continue;
+            }
+
+            s.violations++;
+            if (result.violations++ == 0)
+            {
+                sFailure& fail = result.firstFailure;
+                fail.time = a.times[ia];
+                fail.indexA = ia;
+                fail.indexB = ib;
+                fail.field = s.name;
+                fail.error = error;
+                fail.limit = limit;
+                data_mapping_string_t str;
+                const data_info_t& info = *fields[f].info;
+                cISDataMappings::DataToString(info, NULLPTR, ra, str, fields[f].index, false, false);
+                fail.valueA = str;
+                cISDataMappings::DataToString(info, NULLPTR, rb, str, fields[f].index, false, false);
+                fail.valueB = str;
+            }
+        }
+    }
+}
+
+bool cISLogCompare::Compare(const string& directoryA, const string& directoryB, cISLogger::eLogType logType, const sOptions& options)
+{
+    m_directoryA = directoryA;
+    m_directoryB = directoryB;
+    m_results.clear();
+    m_unmatchedA.clear();
+    m_unmatchedB.clear();
+
+    cISLogger logA, logB;
+    if (!logA.LoadFromDirectory(directoryA, logType) || !logB.LoadFromDirectory(directoryB, logType))
+    {
+        return false;
+    }
+    Compare(logA, logB, options);
+    return true;
+}
+
+void cISLogCompare::Compare(cISLogger& logA, cISLogger& logB, const sOptions& options)
+{
+    m_results.clear();
+    m_unmatchedA.clear();
+    m_unmatchedB.clear();
+
+    // The logs are independent, so read them at the same time
+    records_t recordsA, recordsB;
+    thread loadB([&]() { Load(logB, options, recordsB); });
+    Load(logA, options, recordsA);
+    loadB.join();
+
+    // Devices by serial number.  Two single device logs are compared regardless, e.g. a replay on another unit.
+    vector<pair<uint32_t, uint32_t>> devices;
+    if (recordsA.size() == 1 && recordsB.size() == 1)
+    {
+        devices.push_back({ recordsA.begin()->first, recordsB.begin()->first });
+    }
+    else
+    {
+        for (auto& dev : recordsA)
+        {
+            if (recordsB.count(dev.first)) { devices.push_back({ dev.first, dev.first }); }
+            else                           { m_unmatchedA.push_back(dev.first); }
+        }
+        for (auto& dev : recordsB)
+        {
+            if (!recordsA.count(dev.first)) { m_unmatchedB.push_back(dev.first); }
+        }
+    }
+
+    // One shard per device and DID found in either log
+    static const sRecords empty;
+    vector<pair<const sRecords*, const sRecords*>> shards;
+    for (auto& dev : devices)
+    {
+        map<uint32_t, sRecords>& didsA = recordsA[dev.first];
+        map<uint32_t, sRecords>& didsB = recordsB[dev.second];
+        set<uint32_t> dids;
+        for (auto& it : didsA) { dids.insert(it.first); }
+        for (auto& it : didsB) { dids.insert(it.first); }
+        for (uint32_t did : dids)
+        {
+            auto a = didsA.find(did);
+            auto b = didsB.find(did);
+            shards.push_back({ (a != didsA.end() ? &a->second : &empty), (b != didsB.end() ? &b->second : &empty) });
+            sDidResult result;
+            result.serialA = dev.first;
+            result.serialB = dev.second;
+            result.did = did;
+            m_results.push_back(result);
+        }
+    }
+
+    // Each worker takes the next uncompared DID
+    atomic<size_t> next(0);
+    auto worker = [&]()
+    {
+        for (size_t i; (i = next++) < shards.size(); )
+        {
+            CompareDid(m_results[i].did, *shards[i].first, *shards[i].second, options, m_results[i]);
+        }
+    };
+    int threadCount = (options.threads > 0 ? options.threads : (int)thread::hardware_concurrency());
+    threadCount = _CLAMP(threadCount, 1, _MAX((int)shards.size(), 1));
+    vector<thread> threads;
+    for (int i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (thread& t : threads)
+    {
+        t.join();
+    }
+}
+
+bool cISLogCompare::Passed() const
+{
+    if (!m_unmatchedA.empty() || !m_unmatchedB.empty())
+    {
+        return false;
+    }
+    for (const sDidResult& result : m_results)
+    {
+        if (!result.Passed())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+string cISLogCompare::ToYaml()
+{
+    YAML::Emitter out;
+    out << YAML::BeginMap;
+    out << YAML::Key << "passed" << YAML::Value << Passed();
+    out << YAML::Key << "logA" << YAML::Value << m_directoryA;
+    out << YAML::Key << "logB" << YAML::Value << m_directoryB;
+    if (!m_unmatchedA.empty() || !m_unmatchedB.empty())
+    {
+        out << YAML::Key << "onlyInA" << YAML::Value << YAML::Flow << m_unmatchedA;
+        out << YAML::Key << "onlyInB" << YAML::Value << YAML::Flow << m_unmatchedB;
+    }
+    out << YAML::Key << "dids" << YAML::Value << YAML::BeginSeq;
+    for (const sDidResult& r : m_results)
+    {
+        const char* name = cISDataMappings::DataName(r.did);
+        out << YAML::BeginMap;
+        out << YAML::Key << "did" << YAML::Value << (name ? string(name) : to_string(r.did));
+        out << YAML::Key << "serialA" << YAML::Value << r.serialA;
+        out << YAML::Key << "serialB" << YAML::Value << r.serialB;
+        out << YAML::Key << "passed" << YAML::Value << r.Passed();
+        out << YAML::Key << "countA" << YAML::Value << r.countA;
+        out << YAML::Key << "countB" << YAML::Value << r.countB;
+        out << YAML::Key << "paired" << YAML::Value << r.paired;
+        out << YAML::Key << "violations" << YAML::Value << r.violations;
+        bool differ = false;
+        for (const sFieldStats& s : r.fields)
+        {
+            differ |= (s.maxAbsError != 0.0);
+        }
+        if (differ)
+        {
+            out << YAML::Key << "fields" << YAML::Value << YAML::BeginMap;
+            for (const sFieldStats& s : r.fields)
+            {
+                if (s.maxAbsError == 0.0)
+                {
+                    continue;
+                }
+                out << YAML::Key << s.name << YAML::Value << YAML::Flow << YAML::BeginMap;
+                out << YAML::Key << "count" << YAML::Value << s.count;
+                out << YAML::Key << "violations" << YAML::Value << s.violations;
+                out << YAML::Key << "maxAbs" << YAML::Value << s.maxAbsError;
+                out << YAML::Key << "meanAbs" << YAML::Value << s.MeanAbsError();
+                out << YAML::Key << "rms" << YAML::Value << s.RmsError();
+                out << YAML::EndMap;
+            }
+            out << YAML::EndMap;
+        }
+        if (r.violations)
+        {
+            const sFailure& f = r.firstFailure;
+            out << YAML::Key << "firstFailure" << YAML::Value << YAML::Flow << YAML::BeginMap;
+            out << YAML::Key << "time" << YAML::Value << f.time;
+            out << YAML::Key << "indexA" << YAML::Value << f.indexA;
+            out << YAML::Key << "indexB" << YAML::Value << f.indexB;
+            out << YAML::Key << "field" << YAML::Value << f.field;
+            out << YAML::Key << "a" << YAML::Value << f.valueA;
+            out << YAML::Key << "b" << YAML::Value << f.valueB;
+            out << YAML::Key << "error" << YAML::Value << f.error;
+            out << YAML::Key << "limit" << YAML::Value << f.limit;
+            out << YAML::EndMap;
+        }
+        out << YAML::EndMap;
+    }
+    out << YAML::EndSeq;
+    out << YAML::EndMap;
+    return out.c_str();
+}
@@ -0,0 +1,129 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef IS_LOG_COMPARE_H
+#define IS_LOG_COMPARE_H
+
+#include <map>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "ISConstants.h"
+#include "ISLogger.h"
+
+/**
+ * Regression comparison of two logs, i.e. a reference log and the same data recorded or replayed with new firmware.
+ * Devices are matched by serial number and records of each DID are paired by timestamp (by order for DIDs without a
+ * timestamp), then compared field by field using the cISDataMappings field metadata.  DIDs are compared in parallel
+ * and the result does not depend on the thread count.
+ */
+class cISLogCompare
+{
+public:
+    struct sTolerance
+    {
+        double abs = 0.0;               // Allowed |a - b| in raw (unconverted) field units
+        double rel = 0.0;               // Additional allowance as a fraction of |a|
+    };
+
+    struct sOptions
+    {
+        double timeTolerance = 0.0005;  // (s) Records with timestamps this close are paired
+        sTolerance tolerance;           // Default for all fields.  Exact match unless set.
+        std::map<std::string, sTolerance> fieldTolerances;      // Keyed "DID_INS_1.theta" or "theta", overrides the default
+        std::vector<uint32_t> dids;     // DIDs to compare.  Empty compares all.
+        int threads = 0;                // Worker threads.  0 uses the hardware concurrency.
+    };
+
+    struct sFieldStats
+    {
+        std::string name;               // Field name, with [index] for array elements
+        uint64_t count = 0;
+        uint64_t violations = 0;
+        double maxAbsError = 0.0;
+        double sumAbsError = 0.0;
+        double sumSqError = 0.0;
+
+        double MeanAbsError() const { return (count ? sumAbsError / count : 0.0); }
+        double RmsError() const { return (count ? sqrt(sumSqError / count) : 0.0); }
+    };
+
+    struct sFailure
+    {
+        double time = 0.0;              // (s) Data timestamp of record A
+        size_t indexA = 0;              // Record index within the DID of each log
+        size_t indexB = 0;
+        std::string field;
+        std::string valueA;
+        std::string valueB;
+        double error = 0.0;
+        double limit = 0.0;
+    };
+
+    struct sDidResult
+    {
+        uint32_t serialA = 0;
+        uint32_t serialB = 0;
+        uint32_t did = 0;
+        size_t countA = 0;
+        size_t countB = 0;
+        size_t paired = 0;
+        uint64_t violations = 0;
+        std::vector<sFieldStats> fields;    // One per field and array element
+        sFailure firstFailure;              // Valid if violations is non-zero
+
+        bool Passed() const { return violations == 0 && paired == countA && paired == countB; }
+    };
+
+    // Full size data sets of one DID (partial data zero filled) and their timestamps, in log order
+    struct sRecords
+    {
+        uint32_t size = 0;
+        std::vector<uint8_t> data;
+        std::vector<double> times;
+
+        size_t Count() const { return times.size(); }
+        const uint8_t* Record(size_t i) const { return &data[i * size]; }
+        void Push(const p_data_hdr_t& hdr, const uint8_t* buf);
+    };
+
+    /** Load two log directories of the same type and compare them.  Returns false if either has no logs. */
+    bool Compare(const std::string& directoryA, const std::string& directoryB, cISLogger::eLogType logType = cISLogger::LOGTYPE_DAT) { return Compare(directoryA, directoryB, logType, sOptions()); }
+    bool Compare(const std::string& directoryA, const std::string& directoryB, cISLogger::eLogType logType, const sOptions& options);
+
+    /** Compare two loaded logs, reading each to the end */
+    void Compare(cISLogger& logA, cISLogger& logB, const sOptions& options);
+
+    /** Pair and compare records of one DID.  serialA/B of result are left as is. */
+    static void CompareDid(uint32_t did, const sRecords& a, const sRecords& b, const sOptions& options, sDidResult& result);
+
+    bool Passed() const;
+    const std::vector<sDidResult>& Results() { return m_results; }
+
+    /** YAML report.  Only fields that differ are listed, each with its error statistics. */
+    std::string ToYaml();
+
+private:
+    typedef std::map<uint32_t, std::map<uint32_t, sRecords>> records_t;    // by serial number, then DID
+
+    static void Load(cISLogger& log, const sOptions& options, records_t& records);
+
+    std::string m_directoryA;
+    std::string m_directoryB;
+    std::vector<uint32_t> m_unmatchedA;     // Serial numbers only in one log
+    std::vector<uint32_t> m_unmatchedB;
+    std::vector<sDidResult> m_results;      // By serial number, then DID
+};
+
+#endif // IS_LOG_COMPARE_H
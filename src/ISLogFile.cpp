@@ -14,7 +14,15 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include "ISConstants.h"
 #include <cstdarg>
 
-cISLogFile::cISLogFile() : m_file(NULLPTR)
+#if PLATFORM_IS_LINUX
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif !PLATFORM_IS_WINDOWS
+#include <unistd.h>
+#endif
+
+cISLogFile::cISLogFile() : m_file(NULLPTR), m_preallocated(false)
 {
 }
 
@@ -35,6 +43,7 @@ cISLogFile::~cISLogFile()
 bool cISLogFile::open(const char* filePath, const char* mode)
 {
     m_file = fopen(filePath, mode);
+    m_preallocated = false;
     return m_file;
 }
 
@@ -42,6 +51,17 @@ bool cISLogFile::close()
 {
     if (m_file)
     {
+#if PLATFORM_IS_LINUX
+        if (m_preallocated)
+        {   // Blocks reserved with FALLOC_FL_KEEP_SIZE stay allocated after close.  Truncating to the data size returns them.
+            struct stat st;
+            fflush(m_file);
+            if (fstat(fileno(m_file), &st) == 0 && ftruncate(fileno(m_file), st.st_size) == 0)
+            {
+                m_preallocated = false;
+            }
+        }
+#endif
         int result = fclose(m_file);
         if (result == 0)
         {
@@ -201,3 +221,33 @@ int cISLogFile::eof()
     }
 }
 
+bool cISLogFile::preallocate(std::size_t len)
+{
+    if (m_file == NULLPTR)
+    {
+        return false;
+    }
+
+#if PLATFORM_IS_LINUX
+    // Reserve blocks but keep the file size at zero so an unfilled file doesn't end in zeros
+    m_preallocated = (fallocate(fileno(m_file), FALLOC_FL_KEEP_SIZE, 0, (off_t)len) == 0);
+    return m_preallocated;
+#else
+    (void)len;
+    return false;
+#endif
+}
+
+bool cISLogFile::sync()
+{
+    if (!flush())
+    {
+        return false;
+    }
+
+#if PLATFORM_IS_WINDOWS
+    return true;
+#else
+    return fsync(fileno(m_file)) == 0;
+#endif
+}
@@ -34,9 +34,12 @@ public:
     int seek(long int offset, int origin = SEEK_CUR) OVERRIDE;
     long int tell() OVERRIDE;
     int eof() OVERRIDE;
+    bool preallocate(std::size_t len) OVERRIDE;
+    bool sync() OVERRIDE;
 
 private:
     FILE *m_file;
+    bool m_preallocated;                    // Blocks past the end of the data are released on close
 };
 
 
@@ -47,6 +47,8 @@ public:
     virtual int seek(long int offset, int origin = SEEK_SET) = 0;   // origin = SEEK_SET means offset is from start of file
     virtual long int tell() = 0;
     virtual int eof() = 0;		// returns non-zero at end of file
+    virtual bool preallocate(std::size_t len) { (void)len; return false; }     // reserve disk space without changing file size, unused space is released on close
+    virtual bool sync() { return flush(); }                                     // flush and commit data to disk
 
 };
 
@@ -0,0 +1,192 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <cstdio>
+
+#include "ISLogFileRotator.h"
+#include "ISLogFileFactory.h"
+
+using namespace std;
+
+// The prepared file has a temporary extension until Take(), so log scanners and catalogs never see an unused file
+static string preparedFileName(const string& fileName)
+{
+    size_t dot = fileName.rfind('.');
+    size_t slash = fileName.find_last_of("/\\");
+    if (dot == string::npos || (slash != string::npos && dot < slash))
+    {
+        dot = fileName.size();
+    }
+    return fileName.substr(0, dot) + ".tmp";
+}
+
+cISLogFileRotator::~cISLogFileRotator()
+{
+    Finish();
+
+    {
+        unique_lock<mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+void cISLogFileRotator::Prepare(const string& fileName, size_t preallocateSize)
+{
+    {
+        unique_lock<mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return m_preparedName.empty() || m_preparedReady; });
+    }
+    DiscardPrepared();
+
+    {
+        unique_lock<mutex> lock(m_mutex);
+        m_preparedName = fileName;
+        m_preparedReady = false;
+    }
+
+    Post([this, fileName, preallocateSize]()
+    {
+        cISLogFileBase* file = CreateISLogFile(preparedFileName(fileName), "wb");
+        if (!file->isOpened())
+        {
+            CloseISLogFile(file);
+        }
+        else if (preallocateSize)
+        {
+            file->preallocate(preallocateSize);
+        }
+
+        unique_lock<mutex> lock(m_mutex);
+        m_prepared = file;
+        m_preparedReady = true;
+    });
+}
+
+cISLogFileBase* cISLogFileRotator::Take(const string& fileName)
+{
+    unique_lock<mutex> lock(m_mutex);
+    if (m_preparedName != fileName)
+    {
+        return NULLPTR;
+    }
+
+    // Opening the same name here while the background open runs would truncate each other
+    m_cv.wait(lock, [this] { return m_preparedReady; });
+
+    cISLogFileBase* file = m_prepared;
+    m_prepared = NULLPTR;
+    m_preparedName.clear();
+    m_preparedReady = false;
+    lock.unlock();
+
+    if (file != NULLPTR && rename(preparedFileName(fileName).c_str(), fileName.c_str()) != 0)
+    {   // i.e. Windows doesn't rename open files
+        CloseISLogFile(file);
+        remove(preparedFileName(fileName).c_str());
+        return NULLPTR;
+    }
+    return file;
+}
+
+void cISLogFileRotator::Retire(cISLogFileBase* file)
+{
+    if (file == NULLPTR)
+    {
+        return;
+    }
+
+    Post([file]()
+    {
+        cISLogFileBase* f = file;
+        f->sync();
+        CloseISLogFile(f);
+    });
+}
+
+void cISLogFileRotator::Finish()
+{
+    {
+        unique_lock<mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return m_busy == 0; });
+    }
+    DiscardPrepared();
+}
+
+void cISLogFileRotator::DiscardPrepared()
+{
+    cISLogFileBase* file;
+    string fileName;
+    {
+        unique_lock<mutex> lock(m_mutex);
+        if (!m_preparedReady)
+        {
+            return;
+        }
+        file = m_prepared;
+        fileName = m_preparedName;
+        m_prepared = NULLPTR;
+        m_preparedName.clear();
+        m_preparedReady = false;
+    }
+
+    if (file != NULLPTR)
+    {
+        CloseISLogFile(file);
+        remove(preparedFileName(fileName).c_str());
+    }
+}
+
+void cISLogFileRotator::Post(const function<void()>& job)
+{
+#if PLATFORM_IS_EVB_2
+    job();
+    m_cv.notify_all();
+#else
+    {
+        unique_lock<mutex> lock(m_mutex);
+        m_jobs.push_back(job);
+        m_busy++;
+        if (!m_thread.joinable())
+        {
+            m_thread = thread(&cISLogFileRotator::Run, this);
+        }
+    }
+    m_cv.notify_all();
+#endif
+}
+
+void cISLogFileRotator::Run()
+{
+    unique_lock<mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cv.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+        if (m_jobs.empty())
+        {   // Stopped
+            return;
+        }
+
+        function<void()> job = m_jobs.front();
+        m_jobs.pop_front();
+        lock.unlock();
+        job();
+        lock.lock();
+        m_busy--;
+        m_cv.notify_all();
+    }
+}
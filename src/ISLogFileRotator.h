@@ -0,0 +1,72 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef IS_LOG_FILE_ROTATOR_H
+#define IS_LOG_FILE_ROTATOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "ISLogFileBase.h"
+
+/**
+ * Moves log file open and close off the write path.  The next file is created and preallocated on a background thread
+ * while the current file is written, and the previous file is flushed, synced and closed in the background after
+ * rotation.  Rotating is then a pointer swap: Retire(current) and Take(next).
+ */
+class cISLogFileRotator
+{
+public:
+    ~cISLogFileRotator();
+
+    /**
+     * Create and preallocate fileName in the background for a later Take().  Replaces any unused prepared file.  The file
+     * has a .tmp extension until it is taken, so directory scans and log catalogs don't see it.
+     */
+    void Prepare(const std::string& fileName, std::size_t preallocateSize);
+
+    /**
+     * @return the prepared file, renamed to fileName, if it matches fileName, otherwise NULLPTR and the caller opens the
+     * file itself.
+     * Only waits if the prepare for fileName is still in progress.
+     */
+    cISLogFileBase* Take(const std::string& fileName);
+
+    /** Flush, sync, close and delete file in the background.  Closing releases the unused preallocated space. */
+    void Retire(cISLogFileBase* file);
+
+    /** Wait for all background work and delete any prepared file that was not used */
+    void Finish();
+
+private:
+    void Post(const std::function<void()>& job);
+    void Run();
+    void DiscardPrepared();
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::function<void()>> m_jobs;
+    int m_busy = 0;                         // Jobs queued or running
+    bool m_stop = false;
+
+    std::string m_preparedName;
+    cISLogFileBase* m_prepared = NULLPTR;
+    bool m_preparedReady = false;
+};
+
+#endif // IS_LOG_FILE_ROTATOR_H
@@ -0,0 +1,289 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <cstdlib>
+
+#include "ISLogFilter.h"
+#include "ISDataMappings.h"
+#include "yaml-cpp/yaml.h"
+
+using namespace std;
+
+static uint64_t fnv1a(uint64_t hash, const uint8_t* data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ data[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static bool parseRule(const YAML::Node& node, cISLogFilter::sRule& rule)
+{
+    if (!node.IsMap())
+    {
+        return false;
+    }
+    rule = cISLogFilter::sRule();
+    for (const auto& kv : node)
+    {
+        string key = kv.first.as<string>();
+        if      (key == "every")        { rule.every = kv.second.as<uint32_t>(); }
+        else if (key == "period_ms")    { rule.periodMs = kv.second.as<uint32_t>(); }
+        else if (key == "on_change")    { rule.onChange = kv.second.as<bool>(); }
+        else                            { return false; }
+    }
+    return true;
+}
+
+bool cISLogFilter::Load(const string& filename)
+{
+    try
+    {
+        return Load(YAML::LoadFile(filename));
+    }
+    catch (YAML::Exception& e)
+    {
+        Clear();
+        return false;
+    }
+}
+
+bool cISLogFilter::Load(const YAML::Node& yaml)
+{
+    Clear();
+    if (yaml.IsNull())
+    {   // Empty file, keep everything
+        return true;
+    }
+    if (!yaml.IsMap())
+    {
+        return false;
+    }
+
+    try
+    {
+        for (const auto& device : yaml)
+        {
+            string name = device.first.as<string>();
+            uint32_t serialNo = ALL_DEVICES;
+            if (name != "all")
+            {
+                char* end;
+                serialNo = strtoul(name.c_str() + (name.rfind("SN", 0) == 0 ? 2 : 0), &end, 10);
+                if (*end != '\0' || serialNo == ALL_DEVICES)
+                {
+                    Clear();
+                    return false;
+                }
+            }
+
+            if (!device.second.IsMap())
+            {
+                Clear();
+                return false;
+            }
+            for (const auto& kv : device.second)
+            {
+                uint32_t did = cISDataMappings::Did(kv.first.as<string>());
+                sRule rule;
+                if (did == DID_NULL || did >= DID_COUNT || !parseRule(kv.second, rule))
+                {
+                    Clear();
+                    return false;
+                }
+                SetRule(serialNo, did, rule);
+            }
+        }
+    }
+    catch (YAML::Exception& e)
+    {
+        Clear();
+        return false;
+    }
+
+    return true;
+}
+
+void cISLogFilter::Apply(sDevice& dev, uint32_t did, const sRule& rule, bool deviceRule)
+{
+    sState& state = dev.did[did];
+    if (state.hasRule && !deviceRule)
+    {   // Device specific rule takes precedence
+        return;
+    }
+    state.rule = rule;
+    state.hasRule = deviceRule;
+    state.count = 0;
+    state.kept = false;
+}
+
+void cISLogFilter::SetRule(uint32_t serialNo, uint32_t did, const sRule& rule)
+{
+    if (did >= DID_COUNT)
+    {
+        return;
+    }
+
+    if (serialNo == ALL_DEVICES)
+    {
+        m_defaultRules[did] = rule;
+        for (auto& it : m_devices)
+        {
+            Apply(*it.second, did, rule, false);
+        }
+    }
+    else
+    {
+        m_deviceRules[serialNo][did] = rule;
+        auto it = m_devices.find(serialNo);
+        if (it != m_devices.end())
+        {
+            Apply(*it->second, did, rule, true);
+        }
+    }
+
+    m_enabled |= !rule.KeepAll();
+}
+
+void cISLogFilter::Clear()
+{
+    m_enabled = false;
+    for (sRule& rule : m_defaultRules)
+    {
+        rule = sRule();
+    }
+    m_deviceRules.clear();
+    m_devices.clear();
+}
+
+cISLogFilter::sDevice& cISLogFilter::Device(uint32_t serialNo)
+{
+    unique_ptr<sDevice>& dev = m_devices[serialNo];
+    if (dev == nullptr)
+    {   // Resolve rules once so each packet is a table lookup
+        dev.reset(new sDevice());
+        is_comm_init(&dev->comm, dev->commBuf, sizeof(dev->commBuf));
+        for (uint32_t did = 0; did < DID_COUNT; did++)
+        {
+            dev->did[did].rule = m_defaultRules[did];
+        }
+        auto it = m_deviceRules.find(serialNo);
+        if (it != m_deviceRules.end())
+        {
+            for (auto& rule : it->second)
+            {
+                Apply(*dev, rule.first, rule.second, true);
+            }
+        }
+    }
+    return *dev;
+}
+
+bool cISLogFilter::Keep(uint32_t serialNo, const p_data_hdr_t* dataHdr, const uint8_t* dataBuf, uint32_t timeMs)
+{
+    if (!m_enabled || dataHdr->id >= DID_COUNT)
+    {
+        return true;
+    }
+
+    sState& state = Device(serialNo).did[dataHdr->id];
+    const sRule& rule = state.rule;
+    bool keep = true;
+    uint64_t hash = 0;
+
+    if (rule.every != 1)
+    {
+        keep = (rule.every != 0 && state.count % rule.every == 0);
+        state.count++;
+    }
+    if (keep && rule.periodMs && state.kept)
+    {
+        keep = (timeMs - state.lastTimeMs >= rule.periodMs);
+    }
+    if (keep && rule.onChange)
+    {
+        hash = fnv1a(0xcbf29ce484222325ULL, (const uint8_t*)&dataHdr->offset, sizeof(dataHdr->offset));
+        hash = fnv1a(hash, dataBuf, dataHdr->size);
+        keep = (!state.kept || hash != state.lastHash);
+    }
+
+    if (keep)
+    {
+        state.kept = true;
+        state.lastTimeMs = timeMs;
+        state.lastHash = hash;
+        state.stats.kept++;
+    }
+    else
+    {
+        state.stats.dropped++;
+    }
+    return keep;
+}
+
+void cISLogFilter::Filter(uint32_t serialNo, const uint8_t* data, int size, uint32_t timeMs, const pfnWrite& write)
+{
+    if (!m_enabled)
+    {
+        write(data, size);
+        return;
+    }
+
+    is_comm_instance_t& comm = Device(serialNo).comm;
+    for (const uint8_t* ptr = data; ptr < data + size; ptr++)
+    {
+        protocol_type_t ptype = is_comm_parse_byte(&comm, *ptr);
+        switch (ptype)
+        {
+        case _PTYPE_NONE:
+        case _PTYPE_PARSE_ERROR:
+            break;
+
+        case _PTYPE_INERTIAL_SENSE_DATA:
+            if (!Keep(serialNo, &comm.rxPkt.dataHdr, comm.rxPkt.data.ptr, timeMs))
+            {
+                break;
+            }
+            // fall through
+        default:
+            // Packet ends at the parser head
+            write(comm.rxBuf.head - comm.rxPkt.size, (int)comm.rxPkt.size);
+            break;
+        }
+    }
+}
+
+cISLogFilter::sStats cISLogFilter::Stats(uint32_t serialNo, uint32_t did)
+{
+    auto it = m_devices.find(serialNo);
+    if (it == m_devices.end() || did >= DID_COUNT)
+    {
+        return sStats();
+    }
+    return it->second->did[did].stats;
+}
+
+cISLogFilter::sStats cISLogFilter::TotalStats()
+{
+    sStats total = {};
+    for (auto& it : m_devices)
+    {
+        for (const sState& state : it.second->did)
+        {
+            total.kept += state.stats.kept;
+            total.dropped += state.stats.dropped;
+        }
+    }
+    return total;
+}
@@ -0,0 +1,119 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef IS_LOG_FILTER_H
+#define IS_LOG_FILTER_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "ISConstants.h"
+#include "ISComm.h"
+#include "data_sets.h"
+
+namespace YAML { class Node; }
+
+/**
+ * Per DID, per device decimation of logged data, so devices can stream at full rate to live consumers while the log
+ * only receives what analysis needs.  Rules are looked up by DID in a per device table, so evaluating a packet is O(1).
+ *
+ * YAML format, with DIDs by name or number and devices by serial number ("all" applies to every device):
+ *
+ *     all:
+ *       DID_INS_1: { every: 10 }           # Keep every 10th packet
+ *       DID_GPS1_POS: { period_ms: 1000 }  # Keep at most one packet per second
+ *       DID_SYS_PARAMS: { on_change: true } # Keep only packets whose payload changed
+ *       DID_PIMU: { every: 0 }             # Drop all
+ *     123456:
+ *       DID_INS_1: { every: 1 }            # Full rate for this device
+ *
+ * Conditions in one rule are combined, all must pass for a packet to be kept.
+ */
+class cISLogFilter
+{
+public:
+    struct sRule
+    {
+        uint32_t every;             // Keep every Nth packet.  1 keeps all, 0 drops all.
+        uint32_t periodMs;          // Minimum time between kept packets.  0 disables.
+        bool onChange;              // Keep only packets whose data differs from the last kept packet
+
+        sRule(uint32_t every_ = 1, uint32_t periodMs_ = 0, bool onChange_ = false) : every(every_), periodMs(periodMs_), onChange(onChange_) {}
+        bool KeepAll() const { return every == 1 && periodMs == 0 && !onChange; }
+    };
+
+    struct sStats
+    {
+        uint64_t kept;
+        uint64_t dropped;
+    };
+
+    typedef std::function<void(const uint8_t* data, int size)> pfnWrite;
+
+    static const uint32_t ALL_DEVICES = 0;
+
+    /** Load rules from a YAML file, replacing existing rules.  @return false on file or format error */
+    bool Load(const std::string& filename);
+    bool Load(const YAML::Node& yaml);
+
+    /** Set the rule for one DID on one device, or on all devices that don't have their own rule */
+    void SetRule(uint32_t serialNo, uint32_t did, const sRule& rule);
+    void Clear();
+
+    /** @return true if any rule can drop data */
+    bool Enabled() { return m_enabled; }
+
+    /** @return true if the packet should be logged */
+    bool Keep(uint32_t serialNo, const p_data_hdr_t* dataHdr, const uint8_t* dataBuf, uint32_t timeMs);
+
+    /**
+     * Filter a raw byte stream.  Each complete packet that is kept is passed to write.  Packets other than ISB data
+     * are always kept, bytes that don't parse into a packet are dropped.
+     */
+    void Filter(uint32_t serialNo, const uint8_t* data, int size, uint32_t timeMs, const pfnWrite& write);
+
+    sStats Stats(uint32_t serialNo, uint32_t did);
+    sStats TotalStats();
+
+private:
+    struct sState
+    {
+        sRule rule;
+        bool hasRule = false;       // Device specific rule, not replaced by ALL_DEVICES rules
+        uint32_t count = 0;
+        uint32_t lastTimeMs = 0;
+        uint64_t lastHash = 0;
+        bool kept = false;          // lastTimeMs and lastHash are valid
+        sStats stats = {};
+    };
+
+    struct sDevice
+    {
+        sState did[DID_COUNT];
+        uint8_t commBuf[PKT_BUF_SIZE];
+        is_comm_instance_t comm;
+    };
+
+    sDevice& Device(uint32_t serialNo);
+    void Apply(sDevice& dev, uint32_t did, const sRule& rule, bool deviceRule);
+
+    bool m_enabled = false;
+    sRule m_defaultRules[DID_COUNT];
+    std::map<uint32_t, std::map<uint32_t, sRule>> m_deviceRules;
+    std::unordered_map<uint32_t, std::unique_ptr<sDevice>> m_devices;
+};
+
+#endif // IS_LOG_FILTER_H
@@ -0,0 +1,330 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "ISLogInventory.h"
+#include "ISLogger.h"
+#include "ISDataMappings.h"
+#include "ISFileManager.h"
+#include "ISLogFileFactory.h"
+#include "DataChunk.h"
+#include "yaml-cpp/yaml.h"
+
+using namespace std;
+
+void cISLogInventory::AddPacket(sDeviceSummary& summary, const p_data_hdr_t& hdr, const uint8_t* data, double gapSec)
+{
+    summary.packets++;
+    sDidSummary& did = summary.dids[hdr.id];
+    did.count++;
+    did.bytes += hdr.size;
+
+    double time = cISDataMappings::Timestamp(&hdr, data);
+    if (time == 0.0)
+    {
+        return;
+    }
+    if (did.firstTime == 0.0)
+    {
+        did.firstTime = time;
+    }
+    else
+    {   // Time going backwards (i.e. week rollover) is not a gap
+        double dt = time - did.lastTime;
+        if (dt > gapSec)
+        {
+            did.gaps++;
+        }
+        did.maxGap = _MAX(did.maxGap, dt);
+    }
+    did.lastTime = time;
+}
+
+bool cISLogInventory::ScanDat(cISLogFileBase* file, const sOptions& options, sDeviceSummary& summary)
+{
+    // One read per chunk, then walk record headers in place
+    vector<uint8_t> buf(DEFAULT_CHUNK_DATA_SIZE);
+    vector<uint8_t> decoded;
+    sChunkHeader hdr;
+    while (file->read(&hdr, sizeof(hdr)) == sizeof(hdr))
+    {
+        if (hdr.marker != DATA_CHUNK_MARKER || hdr.dataSize != ~hdr.invDataSize)
+        {
+            summary.errors++;
+            return false;
+        }
+        if (summary.serialNo == 0)
+        {
+            summary.serialNo = hdr.devSerialNum;
+        }
+        if (hdr.dataSize > buf.size())
+        {
+            buf.resize(hdr.dataSize);
+        }
+        if (file->read(buf.data(), hdr.dataSize) != hdr.dataSize)
+        {
+            summary.errors++;
+            return false;
+        }
+        if (memcmp(hdr.name, DATA_CHUNK_NAME_DELTA, 4) == 0)
+        {
+            decoded.resize(DEFAULT_CHUNK_DATA_SIZE);
+            int32_t size = cDataChunk::DeltaDecode(buf.data(), hdr.dataSize, decoded.data(), (int32_t)decoded.size());
+            if (size < 0)
+            {
+                summary.errors++;
+                continue;
+            }
+            buf.swap(decoded);
+            hdr.dataSize = size;
+        }
+
+        for (uint32_t pos = 0; pos + sizeof(p_data_hdr_t) <= hdr.dataSize; )
+        {
+            const p_data_hdr_t* dataHdr = (const p_data_hdr_t*)&buf[pos];
+            pos += sizeof(p_data_hdr_t);
+            if (cISLogger::isHeaderCorrupt(dataHdr) || pos + dataHdr->size > hdr.dataSize)
+            {   // Skip remainder of chunk
+                summary.errors++;
+                break;
+            }
+            AddPacket(summary, *dataHdr, &buf[pos], options.gapSec);
+            pos += dataHdr->size;
+        }
+    }
+    return true;
+}
+
+bool cISLogInventory::ScanRaw(cISLogFileBase* file, const sOptions& options, sDeviceSummary& summary)
+{
+    // Walk ISB headers in large blocks.  Partial packets at the end of a block are moved to the front.
+    vector<uint8_t> buf(LOG_INVENTORY_READ_SIZE + PKT_BUF_SIZE);
+    size_t size = 0;
+    size_t n;
+    while ((n = file->read(buf.data() + size, LOG_INVENTORY_READ_SIZE)) > 0)
+    {
+        size += n;
+        size_t pos = 0;
+        while (pos + sizeof(packet_hdr_t) <= size)
+        {
+            const uint8_t* ptr = &buf[pos];
+            if (ptr[0] != PSC_ISB_PREAMBLE_BYTE1 || ptr[1] != PSC_ISB_PREAMBLE_BYTE2)
+            {
+                pos++;
+                summary.otherBytes++;
+                continue;
+            }
+
+            const packet_hdr_t* pktHdr = (const packet_hdr_t*)ptr;
+            size_t pktSize = sizeof(packet_hdr_t) + pktHdr->payloadSize + 2;
+            if (pktSize > PKT_BUF_SIZE)
+            {
+                pos++;
+                summary.otherBytes++;
+                continue;
+            }
+            if (pos + pktSize > size)
+            {   // Need more data
+                break;
+            }
+
+            // Checksum rejects preambles found inside other data
+            uint16_t cksum = (uint16_t)(ptr[pktSize - 2] | (ptr[pktSize - 1] << 8));
+            if (cksum != is_comm_isb_checksum16(0, ptr, (int)pktSize - 2))
+            {
+                pos++;
+                summary.otherBytes++;
+                continue;
+            }
+
+            uint8_t ptype = pktHdr->flags & PKT_TYPE_MASK;
+            if (ptype == PKT_TYPE_DATA || ptype == PKT_TYPE_SET_DATA)
+            {
+                p_data_hdr_t dataHdr;
+                const uint8_t* data = ptr + sizeof(packet_hdr_t);
+                dataHdr.id = pktHdr->id;
+                dataHdr.size = pktHdr->payloadSize;
+                dataHdr.offset = 0;
+                if ((pktHdr->flags & ISB_FLAGS_PAYLOAD_W_OFFSET) && dataHdr.size >= 2)
+                {
+                    dataHdr.offset = (uint16_t)(data[0] | (data[1] << 8));
+                    dataHdr.size -= 2;
+                    data += 2;
+                }
+                AddPacket(summary, dataHdr, data, options.gapSec);
+            }
+            else
+            {
+                summary.otherBytes += pktSize;
+            }
+            pos += pktSize;
+        }
+
+        memmove(buf.data(), buf.data() + pos, size - pos);
+        size -= pos;
+    }
+    summary.otherBytes += size;
+    return true;
+}
+
+bool cISLogInventory::ScanFile(const string& filename, const sOptions& options, sDeviceSummary& summary)
+{
+    int serialNo, index;
+    string date, time;
+    if (cISLogger::ParseFilename(ISFileManager::GetFileName(filename), serialNo, date, time, index) && serialNo > 0)
+    {
+        summary.serialNo = serialNo;
+    }
+
+    cISLogFileBase* file = CreateISLogFile(filename, "rb");
+    if (file == NULLPTR || !file->isOpened())
+    {
+        CloseISLogFile(file);
+        return false;
+    }
+
+    bool raw = (filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".raw") == 0);
+    bool ok = (raw ? ScanRaw(file, options, summary) : ScanDat(file, options, summary));
+    summary.fileCount++;
+    summary.fileBytes += file->tell();
+    CloseISLogFile(file);
+    return ok;
+}
+
+void cISLogInventory::Merge(sDeviceSummary& a, const sDeviceSummary& b, double gapSec)
+{
+    if (a.serialNo == 0)
+    {
+        a.serialNo = b.serialNo;
+    }
+    a.fileCount += b.fileCount;
+    a.fileBytes += b.fileBytes;
+    a.packets += b.packets;
+    a.otherBytes += b.otherBytes;
+    a.errors += b.errors;
+
+    for (auto& it : b.dids)
+    {
+        sDidSummary& da = a.dids[it.first];
+        const sDidSummary& db = it.second;
+        if (da.firstTime == 0.0)
+        {
+            da.firstTime = db.firstTime;
+        }
+        else if (db.firstTime != 0.0)
+        {   // Gap across the file boundary
+            double dt = db.firstTime - da.lastTime;
+            if (dt > gapSec)
+            {
+                da.gaps++;
+            }
+            da.maxGap = _MAX(da.maxGap, dt);
+        }
+        if (db.lastTime != 0.0)
+        {
+            da.lastTime = db.lastTime;
+        }
+        da.count += db.count;
+        da.bytes += db.bytes;
+        da.gaps += db.gaps;
+        da.maxGap = _MAX(da.maxGap, db.maxGap);
+    }
+}
+
+bool cISLogInventory::Scan(const string& directory, const sOptions& options)
+{
+    m_directory = directory;
+    m_devices.clear();
+
+    // Sorted by name, so files of each device are in index order
+    vector<ISFileManager::file_info_t> files;
+    ISFileManager::GetDirectorySpaceUsed(directory, "\\.(dat|raw)$", files, false, false);
+    if (files.empty())
+    {
+        return false;
+    }
+    sort(files.begin(), files.end(), [](const ISFileManager::file_info_t& a, const ISFileManager::file_info_t& b) { return a.name < b.name; });
+
+    // Each worker takes the next unscanned file
+    vector<sDeviceSummary> results(files.size());
+    atomic<size_t> next(0);
+    auto worker = [&]()
+    {
+        for (size_t i; (i = next++) < files.size(); )
+        {
+            ScanFile(files[i].name, options, results[i]);
+        }
+    };
+    int threadCount = (options.threads > 0 ? options.threads : (int)thread::hardware_concurrency());
+    threadCount = _CLAMP(threadCount, 1, (int)files.size());
+    vector<thread> threads;
+    for (int i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (thread& t : threads)
+    {
+        t.join();
+    }
+
+    for (sDeviceSummary& result : results)
+    {
+        Merge(m_devices[result.serialNo], result, options.gapSec);
+    }
+    return true;
+}
+
+string cISLogInventory::ToYaml()
+{
+    YAML::Emitter out;
+    out << YAML::BeginMap;
+    out << YAML::Key << "directory" << YAML::Value << m_directory;
+    out << YAML::Key << "devices" << YAML::Value << YAML::BeginSeq;
+    for (auto& it : m_devices)
+    {
+        const sDeviceSummary& dev = it.second;
+        out << YAML::BeginMap;
+        out << YAML::Key << "serial" << YAML::Value << dev.serialNo;
+        out << YAML::Key << "files" << YAML::Value << dev.fileCount;
+        out << YAML::Key << "bytes" << YAML::Value << dev.fileBytes;
+        out << YAML::Key << "packets" << YAML::Value << dev.packets;
+        out << YAML::Key << "otherBytes" << YAML::Value << dev.otherBytes;
+        out << YAML::Key << "errors" << YAML::Value << dev.errors;
+        out << YAML::Key << "dids" << YAML::Value << YAML::BeginMap;
+        for (auto& did : dev.dids)
+        {
+            const sDidSummary& d = did.second;
+            const char* name = cISDataMappings::DataName(did.first);
+            out << YAML::Key << (name ? string(name) : to_string(did.first)) << YAML::Value << YAML::Flow << YAML::BeginMap;
+            out << YAML::Key << "count" << YAML::Value << d.count;
+            out << YAML::Key << "bytes" << YAML::Value << d.bytes;
+            if (d.firstTime != 0.0)
+            {
+                out << YAML::Key << "first" << YAML::Value << d.firstTime;
+                out << YAML::Key << "last" << YAML::Value << d.lastTime;
+                out << YAML::Key << "gaps" << YAML::Value << d.gaps;
+                out << YAML::Key << "maxGap" << YAML::Value << d.maxGap;
+            }
+            out << YAML::EndMap;
+        }
+        out << YAML::EndMap;
+        out << YAML::EndMap;
+    }
+    out << YAML::EndSeq;
+    out << YAML::EndMap;
+    return out.c_str();
+}
@@ -0,0 +1,85 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef IS_LOG_INVENTORY_H
+#define IS_LOG_INVENTORY_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ISConstants.h"
+#include "ISComm.h"
+#include "ISLogFileBase.h"
+
+#define LOG_INVENTORY_READ_SIZE     (256 * 1024)    // RAW file read block size
+
+/**
+ * Summary of a log directory (devices, DIDs, packet counts, time span and gaps) built from chunk and ISB packet
+ * headers only.  Payloads are never copied or decoded, apart from the timestamp field of each packet.  Files are
+ * scanned in parallel and the result does not depend on the thread count.
+ */
+class cISLogInventory
+{
+public:
+    struct sOptions
+    {
+        double gapSec = 1.0;            // Time between consecutive packets of one DID counted as a gap
+        int threads = 0;                // Worker threads.  0 uses the hardware concurrency.
+    };
+
+    struct sDidSummary
+    {
+        uint64_t count = 0;
+        uint64_t bytes = 0;             // Data bytes, excluding headers
+        double firstTime = 0;           // (s) First and last non-zero data timestamp
+        double lastTime = 0;
+        uint32_t gaps = 0;
+        double maxGap = 0;              // (s)
+    };
+
+    struct sDeviceSummary
+    {
+        uint32_t serialNo = 0;
+        uint32_t fileCount = 0;
+        uint64_t fileBytes = 0;
+        uint64_t packets = 0;           // ISB data packets
+        uint64_t otherBytes = 0;        // RAW bytes not in ISB data packets (NMEA, UBX, RTCM, ...)
+        uint32_t errors = 0;            // Corrupt chunks or records
+        std::map<uint32_t, sDidSummary> dids;
+    };
+
+    bool Scan(const std::string& directory) { return Scan(directory, sOptions()); }
+    bool Scan(const std::string& directory, const sOptions& options);
+
+    /** Scan one DAT or RAW file, chosen by extension */
+    static bool ScanFile(const std::string& filename, const sOptions& options, sDeviceSummary& summary);
+
+    /** Append b, which follows a in time, to a */
+    static void Merge(sDeviceSummary& a, const sDeviceSummary& b, double gapSec);
+
+    const std::map<uint32_t, sDeviceSummary>& Devices() { return m_devices; }
+
+    /** Compact YAML summary, one flow style line per DID */
+    std::string ToYaml();
+
+private:
+    static void AddPacket(sDeviceSummary& summary, const p_data_hdr_t& hdr, const uint8_t* data, double gapSec);
+    static bool ScanDat(cISLogFileBase* file, const sOptions& options, sDeviceSummary& summary);
+    static bool ScanRaw(cISLogFileBase* file, const sOptions& options, sDeviceSummary& summary);
+
+    std::string m_directory;
+    std::map<uint32_t, sDeviceSummary> m_devices;
+};
+
+#endif // IS_LOG_INVENTORY_H
@@ -96,7 +96,7 @@ cLogStats::cLogStats()
 
 void cLogStats::Clear()
 {
-    for (std::map<protocol_type_t, sLogStatPType>::iterator it = msgs.begin(); it != msgs.end(); ++it)
+    for (log_stat_ptype_map_t::iterator it = msgs.begin(); it != msgs.end(); ++it)
     {
 //        protocol_type_t ptype = it->first;
         sLogStatPType& msg = it->second;
@@ -117,16 +117,39 @@ void cLogStats::LogError(const p_data_hdr_t* hdr, protocol_type_t ptype)
     msg.errors++;
     if (hdr != NULL && hdr->id < DID_COUNT)
     {
-        cLogStatMsgId& d = msg.stats[hdr->id];
-        d.errors++;
+        cLogStatMsgId* d = MsgId(msg, hdr->id);
+        if (d)
+        {
+            d->errors++;
+        }
+    }
+}
+
+cLogStatMsgId* cLogStats::MsgId(sLogStatPType &msg, int id)
+{
+    log_stat_msg_map_t::iterator it = msg.stats.find(id);
+    if (it != msg.stats.end())
+    {
+        return &it->second;
+    }
+    if (!cISMemory::Available(cISMemory::LOG_STATS, cISMemory::NodeBytes<log_stat_msg_map_t>()))
+    {
+        cISMemory::Shed(cISMemory::LOG_STATS);
+        return NULL;
     }
+    return &msg.stats[id];
 }
 
 void cLogStats::LogData(protocol_type_t ptype, int id, int bytes, double timestamp)
 {
     sLogStatPType &msg = msgs[ptype];
-    cLogStatMsgId &d = msg.stats[id];
     msg.count++;
+    cLogStatMsgId* pd = MsgId(msg, id);
+    if (pd == NULL)
+    {
+        return;
+    }
+    cLogStatMsgId &d = *pd;
     d.count++;
 
     unsigned int timeMs = (unsigned int)(timestamp*1000.0);
@@ -162,7 +185,7 @@ string cLogStats::MessageStats(protocol_type_t ptype, sLogStatPType &msg, bool s
     if (showDeltaTime)  { ss << "  dtMs(avg  min  max)   Bps Irreg"; }
     ss << endl;
 
-    for (std::map<int, cLogStatMsgId>::iterator it = msg.stats.begin(); it != msg.stats.end(); ++it)
+    for (log_stat_msg_map_t::iterator it = msg.stats.begin(); it != msg.stats.end(); ++it)
     {
         int id = it->first;
         cLogStatMsgId& stat = it->second;
@@ -223,7 +246,7 @@ string cLogStats::MessageStats(protocol_type_t ptype, sLogStatPType &msg, bool s
 unsigned int cLogStats::Count()
 {
     unsigned int count = 0;
-    for (std::map<protocol_type_t, sLogStatPType>::iterator it = msgs.begin(); it != msgs.end(); ++it) 
+    for (log_stat_ptype_map_t::iterator it = msgs.begin(); it != msgs.end(); ++it) 
     {
         count += it->second.count;
     }
@@ -233,7 +256,7 @@ unsigned int cLogStats::Count()
 unsigned int cLogStats::Errors()
 {
     unsigned int errors = 0;
-    for (std::map<protocol_type_t, sLogStatPType>::iterator it = msgs.begin(); it != msgs.end(); ++it) 
+    for (log_stat_ptype_map_t::iterator it = msgs.begin(); it != msgs.end(); ++it) 
     {
         errors += it->second.errors;
     }    
@@ -245,7 +268,7 @@ string cLogStats::Stats()
     std::stringstream ss;
     unsigned int count = Count();
     ss << "Total: count " << count << endl;
-    for (std::map<protocol_type_t, sLogStatPType>::iterator it = msgs.begin(); it != msgs.end(); ++it)
+    for (log_stat_ptype_map_t::iterator it = msgs.begin(); it != msgs.end(); ++it)
     {
         protocol_type_t ptype = it->first;
         sLogStatPType& msg = it->second;
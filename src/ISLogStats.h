@@ -19,6 +19,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include "data_sets.h"
 #include "ISComm.h"
+#include "ISMemory.h"
 
 
 typedef void (*FuncLogDataAndTimestamp)(uint32_t dataId, double timeMs);
@@ -46,17 +47,21 @@ public:
 	void LogByteSize(unsigned int timeMs, int bytes);
 };
 
+typedef is_counted_map<int, cLogStatMsgId, cISMemory::LOG_STATS> log_stat_msg_map_t;
+
 struct sLogStatPType
 {
-	std::map<int, cLogStatMsgId> stats;     // ID, cLogStatMsgId
+	log_stat_msg_map_t stats;               // ID, cLogStatMsgId.  Ids beyond the cISMemory::LOG_STATS cap are only counted in the totals below.
 	unsigned int count;                     // count of all message ids
 	unsigned int errors;                    // total error count
 };
 
+typedef is_counted_map<protocol_type_t, sLogStatPType, cISMemory::LOG_STATS> log_stat_ptype_map_t;
+
 class cLogStats
 {
 public:
-	std::map<protocol_type_t, sLogStatPType> msgs;
+	log_stat_ptype_map_t msgs;
 	cISLogFileBase* statsFile;
 
 	cLogStats();
@@ -68,6 +73,9 @@ public:
 	std::string MessageStats(protocol_type_t ptype, sLogStatPType &msg, bool showDeltaTime=true, bool showErrors=false);
 	std::string Stats();
 	void WriteToFile(const std::string& fileName);
+
+private:
+	cLogStatMsgId* MsgId(sLogStatPType &msg, int id);
 };
 
 
@@ -126,6 +126,7 @@ cISLogger::~cISLogger()
 void cISLogger::Cleanup()
 {
     LOCK_MUTEX();
+    m_blackBoxes.clear();
     m_devices.clear();
     m_logStats.Clear();
     UNLOCK_MUTEX();
@@ -135,6 +136,8 @@ void cISLogger::Update()
 {
     time_t timeSec = GetTime();
 
+    StepBlackBoxTrigger();
+
     if (m_lastCommTime == 0)
     {
         m_lastCommTime = timeSec;
@@ -214,6 +217,17 @@ bool cISLogger::InitSave(const string &directory, const sSaveOptions &options)
     }
 
     m_maxFileSize = _MIN(m_maxFileSize, options.maxFileSize);
+    m_rotatePeriodSec = options.rotatePeriodSec;
+    m_rotateGpsTime = options.rotateGpsTime;
+    m_deltaEncoding = options.deltaEncoding;
+
+    // Decimation rules
+    m_filter.Clear();
+    if (!options.filterFile.empty() && !m_filter.Load(options.filterFile))
+    {
+        printf("Failed to load log filter: %s\n", options.filterFile.c_str());
+        return false;
+    }
 
     // create root dir
     _MKDIR(m_rootDirectory.c_str());
@@ -237,11 +251,48 @@ bool cISLogger::InitSave(const string &directory, const sSaveOptions &options)
     cISLogFileBase *statsFile = CreateISLogFile(str, "w");
     CloseISLogFile(statsFile);
 
+    InitCatalog();
+
     // Initialize devices
     // return InitDevicesForWriting(numDevices); // Lazy Initialize of devices (when they are explicitly added)
     return ISFileManager::PathIsDir(m_directory);
 }
 
+static string catalogExtension(cISLogger::eLogType logType)
+{
+    switch (logType)
+    {
+    case cISLogger::LOGTYPE_DAT: return ".dat";
+    case cISLogger::LOGTYPE_RAW: return ".raw";
+    default: return "";
+    }
+}
+
+void cISLogger::InitCatalog()
+{
+    m_catalog.reset();
+    string extension = catalogExtension(m_logType);
+    if (extension.empty())
+    {
+        return;
+    }
+
+    // Continue a current catalog.  Otherwise only catalog this log if the directory has no other files the catalog would miss.
+    std::shared_ptr<cISLogCatalog> catalog = make_shared<cISLogCatalog>();
+    if (!(catalog->Read(m_directory, extension) && catalog->IsCurrent()))
+    {
+        vector<ISFileManager::file_info_t> files;
+        ISFileManager::GetDirectorySpaceUsed(m_directory, "\\" + extension + "$", files, false, false);
+        if (files.size())
+        {
+            ISFileManager::DeleteFile(cISLogCatalog::Path(m_directory, extension));
+            return;
+        }
+        catalog->Clear(m_directory, extension);
+    }
+    m_catalog = catalog;
+}
+
 [[deprecated("Not recommended for future development.")]]
 bool cISLogger::InitSave(eLogType logType, const string &directory, float driveUsageLimitPercent, uint32_t maxFileSize, bool useSubFolderTimestamp)
 {
@@ -304,7 +355,10 @@ std::shared_ptr<cDeviceLog> cISLogger::registerDevice(ISDevice& device) {
 #endif
     }
     device.devLogger->InitDeviceForWriting(m_timeStamp, m_directory, m_maxDiskSpace, m_maxFileSize);
-    m_devices[device.devInfo.serialNumber] = device.devLogger;
+    device.devLogger->SetRotation(m_rotatePeriodSec, m_rotateGpsTime);
+    device.devLogger->SetDeltaEncoding(m_deltaEncoding);
+    device.devLogger->SetCatalog(m_catalog);
+    m_devices[device.config->devInfo.serialNumber] = device.devLogger;
 
     return device.devLogger;
 }
@@ -323,6 +377,9 @@ std::shared_ptr<cDeviceLog> cISLogger::registerDevice(uint16_t hdwId, uint32_t s
 #endif
     }
     deviceLog->InitDeviceForWriting(m_timeStamp, m_directory, m_maxDiskSpace, m_maxFileSize);
+    deviceLog->SetRotation(m_rotatePeriodSec, m_rotateGpsTime);
+    deviceLog->SetDeltaEncoding(m_deltaEncoding);
+    deviceLog->SetCatalog(m_catalog);
     m_devices[serialNo] = deviceLog;
 
     return deviceLog;
@@ -412,6 +469,7 @@ bool cISLogger::LoadFromDirectory(const string &directory, eLogType logType, vec
 {
     // Delete and clear prior devices
     Cleanup();
+    m_catalog.reset();
     m_logType = logType;
     m_useChunkHeader = logType != cISLogger::LOGTYPE_RAW;
     string fileExtensionRegex;
@@ -428,6 +486,16 @@ bool cISLogger::LoadFromDirectory(const string &directory, eLogType logType, vec
     case cISLogger::LOGTYPE_KML: return false; // fileExtensionRegex = "\\.kml$"; break; // kml read not supported
     }
 
+    // A current catalog lists the files of each device without searching the directory
+    std::shared_ptr<cISLogCatalog> catalog = make_shared<cISLogCatalog>();
+    string extension = catalogExtension(logType);
+    if (!extension.empty() && catalog->Read(directory, extension) && catalog->IsCurrent() &&
+        LoadFromCatalog(directory, logType, *catalog, serials))
+    {
+        m_catalog = catalog;
+        return true;
+    }
+
     // get all files, sorted by name
     vector<ISFileManager::file_info_t> files;
     ISFileManager::GetDirectorySpaceUsed(directory, fileExtensionRegex, files, false, false);
@@ -504,7 +572,42 @@ bool cISLogger::LoadFromDirectory(const string &directory, eLogType logType, vec
     return (m_devices.size() != 0);
 }
 
-bool cISLogger::LogData(std::shared_ptr<cDeviceLog> deviceLog, p_data_hdr_t *dataHdr, const uint8_t *dataBuf)
+bool cISLogger::LoadFromCatalog(const string& directory, eLogType logType, cISLogCatalog& catalog, const vector<string>& serials)
+{
+    bool useAll = serials.empty() || find(serials.begin(), serials.end(), "ALL") != serials.end();
+
+    LOCK_MUTEX();
+    for (auto& device : catalog.Devices())
+    {
+        string serialNumber = to_string(device.first);
+        if (!useAll && find(serials.begin(), serials.end(), serialNumber) == serials.end())
+        {
+            continue;
+        }
+
+        // i.e. IS_LOG_FILE_PREFIX 30013_20170103_151023_001
+        int serialNum, index;
+        string date, time;
+        if (m_timeStamp.empty() && ParseFilename(device.second.front().name, serialNum, date, time, index))
+        {
+            m_timeStamp = date + (date.size() ? "_" : "") + time;
+        }
+
+        std::shared_ptr<cDeviceLog> deviceLog;
+        if (logType == cISLogger::LOGTYPE_RAW)  { deviceLog = make_shared<cDeviceLogRaw>(0, device.first); }
+        else                                    { deviceLog = make_shared<cDeviceLogSerial>(0, device.first); }
+        deviceLog->SetupReadInfo(directory, device.first, device.second);
+        m_devices[device.first] = deviceLog;
+    }
+    UNLOCK_MUTEX();
+
+    for (auto &d : this->DeviceLogs()) {
+        d->InitDeviceForReading();
+    }
+    return (m_devices.size() != 0);
+}
+
+bool cISLogger::LogData(const std::shared_ptr<cDeviceLog>& deviceLog, p_data_hdr_t *dataHdr, const uint8_t *dataBuf)
 {
     // This method is NOT for LOGTYPE_RAW (but all others)
     if (!m_enabled || (deviceLog == nullptr) || (m_logType == LOGTYPE_RAW)) {
@@ -522,8 +625,37 @@ bool cISLogger::LogData(std::shared_ptr<cDeviceLog> deviceLog, p_data_hdr_t *dat
     {
         m_errorFile.lprintf("Corrupt log header, id: %lu, offset: %lu, size: %lu\r\n", (unsigned long)dataHdr->id, (unsigned long)dataHdr->offset, (unsigned long)dataHdr->size);
         m_logStats.LogError(dataHdr);
+        return true;
+    }
+
+    uint32_t timeMs = current_timeMs();
+    if (!m_filter.Keep(deviceLog->SerialNumber(), dataHdr, dataBuf, timeMs))
+    {   // Decimated
+        return true;
     }
-    else if (!deviceLog->SaveData(dataHdr, dataBuf))
+
+    if (m_blackBoxSize)
+    {
+        StepBlackBoxTrigger();
+        cISBlackBox& blackBox = BlackBox(deviceLog);
+        if (blackBox.IsTrigger(dataHdr, dataBuf))
+        {
+            TriggerBlackBox(deviceLog, blackBox, timeMs);
+        }
+        if (!blackBox.Recording(timeMs))
+        {   // Hold in memory until a trigger
+            blackBox.Push(timeMs, dataHdr, dataBuf);
+            return true;
+        }
+    }
+
+    SaveData(deviceLog, dataHdr, dataBuf);
+    return true;
+}
+
+void cISLogger::SaveData(const std::shared_ptr<cDeviceLog>& deviceLog, p_data_hdr_t *dataHdr, const uint8_t *dataBuf)
+{
+    if (!deviceLog->SaveData(dataHdr, dataBuf))
     {
         m_errorFile.lprintf("Underlying log implementation failed to save\r\n");
         m_logStats.LogError(dataHdr);
@@ -546,10 +678,9 @@ bool cISLogger::LogData(std::shared_ptr<cDeviceLog> deviceLog, p_data_hdr_t *dat
         }
     }
 #endif
-    return true;
 }
 
-bool cISLogger::LogData(std::shared_ptr<cDeviceLog> deviceLog, int dataSize, const uint8_t *dataBuf)
+bool cISLogger::LogData(const std::shared_ptr<cDeviceLog>& deviceLog, int dataSize, const uint8_t *dataBuf)
 {
     // This method is ONLY for LOGTYPE_RAW
     if (!m_enabled || (deviceLog == nullptr) || (m_logType != LOGTYPE_RAW)) {
@@ -563,16 +694,117 @@ bool cISLogger::LogData(std::shared_ptr<cDeviceLog> deviceLog, int dataSize, con
     }
 
     m_lastCommTime = GetTime();
+    uint32_t timeMs = current_timeMs();
+
+    if (m_filter.Enabled())
+    {   // Pass each kept packet on separately
+        m_filter.Filter(deviceLog->SerialNumber(), dataBuf, dataSize, timeMs, [&](const uint8_t* data, int size) { LogRawData(deviceLog, size, data, timeMs); });
+    }
+    else
+    {
+        LogRawData(deviceLog, dataSize, dataBuf, timeMs);
+    }
+    return true;
+}
+
+void cISLogger::LogRawData(const std::shared_ptr<cDeviceLog>& deviceLog, int dataSize, const uint8_t *dataBuf, uint32_t timeMs)
+{
+    if (m_blackBoxSize)
+    {
+        StepBlackBoxTrigger();
+        cISBlackBox& blackBox = BlackBox(deviceLog);
+        if (blackBox.IsTrigger(dataBuf, dataSize))
+        {
+            TriggerBlackBox(deviceLog, blackBox, timeMs);
+        }
+        if (!blackBox.Recording(timeMs))
+        {   // Hold in memory until a trigger
+            blackBox.Push(timeMs, dataBuf, dataSize);
+            return;
+        }
+    }
+
+    SaveData(deviceLog, dataSize, dataBuf);
+}
+
+void cISLogger::SaveData(const std::shared_ptr<cDeviceLog>& deviceLog, int dataSize, const uint8_t *dataBuf)
+{
     if (!deviceLog->SaveData(dataSize, dataBuf, m_logStats))
     {	// Save Error
         m_errorFile.lprintf("Underlying log implementation failed to save\r\n");
         m_logStats.LogError(NULL);
     }
+}
+
+void cISLogger::EnableBlackBox(size_t bytesPerDevice, uint32_t preTriggerMs, uint32_t postTriggerMs)
+{
+    LOCK_MUTEX();
+    m_blackBoxSize = bytesPerDevice;
+    m_blackBoxPreMs = preTriggerMs;
+    m_blackBoxPostMs = postTriggerMs;
+    m_blackBoxes.clear();
+    if (m_blackBoxSize)
+    {   // Allocate rings up front for known devices
+        for (auto& it : m_devices)
+        {
+            BlackBox(it.second);
+        }
+    }
+    UNLOCK_MUTEX();
+}
+
+cISBlackBox& cISLogger::BlackBox(const std::shared_ptr<cDeviceLog>& deviceLog)
+{
+    std::unique_ptr<cISBlackBox>& blackBox = m_blackBoxes[deviceLog.get()];
+    if (blackBox == nullptr)
+    {
+        blackBox.reset(new cISBlackBox());
+        blackBox->Init(m_blackBoxSize, m_blackBoxPreMs, m_blackBoxPostMs);
+    }
+    return *blackBox;
+}
+
+void cISLogger::TriggerBlackBox(const std::shared_ptr<cDeviceLog>& deviceLog, cISBlackBox& blackBox, uint32_t timeMs)
+{
+    // Buffered records are written through the normal path, the same as live data
+    if (m_logType == LOGTYPE_RAW)
+    {
+        blackBox.Trigger(timeMs, [&](const uint8_t* data, uint32_t size) { SaveData(deviceLog, (int)size, data); });
+    }
     else
-    {	// Success
+    {
+        blackBox.Trigger(timeMs, [&](const uint8_t* data, uint32_t size) { SaveData(deviceLog, (p_data_hdr_t*)data, data + sizeof(p_data_hdr_t)); });
+    }
+}
 
+void cISLogger::TriggerBlackBox()
+{
+    m_blackBoxTriggerMs = current_timeMs();
+    m_blackBoxTriggerPending = true;
+}
+
+void cISLogger::StepBlackBoxTrigger()
+{
+    if (!m_blackBoxTriggerPending.exchange(false) || !m_blackBoxSize)
+    {
+        return;
     }
-    return true;
+
+    uint32_t timeMs = m_blackBoxTriggerMs;
+    for (auto& it : m_devices)
+    {
+        TriggerBlackBox(it.second, BlackBox(it.second), timeMs);
+    }
+}
+
+cISBlackBox::sStats cISLogger::BlackBoxStats(const std::shared_ptr<cDeviceLog>& deviceLog)
+{
+    auto it = m_blackBoxes.find(deviceLog.get());
+    if (it == m_blackBoxes.end())
+    {
+        return cISBlackBox::sStats();
+    }
+    return it->second->Stats();
 }
 
 p_data_buf_t *cISLogger::ReadData(std::shared_ptr<cDeviceLog> deviceLog)
@@ -676,6 +908,16 @@ uint64_t cISLogger::LogSizeAll()
     return size;
 }
 
+uint64_t cISLogger::GnssTrimBytesAll()
+{
+    uint64_t size = 0;
+    for (auto it : m_devices)
+    {
+        size += it.second->GnssTrimBytes();
+    }
+    return size;
+}
+
 float cISLogger::LogSizeAllMB()
 {
     return LogSizeAll() * 0.000001f;
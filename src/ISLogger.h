@@ -16,6 +16,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #define _FILE_OFFSET_BITS 64
 
 #include <stdio.h>
+#include <atomic>
 #include <string>
 #include <vector>
 #include <map>
@@ -38,7 +39,10 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #endif
 
 #include "ISConstants.h"
+#include "ISClock.h"
 #include "ISLogStats.h"
+#include "ISBlackBox.h"
+#include "ISLogFilter.h"
 
 
 // default logging path if none specified
@@ -71,6 +75,10 @@ public:
         bool useSubFolderTimestamp;                 // Cause each log instance to be written to separate timestamped folder.
         std::string timeStamp;                      // Used to name each log instance directory.  System date and time used if left empty.
         std::string subDirectory;                   // Write logs into sub-directory of this name inside log instance directory. 
+        uint32_t rotatePeriodSec;                   // Start a new file each period (i.e. 3600 for hourly files), in addition to maxFileSize.  0 disables.  DAT and RAW logs only.
+        bool rotateGpsTime;                         // Align rotatePeriodSec to GPS time from logged DID_GPS1_POS/DID_GPS2_POS instead of system time.
+        std::string filterFile;                     // YAML per DID decimation rules (see cISLogFilter).  Empty logs all data.
+        bool deltaEncoding;                         // Delta encode repeated same-DID records in each chunk.  DAT logs only.
 
         sSaveOptions(                               // Default Options:
             eLogType type = LOGTYPE_RAW,            // Raw packetized serial.  
@@ -84,7 +92,10 @@ public:
             driveUsageLimitMb(limitMb),
             maxFileSize(fileSize),
             useSubFolderTimestamp(useTimestamp),
-            subDirectory(subDir)
+            subDirectory(subDir),
+            rotatePeriodSec(0),
+            rotateGpsTime(false),
+            deltaEncoding(false)
         {}
     };
 
@@ -110,8 +121,8 @@ public:
 
     // Update internal state, handle timeouts, remove old files for file culling, etc.
     void Update();
-    bool LogData(std::shared_ptr<cDeviceLog> devLogger, p_data_hdr_t* dataHdr, const uint8_t* dataBuf);
-    bool LogData(std::shared_ptr<cDeviceLog> devLogger, int dataSize, const uint8_t* dataBuf);
+    bool LogData(const std::shared_ptr<cDeviceLog>& devLogger, p_data_hdr_t* dataHdr, const uint8_t* dataBuf);
+    bool LogData(const std::shared_ptr<cDeviceLog>& devLogger, int dataSize, const uint8_t* dataBuf);
     bool LogDataBySN(uint32_t serialNo, p_data_hdr_t* dataHdr, const uint8_t* dataBuf) { return LogData(DeviceLogBySerialNumber(serialNo), dataHdr, dataBuf); }
     bool LogDataBySN(uint32_t serialNo, int dataSize, const uint8_t* dataBuf) {  return LogData(DeviceLogBySerialNumber(serialNo), dataSize, dataBuf); }
     p_data_buf_t* ReadData(std::shared_ptr<cDeviceLog> devLogger = nullptr);
@@ -129,6 +140,7 @@ public:
     uint64_t LogSizeAll();
     uint64_t LogSize(uint32_t devSerialNo);
     float LogSizeAllMB();
+    uint64_t GnssTrimBytesAll();                // Bytes saved by trimming sat/sig arrays, all devices
     float LogSizeMB(uint32_t devSerialNo);
     float FileSizeMB(uint32_t devSerialNo);
     uint32_t FileCount(uint32_t devSerialNo);
@@ -140,6 +152,27 @@ public:
     std::shared_ptr<cDeviceLog> DeviceLogBySerialNumber(uint32_t serialNo) {
         return (m_devices.count(serialNo) ? m_devices[serialNo] : nullptr);
     }
+
+    /**
+     * Black box mode: keep the last bytesPerDevice of data in memory per device and only write to file around
+     * triggers (DID_EVENT, DID_SYS_FAULT, new DID_SYS_PARAMS genFaultCode bits, or TriggerBlackBox()).  Each trigger
+     * writes up to preTriggerMs of buffered data followed by live data until postTriggerMs after the last trigger.
+     * @param bytesPerDevice ring size per device.  0 disables black box mode.
+     */
+    void EnableBlackBox(size_t bytesPerDevice = BLACK_BOX_DEFAULT_SIZE, uint32_t preTriggerMs = BLACK_BOX_DEFAULT_PRE_TRIGGER_MS, uint32_t postTriggerMs = BLACK_BOX_DEFAULT_POST_TRIGGER_MS);
+    bool BlackBoxEnabled() { return m_blackBoxSize != 0; }
+    /**
+     * Trigger all devices' black boxes.  Safe to call from any thread; the rings are written by the logging thread on
+     * its next LogData() or Update().
+     */
+    void TriggerBlackBox();
+    cISBlackBox::sStats BlackBoxStats(const std::shared_ptr<cDeviceLog>& devLogger);
+
+    // Per DID decimation rules applied to data before it is logged
+    cISLogFilter& Filter() { return m_filter; }
+
+    // Catalog of the DAT or RAW log being written, or the catalog LoadFromDirectory read the log with.  NULL otherwise.
+    std::shared_ptr<cISLogCatalog> Catalog() { return m_catalog; }
     // bool SetDeviceInfo(const dev_info_t *info, unsigned int device = 0);
     // const dev_info_t* DeviceInfo(unsigned int device = 0);
 
@@ -249,6 +282,14 @@ private:
 
     bool InitDevicesForWriting(std::vector<ISDevice>& devices);
     void Cleanup();
+    bool LoadFromCatalog(const std::string& directory, eLogType logType, cISLogCatalog& catalog, const std::vector<std::string>& serials);
+    void InitCatalog();
+    void SaveData(const std::shared_ptr<cDeviceLog>& devLogger, p_data_hdr_t* dataHdr, const uint8_t* dataBuf);
+    void SaveData(const std::shared_ptr<cDeviceLog>& devLogger, int dataSize, const uint8_t* dataBuf);
+    void LogRawData(const std::shared_ptr<cDeviceLog>& devLogger, int dataSize, const uint8_t* dataBuf, uint32_t timeMs);
+    cISBlackBox& BlackBox(const std::shared_ptr<cDeviceLog>& devLogger);
+    void TriggerBlackBox(const std::shared_ptr<cDeviceLog>& devLogger, cISBlackBox& blackBox, uint32_t timeMs);
+    void StepBlackBoxTrigger();
     void PrintProgress();
 
     static time_t GetTime()
@@ -256,7 +297,7 @@ private:
 #if PLATFORM_IS_EVB_2
         return static_cast<time_t>(time_msec() / 1000);
 #else
-        return time(NULLPTR);
+        return cISClock::UnixTime();
 #endif
     }
 
@@ -271,6 +312,17 @@ private:
     uint64_t				m_maxDiskSpace = 0;		// Limit for logging.  Zero to disable file culling drive management.
     uint64_t				m_usedDiskSpace = 0;	// Size of all logs
     uint32_t				m_maxFileSize = 0;
+    uint32_t				m_rotatePeriodSec = 0;
+    bool					m_rotateGpsTime = false;
+    bool					m_deltaEncoding = false;
+    std::shared_ptr<cISLogCatalog> m_catalog;
+    size_t					m_blackBoxSize = 0;		// Black box ring size per device.  Zero disables black box mode.
+    uint32_t				m_blackBoxPreMs = 0;
+    uint32_t				m_blackBoxPostMs = 0;
+    std::map<cDeviceLog*, std::unique_ptr<cISBlackBox>> m_blackBoxes;
+    std::atomic<bool>		m_blackBoxTriggerPending{ false };	// Set by TriggerBlackBox(), handled on the logging thread
+    std::atomic<uint32_t>	m_blackBoxTriggerMs{ 0 };
+    cISLogFilter			m_filter;
     cLogStats				m_logStats;
 #if PLATFORM_IS_EVB_2
     cISLogFileFatFs         m_errorFile;
@@ -0,0 +1,368 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+#include "ISMagCal.h"
+#include "ISMatrix.h"
+#include "ISDataMappings.h"
+#include "yaml-cpp/yaml.h"
+
+using namespace std;
+
+#define MAG_CAL_ORIGIN_SAMPLES      256     // Samples averaged for the origin of streaming accumulation
+
+void cISMagCal::Clear()
+{
+    m_samples.clear();
+    m_streaming = false;
+    m_result = sResult();
+}
+
+void cISMagCal::Init(sNormal& n, const double origin[3], double scale)
+{
+    memset(&n, 0, sizeof(n));
+    memcpy(n.origin, origin, sizeof(n.origin));
+    n.scale = (scale > 0.0 ? scale : 1.0);
+}
+
+void cISMagCal::Accumulate(sNormal& n, const float mag[3])
+{
+    double x = (mag[0] - n.origin[0]) / n.scale;
+    double y = (mag[1] - n.origin[1]) / n.scale;
+    double z = (mag[2] - n.origin[2]) / n.scale;
+    double d[9] = { x*x, y*y, z*z, 2*x*y, 2*x*z, 2*y*z, 2*x, 2*y, 2*z };
+
+    for (int i = 0; i < 9; i++)
+    {
+        double* row = &n.DtD[i * 9];
+        for (int j = i; j < 9; j++)
+        {
+            row[j] += d[i] * d[j];
+        }
+        n.Dt1[i] += d[i];
+    }
+    n.count++;
+}
+
+void cISMagCal::InitStreaming()
+{
+    // Mean of samples on the ellipsoid is inside it, which keeps the fit well conditioned
+    double origin[3] = {};
+    size_t count = m_samples.size();
+    for (auto& s : m_samples)
+    {
+        for (int i = 0; i < 3; i++) { origin[i] += s[i]; }
+    }
+    for (int i = 0; i < 3; i++) { origin[i] /= count; }
+    double scale = 0.0;
+    for (auto& s : m_samples)
+    {
+        for (int i = 0; i < 3; i++) { scale += (s[i] - origin[i]) * (s[i] - origin[i]); }
+    }
+    scale = sqrt(scale / count);
+
+    Init(m_normal, origin, scale);
+    for (auto& s : m_samples)
+    {
+        Accumulate(m_normal, s.data());
+    }
+    m_streaming = true;
+}
+
+void cISMagCal::Add(const float mag[3])
+{
+    if (!isfinite(mag[0]) || !isfinite(mag[1]) || !isfinite(mag[2]) || (mag[0] == 0.0f && mag[1] == 0.0f && mag[2] == 0.0f))
+    {
+        return;
+    }
+
+    m_samples.push_back({ mag[0], mag[1], mag[2] });
+    if (m_streaming)
+    {
+        Accumulate(m_normal, mag);
+    }
+    else if (m_samples.size() >= MAG_CAL_ORIGIN_SAMPLES)
+    {
+        InitStreaming();
+    }
+}
+
+bool cISMagCal::AddLog(const string& directory, cISLogger::eLogType logType, uint32_t serial)
+{
+    cISLogger log;
+    if (!log.LoadFromDirectory(directory, logType))
+    {
+        return false;
+    }
+
+    size_t count = m_samples.size();
+    for (auto& devLog : log.DeviceLogs())
+    {
+        if (serial && devLog->SerialNumber() != serial)
+        {
+            continue;
+        }
+
+        p_data_buf_t* data;
+        while ((data = log.ReadData(devLog)) != NULLPTR)
+        {
+            // Full records only.  Structures are packed, so copy out the field.
+            uint32_t offset;
+            switch (data->hdr.id)
+            {
+            case DID_MAGNETOMETER:  offset = offsetof(magnetometer_t, mag);             break;
+            case DID_PIMU_MAG:      offset = offsetof(pimu_mag_t, mag.mag);             break;
+            case DID_IMU_MAG:       offset = offsetof(imu_mag_t, mag.mag);              break;
+            default:                continue;
+            }
+            if (data->hdr.offset != 0 || data->hdr.size < offset + 3 * sizeof(float))
+            {
+                continue;
+            }
+            float mag[3];
+            memcpy(mag, data->buf + offset, sizeof(mag));
+            Add(mag);
+        }
+    }
+    return (m_samples.size() > count);
+}
+
+bool cISMagCal::Solve(const sNormal& n)
+{
+    if (n.count < 9)
+    {
+        return false;
+    }
+
+    double DtD[81];
+    for (int i = 0; i < 9; i++)
+    {
+        for (int j = 0; j < 9; j++)
+        {
+            DtD[i * 9 + j] = (j >= i ? n.DtD[i * 9 + j] : n.DtD[j * 9 + i]);
+        }
+    }
+    double v[9];
+    if (cholesky_solve_MatN_d(v, DtD, n.Dt1, 9))
+    {
+        return false;
+    }
+
+    // Center c = -A^-1 g.  A must be positive definite for an ellipsoid.
+    ixMatrix3d A = { v[0], v[3], v[4],
+                     v[3], v[1], v[5],
+                     v[4], v[5], v[2] };
+    ixMatrix3d L;
+    memcpy(L, A, sizeof(L));
+    double negG[3] = { -v[6], -v[7], -v[8] };
+    double c[3];
+    if (cholesky_solve_MatN_d(c, L, negG, 3))
+    {
+        return false;
+    }
+
+    // (x - c)^T (A / k) (x - c) = 1
+    double k = 1.0 - dot_Vec3d_Vec3d(negG, c);
+    if (!(k > 0.0))
+    {
+        return false;
+    }
+
+    ixVector3d eigenvalues;
+    ixMatrix3d V;
+    eig_Mat3x3_sym_d(eigenvalues, V, A);
+    if (!(eigenvalues[2] > 0.0))
+    {
+        return false;
+    }
+
+    // W = sqrt(A / k) / scale maps raw samples on the ellipsoid onto the unit sphere
+    double root[3];
+    for (int i = 0; i < 3; i++)
+    {
+        root[i] = sqrt(eigenvalues[i] / k) / n.scale;
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            m_W[i * 3 + j] = V[i * 3 + 0] * root[0] * V[j * 3 + 0] + V[i * 3 + 1] * root[1] * V[j * 3 + 1] + V[i * 3 + 2] * root[2] * V[j * 3 + 2];
+        }
+        m_bias[i] = n.origin[i] + n.scale * c[i];
+    }
+
+    // Semi-axes are 1 / root
+    m_field = 1.0 / cbrt(root[0] * root[1] * root[2]);
+    m_condition = root[0] / root[2];
+    return true;
+}
+
+double cISMagCal::Residual(const float mag[3], double unit[3])
+{
+    double d[3] = { mag[0] - m_bias[0], mag[1] - m_bias[1], mag[2] - m_bias[2] };
+    for (int i = 0; i < 3; i++)
+    {
+        unit[i] = m_W[i * 3] * d[0] + m_W[i * 3 + 1] * d[1] + m_W[i * 3 + 2] * d[2];
+    }
+    double norm = sqrt(dot_Vec3d(unit));
+    if (norm > 0.0)
+    {
+        for (int i = 0; i < 3; i++) { unit[i] /= norm; }
+    }
+    return norm - 1.0;
+}
+
+// Residuals beyond this are outliers.  absResiduals is reordered.
+static double rejectThreshold(const cISMagCal::sOptions& options, vector<double>& absResiduals)
+{
+    auto median = absResiduals.begin() + absResiduals.size() / 2;
+    nth_element(absResiduals.begin(), median, absResiduals.end());
+    return _MAX(options.rejectSigma * 1.4826 * *median, options.minRejectResidual);
+}
+
+const cISMagCal::sResult& cISMagCal::Fit(const sOptions& options)
+{
+    m_result = sResult();
+    m_result.samples = m_samples.size();
+    if (!m_streaming && m_samples.size())
+    {
+        InitStreaming();
+    }
+    if (!m_streaming || !Solve(m_normal))
+    {
+        return m_result;
+    }
+
+    // Reject outliers and refit from the kept samples, centered on the current fit
+    vector<double> residuals(m_samples.size());
+    double unit[3];
+    double threshold = INFINITY;
+    uint64_t inliers = m_samples.size();
+    while (m_result.iterations < options.iterations)
+    {
+        for (size_t i = 0; i < m_samples.size(); i++)
+        {
+            residuals[i] = fabs(Residual(m_samples[i].data(), unit));
+        }
+        vector<double> sorted = residuals;
+        threshold = rejectThreshold(options, sorted);
+
+        sNormal n;
+        Init(n, m_bias, m_field);
+        for (size_t i = 0; i < m_samples.size(); i++)
+        {
+            if (residuals[i] <= threshold)
+            {
+                Accumulate(n, m_samples[i].data());
+            }
+        }
+        if (!Solve(n))
+        {   // Too few samples kept, keep the previous fit
+            break;
+        }
+        m_result.iterations++;
+        if (n.count == inliers)
+        {
+            break;
+        }
+        inliers = n.count;
+    }
+
+    // Quality over the samples kept by the final fit
+    for (size_t i = 0; i < m_samples.size(); i++)
+    {
+        residuals[i] = fabs(Residual(m_samples[i].data(), unit));
+    }
+    if (options.iterations > 0)
+    {
+        vector<double> sorted = residuals;
+        threshold = rejectThreshold(options, sorted);
+    }
+    double sumSq = 0.0;
+    bool bins[MAG_CAL_COVERAGE_BINS] = {};
+    for (size_t i = 0; i < m_samples.size(); i++)
+    {
+        double r = residuals[i];
+        if (r > threshold)
+        {
+            continue;
+        }
+        Residual(m_samples[i].data(), unit);
+        m_result.inliers++;
+        sumSq += r * r;
+        m_result.residualMax = _MAX(m_result.residualMax, r);
+        int lat = _CLAMP((int)((unit[2] + 1.0) * 3.0), 0, 5);
+        int lon = _CLAMP((int)((atan2(unit[1], unit[0]) + C_PI) * (6.0 / C_PI)), 0, 11);
+        bins[lat * 12 + lon] = true;
+    }
+    if (m_result.inliers == 0)
+    {
+        return m_result;
+    }
+    m_result.residualRms = sqrt(sumSq / m_result.inliers);
+    m_result.coverage = count(bins, bins + MAG_CAL_COVERAGE_BINS, true) / (double)MAG_CAL_COVERAGE_BINS;
+    m_result.conditionNumber = m_condition;
+    m_result.fieldStrength = m_field;
+
+    double scale = (options.fieldStrength > 0.0 ? options.fieldStrength : m_field);
+    for (int i = 0; i < 9; i++)
+    {
+        m_result.Wcal[i] = (float)(m_W[i] * scale);
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        m_result.bias_cal[i] = (float)m_bias[i];
+    }
+    m_result.valid = true;
+    return m_result;
+}
+
+void cISMagCal::ToMagObsInfo(inl2_mag_obs_info_t& info)
+{
+    if (!m_result.valid)
+    {
+        return;
+    }
+    memcpy(info.Wcal, m_result.Wcal, sizeof(info.Wcal));
+    memcpy(info.bias_cal, m_result.bias_cal, sizeof(info.bias_cal));
+    info.Ncal_samples = (uint32_t)_MIN(m_result.inliers, (uint64_t)UINT32_MAX);
+    info.calibrated = 1;
+}
+
+string cISMagCal::ToYaml()
+{
+    YAML::Emitter out;
+    out << YAML::BeginMap;
+    out << YAML::Key << "valid" << YAML::Value << m_result.valid;
+    out << YAML::Key << "samples" << YAML::Value << m_result.samples;
+    out << YAML::Key << "inliers" << YAML::Value << m_result.inliers;
+    out << YAML::Key << "iterations" << YAML::Value << m_result.iterations;
+    out << YAML::Key << "fieldStrength" << YAML::Value << m_result.fieldStrength;
+    out << YAML::Key << "residualRms" << YAML::Value << m_result.residualRms;
+    out << YAML::Key << "residualMax" << YAML::Value << m_result.residualMax;
+    out << YAML::Key << "conditionNumber" << YAML::Value << m_result.conditionNumber;
+    out << YAML::Key << "coverage" << YAML::Value << m_result.coverage;
+    if (m_result.valid)
+    {
+        out << YAML::Key << cISDataMappings::DataName(DID_INL2_MAG_OBS_INFO) << YAML::Value << YAML::BeginMap;
+        out << YAML::Key << "Wcal" << YAML::Value << YAML::Flow << vector<float>(m_result.Wcal, m_result.Wcal + 9);
+        out << YAML::Key << "bias_cal" << YAML::Value << YAML::Flow << vector<float>(m_result.bias_cal, m_result.bias_cal + 3);
+        out << YAML::EndMap;
+    }
+    out << YAML::EndMap;
+    return out.c_str();
+}
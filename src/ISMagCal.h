@@ -0,0 +1,106 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef IS_MAG_CAL_H
+#define IS_MAG_CAL_H
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "ISConstants.h"
+#include "data_sets.h"
+#include "ISLogger.h"
+
+#define MAG_CAL_COVERAGE_BINS       72      // 6 latitude (equal area) x 12 longitude bins of calibrated direction
+
+/**
+ * Host side hard and soft iron magnetometer calibration from logged data.  Samples are accumulated into the normal
+ * equations of an algebraic ellipsoid fit as they are added, so a fit needs no second pass.  Fit() then refines it by
+ * rejecting samples whose calibrated magnitude is far from the fitted field, re-accumulating over the kept samples.
+ * Each pass is linear in the number of samples.  The result uses the device convention Bcal = Wcal * (Braw - bias_cal).
+ */
+class cISMagCal
+{
+public:
+    struct sOptions
+    {
+        int iterations = 5;                 // Outlier rejection passes after the first fit
+        double rejectSigma = 3.0;           // Reject samples with |residual| above this many robust (MAD) sigmas
+        double minRejectResidual = 0.01;    // ...but never below this fraction of the field
+        double fieldStrength = 0.0;         // Calibrated field magnitude.  0 keeps the fitted raw magnitude.
+    };
+
+    struct sResult
+    {
+        bool valid = false;
+        float Wcal[9] = { 1, 0, 0, 0, 1, 0, 0, 0, 1 };     // Soft iron, row major
+        float bias_cal[3] = {};             // Hard iron, raw units
+        double fieldStrength = 0.0;         // Fitted field magnitude in raw units (geometric mean of semi-axes)
+        uint64_t samples = 0;
+        uint64_t inliers = 0;
+        double residualRms = 0.0;           // Of inlier |Bcal| / field - 1
+        double residualMax = 0.0;
+        double conditionNumber = 0.0;       // Largest / smallest ellipsoid semi-axis, 1 for a sphere
+        double coverage = 0.0;              // Fraction of MAG_CAL_COVERAGE_BINS holding an inlier
+        int iterations = 0;
+    };
+
+    /** Add one raw magnetometer sample.  Non-finite and all zero samples are ignored. */
+    void Add(const float mag[3]);
+
+    /** Add samples from DID_MAGNETOMETER, DID_PIMU_MAG and DID_IMU_MAG records of a log.  serial 0 uses every device. */
+    bool AddLog(const std::string& directory, cISLogger::eLogType logType = cISLogger::LOGTYPE_DAT, uint32_t serial = 0);
+
+    /** Fit an ellipsoid to the samples added so far */
+    const sResult& Fit() { return Fit(sOptions()); }
+    const sResult& Fit(const sOptions& options);
+
+    const sResult& Result() { return m_result; }
+    size_t SampleCount() { return m_samples.size(); }
+    void Clear();
+
+    /** Result as the calibration fields of DID_INL2_MAG_OBS_INFO */
+    void ToMagObsInfo(inl2_mag_obs_info_t& info);
+
+    /** YAML of the quality metrics and the DID_INL2_MAG_OBS_INFO calibration fields */
+    std::string ToYaml();
+
+private:
+    // Normal equations of x^T A x + 2 g^T x = 1 over samples shifted and scaled to x = (mag - origin) / scale
+    struct sNormal
+    {
+        double origin[3];
+        double scale;
+        double DtD[81];                     // 9x9, upper triangle accumulated
+        double Dt1[9];
+        uint64_t count;
+    };
+
+    static void Init(sNormal& n, const double origin[3], double scale);
+    static void Accumulate(sNormal& n, const float mag[3]);
+    bool Solve(const sNormal& n);
+    double Residual(const float mag[3], double unit[3]);
+    void InitStreaming();
+
+    std::vector<std::array<float, 3>> m_samples;
+    sNormal m_normal;                       // Accumulated as samples are added, once the origin is known
+    bool m_streaming = false;
+    double m_W[9] = {};                     // Unit sphere calibration of the last solve
+    double m_bias[3] = {};
+    double m_field = 0.0;                   // Raw field magnitude of the last solve
+    double m_condition = 0.0;
+    sResult m_result;
+};
+
+#endif // IS_MAG_CAL_H
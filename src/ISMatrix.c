@@ -1199,6 +1199,116 @@ char inv_Mat4( ixMatrix4 result, const ixMatrix4 m )
     return 0;
 }
 
+char cholesky_solve_MatN_d( double *x, double *A, const double *b, i_t n )
+{
+	// A = L * L^T, L in the lower triangle of A
+	for( int j=0; j < n; j++ )
+	{
+		double *A_j = &A[j*n];
+		double d = A_j[j];
+		for( int k=0; k < j; k++ )
+			d -= A_j[k] * A_j[k];
+		if( !(d > 0.0) )
+			return -1;
+		A_j[j] = sqrt( d );
+
+		for( int i=j + 1; i < n; i++ )
+		{
+			double *A_i = &A[i*n];
+			double s = A_i[j];
+			for( int k=0; k < j; k++ )
+				s -= A_i[k] * A_j[k];
+			A_i[j] = s / A_j[j];
+		}
+	}
+
+	// L * y = b
+	for( int i=0; i < n; i++ )
+	{
+		double s = b[i];
+		for( int k=0; k < i; k++ )
+			s -= A[i*n + k] * x[k];
+		x[i] = s / A[i*n + i];
+	}
+
+	// L^T * x = y
+	for( int i=n - 1; i >= 0; i-- )
+	{
+		double s = x[i];
+		for( int k=i + 1; k < n; k++ )
+			s -= A[k*n + i] * x[k];
+		x[i] = s / A[i*n + i];
+	}
+
+	return 0;
+}
+
+void eig_Mat3x3_sym_d( ixVector3d eigenvalues, ixMatrix3d V, const ixMatrix3d m )
+{
+	double a[9];
+	memcpy( a, m, sizeof(a) );
+	for( int i=0; i < 9; i++ )
+		V[i] = (i % 4 == 0 ? 1.0 : 0.0);
+
+	// Cyclic Jacobi, converges in a few sweeps for 3x3
+	for( int sweep=0; sweep < 16; sweep++ )
+	{
+		double off = a[1]*a[1] + a[2]*a[2] + a[5]*a[5];
+		if( off < 1.0e-30 * (a[0]*a[0] + a[4]*a[4] + a[8]*a[8]) || off == 0.0 )
+			break;
+
+		for( int p=0; p < 2; p++ )
+		for( int q=p + 1; q < 3; q++ )
+		{
+			double apq = a[p*3 + q];
+			if( apq == 0.0 )
+				continue;
+
+			// Rotation zeroing a[p][q]
+			double theta = (a[q*3 + q] - a[p*3 + p]) / (2.0 * apq);
+			double t = (theta >= 0.0 ? 1.0 : -1.0) / (fabs( theta ) + sqrt( theta*theta + 1.0 ));
+			double c = 1.0 / sqrt( t*t + 1.0 );
+			double s = t * c;
+
+			for( int k=0; k < 3; k++ )
+			{	// Columns p and q
+				double akp = a[k*3 + p], akq = a[k*3 + q];
+				a[k*3 + p] = c*akp - s*akq;
+				a[k*3 + q] = s*akp + c*akq;
+			}
+			for( int k=0; k < 3; k++ )
+			{	// Rows p and q
+				double apk = a[p*3 + k], aqk = a[q*3 + k];
+				a[p*3 + k] = c*apk - s*aqk;
+				a[q*3 + k] = s*apk + c*aqk;
+			}
+			for( int k=0; k < 3; k++ )
+			{
+				double vkp = V[k*3 + p], vkq = V[k*3 + q];
+				V[k*3 + p] = c*vkp - s*vkq;
+				V[k*3 + q] = s*vkp + c*vkq;
+			}
+		}
+	}
+
+	for( int i=0; i < 3; i++ )
+		eigenvalues[i] = a[i*4];
+
+	// Descending order
+	for( int i=0; i < 2; i++ )
+	for( int j=i + 1; j < 3; j++ )
+	{
+		if( eigenvalues[j] > eigenvalues[i] )
+		{
+			double tmp = eigenvalues[i]; eigenvalues[i] = eigenvalues[j]; eigenvalues[j] = tmp;
+			for( int k=0; k < 3; k++ )
+			{
+				tmp = V[k*3 + i]; V[k*3 + i] = V[k*3 + j]; V[k*3 + j] = tmp;
+			}
+		}
+	}
+}
+
 // Initialize Alpha Filter alpha and beta values
 void LPFO0_init_Vec3( sLpfO0 *lpf, f_t dt, f_t cornerFreqHz, const ixVector3 initVal )
 {
@@ -646,6 +646,18 @@ char inv_Mat3( ixMatrix3 result, const ixMatrix3 m );
  */
 char inv_Mat4( ixMatrix4 result, const ixMatrix4 m );
 
+/* Solve A(nxn) * x(n) = b(n) for symmetric positive definite A by Cholesky decomposition.
+ * A is overwritten with its lower triangular factor.  x and b may be the same array.
+ * return 0 on success, -1 if A is not positive definite
+ */
+char cholesky_solve_MatN_d( double *x, double *A, const double *b, i_t n );
+
+/* Eigen decomposition of symmetric matrix by Jacobi rotations
+ * m(3x3) = V(3x3) * diag(eigenvalues) * V(3x3)^T
+ * Eigenvectors are the columns of V, sorted by descending eigenvalue.
+ */
+void eig_Mat3x3_sym_d( ixVector3d eigenvalues, ixMatrix3d V, const ixMatrix3d m );
+
 /*
  * Normalize 2 dimensional vector
  */
@@ -0,0 +1,832 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <memory>
+
+#include "ISMcap.h"
+#include "ISLogger.h"
+#include "ISDataMappings.h"
+#include "ISLogFileFactory.h"
+#include "time_conversion.h"
+#include "miniz.h"
+
+using namespace std;
+
+static const uint8_t s_mcapMagic[8] = { 0x89, 'M', 'C', 'A', 'P', '0', '\r', '\n' };
+
+enum eMcapOpcode
+{
+    MCAP_OP_HEADER          = 0x01,
+    MCAP_OP_FOOTER          = 0x02,
+    MCAP_OP_SCHEMA          = 0x03,
+    MCAP_OP_CHANNEL         = 0x04,
+    MCAP_OP_MESSAGE         = 0x05,
+    MCAP_OP_CHUNK           = 0x06,
+    MCAP_OP_MESSAGE_INDEX   = 0x07,
+    MCAP_OP_CHUNK_INDEX     = 0x08,
+    MCAP_OP_STATISTICS      = 0x0B,
+    MCAP_OP_SUMMARY_OFFSET  = 0x0E,
+    MCAP_OP_DATA_END        = 0x0F,
+};
+
+// Little endian record field encoding
+static inline void put(vector<uint8_t>& b, const void* v, size_t size) { b.insert(b.end(), (const uint8_t*)v, (const uint8_t*)v + size); }
+static inline void put8(vector<uint8_t>& b, uint8_t v)   { b.push_back(v); }
+static inline void put16(vector<uint8_t>& b, uint16_t v) { put(b, &v, sizeof(v)); }
+static inline void put32(vector<uint8_t>& b, uint32_t v) { put(b, &v, sizeof(v)); }
+static inline void put64(vector<uint8_t>& b, uint64_t v) { put(b, &v, sizeof(v)); }
+static inline void putStr(vector<uint8_t>& b, const string& s) { put32(b, (uint32_t)s.size()); put(b, s.data(), s.size()); }
+
+// Record is opcode, uint64 content length, content
+static inline size_t beginRecord(vector<uint8_t>& b, uint8_t opcode)
+{
+    size_t start = b.size();
+    put8(b, opcode);
+    put64(b, 0);
+    return start;
+}
+
+static inline void endRecord(vector<uint8_t>& b, size_t start)
+{
+    uint64_t len = b.size() - start - 9;
+    memcpy(&b[start + 1], &len, sizeof(len));
+}
+
+// Array and map fields are prefixed with their uint32 byte length
+static inline size_t beginLength32(vector<uint8_t>& b)
+{
+    size_t start = b.size();
+    put32(b, 0);
+    return start;
+}
+
+static inline void endLength32(vector<uint8_t>& b, size_t start)
+{
+    uint32_t len = (uint32_t)(b.size() - start - 4);
+    memcpy(&b[start], &len, sizeof(len));
+}
+
+static inline uint32_t mcapCrc32(uint32_t crc, const void* data, size_t size)
+{
+    return (uint32_t)mz_crc32(crc, (const unsigned char*)data, size);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// LZ4
+//////////////////////////////////////////////////////////////////////////
+
+static inline uint32_t read32(const uint8_t* p) { uint32_t v; memcpy(&v, p, sizeof(v)); return v; }
+static inline uint32_t rotl32(uint32_t x, int r) { return (x << r) | (x >> (32 - r)); }
+static inline uint32_t lz4Hash(uint32_t seq) { return (seq * 2654435761U) >> (32 - MCAP_LZ4_HASH_LOG); }
+
+// xxHash32 of fewer than 16 bytes, for the frame descriptor checksum
+static uint32_t xxh32Short(const uint8_t* p, size_t len)
+{
+    static const uint32_t PRIME1 = 2654435761U, PRIME2 = 2246822519U, PRIME3 = 3266489917U, PRIME4 = 668265263U, PRIME5 = 374761393U;
+    uint32_t h = PRIME5 + (uint32_t)len;
+    const uint8_t* end = p + len;
+    for (; p + 4 <= end; p += 4)
+    {
+        h = rotl32(h + read32(p) * PRIME3, 17) * PRIME4;
+    }
+    for (; p < end; p++)
+    {
+        h = rotl32(h + (*p) * PRIME5, 11) * PRIME1;
+    }
+    h ^= h >> 15;   h *= PRIME2;
+    h ^= h >> 13;   h *= PRIME3;
+    h ^= h >> 16;
+    return h;
+}
+
+static inline uint8_t* lz4Length(uint8_t* op, size_t len)
+{
+    for (; len >= 255; len -= 255)
+    {
+        *op++ = 255;
+    }
+    *op++ = (uint8_t)len;
+    return op;
+}
+
+// Greedy single pass LZ4 block compression.  Returns 0 if the output would not be smaller than the input.
+static size_t lz4CompressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst, uint32_t* table)
+{
+    static const int MINMATCH = 4, LASTLITERALS = 5, MFLIMIT = 12;
+    const uint8_t* ip = src;
+    const uint8_t* anchor = src;
+    const uint8_t* iend = src + srcSize;
+    uint8_t* op = dst;
+    uint8_t* oend = dst + srcSize;
+
+    memset(table, 0, sizeof(uint32_t) << MCAP_LZ4_HASH_LOG);
+    if (srcSize > (size_t)MFLIMIT)
+    {
+        const uint8_t* mflimit = iend - MFLIMIT;
+        const uint8_t* matchlimit = iend - LASTLITERALS;
+        while (ip < mflimit)
+        {
+            uint32_t seq = read32(ip);
+            uint32_t h = lz4Hash(seq);
+            const uint8_t* ref = src + table[h];
+            table[h] = (uint32_t)(ip - src);
+            if (ref >= ip || ip - ref > 65535 || read32(ref) != seq)
+            {   // Skip faster through data that doesn't compress
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            const uint8_t* mp = ip + MINMATCH;
+            const uint8_t* rp = ref + MINMATCH;
+            while (mp < matchlimit && *mp == *rp)
+            {
+                mp++;
+                rp++;
+            }
+
+            size_t litLen = ip - anchor;
+            size_t matchLen = mp - ip - MINMATCH;
+            if (op + 1 + litLen + litLen / 255 + 1 + 2 + matchLen / 255 + 1 + LASTLITERALS >= oend)
+            {
+                return 0;
+            }
+            uint8_t* token = op++;
+            *token = (uint8_t)((litLen < 15 ? litLen : 15) << 4);
+            if (litLen >= 15)
+            {
+                op = lz4Length(op, litLen - 15);
+            }
+            memcpy(op, anchor, litLen);
+            op += litLen;
+            uint16_t offset = (uint16_t)(ip - ref);
+            memcpy(op, &offset, 2);
+            op += 2;
+            *token |= (uint8_t)(matchLen < 15 ? matchLen : 15);
+            if (matchLen >= 15)
+            {
+                op = lz4Length(op, matchLen - 15);
+            }
+
+            ip = anchor = mp;
+        }
+    }
+
+    // Last literals
+    size_t litLen = iend - anchor;
+    if (op + 1 + litLen + litLen / 255 + 1 >= oend)
+    {
+        return 0;
+    }
+    *op++ = (uint8_t)((litLen < 15 ? litLen : 15) << 4);
+    if (litLen >= 15)
+    {
+        op = lz4Length(op, litLen - 15);
+    }
+    memcpy(op, anchor, litLen);
+    op += litLen;
+    return op - dst;
+}
+
+size_t lz4CompressFrame(const uint8_t* src, size_t srcSize, vector<uint8_t>& dst)
+{
+    // Worst case is every block stored plus frame header, block sizes and end mark
+    size_t blocks = (srcSize + MCAP_LZ4_BLOCK_SIZE - 1) / MCAP_LZ4_BLOCK_SIZE;
+    dst.resize(7 + srcSize + 4 * blocks + 4);
+    uint8_t* op = dst.data();
+
+    // Frame descriptor: version 1, independent blocks, 4 MB max block size
+    static const uint32_t magic = 0x184D2204;
+    memcpy(op, &magic, 4);
+    op[4] = 0x60;
+    op[5] = 0x70;
+    op[6] = (uint8_t)(xxh32Short(op + 4, 2) >> 8);
+    op += 7;
+
+    vector<uint32_t> table((size_t)1 << MCAP_LZ4_HASH_LOG);
+    for (size_t pos = 0; pos < srcSize; pos += MCAP_LZ4_BLOCK_SIZE)
+    {
+        size_t size = _MIN((size_t)MCAP_LZ4_BLOCK_SIZE, srcSize - pos);
+        uint32_t blockSize = (uint32_t)lz4CompressBlock(src + pos, size, op + 4, table.data());
+        if (blockSize == 0)
+        {   // Store uncompressed
+            memcpy(op + 4, src + pos, size);
+            blockSize = (uint32_t)size | 0x80000000;
+        }
+        memcpy(op, &blockSize, 4);
+        op += 4 + (blockSize & 0x7FFFFFFF);
+    }
+
+    memset(op, 0, 4);
+    op += 4;
+    return op - dst.data();
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// cMcapWriter
+//////////////////////////////////////////////////////////////////////////
+
+bool cMcapWriter::Open(const string& filename, const sOptions& options)
+{
+    Close();
+
+    m_options = options;
+    m_options.chunkSize = _MAX(m_options.chunkSize, 1024u);
+    m_file = CreateISLogFile(filename, "wb");
+    if (m_file == NULLPTR || !m_file->isOpened())
+    {
+        CloseISLogFile(m_file);
+        return false;
+    }
+
+    m_error = false;
+    m_fileOffset = 0;
+    m_dataCrc = 0;
+    m_schemas.clear();
+    m_channels.clear();
+    m_chunkIndexes.clear();
+    m_chunk.clear();
+    m_chunk.reserve(m_options.chunkSize + 1024);
+    m_chunkChannels.clear();
+    m_messageCount = 0;
+    m_startTime = m_endTime = 0;
+
+    Write(s_mcapMagic, sizeof(s_mcapMagic));
+    m_record.clear();
+    size_t start = beginRecord(m_record, MCAP_OP_HEADER);
+    putStr(m_record, m_options.profile);
+    putStr(m_record, "inertial-sense-sdk");
+    endRecord(m_record, start);
+    Write(m_record);
+    return !m_error;
+}
+
+void cMcapWriter::Write(const void* data, size_t size)
+{
+    if (m_file->write(data, size) != size)
+    {
+        m_error = true;
+    }
+    if (m_options.crc)
+    {
+        m_dataCrc = mcapCrc32(m_dataCrc, data, size);
+    }
+    m_fileOffset += size;
+}
+
+void cMcapWriter::SchemaRecord(vector<uint8_t>& out, const sSchema& schema)
+{
+    size_t start = beginRecord(out, MCAP_OP_SCHEMA);
+    put16(out, schema.id);
+    putStr(out, schema.name);
+    putStr(out, schema.encoding);
+    putStr(out, schema.data);
+    endRecord(out, start);
+}
+
+void cMcapWriter::ChannelRecord(vector<uint8_t>& out, const sChannel& channel)
+{
+    size_t start = beginRecord(out, MCAP_OP_CHANNEL);
+    put16(out, channel.id);
+    put16(out, channel.schemaId);
+    putStr(out, channel.topic);
+    putStr(out, channel.messageEncoding);
+    size_t map = beginLength32(out);
+    for (auto& kv : channel.metadata)
+    {
+        putStr(out, kv.first);
+        putStr(out, kv.second);
+    }
+    endLength32(out, map);
+    endRecord(out, start);
+}
+
+uint16_t cMcapWriter::AddSchema(const string& name, const string& encoding, const string& data)
+{
+    if (m_file == NULLPTR || m_schemas.size() >= 0xFFFF)
+    {
+        return 0;
+    }
+
+    // Schema id 0 means "no schema"
+    sSchema schema = { (uint16_t)(m_schemas.size() + 1), name, encoding, data };
+    m_record.clear();
+    SchemaRecord(m_record, schema);
+    Write(m_record);
+    m_schemas.push_back(schema);
+    return schema.id;
+}
+
+uint16_t cMcapWriter::AddChannel(uint16_t schemaId, const string& topic, const string& messageEncoding, const map<string, string>& metadata)
+{
+    if (m_file == NULLPTR || m_channels.size() >= 0xFFFF)
+    {
+        return 0xFFFF;
+    }
+
+    // Written ahead of the open chunk, so it precedes all messages that reference it
+    m_channels.emplace_back();
+    sChannel& channel = m_channels.back();
+    channel.id = (uint16_t)(m_channels.size() - 1);
+    channel.schemaId = schemaId;
+    channel.topic = topic;
+    channel.messageEncoding = messageEncoding;
+    channel.metadata = metadata;
+    m_record.clear();
+    ChannelRecord(m_record, channel);
+    Write(m_record);
+    return channel.id;
+}
+
+bool cMcapWriter::WriteMessage(uint16_t channelId, uint32_t sequence, uint64_t logTime, uint64_t publishTime, const void* data, size_t size)
+{
+    if (m_file == NULLPTR || channelId >= m_channels.size())
+    {
+        return false;
+    }
+
+    sChannel& channel = m_channels[channelId];
+    if (channel.index.empty())
+    {
+        m_chunkChannels.push_back(channelId);
+    }
+    channel.index.push_back({ logTime, m_chunk.size() });
+    channel.messageCount++;
+
+    size_t start = beginRecord(m_chunk, MCAP_OP_MESSAGE);
+    put16(m_chunk, channelId);
+    put32(m_chunk, sequence);
+    put64(m_chunk, logTime);
+    put64(m_chunk, publishTime);
+    put(m_chunk, data, size);
+    endRecord(m_chunk, start);
+
+    if (m_messageCount == 0 || logTime < m_startTime) { m_startTime = logTime; }
+    if (m_messageCount == 0 || logTime > m_endTime)   { m_endTime = logTime; }
+    if (start == 0 || logTime < m_chunkStartTime)      { m_chunkStartTime = logTime; }
+    if (start == 0 || logTime > m_chunkEndTime)        { m_chunkEndTime = logTime; }
+    m_messageCount++;
+
+    if (m_chunk.size() >= m_options.chunkSize)
+    {
+        return FlushChunk();
+    }
+    return !m_error;
+}
+
+bool cMcapWriter::FlushChunk()
+{
+    if (m_chunk.empty())
+    {
+        return !m_error;
+    }
+
+    const uint8_t* records = m_chunk.data();
+    size_t recordsSize = m_chunk.size();
+    string compression;
+    if (m_options.compression == COMPRESSION_LZ4)
+    {
+        recordsSize = lz4CompressFrame(m_chunk.data(), m_chunk.size(), m_compressed);
+        records = m_compressed.data();
+        compression = "lz4";
+    }
+
+    sChunkIndex index;
+    index.startTime = m_chunkStartTime;
+    index.endTime = m_chunkEndTime;
+    index.chunkOffset = m_fileOffset;
+    index.compressedSize = recordsSize;
+    index.uncompressedSize = m_chunk.size();
+
+    // Chunk record header, then the records written straight from the chunk buffer
+    m_record.clear();
+    put8(m_record, MCAP_OP_CHUNK);
+    put64(m_record, 8 + 8 + 8 + 4 + 4 + compression.size() + 8 + recordsSize);
+    put64(m_record, m_chunkStartTime);
+    put64(m_record, m_chunkEndTime);
+    put64(m_record, m_chunk.size());
+    put32(m_record, m_options.crc ? mcapCrc32(0, m_chunk.data(), m_chunk.size()) : 0);
+    putStr(m_record, compression);
+    put64(m_record, recordsSize);
+    Write(m_record);
+    Write(records, recordsSize);
+    index.chunkLength = m_fileOffset - index.chunkOffset;
+
+    // Message indexes follow the chunk
+    uint64_t indexStart = m_fileOffset;
+    for (uint16_t id : m_chunkChannels)
+    {
+        sChannel& channel = m_channels[id];
+        if (!is_sorted(channel.index.begin(), channel.index.end()))
+        {
+            stable_sort(channel.index.begin(), channel.index.end(), [](const pair<uint64_t, uint64_t>& a, const pair<uint64_t, uint64_t>& b) { return a.first < b.first; });
+        }
+        index.indexOffsets.push_back({ id, m_fileOffset });
+        m_record.clear();
+        size_t start = beginRecord(m_record, MCAP_OP_MESSAGE_INDEX);
+        put16(m_record, id);
+        put32(m_record, (uint32_t)(channel.index.size() * 16));
+        put(m_record, channel.index.data(), channel.index.size() * 16);
+        endRecord(m_record, start);
+        Write(m_record);
+        channel.index.clear();
+    }
+    index.indexLength = m_fileOffset - indexStart;
+    m_chunkIndexes.push_back(index);
+
+    m_chunk.clear();
+    m_chunkChannels.clear();
+    return !m_error;
+}
+
+bool cMcapWriter::Close()
+{
+    if (m_file == NULLPTR)
+    {
+        return false;
+    }
+
+    FlushChunk();
+
+    m_record.clear();
+    size_t start = beginRecord(m_record, MCAP_OP_DATA_END);
+    put32(m_record, m_dataCrc);
+    endRecord(m_record, start);
+    Write(m_record);
+
+    // Summary section.  Each group of records gets a summary offset record.
+    uint64_t summaryStart = m_fileOffset;
+    vector<uint8_t> summary;
+    vector<uint8_t> offsets;
+    auto group = [&](uint8_t opcode, size_t groupStart)
+    {
+        if (summary.size() > groupStart)
+        {
+            size_t s = beginRecord(offsets, MCAP_OP_SUMMARY_OFFSET);
+            put8(offsets, opcode);
+            put64(offsets, summaryStart + groupStart);
+            put64(offsets, summary.size() - groupStart);
+            endRecord(offsets, s);
+        }
+    };
+
+    size_t groupStart = summary.size();
+    for (const sSchema& schema : m_schemas)
+    {
+        SchemaRecord(summary, schema);
+    }
+    group(MCAP_OP_SCHEMA, groupStart);
+
+    groupStart = summary.size();
+    for (const sChannel& channel : m_channels)
+    {
+        ChannelRecord(summary, channel);
+    }
+    group(MCAP_OP_CHANNEL, groupStart);
+
+    groupStart = summary.size();
+    start = beginRecord(summary, MCAP_OP_STATISTICS);
+    put64(summary, m_messageCount);
+    put16(summary, (uint16_t)m_schemas.size());
+    put32(summary, (uint32_t)m_channels.size());
+    put32(summary, 0);      // Attachments
+    put32(summary, 0);      // Metadata
+    put32(summary, (uint32_t)m_chunkIndexes.size());
+    put64(summary, m_startTime);
+    put64(summary, m_endTime);
+    size_t map = beginLength32(summary);
+    for (const sChannel& channel : m_channels)
+    {
+        put16(summary, channel.id);
+        put64(summary, channel.messageCount);
+    }
+    endLength32(summary, map);
+    endRecord(summary, start);
+    group(MCAP_OP_STATISTICS, groupStart);
+
+    groupStart = summary.size();
+    for (const sChunkIndex& index : m_chunkIndexes)
+    {
+        start = beginRecord(summary, MCAP_OP_CHUNK_INDEX);
+        put64(summary, index.startTime);
+        put64(summary, index.endTime);
+        put64(summary, index.chunkOffset);
+        put64(summary, index.chunkLength);
+        map = beginLength32(summary);
+        for (auto& offset : index.indexOffsets)
+        {
+            put16(summary, offset.first);
+            put64(summary, offset.second);
+        }
+        endLength32(summary, map);
+        put64(summary, index.indexLength);
+        putStr(summary, m_options.compression == COMPRESSION_LZ4 ? "lz4" : "");
+        put64(summary, index.compressedSize);
+        put64(summary, index.uncompressedSize);
+        endRecord(summary, start);
+    }
+    group(MCAP_OP_CHUNK_INDEX, groupStart);
+
+    uint64_t summaryOffsetStart = summaryStart + summary.size();
+    summary.insert(summary.end(), offsets.begin(), offsets.end());
+
+    // Footer CRC covers the summary through the footer's summary_offset_start field
+    put8(summary, MCAP_OP_FOOTER);
+    put64(summary, 8 + 8 + 4);
+    put64(summary, summaryStart);
+    put64(summary, summaryOffsetStart);
+    put32(summary, m_options.crc ? mcapCrc32(0, summary.data(), summary.size()) : 0);
+    put(summary, s_mcapMagic, sizeof(s_mcapMagic));
+    Write(summary);
+
+    bool ok = !m_error;
+    CloseISLogFile(m_file);
+    m_chunk = vector<uint8_t>();
+    m_compressed = vector<uint8_t>();
+    return ok;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// cMcapExporter
+//////////////////////////////////////////////////////////////////////////
+
+static string ros1FieldName(const string& name)
+{
+    string out;
+    for (char c : name)
+    {
+        out += (isalnum((unsigned char)c) ? c : '_');
+    }
+    if (out.empty() || !isalpha((unsigned char)out[0]))
+    {
+        out = "f_" + out;
+    }
+    return out;
+}
+
+string cMcapExporter::SchemaDefinition(uint32_t did)
+{
+    static const char* const typeNames[DATA_TYPE_COUNT] = { "int8", "uint8", "int16", "uint16", "int32", "uint32", "int64", "uint64", "float32", "float64", "uint8", "uint8" };
+
+    const data_set_t* ds = cISDataMappings::DataSet(did);
+    if (ds == NULLPTR || ds->size == 0)
+    {
+        return "uint8[] data\n";
+    }
+
+    vector<const data_info_t*> fields;
+    for (auto& it : ds->indexToInfo)
+    {
+        fields.push_back(it.second);
+    }
+    stable_sort(fields.begin(), fields.end(), [](const data_info_t* a, const data_info_t* b) { return a->offset < b->offset; });
+
+    string def;
+    uint32_t cursor = 0;
+    int pad = 0;
+    for (const data_info_t* f : fields)
+    {
+        if (f->offset < cursor || f->offset + f->size > ds->size || f->type >= DATA_TYPE_COUNT)
+        {   // Union members after the first and anything outside the structure
+            continue;
+        }
+        if (f->offset > cursor)
+        {
+            def += "uint8[" + to_string(f->offset - cursor) + "] pad" + to_string(pad++) + "\n";
+        }
+
+        uint32_t count = _MAX(f->arraySize, 1u);
+        bool numeric = (f->type < DATA_TYPE_STRING && s_eDataTypeSize[f->type] * count == f->size);
+        if (numeric)
+        {
+            def += string(typeNames[f->type]) + (f->arraySize ? "[" + to_string(f->arraySize) + "]" : "");
+        }
+        else
+        {   // Strings, binary and anything else are bytes
+            def += "uint8[" + to_string(f->size) + "]";
+        }
+        def += " " + ros1FieldName(f->name);
+        if (!f->units.empty() && !f->units[0].empty())
+        {
+            def += "  # " + f->units[0];
+        }
+        def += "\n";
+        cursor = f->offset + f->size;
+    }
+    if (cursor < ds->size)
+    {
+        def += "uint8[" + to_string(ds->size - cursor) + "] pad" + to_string(pad++) + "\n";
+    }
+    return def;
+}
+
+/**
+ * Puts one device's data on a single epoch, Unix time in ns.  Data sets are stamped with GPS time of week, time since
+ * boot, or GPS seconds (raw observations).  Time of week uses the GPS week from the data set or the last one seen, and
+ * time since boot uses the towOffset of the last GPS position.  Until the device has GPS time, time since boot is used.
+ * Data that can't be placed on the device's epoch keeps the previous log time.
+ */
+class cMcapDeviceTime
+{
+public:
+    uint64_t LogTimeNs(const p_data_hdr_t& hdr, const uint8_t* buf)
+    {
+        const data_set_t* ds = cISDataMappings::DataSet(hdr.id);
+        if (ds == NULLPTR)
+        {
+            return m_lastNs;
+        }
+
+        // GPS week and time of week offset
+        auto week = ds->nameToInfo.find("week");
+        if (week != ds->nameToInfo.end() && week->second.type == DATA_TYPE_UINT32)
+        {
+            const uint8_t* ptr = cISDataMappings::FieldData(week->second, 0, &hdr, buf);
+            uint32_t value = 0;
+            if (ptr && ptr + sizeof(value) <= buf + hdr.size)
+            {
+                memcpy(&value, ptr, sizeof(value));
+            }
+            m_week = (value ? value : m_week);
+        }
+        if ((hdr.id == DID_GPS1_POS || hdr.id == DID_GPS2_POS) && hdr.offset == 0 && hdr.size >= offsetof(gps_pos_t, satsUsed))
+        {
+            gps_pos_t pos;
+            memcpy(&pos, buf, offsetof(gps_pos_t, satsUsed));
+            if (pos.week && pos.towOffset != 0.0)
+            {
+                m_towOffset = pos.towOffset;
+                m_leapS = (pos.leapS ? pos.leapS : m_leapS);
+            }
+        }
+
+        double timestamp = cISDataMappings::Timestamp(&hdr, buf);
+        if (timestamp <= 0.0)
+        {
+            return m_lastNs;
+        }
+
+        if (hdr.id == DID_GPS1_RAW || hdr.id == DID_GPS2_RAW || hdr.id == DID_GPS_BASE_RAW)
+        {   // Seconds since 1970 on the GPS time scale
+            SetUnixNs((int64_t)(timestamp * 1.0e9 + 0.5) - m_leapS * 1000000000LL);
+        }
+        else if (ds->timestampFields->name != "time")
+        {   // Time of week
+            if (m_week)
+            {
+                SetUnixNs(GpsToUnixNs(timestamp));
+            }
+        }
+        else if (m_towOffset != 0.0 && m_week)
+        {   // Time since boot
+            SetUnixNs(GpsToUnixNs(timestamp + m_towOffset));
+        }
+        else if (!m_unixTime)
+        {
+            m_lastNs = (uint64_t)(timestamp * 1.0e9 + 0.5);
+        }
+        return m_lastNs;
+    }
+
+private:
+    int64_t GpsToUnixNs(double timeOfWeek)
+    {
+        int64_t weekStart = (int64_t)C_GPS_TO_UNIX_OFFSET_S + (int64_t)m_week * C_SECONDS_PER_WEEK - m_leapS;
+        return weekStart * 1000000000LL + (int64_t)(timeOfWeek * 1.0e9 + 0.5);
+    }
+
+    void SetUnixNs(int64_t ns)
+    {
+        m_lastNs = (uint64_t)_MAX(ns, (int64_t)0);
+        m_unixTime = true;
+    }
+
+    uint32_t m_week = 0;
+    double m_towOffset = 0.0;
+    int m_leapS = C_GPS_LEAP_SECONDS;
+    bool m_unixTime = false;
+    uint64_t m_lastNs = 0;
+};
+
+bool cMcapExporter::Export(const string& logDirectory, const string& filename, const sOptions& options, sStats* stats)
+{
+    auto startTime = chrono::steady_clock::now();
+
+    cISLogger logger;
+    bool loaded = false;
+    if (options.logType >= 0)
+    {
+        loaded = logger.LoadFromDirectory(logDirectory, (cISLogger::eLogType)options.logType, { "ALL" });
+    }
+    else
+    {
+        loaded = logger.LoadFromDirectory(logDirectory, cISLogger::LOGTYPE_DAT, { "ALL" }) ||
+                 logger.LoadFromDirectory(logDirectory, cISLogger::LOGTYPE_RAW, { "ALL" });
+    }
+    if (!loaded)
+    {
+        return false;
+    }
+
+    cMcapWriter writer;
+    if (!writer.Open(filename, options.writer))
+    {
+        return false;
+    }
+
+    struct sChannel
+    {
+        uint16_t id = 0xFFFF;
+        uint32_t sequence = 0;
+        vector<uint8_t> data;           // Last full structure, or length prefixed bytes for unmapped DIDs
+    };
+
+    sStats total;
+    uint16_t schemaIds[DID_COUNT] = {};
+    vector<sChannel> channels(DID_COUNT);
+    for (auto& devLog : logger.DeviceLogs())
+    {
+        string prefix = "/SN" + to_string(devLog->SerialNumber()) + "/";
+        for (sChannel& channel : channels)
+        {
+            channel = sChannel();
+        }
+        cMcapDeviceTime deviceTime;
+        total.devices++;
+
+        p_data_buf_t* data;
+        while ((data = logger.ReadData(devLog)) != NULLPTR)
+        {
+            const p_data_hdr_t& hdr = data->hdr;
+            if (hdr.id == DID_NULL || hdr.id >= DID_COUNT)
+            {
+                continue;
+            }
+
+            const char* name = cISDataMappings::DataName(hdr.id);
+            string didName = (name ? string(name) : "DID_" + to_string(hdr.id));
+            if (schemaIds[hdr.id] == 0)
+            {
+                schemaIds[hdr.id] = writer.AddSchema("inertial_sense/" + didName, "ros1msg", SchemaDefinition(hdr.id));
+            }
+
+            sChannel& channel = channels[hdr.id];
+            uint32_t size = cISDataMappings::DataSize(hdr.id);
+            if (channel.id == 0xFFFF)
+            {
+                channel.id = writer.AddChannel(schemaIds[hdr.id], prefix + didName, "ros1", { { "did", to_string(hdr.id) }, { "serial", to_string(devLog->SerialNumber()) } });
+                channel.data.assign(size, 0);
+                total.channels++;
+            }
+
+            if (size)
+            {   // Merge into the full structure
+                uint32_t end = _MIN((uint32_t)hdr.offset + hdr.size, size);
+                if (hdr.offset < end)
+                {
+                    memcpy(channel.data.data() + hdr.offset, data->buf, end - hdr.offset);
+                }
+            }
+            else
+            {   // uint8[] data
+                channel.data.resize(4 + hdr.size);
+                uint32_t len = hdr.size;
+                memcpy(channel.data.data(), &len, 4);
+                memcpy(channel.data.data() + 4, data->buf, hdr.size);
+            }
+
+            uint64_t logTimeNs = deviceTime.LogTimeNs(hdr, data->buf);
+            if (!writer.WriteMessage(channel.id, channel.sequence++, logTimeNs, channel.data.data(), channel.data.size()))
+            {
+                writer.Close();
+                return false;
+            }
+        }
+    }
+
+    total.messages = writer.MessageCount();
+    bool ok = writer.Close();
+    total.bytesWritten = writer.BytesWritten();
+    total.elapsedSec = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    if (stats)
+    {
+        *stats = total;
+    }
+    return ok;
+}
@@ -0,0 +1,167 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef IS_MCAP_H
+#define IS_MCAP_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ISConstants.h"
+#include "ISLogFileBase.h"
+
+#define MCAP_DEFAULT_CHUNK_SIZE     (1024 * 1024)   // Uncompressed chunk size before the chunk is written
+#define MCAP_LZ4_BLOCK_SIZE         (4 * 1024 * 1024)
+#define MCAP_LZ4_HASH_LOG           14
+
+/**
+ * LZ4 frame compression (independent 4 MB blocks, no checksums) as used by MCAP "lz4" chunks.  Returns the frame
+ * size.  dst is resized as needed.
+ */
+size_t lz4CompressFrame(const uint8_t* src, size_t srcSize, std::vector<uint8_t>& dst);
+
+/**
+ * Streaming MCAP writer.  Messages are buffered into chunks of options.chunkSize, and each chunk is written with its
+ * message indexes as soon as it is full.  The summary (schemas, channels, statistics, chunk indexes) is written by
+ * Close().  Memory use is one chunk plus a small record per chunk, so output size is not limited by memory.
+ */
+class cMcapWriter
+{
+public:
+    enum eCompression
+    {
+        COMPRESSION_NONE,
+        COMPRESSION_LZ4,
+    };
+
+    struct sOptions
+    {
+        std::string profile;
+        uint32_t chunkSize = MCAP_DEFAULT_CHUNK_SIZE;
+        eCompression compression = COMPRESSION_NONE;
+        bool crc = true;                // Compute chunk, data section and summary CRCs.  Zero means "not computed".
+    };
+
+    cMcapWriter() {}
+    ~cMcapWriter() { Close(); }
+
+    bool Open(const std::string& filename) { return Open(filename, sOptions()); }
+    bool Open(const std::string& filename, const sOptions& options);
+    bool Close();
+    bool IsOpen() { return m_file != NULLPTR; }
+
+    /** @return schema id, or 0 on error */
+    uint16_t AddSchema(const std::string& name, const std::string& encoding, const std::string& data);
+
+    /** @return channel id */
+    uint16_t AddChannel(uint16_t schemaId, const std::string& topic, const std::string& messageEncoding, const std::map<std::string, std::string>& metadata = {});
+
+    bool WriteMessage(uint16_t channelId, uint32_t sequence, uint64_t logTime, uint64_t publishTime, const void* data, size_t size);
+    bool WriteMessage(uint16_t channelId, uint32_t sequence, uint64_t logTime, const void* data, size_t size) { return WriteMessage(channelId, sequence, logTime, logTime, data, size); }
+
+    uint64_t MessageCount() { return m_messageCount; }
+    uint64_t BytesWritten() { return m_fileOffset; }
+
+private:
+    struct sSchema
+    {
+        uint16_t id;
+        std::string name;
+        std::string encoding;
+        std::string data;
+    };
+
+    struct sChannel
+    {
+        uint16_t id;
+        uint16_t schemaId;
+        std::string topic;
+        std::string messageEncoding;
+        std::map<std::string, std::string> metadata;
+        uint64_t messageCount = 0;
+        std::vector<std::pair<uint64_t, uint64_t>> index;     // Message index (log time, offset) for the current chunk
+    };
+
+    struct sChunkIndex
+    {
+        uint64_t startTime;
+        uint64_t endTime;
+        uint64_t chunkOffset;
+        uint64_t chunkLength;
+        std::vector<std::pair<uint16_t, uint64_t>> indexOffsets;
+        uint64_t indexLength;
+        uint64_t compressedSize;
+        uint64_t uncompressedSize;
+    };
+
+    void Write(const std::vector<uint8_t>& buf) { Write(buf.data(), buf.size()); }
+    void Write(const void* data, size_t size);
+    bool FlushChunk();
+    void SchemaRecord(std::vector<uint8_t>& out, const sSchema& schema);
+    void ChannelRecord(std::vector<uint8_t>& out, const sChannel& channel);
+
+    cISLogFileBase* m_file = NULLPTR;
+    sOptions m_options;
+    bool m_error = false;
+    uint64_t m_fileOffset = 0;
+    uint32_t m_dataCrc = 0;
+
+    std::vector<sSchema> m_schemas;
+    std::vector<sChannel> m_channels;
+    std::vector<sChunkIndex> m_chunkIndexes;
+
+    std::vector<uint8_t> m_chunk;       // Uncompressed records of the current chunk
+    std::vector<uint16_t> m_chunkChannels;
+    uint64_t m_chunkStartTime = 0;
+    uint64_t m_chunkEndTime = 0;
+    std::vector<uint8_t> m_compressed;
+    std::vector<uint8_t> m_record;
+
+    uint64_t m_messageCount = 0;
+    uint64_t m_startTime = 0;
+    uint64_t m_endTime = 0;
+};
+
+/**
+ * Convert .dat/.raw logs to MCAP.  Each device and DID becomes a channel ("/SN<serial>/<DID name>") and each DID a
+ * "ros1msg" schema generated from cISDataMappings, so messages are the packed data set structures as logged, with no
+ * per field encoding.  Partial (offset) packets are merged into the last full structure of their channel.  Message
+ * log time is Unix time in nanoseconds from the device's GPS time, or the device's time since boot until it has GPS
+ * time.  Data without a timestamp uses the last log time of the device.
+ */
+class cMcapExporter
+{
+public:
+    struct sOptions
+    {
+        cMcapWriter::sOptions writer;
+        int logType = -1;                   // cISLogger::eLogType.  -1 = try .dat then .raw
+    };
+
+    struct sStats
+    {
+        uint64_t messages = 0;
+        uint64_t bytesWritten = 0;
+        uint32_t devices = 0;
+        uint32_t channels = 0;
+        double elapsedSec = 0;
+    };
+
+    /** ros1msg definition of a data set, padded so the message is the packed C structure */
+    static std::string SchemaDefinition(uint32_t did);
+
+    static bool Export(const std::string& logDirectory, const std::string& filename, const sOptions& options, sStats* stats = NULLPTR);
+};
+
+#endif // IS_MCAP_H
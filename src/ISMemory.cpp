@@ -0,0 +1,133 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include "ISMemory.h"
+
+#include <stdio.h>
+
+using namespace std;
+
+namespace
+{
+    // Zero initialized before any dynamic initialization, so globals may allocate during static construction
+    struct sCounters
+    {
+        atomic<size_t> live;
+        atomic<size_t> peak;
+        atomic<size_t> cap;
+        atomic<uint64_t> allocations;
+        atomic<uint64_t> shed;
+    };
+    sCounters s_counters[cISMemory::SUBSYSTEM_COUNT];
+}
+
+
+void cISMemory::Allocate(eSubsystem s, size_t bytes)
+{
+    sCounters& c = s_counters[s];
+    size_t live = c.live.fetch_add(bytes, memory_order_relaxed) + bytes;
+    c.allocations.fetch_add(1, memory_order_relaxed);
+    size_t peak = c.peak.load(memory_order_relaxed);
+    while (live > peak && !c.peak.compare_exchange_weak(peak, live, memory_order_relaxed)) {}
+}
+
+
+void cISMemory::Free(eSubsystem s, size_t bytes)
+{
+    s_counters[s].live.fetch_sub(bytes, memory_order_relaxed);
+}
+
+
+bool cISMemory::Available(eSubsystem s, size_t bytes)
+{
+    size_t cap = s_counters[s].cap.load(memory_order_relaxed);
+    return (cap == 0 || s_counters[s].live.load(memory_order_relaxed) + bytes <= cap);
+}
+
+
+void cISMemory::Shed(eSubsystem s, size_t count)
+{
+    s_counters[s].shed.fetch_add(count, memory_order_relaxed);
+}
+
+
+void cISMemory::SetCap(eSubsystem s, size_t bytes)
+{
+    s_counters[s].cap.store(bytes, memory_order_relaxed);
+}
+
+
+void cISMemory::ResetPeak(eSubsystem s)
+{
+    s_counters[s].peak.store(s_counters[s].live.load(memory_order_relaxed), memory_order_relaxed);
+}
+
+
+cISMemory::sUsage cISMemory::Usage(eSubsystem s)
+{
+    sCounters& c = s_counters[s];
+    sUsage usage;
+    usage.live = c.live.load(memory_order_relaxed);
+    usage.peak = c.peak.load(memory_order_relaxed);
+    usage.cap = c.cap.load(memory_order_relaxed);
+    usage.allocations = c.allocations.load(memory_order_relaxed);
+    usage.shed = c.shed.load(memory_order_relaxed);
+    return usage;
+}
+
+
+size_t cISMemory::TotalLive()
+{
+    size_t total = 0;
+    for (int s = 0; s < SUBSYSTEM_COUNT; s++)
+    {
+        total += s_counters[s].live.load(memory_order_relaxed);
+    }
+    return total;
+}
+
+
+const char* cISMemory::Name(eSubsystem s)
+{
+    switch (s)
+    {
+    case LOGGER_QUEUE:  return "logger_queue";
+    case LOG_STATS:     return "log_stats";
+    case MESSAGE_STATS: return "message_stats";
+    case KML:           return "kml";
+    case DEVICE:        return "device";
+    default:            return "unknown";
+    }
+}
+
+
+string cISMemory::Report()
+{
+    string str = "Subsystem           Live KB   Peak KB    Cap KB      Shed\n";
+    char buf[128];
+    for (int s = 0; s < SUBSYSTEM_COUNT; s++)
+    {
+        sUsage u = Usage((eSubsystem)s);
+        if (u.cap)
+        {
+            SNPRINTF(buf, sizeof(buf), "%-16s %10.1f %9.1f %9.1f %9llu\n", Name((eSubsystem)s), u.live / 1024.0, u.peak / 1024.0, u.cap / 1024.0, (unsigned long long)u.shed);
+        }
+        else
+        {
+            SNPRINTF(buf, sizeof(buf), "%-16s %10.1f %9.1f %9s %9llu\n", Name((eSubsystem)s), u.live / 1024.0, u.peak / 1024.0, "-", (unsigned long long)u.shed);
+        }
+        str += buf;
+    }
+    return str;
+}
@@ -0,0 +1,135 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef IS_MEMORY_H
+#define IS_MEMORY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "ISConstants.h"
+
+/**
+ * Per-subsystem heap accounting for the SDK's long lived containers.  Containers allocate through cISCountedAllocator,
+ * which adds to the live and peak byte counts of their subsystem.  A cap (0 = none) is never enforced by the allocator
+ * itself, since std containers can't handle a failed allocation.  Instead each subsystem checks Available() before it
+ * grows and sheds data as follows:
+ *
+ *  LOGGER_QUEUE   Packets waiting for the logger thread.  The newest packet is dropped.
+ *  LOG_STATS      cLogStats per message id maps.  New ids are only counted in the protocol totals.
+ *  MESSAGE_STATS  mul_msg_stats_t per message id maps.  New ids are counted in mul_msg_stats_t::untracked.
+ *  KML            KML track points held until the file is written.  The track is decimated by 2.
+ *  DEVICE         ISDeviceConfig of each open port.  Additional ports are not opened.
+ *
+ * All counters are atomic, so they can be read from any thread at any time.
+ */
+class cISMemory
+{
+public:
+    enum eSubsystem
+    {
+        LOGGER_QUEUE = 0,
+        LOG_STATS,
+        MESSAGE_STATS,
+        KML,
+        DEVICE,
+        SUBSYSTEM_COUNT
+    };
+
+    struct sUsage
+    {
+        size_t live;            // Bytes currently allocated
+        size_t peak;            // Largest live since start or ResetPeak()
+        size_t cap;             // 0 = no cap
+        uint64_t allocations;   // Number of allocations
+        uint64_t shed;          // Number of items dropped to stay within the cap
+    };
+
+    static void Allocate(eSubsystem s, size_t bytes);
+    static void Free(eSubsystem s, size_t bytes);
+
+    /** @return true if bytes more can be allocated without exceeding the cap */
+    static bool Available(eSubsystem s, size_t bytes);
+    static void Shed(eSubsystem s, size_t count = 1);
+
+    static void SetCap(eSubsystem s, size_t bytes);
+    static void ResetPeak(eSubsystem s);
+    static sUsage Usage(eSubsystem s);
+    static size_t TotalLive();
+    static const char* Name(eSubsystem s);
+
+    /** Table of live, peak, cap and shed counts for all subsystems */
+    static std::string Report();
+
+    /** @return bytes the next push_back() allocates, 0 if it fits in the current capacity */
+    template <class V>
+    static size_t GrowthBytes(const V& v)
+    {
+        return (v.size() < v.capacity() ? 0 : _MAX(v.capacity() * 2, (size_t)1) * sizeof(typename V::value_type));
+    }
+
+    /** @return approximate bytes of one std::map node, value plus tree links */
+    template <class M>
+    static constexpr size_t NodeBytes()
+    {
+        return sizeof(typename M::value_type) + 4 * sizeof(void*);
+    }
+};
+
+/**
+ * std allocator that counts into a cISMemory subsystem.  Stateless, so containers keep their size and move semantics.
+ */
+template <typename T, cISMemory::eSubsystem S>
+class cISCountedAllocator
+{
+public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind { typedef cISCountedAllocator<U, S> other; };
+
+    cISCountedAllocator() noexcept {}
+    template <typename U>
+    cISCountedAllocator(const cISCountedAllocator<U, S>&) noexcept {}
+
+    T* allocate(size_t n)
+    {
+        T* p = static_cast<T*>(::operator new(n * sizeof(T)));
+        cISMemory::Allocate(S, n * sizeof(T));
+        return p;
+    }
+
+    void deallocate(T* p, size_t n) noexcept
+    {
+        cISMemory::Free(S, n * sizeof(T));
+        ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const cISCountedAllocator<U, S>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const cISCountedAllocator<U, S>&) const noexcept { return false; }
+};
+
+template <typename T, cISMemory::eSubsystem S>
+using is_counted_vector = std::vector<T, cISCountedAllocator<T, S>>;
+
+template <typename K, typename V, cISMemory::eSubsystem S>
+using is_counted_map = std::map<K, V, std::less<K>, cISCountedAllocator<std::pair<const K, V>, S>>;
+
+#endif // IS_MEMORY_H
@@ -0,0 +1,1181 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <math.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "ISRinex.h"
+#include "ISEarth.h"
+#include "ISFileManager.h"
+#include "ISLogFileFactory.h"
+#include "ISLogger.h"
+
+using namespace std;
+
+#define RINEX_OBS_FIELD_WIDTH   16      // F14.3 + LLI + SSI
+#define RINEX_NAV_FIELD_WIDTH   19      // D19.12
+#define RINEX_DTTOL             0.005   // (s) Observations closer than this belong to the same epoch
+#define GPS_BDT_OFFSET_SEC      14.0    // (s) BeiDou time = GPS time - 14 s
+#define GPS_BDT_WEEK_OFFSET     1356    // BeiDou week 0 = GPS week 1356
+
+// RTKlib observation code table, indexed by obsd_t::code
+static const char* s_obsCodes[] = {
+    ""  ,"1C","1P","1W","1Y", "1M","1N","1S","1L","1E",    //  0- 9
+    "1A","1B","1X","1Z","2C", "2D","2S","2L","2X","2P",    // 10-19
+    "2W","2Y","2M","2N","5I", "5Q","5X","7I","7Q","7X",    // 20-29
+    "6A","6B","6C","6X","6Z", "6S","6L","8L","8Q","8X",    // 30-39
+    "2I","2Q","6I","6Q","3I", "3Q","3X","1I","1Q","5A",    // 40-49
+    "5B","5C","9A","9B","9C", "9X","1D","5D","5P","5Z",    // 50-59
+    "6E","7D","7P","7Z","8D", "8P","4A","4B","4X"          // 60-68
+};
+
+// Constellation index used for per-system tables
+static const char s_sysChar[] = "GREJCIS";
+static const uint16_t s_sysBits[] = { SYS_GPS, SYS_GLO, SYS_GAL, SYS_QZS, SYS_CMP, SYS_IRN, SYS_SBS };
+#define RINEX_SYS_COUNT     7
+
+// GPS/QZS user range accuracy index to meters
+static const double s_uraValue[] = { 2.4, 3.4, 4.85, 6.85, 9.65, 13.65, 24.0, 48.0, 96.0, 192.0, 384.0, 768.0, 1536.0, 3072.0, 6144.0 };
+
+static const double s_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+    1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18
+};
+
+// Powers of ten that are exactly representable in an x87 long double (5^27 < 2^64)
+static long double pow10l(int n)
+{
+    static const long double s_table[] = {
+        1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L,
+        1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L,
+        1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L
+    };
+    if (n >= 0 && n < (int)_ARRAY_ELEMENT_COUNT(s_table))
+    {
+        return s_table[n];
+    }
+    return powl(10.0L, (long double)n);
+}
+
+static inline char* blankField(char* p, int width)
+{
+    memset(p, ' ', width);
+    return p + width;
+}
+
+// Copy a right justified digit string built at the end of tmp into the output field
+static inline char* justify(char* p, const char* digits, int len, int width)
+{
+    if (len > width)
+    {
+        return blankField(p, width);
+    }
+    memset(p, ' ', width - len);
+    memcpy(p + width - len, digits, len);
+    return p + width;
+}
+
+// Round half to even, matching printf for values that are exact ties in binary
+static inline uint64_t roundHalfEven(long double x)
+{
+    long double fl = floorl(x);
+    long double r = x - fl;
+    uint64_t n = (uint64_t)fl;
+    if (r > 0.5L || (r == 0.5L && (n & 1)))
+    {
+        n++;
+    }
+    return n;
+}
+
+char* rinexFormatInt(char* p, int64_t value, int width, char pad)
+{
+    char tmp[24];
+    char *t = tmp + sizeof(tmp);
+    bool neg = value < 0;
+    uint64_t n = neg ? (uint64_t)(-value) : (uint64_t)value;
+    do { *--t = (char)('0' + n % 10); n /= 10; } while (n);
+    int len = (int)(tmp + sizeof(tmp) - t);
+    if (pad == '0')
+    {   // Zero padding goes between the sign and the digits
+        while (len < width - (neg ? 1 : 0)) { *--t = '0'; len++; }
+    }
+    if (neg) { *--t = '-'; len++; }
+    return justify(p, t, len, width);
+}
+
+char* rinexFormatFixed(char* p, double value, int width, int decimals)
+{
+    if (decimals < 0 || decimals > 15 || value != value)
+    {
+        return blankField(p, width);
+    }
+
+    bool neg = value < 0;
+    double a = neg ? -value : value;
+    if (a >= 1e18)
+    {
+        return blankField(p, width);
+    }
+
+    // Split first so the scaled fraction only carries rounding error from the fraction itself
+    double ip = floor(a);
+    uint64_t whole = (uint64_t)ip;
+    uint64_t scale = (uint64_t)s_pow10[decimals];
+    uint64_t frac = roundHalfEven((long double)(a - ip) * (long double)scale);
+    if (frac >= scale)
+    {
+        frac -= scale;
+        whole++;
+    }
+
+    char tmp[48];
+    char *t = tmp + sizeof(tmp);
+    for (int i = 0; i < decimals; i++)
+    {
+        *--t = (char)('0' + frac % 10);
+        frac /= 10;
+    }
+    if (decimals > 0)
+    {
+        *--t = '.';
+    }
+    do { *--t = (char)('0' + whole % 10); whole /= 10; } while (whole);
+    if (neg)
+    {
+        *--t = '-';
+    }
+    return justify(p, t, (int)(tmp + sizeof(tmp) - t), width);
+}
+
+char* rinexFormatExp(char* p, double value, int width, int decimals)
+{
+    if (decimals < 0 || decimals > 17 || value != value)
+    {
+        return blankField(p, width);
+    }
+
+    bool neg = value < 0;
+    long double a = neg ? -value : value;
+    int exp10 = 0;
+    uint64_t mant = 0;
+
+    if (a != 0.0L)
+    {
+        uint64_t lo = (uint64_t)s_pow10[decimals];
+        uint64_t hi = lo * 10;
+        exp10 = (int)floorl(log10l(a));
+        for (int i = 0; i < 3; i++)
+        {   // log10 can be off by one near powers of ten.  Adjust and rescale.
+            int k = decimals - exp10;
+            long double m = (k >= 0 ? a * pow10l(k) : a / pow10l(-k));
+            mant = roundHalfEven(m);
+            if (mant >= hi)         { exp10++; }
+            else if (mant < lo)     { exp10--; }
+            else                    { break; }
+        }
+    }
+
+    char tmp[48];
+    char *t = tmp + sizeof(tmp);
+
+    // Exponent, at least two digits
+    int e = exp10 < 0 ? -exp10 : exp10;
+    do { *--t = (char)('0' + e % 10); e /= 10; } while (e);
+    if (tmp + sizeof(tmp) - t < 2)
+    {
+        *--t = '0';
+    }
+    *--t = (exp10 < 0 ? '-' : '+');
+    *--t = 'E';
+
+    for (int i = 0; i < decimals; i++)
+    {
+        *--t = (char)('0' + mant % 10);
+        mant /= 10;
+    }
+    if (decimals > 0)
+    {
+        *--t = '.';
+    }
+    *--t = (char)('0' + mant % 10);
+    if (neg)
+    {
+        *--t = '-';
+    }
+    return justify(p, t, (int)(tmp + sizeof(tmp) - t), width);
+}
+
+int rinexSatSys(int sat, int *prn)
+{
+    int sys = SYS_NONE;
+    if (sat <= 0 || RINEX_MAX_SAT < sat)
+    {
+        sat = 0;
+    }
+    else if (sat <= NSATGPS)
+    {
+        sys = SYS_GPS; sat += MINPRNGPS - 1;
+    }
+    else if ((sat -= NSATGPS) <= NSATGLO)
+    {
+        sys = SYS_GLO; sat += MINPRNGLO - 1;
+    }
+    else if ((sat -= NSATGLO) <= NSATGAL)
+    {
+        sys = SYS_GAL; sat += MINPRNGAL - 1;
+    }
+    else if ((sat -= NSATGAL) <= NSATQZS)
+    {
+        sys = SYS_QZS; sat += MINPRNQZS - 1;
+    }
+    else if ((sat -= NSATQZS) <= NSATCMP)
+    {
+        sys = SYS_CMP; sat += MINPRNCMP - 1;
+    }
+    else if ((sat -= NSATCMP) <= NSATIRN)
+    {
+        sys = SYS_IRN; sat += MINPRNIRN - 1;
+    }
+    else if ((sat -= NSATIRN) <= NSATLEO)
+    {
+        sys = SYS_LEO; sat += MINPRNLEO - 1;
+    }
+    else if ((sat -= NSATLEO) <= NSATSBS)
+    {
+        sys = SYS_SBS; sat += MINPRNSBS - 1;
+    }
+    else
+    {
+        sat = 0;
+    }
+    if (prn)
+    {
+        *prn = sat;
+    }
+    return sys;
+}
+
+static int sysIndex(int sys)
+{
+    for (int i = 0; i < RINEX_SYS_COUNT; i++)
+    {
+        if (s_sysBits[i] == sys)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool rinexSatId(int sat, char id[4])
+{
+    int prn;
+    int idx = sysIndex(rinexSatSys(sat, &prn));
+    if (idx < 0)
+    {
+        return false;
+    }
+    switch (s_sysBits[idx])
+    {
+    case SYS_QZS:   prn -= 192; break;
+    case SYS_SBS:   prn -= 100; break;
+    }
+    id[0] = s_sysChar[idx];
+    rinexFormatInt(id + 1, prn, 2, '0');
+    id[3] = 0;
+    return true;
+}
+
+const char* rinexObsCode(uint8_t code)
+{
+    if (code == 0 || code >= _ARRAY_ELEMENT_COUNT(s_obsCodes))
+    {
+        return NULLPTR;
+    }
+    return s_obsCodes[code];
+}
+
+uint8_t rinexObsCodeIndex(const char* code)
+{
+    if (code == NULLPTR || code[0] == 0)
+    {
+        return 0;
+    }
+    for (uint8_t i = 1; i < _ARRAY_ELEMENT_COUNT(s_obsCodes); i++)
+    {
+        if (s_obsCodes[i][0] == code[0] && s_obsCodes[i][1] == code[1])
+        {
+            return i;
+        }
+    }
+    return 0;
+}
+
+// Round to the 1e-7 s resolution of RINEX epochs and split into calendar date and time
+static void timeToEpoch(gtime_t t, int ep[5], double *sec)
+{
+    double s = floor(t.sec * 1e7 + 0.5) * 1e-7;
+    if (s >= 1.0)
+    {
+        t.time++;
+        s -= 1.0;
+    }
+
+    int64_t days = (int64_t)t.time / 86400;
+    int64_t sod = (int64_t)t.time - days * 86400;
+    if (sod < 0)
+    {
+        sod += 86400;
+        days--;
+    }
+
+    // Civil date from days since 1970-01-01
+    int64_t z = days + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    int64_t d = doy - (153 * mp + 2) / 5 + 1;
+    int64_t m = mp < 10 ? mp + 3 : mp - 9;
+    ep[0] = (int)(yoe + era * 400 + (m <= 2));
+    ep[1] = (int)m;
+    ep[2] = (int)d;
+    ep[3] = (int)(sod / 3600);
+    ep[4] = (int)((sod % 3600) / 60);
+    *sec = (double)(sod % 60) + s;
+}
+
+static gtime_t gpst2utc(gtime_t t)
+{
+    // Leap seconds looked up at the GPS time are off by at most one second for a few seconds after a leap second
+    return IStimeadd(t, -IStimediff(ISutc2gpst(t), t));
+}
+
+static void headerLine(cRinexOutBuffer& out, const char* content, const char* label)
+{
+    char* p = out.Reserve(82);
+    int len = (int)_MIN(strlen(content), (size_t)60);
+    memcpy(p, content, len);
+    memset(p + len, ' ', 60 - len);
+    p += 60;
+    len = (int)_MIN(strlen(label), (size_t)20);
+    memcpy(p, label, len);
+    memset(p + len, ' ', 20 - len);
+    p += 20;
+    *p++ = '\n';
+    out.Commit(p);
+}
+
+static string currentUtcString()
+{
+    char buf[32];
+    time_t now = time(NULLPTR);
+    struct tm tmUtc;
+#if PLATFORM_IS_WINDOWS
+    gmtime_s(&tmUtc, &now);
+#else
+    gmtime_r(&now, &tmUtc);
+#endif
+    strftime(buf, sizeof(buf), "%Y%m%d %H%M%S UTC", &tmUtc);
+    return buf;
+}
+
+static void pgmRunByLine(cRinexOutBuffer& out, const string& runBy)
+{
+    char line[64];
+    snprintf(line, sizeof(line), "%-20.20s%-20.20s%-20.20s", "IS-SDK", runBy.c_str(), currentUtcString().c_str());
+    headerLine(out, line, "PGM / RUN BY / DATE");
+}
+
+//////////////////////////////////////////////////////////////////////////
+// cRinexOutBuffer
+//////////////////////////////////////////////////////////////////////////
+
+char* cRinexOutBuffer::Reserve(int n)
+{
+    if (m_size + n > RINEX_OUT_BUF_SIZE)
+    {
+        Flush();
+    }
+    return m_buf + m_size;
+}
+
+void cRinexOutBuffer::Write(const char* str, int len)
+{
+    char* p = Reserve(len);
+    memcpy(p, str, len);
+    Commit(p + len);
+}
+
+bool cRinexOutBuffer::Flush()
+{
+    if (m_size == 0 || m_file == NULLPTR)
+    {
+        return true;
+    }
+    size_t n = m_file->write(m_buf, m_size);
+    m_bytesWritten += m_size;
+    m_size = 0;
+    return n > 0 && m_file->good();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// cRinexObsWriter
+//////////////////////////////////////////////////////////////////////////
+
+cRinexObsWriter::cRinexObsWriter()
+{
+    memset(m_codes, 0, sizeof(m_codes));
+}
+
+cRinexObsWriter::~cRinexObsWriter()
+{
+    Close();
+}
+
+bool cRinexObsWriter::Open(const string& filename)
+{
+    Close();
+
+    m_filename = filename;
+    m_spoolFilename = filename + ".tmp";
+    m_spool = CreateISLogFile(m_spoolFilename, "wb");
+    if (!m_spool->isOpened())
+    {
+        CloseISLogFile(m_spool);
+        return false;
+    }
+    m_out.SetFile(m_spool);
+
+    memset(m_codes, 0, sizeof(m_codes));
+    m_epochObsCount = 0;
+    m_epochCount = 0;
+    m_obsCount = 0;
+    m_timeFirst = m_timeLast = gtime_t{};
+    return true;
+}
+
+void cRinexObsWriter::AddObservations(const obsd_t* obs, int count)
+{
+    if (m_spool == NULLPTR)
+    {
+        return;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        const obsd_t &o = obs[i];
+        if (m_epochObsCount > 0 && fabs(IStimediff(o.time, m_epoch[0].time)) > RINEX_DTTOL)
+        {   // New epoch
+            FlushEpoch();
+        }
+        if (m_epochObsCount >= RINEX_MAX_EPOCH_OBS)
+        {
+            FlushEpoch();
+        }
+        m_epoch[m_epochObsCount++] = o;
+    }
+}
+
+int cRinexObsWriter::CodeIndex(int sysIdx, uint8_t code)
+{
+    sSysCodes &c = m_codes[sysIdx];
+    for (int i = 0; i < c.count; i++)
+    {
+        if (c.code[i] == code)
+        {
+            return i;
+        }
+    }
+    if (c.count >= RINEX_MAX_CODES_PER_SYS || rinexObsCode(code) == NULLPTR)
+    {
+        return -1;
+    }
+    // New types are only ever appended so records already written stay consistent with the final header
+    c.code[c.count] = code;
+    return c.count++;
+}
+
+void cRinexObsWriter::WriteSatellite(const obsd_t& o, int sysIdx)
+{
+    // Register any new signal codes
+    int maxIndex = -1;
+    for (int f = 0; f < NFREQ + NEXOBS; f++)
+    {
+        if (o.code[f])
+        {
+            maxIndex = _MAX(maxIndex, CodeIndex(sysIdx, o.code[f]));
+        }
+    }
+    if (maxIndex < 0)
+    {
+        return;
+    }
+
+    sSysCodes &c = m_codes[sysIdx];
+    char* p = m_out.Reserve(4 + 4 * RINEX_OBS_FIELD_WIDTH * RINEX_MAX_CODES_PER_SYS);
+    rinexSatId(o.sat, p);
+    p += 3;
+
+    // Only write columns up to the last signal present.  Trailing blank fields are optional.
+    for (int j = 0; j <= maxIndex && j < c.count; j++)
+    {
+        int f;
+        for (f = 0; f < NFREQ + NEXOBS && o.code[f] != c.code[j]; f++) {}
+        if (f >= NFREQ + NEXOBS)
+        {
+            p = blankField(p, 4 * RINEX_OBS_FIELD_WIDTH);
+            continue;
+        }
+
+        // C (pseudorange)
+        if (o.P[f] == 0.0 || fabs(o.P[f]) >= 1e9)   { p = blankField(p, RINEX_OBS_FIELD_WIDTH); }
+        else                                        { p = rinexFormatFixed(p, o.P[f], 14, 3); *p++ = ' '; *p++ = ' '; }
+
+        // L (carrier phase) with loss of lock indicator
+        if (o.L[f] == 0.0 || fabs(o.L[f]) >= 1e9)   { p = blankField(p, RINEX_OBS_FIELD_WIDTH); }
+        else
+        {
+            p = rinexFormatFixed(p, o.L[f], 14, 3);
+            *p++ = (o.LLI[f] ? (char)('0' + (o.LLI[f] & 0x07)) : ' ');
+            *p++ = ' ';
+        }
+
+        // D (doppler)
+        if (o.D[f] == 0.0f)                         { p = blankField(p, RINEX_OBS_FIELD_WIDTH); }
+        else                                        { p = rinexFormatFixed(p, o.D[f], 14, 3); *p++ = ' '; *p++ = ' '; }
+
+        // S (signal strength, 0.25 dB-Hz units)
+        if (o.SNR[f] == 0)                          { p = blankField(p, RINEX_OBS_FIELD_WIDTH); }
+        else                                        { p = rinexFormatFixed(p, o.SNR[f] * 0.25, 14, 3); *p++ = ' '; *p++ = ' '; }
+    }
+    *p++ = '\n';
+    m_out.Commit(p);
+}
+
+void cRinexObsWriter::FlushEpoch()
+{
+    if (m_epochObsCount == 0)
+    {
+        return;
+    }
+
+    std::sort(m_epoch, m_epoch + m_epochObsCount, [](const obsd_t& a, const obsd_t& b) { return a.sat < b.sat; });
+
+    // Count valid satellites for the epoch record
+    int satCount = 0;
+    for (int i = 0; i < m_epochObsCount; i++)
+    {
+        int idx = sysIndex(rinexSatSys(m_epoch[i].sat, NULLPTR));
+        if (idx >= 0 && (i == 0 || m_epoch[i].sat != m_epoch[i - 1].sat))
+        {
+            satCount++;
+        }
+    }
+    if (satCount == 0)
+    {
+        m_epochObsCount = 0;
+        return;
+    }
+
+    // > yyyy mm dd hh mm ss.sssssss  f nnn
+    int ep[5];
+    double sec;
+    timeToEpoch(m_epoch[0].time, ep, &sec);
+    char* p = m_out.Reserve(48);
+    *p++ = '>';
+    *p++ = ' ';
+    p = rinexFormatInt(p, ep[0], 4, '0');
+    for (int i = 1; i < 5; i++)
+    {
+        *p++ = ' ';
+        p = rinexFormatInt(p, ep[i], 2, '0');
+    }
+    p = rinexFormatFixed(p, sec, 11, 7);
+    *p++ = ' ';
+    *p++ = ' ';
+    *p++ = '0';
+    p = rinexFormatInt(p, satCount, 3);
+    *p++ = '\n';
+    m_out.Commit(p);
+
+    for (int i = 0; i < m_epochObsCount; i++)
+    {
+        int idx = sysIndex(rinexSatSys(m_epoch[i].sat, NULLPTR));
+        if (idx < 0 || (i > 0 && m_epoch[i].sat == m_epoch[i - 1].sat))
+        {   // Unknown or duplicate satellite
+            continue;
+        }
+        WriteSatellite(m_epoch[i], idx);
+        m_obsCount++;
+    }
+
+    if (m_epochCount == 0)
+    {
+        m_timeFirst = m_epoch[0].time;
+    }
+    m_timeLast = m_epoch[0].time;
+    m_epochCount++;
+    m_epochObsCount = 0;
+}
+
+bool cRinexObsWriter::WriteHeader(cISLogFileBase* file)
+{
+    m_out.SetFile(file);
+
+    char line[96];
+    snprintf(line, sizeof(line), "%9.9s%11s%-20s%-20s", RINEX_VERSION_STR, "", "OBSERVATION DATA", "M: Mixed");
+    headerLine(m_out, line, "RINEX VERSION / TYPE");
+    pgmRunByLine(m_out, m_info.runBy);
+    headerLine(m_out, m_info.markerName.c_str(), "MARKER NAME");
+    headerLine(m_out, "", "OBSERVER / AGENCY");
+    snprintf(line, sizeof(line), "%-20.20s%-20.20s%-20.20s", m_info.receiverNumber.c_str(), m_info.receiverType.c_str(), m_info.receiverVersion.c_str());
+    headerLine(m_out, line, "REC # / TYPE / VERS");
+    headerLine(m_out, "", "ANT # / TYPE");
+
+    char* p = line;
+    for (int i = 0; i < 3; i++) { p = rinexFormatFixed(p, m_info.approxPosEcef[i], 14, 4); }
+    *p = 0;
+    headerLine(m_out, line, "APPROX POSITION XYZ");
+    p = line;
+    for (int i = 0; i < 3; i++) { p = rinexFormatFixed(p, m_info.antennaDeltaHen[i], 14, 4); }
+    *p = 0;
+    headerLine(m_out, line, "ANTENNA: DELTA H/E/N");
+
+    // Observation types, 13 per line
+    static const char s_types[] = "CLDS";
+    for (int s = 0; s < RINEX_SYS_COUNT; s++)
+    {
+        sSysCodes &c = m_codes[s];
+        if (c.count == 0)
+        {
+            continue;
+        }
+        int n = c.count * 4;
+        p = line;
+        *p++ = s_sysChar[s];
+        *p++ = ' ';
+        *p++ = ' ';
+        p = rinexFormatInt(p, n, 3);
+        for (int i = 0; i < n; i++)
+        {
+            if (i > 0 && i % 13 == 0)
+            {
+                *p = 0;
+                headerLine(m_out, line, "SYS / # / OBS TYPES");
+                p = blankField(line, 6);
+            }
+            const char* code = rinexObsCode(c.code[i / 4]);
+            *p++ = ' ';
+            *p++ = s_types[i % 4];
+            *p++ = code[0];
+            *p++ = code[1];
+        }
+        *p = 0;
+        headerLine(m_out, line, "SYS / # / OBS TYPES");
+    }
+
+    // Time of first and last observation
+    const char* labels[2] = { "TIME OF FIRST OBS", "TIME OF LAST OBS" };
+    gtime_t times[2] = { m_timeFirst, m_timeLast };
+    for (int t = 0; t < 2 && m_epochCount; t++)
+    {
+        int ep[5];
+        double sec;
+        timeToEpoch(times[t], ep, &sec);
+        p = line;
+        for (int i = 0; i < 5; i++) { p = rinexFormatInt(p, ep[i], 6); }
+        p = rinexFormatFixed(p, sec, 13, 7);
+        memcpy(p, "     GPS", 8);
+        p[8] = 0;
+        headerLine(m_out, line, labels[t]);
+    }
+
+    // Phase shift corrections are not applied to the observations
+    for (int s = 0; s < RINEX_SYS_COUNT; s++)
+    {
+        for (int i = 0; i < m_codes[s].count; i++)
+        {
+            const char* code = rinexObsCode(m_codes[s].code[i]);
+            snprintf(line, sizeof(line), "%c L%c%c  0.00000", s_sysChar[s], code[0], code[1]);
+            headerLine(m_out, line, "SYS / PHASE SHIFT");
+        }
+    }
+
+    headerLine(m_out, "", "END OF HEADER");
+    return m_out.Flush();
+}
+
+bool cRinexObsWriter::Close()
+{
+    if (m_spool == NULLPTR)
+    {
+        return false;
+    }
+
+    FlushEpoch();
+    bool ok = m_out.Flush();
+    CloseISLogFile(m_spool);
+
+    // Final file = header + spooled records
+    cISLogFileBase* file = CreateISLogFile(m_filename, "wb");
+    cISLogFileBase* spool = CreateISLogFile(m_spoolFilename, "rb");
+    if (file->isOpened() && spool->isOpened())
+    {
+        ok = WriteHeader(file) && ok;
+        size_t n;
+        do
+        {
+            char* p = m_out.Reserve(RINEX_OUT_BUF_SIZE);
+            n = spool->read(p, RINEX_OUT_BUF_SIZE);
+            m_out.Commit(p + n);
+            ok = m_out.Flush() && ok;
+        } while (n > 0);
+    }
+    else
+    {
+        ok = false;
+    }
+    m_out.SetFile(NULLPTR);
+    CloseISLogFile(spool);
+    CloseISLogFile(file);
+    ISFileManager::DeleteFile(m_spoolFilename);
+    return ok;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// cRinexNavWriter
+//////////////////////////////////////////////////////////////////////////
+
+cRinexNavWriter::cRinexNavWriter()
+{
+    memset(m_last, 0, sizeof(m_last));
+}
+
+cRinexNavWriter::~cRinexNavWriter()
+{
+    Close();
+}
+
+bool cRinexNavWriter::Open(const string& filename, const string& runBy)
+{
+    Close();
+
+    m_file = CreateISLogFile(filename, "wb");
+    if (!m_file->isOpened())
+    {
+        CloseISLogFile(m_file);
+        return false;
+    }
+    m_out.SetFile(m_file);
+    memset(m_last, 0, sizeof(m_last));
+    m_ephCount = 0;
+
+    char line[96];
+    snprintf(line, sizeof(line), "%9.9s%11s%-20s%-20s", RINEX_VERSION_STR, "", "N: GNSS NAV DATA", "M: MIXED");
+    headerLine(m_out, line, "RINEX VERSION / TYPE");
+    pgmRunByLine(m_out, runBy);
+    headerLine(m_out, "", "END OF HEADER");
+    return true;
+}
+
+bool cRinexNavWriter::Close()
+{
+    if (m_file == NULLPTR)
+    {
+        return false;
+    }
+    bool ok = m_out.Flush();
+    m_out.SetFile(NULLPTR);
+    CloseISLogFile(m_file);
+    return ok;
+}
+
+void cRinexNavWriter::WriteEpoch(char id[4], gtime_t t)
+{
+    int ep[5];
+    double sec;
+    timeToEpoch(t, ep, &sec);
+
+    char* p = m_out.Reserve(32);
+    memcpy(p, id, 3);
+    p += 3;
+    *p++ = ' ';
+    p = rinexFormatInt(p, ep[0], 4, '0');
+    for (int i = 1; i < 5; i++)
+    {
+        *p++ = ' ';
+        p = rinexFormatInt(p, ep[i], 2, '0');
+    }
+    *p++ = ' ';
+    p = rinexFormatInt(p, (int)sec, 2, '0');
+    m_out.Commit(p);
+}
+
+void cRinexNavWriter::WriteLine(double a, double b, double c, double d, int count)
+{
+    double v[4] = { a, b, c, d };
+    char* p = m_out.Reserve(4 + 4 * RINEX_NAV_FIELD_WIDTH + 1);
+    p = blankField(p, 4);
+    for (int i = 0; i < count; i++)
+    {
+        p = rinexFormatExp(p, v[i], RINEX_NAV_FIELD_WIDTH, 12);
+    }
+    *p++ = '\n';
+    m_out.Commit(p);
+}
+
+bool cRinexNavWriter::AddEphemeris(const eph_t& eph)
+{
+    char id[4];
+    int prn;
+    int sys = rinexSatSys(eph.sat, &prn);
+    if (m_file == NULLPTR || sys == SYS_GLO || !rinexSatId(eph.sat, id))
+    {
+        return false;
+    }
+    if (m_last[eph.sat].iode == eph.iode && m_last[eph.sat].toe == (int64_t)eph.toe.time)
+    {   // Already written
+        return false;
+    }
+    m_last[eph.sat].iode = eph.iode;
+    m_last[eph.sat].toe = (int64_t)eph.toe.time;
+
+    // Time system: BeiDou records use BDT, everything else GPST
+    gtime_t toc = eph.toc;
+    gtime_t ttr = eph.ttr;
+    int week;
+    IStime2gpst(eph.toe, &week);
+    if (sys == SYS_CMP)
+    {
+        toc = IStimeadd(toc, -GPS_BDT_OFFSET_SEC);
+        ttr = IStimeadd(ttr, -GPS_BDT_OFFSET_SEC);
+        IStime2gpst(IStimeadd(eph.toe, -GPS_BDT_OFFSET_SEC), &week);
+        week -= GPS_BDT_WEEK_OFFSET;
+    }
+    int ttrWeek;
+    double ttrTow = IStime2gpst(ttr, &ttrWeek);
+    ttrTow += (ttrWeek - week - (sys == SYS_CMP ? GPS_BDT_WEEK_OFFSET : 0)) * 604800.0;
+
+    // SV accuracy in meters: Galileo signal in space accuracy (SISA) or GPS/QZS/BDS URA index
+    double sva;
+    if (sys == SYS_GAL)
+    {
+        int i = eph.sva;
+        if      (i <= 49)   sva = i * 0.01;
+        else if (i <= 74)   sva = 0.5 + (i - 50) * 0.02;
+        else if (i <= 99)   sva = 1.0 + (i - 75) * 0.04;
+        else if (i <= 125)  sva = 2.0 + (i - 100) * 0.16;
+        else                sva = -1.0;
+    }
+    else
+    {
+        sva = (eph.sva >= 0 && eph.sva < (int)_ARRAY_ELEMENT_COUNT(s_uraValue)) ? s_uraValue[eph.sva] : 6144.0;
+    }
+
+    WriteEpoch(id, toc);
+    char* p = m_out.Reserve(3 * RINEX_NAV_FIELD_WIDTH + 1);
+    p = rinexFormatExp(p, eph.f0, RINEX_NAV_FIELD_WIDTH, 12);
+    p = rinexFormatExp(p, eph.f1, RINEX_NAV_FIELD_WIDTH, 12);
+    p = rinexFormatExp(p, eph.f2, RINEX_NAV_FIELD_WIDTH, 12);
+    *p++ = '\n';
+    m_out.Commit(p);
+
+    WriteLine(eph.iode, eph.crs, eph.deln, eph.M0);
+    WriteLine(eph.cuc, eph.e, eph.cus, sqrt(eph.A));
+    WriteLine(eph.toes, eph.cic, eph.OMG0, eph.cis);
+    WriteLine(eph.i0, eph.crc, eph.omg, eph.OMGd);
+    WriteLine(eph.idot, eph.code, week, eph.flag);
+    switch (sys)
+    {
+    case SYS_GAL:   WriteLine(sva, eph.svh, eph.tgd[0], eph.tgd[1]);    WriteLine(ttrTow, 0, 0, 0, 1);          break;
+    case SYS_CMP:   WriteLine(sva, eph.svh, eph.tgd[0], eph.tgd[1]);    WriteLine(ttrTow, eph.iodc, 0, 0, 2);   break;
+    default:        WriteLine(sva, eph.svh, eph.tgd[0], eph.iodc);      WriteLine(ttrTow, eph.fit, 0, 0, 2);    break;
+    }
+
+    m_ephCount++;
+    return true;
+}
+
+bool cRinexNavWriter::AddGlonassEphemeris(const geph_t& geph)
+{
+    char id[4];
+    if (m_file == NULLPTR || rinexSatSys(geph.sat, NULLPTR) != SYS_GLO || !rinexSatId(geph.sat, id))
+    {
+        return false;
+    }
+    if (m_last[geph.sat].iode == geph.iode && m_last[geph.sat].toe == (int64_t)geph.toe.time)
+    {   // Already written
+        return false;
+    }
+    m_last[geph.sat].iode = geph.iode;
+    m_last[geph.sat].toe = (int64_t)geph.toe.time;
+
+    // GLONASS records are referenced to UTC
+    gtime_t toc = gpst2utc(geph.toe);
+    double tof = IStime2gpst(gpst2utc(geph.tof), NULLPTR);
+
+    WriteEpoch(id, toc);
+    char* p = m_out.Reserve(3 * RINEX_NAV_FIELD_WIDTH + 1);
+    p = rinexFormatExp(p, -geph.taun, RINEX_NAV_FIELD_WIDTH, 12);
+    p = rinexFormatExp(p, geph.gamn, RINEX_NAV_FIELD_WIDTH, 12);
+    p = rinexFormatExp(p, tof, RINEX_NAV_FIELD_WIDTH, 12);
+    *p++ = '\n';
+    m_out.Commit(p);
+
+    // Position, velocity and acceleration in km, km/s and km/s^2
+    WriteLine(geph.pos[0] * 1e-3, geph.vel[0] * 1e-3, geph.acc[0] * 1e-3, geph.svh);
+    WriteLine(geph.pos[1] * 1e-3, geph.vel[1] * 1e-3, geph.acc[1] * 1e-3, geph.frq);
+    WriteLine(geph.pos[2] * 1e-3, geph.vel[2] * 1e-3, geph.acc[2] * 1e-3, geph.age);
+
+    m_ephCount++;
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// cRinexExporter
+//////////////////////////////////////////////////////////////////////////
+
+struct sRinexJob
+{
+    std::shared_ptr<cDeviceLog> devLog;
+    bool checkHeader;
+    std::string filePrefix;
+    cRinexExporter::sStats stats;
+    bool ok = true;
+};
+
+static const char* rawReceiverName(uint32_t did)
+{
+    switch (did)
+    {
+    case DID_GPS1_RAW:      return "GPS1";
+    case DID_GPS2_RAW:      return "GPS2";
+    default:                return "BASE";
+    }
+}
+
+static void exportDevice(sRinexJob& job, const cRinexExporter::sOptions& options)
+{
+    cRinexObsWriter obsWriter[3];       // GPS1, GPS2, BASE
+    cRinexNavWriter navWriter;
+    dev_info_t devInfo = {};
+    string serial = to_string(job.devLog->SerialNumber());
+
+    p_data_buf_t* data;
+    while ((data = job.devLog->ReadData()) != NULLPTR)
+    {
+        job.stats.packets++;
+        if (job.checkHeader && cISLogger::isHeaderCorrupt(&data->hdr))
+        {
+            continue;
+        }
+
+        uint32_t did = data->hdr.id;
+        if (did == DID_DEV_INFO)
+        {
+            copyDataPToStructP2(&devInfo, &data->hdr, data->buf, sizeof(dev_info_t));
+            continue;
+        }
+
+        int w;
+        switch (did)
+        {
+        case DID_GPS1_RAW:      w = 0;  break;
+        case DID_GPS2_RAW:      w = 1;  break;
+        case DID_GPS_BASE_RAW:  w = 2;  break;
+        default:                continue;
+        }
+
+        // gps_raw_t is always sent whole
+        const int rawHdrSize = offsetof(gps_raw_t, data);
+        if (data->hdr.offset != 0 || data->hdr.size < (uint32_t)rawHdrSize)
+        {
+            continue;
+        }
+        const gps_raw_t* raw = (const gps_raw_t*)data->buf;
+        int payload = (int)data->hdr.size - rawHdrSize;
+
+        switch (raw->dataType)
+        {
+        case raw_data_type_observation:
+            if (options.writeObs)
+            {
+                if (!obsWriter[w].IsOpen() && !obsWriter[w].Open(options.outputDirectory + "/" + job.filePrefix + "_" + rawReceiverName(did) + ".obs"))
+                {
+                    job.ok = false;
+                    return;
+                }
+                int count = _MIN((int)raw->obsCount, _MIN((int)MAX_OBSERVATION_COUNT_IN_RTK_MESSAGE, payload / (int)sizeof(obsd_t)));
+                obsWriter[w].AddObservations(raw->data.obs, count);
+            }
+            break;
+
+        case raw_data_type_ephemeris:
+        case raw_data_type_glonass_ephemeris:
+            if (options.writeNav)
+            {
+                if (!navWriter.IsOpen() && !navWriter.Open(options.outputDirectory + "/" + job.filePrefix + ".nav"))
+                {
+                    job.ok = false;
+                    return;
+                }
+                if (raw->dataType == raw_data_type_ephemeris && payload >= (int)sizeof(eph_t))
+                {
+                    navWriter.AddEphemeris(raw->data.eph);
+                }
+                else if (raw->dataType == raw_data_type_glonass_ephemeris && payload >= (int)sizeof(geph_t))
+                {
+                    navWriter.AddGlonassEphemeris(raw->data.gloEph);
+                }
+            }
+            break;
+
+        case raw_data_type_base_station_antenna_position:
+            if (payload >= (int)sizeof(sta_t))
+            {
+                sRinexHeaderInfo& info = obsWriter[w].HeaderInfo();
+                for (int i = 0; i < 3; i++)
+                {
+                    info.approxPosEcef[i] = raw->data.sta.pos[i];
+                }
+                info.antennaDeltaHen[0] = raw->data.sta.hgt;
+            }
+            break;
+        }
+    }
+
+    // Header details only need to be known by close
+    char version[32];
+    snprintf(version, sizeof(version), "%d.%d.%d.%d", devInfo.firmwareVer[0], devInfo.firmwareVer[1], devInfo.firmwareVer[2], devInfo.firmwareVer[3]);
+    for (int w = 0; w < 3; w++)
+    {
+        if (!obsWriter[w].IsOpen())
+        {
+            continue;
+        }
+        sRinexHeaderInfo& info = obsWriter[w].HeaderInfo();
+        info.markerName = "SN" + serial;
+        info.receiverNumber = serial;
+        info.receiverType = devInfo.manufacturer[0] ? string(devInfo.manufacturer, strnlen(devInfo.manufacturer, DEVINFO_MANUFACTURER_STRLEN)) : "Inertial Sense";
+        info.receiverVersion = version;
+        job.ok = obsWriter[w].Close() && job.ok;
+        job.stats.epochs += obsWriter[w].EpochCount();
+        job.stats.observations += obsWriter[w].ObservationCount();
+        job.stats.bytesWritten += obsWriter[w].BytesWritten();
+    }
+    if (navWriter.IsOpen())
+    {
+        job.stats.ephemerides += navWriter.EphemerisCount();
+        job.stats.bytesWritten += navWriter.BytesWritten();
+        job.ok = navWriter.Close() && job.ok;
+    }
+}
+
+bool cRinexExporter::Export(const vector<string>& logDirectories, const sOptions& options, sStats* stats)
+{
+    auto startTime = chrono::steady_clock::now();
+
+    if (!ISFileManager::CreateDirectory(options.outputDirectory) && !ISFileManager::PathIsDir(options.outputDirectory))
+    {
+        return false;
+    }
+
+    // Load all logs.  Loggers must outlive the jobs that read from their device logs.
+    vector<unique_ptr<cISLogger>> loggers;
+    vector<sRinexJob> jobs;
+    for (const string& dir : logDirectories)
+    {
+        unique_ptr<cISLogger> logger(new cISLogger());
+        cISLogger::eLogType type = cISLogger::LOGTYPE_DAT;
+        bool loaded = false;
+        if (options.logType >= 0)
+        {
+            type = (cISLogger::eLogType)options.logType;
+            loaded = logger->LoadFromDirectory(dir, type, { "ALL" });
+        }
+        else
+        {
+            loaded = logger->LoadFromDirectory(dir, (type = cISLogger::LOGTYPE_DAT), { "ALL" }) ||
+                     logger->LoadFromDirectory(dir, (type = cISLogger::LOGTYPE_RAW), { "ALL" });
+        }
+        if (!loaded)
+        {
+            continue;
+        }
+
+        for (auto& devLog : logger->DeviceLogs())
+        {
+            sRinexJob job;
+            job.devLog = devLog;
+            job.checkHeader = (type != cISLogger::LOGTYPE_RAW);
+            job.filePrefix = "SN" + to_string(devLog->SerialNumber()) + (logger->TimeStamp().empty() ? "" : "_" + logger->TimeStamp());
+            jobs.push_back(job);
+        }
+        loggers.push_back(std::move(logger));
+    }
+    if (jobs.empty())
+    {
+        return false;
+    }
+
+    // Each device log owns its own files and parser so devices are independent
+    int threadCount = options.maxThreads > 0 ? options.maxThreads : (int)std::thread::hardware_concurrency();
+    threadCount = _CLAMP(threadCount, 1, (int)jobs.size());
+    std::atomic<size_t> nextJob(0);
+    auto worker = [&]()
+    {
+        size_t i;
+        while ((i = nextJob++) < jobs.size())
+        {
+            exportDevice(jobs[i], options);
+        }
+    };
+    vector<std::thread> threads;
+    for (int i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    bool ok = true;
+    sStats total;
+    for (auto& job : jobs)
+    {
+        ok = ok && job.ok;
+        total.packets += job.stats.packets;
+        total.epochs += job.stats.epochs;
+        total.observations += job.stats.observations;
+        total.ephemerides += job.stats.ephemerides;
+        total.bytesWritten += job.stats.bytesWritten;
+    }
+    total.devices = (uint32_t)jobs.size();
+    total.elapsedSec = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    if (stats)
+    {
+        *stats = total;
+    }
+    return ok;
+}
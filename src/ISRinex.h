@@ -0,0 +1,214 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef IS_RINEX_H
+#define IS_RINEX_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "ISConstants.h"
+#include "ISLogFileBase.h"
+#include "rtk_defines.h"
+
+extern "C"
+{
+#include "data_sets.h"
+}
+
+#define RINEX_VERSION_STR           "3.04"
+#define RINEX_MAX_EPOCH_OBS         128         // Max satellites buffered per epoch.  Larger epochs are split.
+#define RINEX_MAX_CODES_PER_SYS     8           // Max observation codes (signals) tracked per constellation
+#define RINEX_OUT_BUF_SIZE          (64 * 1024) // Output staging buffer.  File writes happen in blocks of this size.
+#define RINEX_MAX_SAT               (NSATGPS + NSATGLO + NSATGAL + NSATQZS + NSATCMP + NSATIRN + NSATLEO + NSATSBS)
+
+/**
+ * Number formatting used by the RINEX writers.  These replace printf on the hot path and match the output of
+ * "%*.*f" and "%*.*E" for the value ranges found in observation and ephemeris data.  Each writes exactly `width`
+ * characters (right justified) and returns a pointer to the character following the field.  Values that do not
+ * fit in the field are written as blanks, which RINEX readers treat as "no observation".
+ */
+char* rinexFormatInt(char* p, int64_t value, int width, char pad = ' ');
+char* rinexFormatFixed(char* p, double value, int width, int decimals);
+char* rinexFormatExp(char* p, double value, int width, int decimals);
+
+/** Convert RTKlib satellite number into constellation (SYS_GPS, SYS_GAL, ...) and PRN.  Returns SYS_NONE on error. */
+int rinexSatSys(int sat, int *prn);
+
+/** Write the three character RINEX satellite id (i.e. "G05", "E12") into id.  Returns false for unknown satellites. */
+bool rinexSatId(int sat, char id[4]);
+
+/** Two character RINEX observation code (i.e. "1C", "5Q") for an obsd_t::code value, or NULL if unknown. */
+const char* rinexObsCode(uint8_t code);
+
+/** obsd_t::code value for a two character RINEX observation code (i.e. "1C", "5Q"), or 0 if unknown. */
+uint8_t rinexObsCodeIndex(const char* code);
+
+/** Information written into the RINEX observation header */
+struct sRinexHeaderInfo
+{
+    std::string markerName;
+    std::string receiverNumber;
+    std::string receiverType;
+    std::string receiverVersion;
+    std::string runBy;
+    double approxPosEcef[3] = {};           // (m) Approximate marker position
+    double antennaDeltaHen[3] = {};         // (m) Antenna height, east, north eccentricity
+};
+
+/**
+ * Fixed size output staging buffer.  Formatters write directly into the buffer and full blocks are handed to the
+ * underlying file, so a record never costs more than a memcpy-sized write.
+ */
+class cRinexOutBuffer
+{
+public:
+    cRinexOutBuffer() {}
+    ~cRinexOutBuffer() { Flush(); }
+
+    // Byte count restarts whenever a new file is attached
+    void SetFile(cISLogFileBase* file) { m_file = file; m_size = 0; if (file) { m_bytesWritten = 0; } }
+
+    // Ensure at least n contiguous bytes are available and return the write position
+    char* Reserve(int n);
+
+    // Mark n bytes written at the position returned by Reserve()
+    void Commit(char* end) { m_size = (int)(end - m_buf); }
+
+    void Write(const char* str, int len);
+    bool Flush();
+    uint64_t BytesWritten() { return m_bytesWritten + m_size; }
+
+private:
+    cISLogFileBase* m_file = NULLPTR;
+    char m_buf[RINEX_OUT_BUF_SIZE];
+    int m_size = 0;
+    uint64_t m_bytesWritten = 0;
+};
+
+/**
+ * Streaming RINEX 3 observation writer for one receiver.  Observations (obsd_t) are grouped into epochs using a
+ * fixed size buffer and written as soon as the epoch time changes.  The set of observation types per constellation
+ * is only known once all data is seen, so records are spooled to a temporary file and the header is prepended
+ * when the writer is closed.  Memory use does not depend on log length.
+ */
+class cRinexObsWriter
+{
+public:
+    cRinexObsWriter();
+    ~cRinexObsWriter();
+
+    bool Open(const std::string& filename);
+    bool Close();
+    bool IsOpen() { return m_spool != NULLPTR; }
+
+    // Header content can be updated any time before Close()
+    sRinexHeaderInfo& HeaderInfo() { return m_info; }
+
+    // Add observations.  Observations for one epoch may be split across several calls.
+    void AddObservations(const obsd_t* obs, int count);
+
+    uint64_t EpochCount() { return m_epochCount; }
+    uint64_t ObservationCount() { return m_obsCount; }
+    uint64_t BytesWritten() { return m_out.BytesWritten(); }
+
+private:
+    struct sSysCodes
+    {
+        uint8_t code[RINEX_MAX_CODES_PER_SYS];
+        int count;
+    };
+
+    void FlushEpoch();
+    void WriteSatellite(const obsd_t& obs, int sysIndex);
+    int  CodeIndex(int sysIndex, uint8_t code);
+    bool WriteHeader(cISLogFileBase* file);
+
+    std::string m_filename;
+    std::string m_spoolFilename;
+    cISLogFileBase* m_spool = NULLPTR;
+    cRinexOutBuffer m_out;
+    sRinexHeaderInfo m_info;
+
+    obsd_t m_epoch[RINEX_MAX_EPOCH_OBS];
+    int m_epochObsCount = 0;
+    sSysCodes m_codes[8];
+    gtime_t m_timeFirst = {};
+    gtime_t m_timeLast = {};
+    uint64_t m_epochCount = 0;
+    uint64_t m_obsCount = 0;
+};
+
+/**
+ * Streaming RINEX 3 mixed navigation writer.  Ephemerides are rebroadcast continuously by the receiver so each
+ * satellite's last written issue is remembered and duplicates are dropped.
+ */
+class cRinexNavWriter
+{
+public:
+    cRinexNavWriter();
+    ~cRinexNavWriter();
+
+    bool Open(const std::string& filename, const std::string& runBy = "");
+    bool Close();
+    bool IsOpen() { return m_file != NULLPTR; }
+
+    bool AddEphemeris(const eph_t& eph);
+    bool AddGlonassEphemeris(const geph_t& geph);
+
+    uint64_t EphemerisCount() { return m_ephCount; }
+    uint64_t BytesWritten() { return m_out.BytesWritten(); }
+
+private:
+    void WriteEpoch(char id[4], gtime_t t);
+    void WriteLine(double a, double b, double c, double d, int count = 4);
+
+    cISLogFileBase* m_file = NULLPTR;
+    cRinexOutBuffer m_out;
+    struct { int32_t iode; int64_t toe; } m_last[RINEX_MAX_SAT + 1];
+    uint64_t m_ephCount = 0;
+};
+
+/**
+ * Convert raw GNSS data (DID_GPS1_RAW, DID_GPS2_RAW, DID_GPS_BASE_RAW) in one or more logs into RINEX 3 OBS and NAV
+ * files.  Every device in every log is processed on its own worker thread, writing one .obs file per receiver and
+ * one .nav file per device into the output directory.
+ */
+class cRinexExporter
+{
+public:
+    struct sOptions
+    {
+        std::string outputDirectory = "rinex";
+        bool writeObs = true;
+        bool writeNav = true;
+        int maxThreads = 0;                 // 0 = hardware concurrency
+        int logType = -1;                   // cISLogger::eLogType.  -1 = try .dat then .raw
+    };
+
+    struct sStats
+    {
+        uint64_t packets = 0;
+        uint64_t epochs = 0;
+        uint64_t observations = 0;
+        uint64_t ephemerides = 0;
+        uint64_t bytesWritten = 0;
+        uint32_t devices = 0;
+        double elapsedSec = 0;
+    };
+
+    // Returns false if no log could be loaded or an output file could not be created
+    static bool Export(const std::vector<std::string>& logDirectories, const sOptions& options, sStats* stats = NULLPTR);
+};
+
+#endif // IS_RINEX_H
@@ -0,0 +1,824 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <math.h>
+#include <string.h>
+#include <stddef.h>
+
+#include "ISRtcm3.h"
+#include "ISClock.h"
+#include "ISEarth.h"
+
+extern "C"
+{
+#include "ISComm.h"
+}
+
+#define CLIGHT          299792458.0         // (m/s) Speed of light
+#define RANGE_MS        (CLIGHT * 0.001)    // (m) Range in 1 ms
+#define SC2RAD          3.1415926535898     // Semi-circle to radian (GPS ICD value of pi)
+#define MOSCOW_UTC_SEC  10800.0             // (s) GLONASS time is UTC + 3 h
+#define BDT_GPST_SEC    14.0                // (s) GPS time - BeiDou time
+
+// Bit field encoding
+enum eRtcm3Enc
+{
+    ENC_U,                                  // Unsigned
+    ENC_S,                                  // Two's complement
+    ENC_SM,                                 // Sign magnitude (GLONASS)
+};
+
+// Bit field destination
+enum eRtcm3Dst
+{
+    DST_NONE,                               // Reserved or unused bits
+    DST_I32,                                // int32_t member
+    DST_F64,                                // double member
+    DST_TMP,                                // Temporary value used to compute a member
+};
+
+/** Message field.  Value = raw * scale, written to the member at offset or to temporary index. */
+struct sRtcm3Field
+{
+    uint8_t bits;
+    uint8_t enc;
+    uint8_t dst;
+    uint16_t offset;
+    double scale;
+};
+
+#define RF_SKIP(bits)                           { bits, ENC_U, DST_NONE, 0, 0.0 }
+#define RF_INT(bits, enc, type, member)         { bits, enc, DST_I32, (uint16_t)offsetof(type, member), 1.0 }
+#define RF_DBL(bits, enc, type, member, scale)  { bits, enc, DST_F64, (uint16_t)offsetof(type, member), scale }
+#define RF_TMP(bits, enc, index, scale)         { bits, enc, DST_TMP, index, scale }
+
+/** MSM field, decoded for every satellite or every cell before the next field starts */
+struct sRtcm3MsmField
+{
+    uint8_t bits;
+    uint8_t enc;
+    uint8_t index;
+    uint8_t hasInvalid;                     // Max unsigned or min signed raw value means "not available"
+    double scale;
+};
+
+enum eMsmSatField   { SAT_RR_INT, SAT_EXT, SAT_RR_MOD, SAT_RATE, SAT_FIELD_COUNT };
+enum eMsmCellField  { CELL_PR, CELL_CP, CELL_LOCK, CELL_HALF, CELL_CNR, CELL_RATE, CELL_FIELD_COUNT };
+
+//////////////////////////////////////////////////////////////////////////
+// Message tables (RTCM 10403.3)
+//////////////////////////////////////////////////////////////////////////
+
+enum { T_STAID, T_PRN, T_WEEK, T_TOC, T_SQRTA, T_FIT, T_FRQ, T_TKH, T_TKM, T_TKS, T_BN, T_TB, T_HEIGHT, T_COUNT };
+
+// 1005/1006 stationary RTK reference station ARP
+static const sRtcm3Field s_msg1005[] = {
+    RF_TMP(12, ENC_U, T_STAID, 1.0),
+    RF_SKIP(6 + 1 + 1 + 1 + 1),             // ITRF year, GPS/GLO/GAL indicators, reference station indicator
+    RF_DBL(38, ENC_S, sta_t, pos[0], 0.0001),
+    RF_SKIP(2),                             // Single receiver oscillator, reserved
+    RF_DBL(38, ENC_S, sta_t, pos[1], 0.0001),
+    RF_SKIP(2),                             // Quarter cycle indicator
+    RF_DBL(38, ENC_S, sta_t, pos[2], 0.0001),
+};
+static const sRtcm3Field s_msg1006[] = {
+    RF_TMP(16, ENC_U, T_HEIGHT, 0.0001),    // Antenna height, follows 1005 content
+};
+
+// 1019 GPS ephemeris
+static const sRtcm3Field s_msg1019[] = {
+    RF_TMP(6,  ENC_U, T_PRN, 1.0),
+    RF_TMP(10, ENC_U, T_WEEK, 1.0),
+    RF_INT(4,  ENC_U, eph_t, sva),
+    RF_INT(2,  ENC_U, eph_t, code),
+    RF_DBL(14, ENC_S, eph_t, idot, 0x1p-43 * SC2RAD),
+    RF_INT(8,  ENC_U, eph_t, iode),
+    RF_TMP(16, ENC_U, T_TOC, 16.0),
+    RF_DBL(8,  ENC_S, eph_t, f2, 0x1p-55),
+    RF_DBL(16, ENC_S, eph_t, f1, 0x1p-43),
+    RF_DBL(22, ENC_S, eph_t, f0, 0x1p-31),
+    RF_INT(10, ENC_U, eph_t, iodc),
+    RF_DBL(16, ENC_S, eph_t, crs, 0x1p-5),
+    RF_DBL(16, ENC_S, eph_t, deln, 0x1p-43 * SC2RAD),
+    RF_DBL(32, ENC_S, eph_t, M0, 0x1p-31 * SC2RAD),
+    RF_DBL(16, ENC_S, eph_t, cuc, 0x1p-29),
+    RF_DBL(32, ENC_U, eph_t, e, 0x1p-33),
+    RF_DBL(16, ENC_S, eph_t, cus, 0x1p-29),
+    RF_TMP(32, ENC_U, T_SQRTA, 0x1p-19),
+    RF_DBL(16, ENC_U, eph_t, toes, 16.0),
+    RF_DBL(16, ENC_S, eph_t, cic, 0x1p-29),
+    RF_DBL(32, ENC_S, eph_t, OMG0, 0x1p-31 * SC2RAD),
+    RF_DBL(16, ENC_S, eph_t, cis, 0x1p-29),
+    RF_DBL(32, ENC_S, eph_t, i0, 0x1p-31 * SC2RAD),
+    RF_DBL(16, ENC_S, eph_t, crc, 0x1p-5),
+    RF_DBL(32, ENC_S, eph_t, omg, 0x1p-31 * SC2RAD),
+    RF_DBL(24, ENC_S, eph_t, OMGd, 0x1p-43 * SC2RAD),
+    RF_DBL(8,  ENC_S, eph_t, tgd[0], 0x1p-31),
+    RF_INT(6,  ENC_U, eph_t, svh),
+    RF_INT(1,  ENC_U, eph_t, flag),
+    RF_TMP(1,  ENC_U, T_FIT, 1.0),
+};
+
+// 1020 GLONASS ephemeris.  Position, velocity and acceleration are in km.
+static const sRtcm3Field s_msg1020[] = {
+    RF_TMP(6,  ENC_U, T_PRN, 1.0),
+    RF_TMP(5,  ENC_U, T_FRQ, 1.0),
+    RF_SKIP(1 + 1 + 2),                     // Almanac health, health availability, P1
+    RF_TMP(5,  ENC_U, T_TKH, 3600.0),
+    RF_TMP(6,  ENC_U, T_TKM, 60.0),
+    RF_TMP(1,  ENC_U, T_TKS, 30.0),
+    RF_TMP(1,  ENC_U, T_BN, 1.0),
+    RF_SKIP(1),                             // P2
+    RF_TMP(7,  ENC_U, T_TB, 1.0),
+    RF_DBL(24, ENC_SM, geph_t, vel[0], 0x1p-20 * 1e3),
+    RF_DBL(27, ENC_SM, geph_t, pos[0], 0x1p-11 * 1e3),
+    RF_DBL(5,  ENC_SM, geph_t, acc[0], 0x1p-30 * 1e3),
+    RF_DBL(24, ENC_SM, geph_t, vel[1], 0x1p-20 * 1e3),
+    RF_DBL(27, ENC_SM, geph_t, pos[1], 0x1p-11 * 1e3),
+    RF_DBL(5,  ENC_SM, geph_t, acc[1], 0x1p-30 * 1e3),
+    RF_DBL(24, ENC_SM, geph_t, vel[2], 0x1p-20 * 1e3),
+    RF_DBL(27, ENC_SM, geph_t, pos[2], 0x1p-11 * 1e3),
+    RF_DBL(5,  ENC_SM, geph_t, acc[2], 0x1p-30 * 1e3),
+    RF_SKIP(1),                             // P3
+    RF_DBL(11, ENC_SM, geph_t, gamn, 0x1p-40),
+    RF_SKIP(2 + 1),                         // P, ln
+    RF_DBL(22, ENC_SM, geph_t, taun, 0x1p-30),
+    RF_DBL(5,  ENC_SM, geph_t, dtaun, 0x1p-30),
+    RF_INT(5,  ENC_U, geph_t, age),
+    RF_SKIP(1 + 4 + 11 + 2 + 1 + 11 + 32 + 5 + 22 + 1 + 7),    // P4, FT, NT, M, almanac, NA, tauc, N4, tauGPS, ln, reserved
+};
+
+// MSM satellite data
+static const sRtcm3MsmField s_msmSat46[] = {    // MSM4, MSM6
+    { 8,  ENC_U, SAT_RR_INT, 1, 1.0 },
+    { 10, ENC_U, SAT_RR_MOD, 0, 0x1p-10 },
+};
+static const sRtcm3MsmField s_msmSat57[] = {    // MSM5, MSM7
+    { 8,  ENC_U, SAT_RR_INT, 1, 1.0 },
+    { 4,  ENC_U, SAT_EXT,    0, 1.0 },
+    { 10, ENC_U, SAT_RR_MOD, 0, 0x1p-10 },
+    { 14, ENC_S, SAT_RATE,   1, 1.0 },
+};
+
+// MSM signal data
+static const sRtcm3MsmField s_msmCell4[] = {
+    { 15, ENC_S, CELL_PR,   1, 0x1p-24 },
+    { 22, ENC_S, CELL_CP,   1, 0x1p-29 },
+    { 4,  ENC_U, CELL_LOCK, 0, 1.0 },
+    { 1,  ENC_U, CELL_HALF, 0, 1.0 },
+    { 6,  ENC_U, CELL_CNR,  0, 1.0 },
+};
+static const sRtcm3MsmField s_msmCell5[] = {
+    { 15, ENC_S, CELL_PR,   1, 0x1p-24 },
+    { 22, ENC_S, CELL_CP,   1, 0x1p-29 },
+    { 4,  ENC_U, CELL_LOCK, 0, 1.0 },
+    { 1,  ENC_U, CELL_HALF, 0, 1.0 },
+    { 6,  ENC_U, CELL_CNR,  0, 1.0 },
+    { 15, ENC_S, CELL_RATE, 1, 0.0001 },
+};
+static const sRtcm3MsmField s_msmCell6[] = {
+    { 20, ENC_S, CELL_PR,   1, 0x1p-29 },
+    { 24, ENC_S, CELL_CP,   1, 0x1p-31 },
+    { 10, ENC_U, CELL_LOCK, 0, 1.0 },
+    { 1,  ENC_U, CELL_HALF, 0, 1.0 },
+    { 10, ENC_U, CELL_CNR,  0, 0x1p-4 },
+};
+static const sRtcm3MsmField s_msmCell7[] = {
+    { 20, ENC_S, CELL_PR,   1, 0x1p-29 },
+    { 24, ENC_S, CELL_CP,   1, 0x1p-31 },
+    { 10, ENC_U, CELL_LOCK, 0, 1.0 },
+    { 1,  ENC_U, CELL_HALF, 0, 1.0 },
+    { 10, ENC_U, CELL_CNR,  0, 0x1p-4 },
+    { 15, ENC_S, CELL_RATE, 1, 0.0001 },
+};
+
+struct sRtcm3MsmType
+{
+    const sRtcm3MsmField* sat;
+    int satCount;
+    const sRtcm3MsmField* cell;
+    int cellCount;
+    bool extendedLock;                      // 10 bit lock time indicator
+};
+
+static const sRtcm3MsmType s_msmTypes[4] = {
+    { s_msmSat46, _ARRAY_ELEMENT_COUNT(s_msmSat46), s_msmCell4, _ARRAY_ELEMENT_COUNT(s_msmCell4), false },
+    { s_msmSat57, _ARRAY_ELEMENT_COUNT(s_msmSat57), s_msmCell5, _ARRAY_ELEMENT_COUNT(s_msmCell5), false },
+    { s_msmSat46, _ARRAY_ELEMENT_COUNT(s_msmSat46), s_msmCell6, _ARRAY_ELEMENT_COUNT(s_msmCell6), true },
+    { s_msmSat57, _ARRAY_ELEMENT_COUNT(s_msmSat57), s_msmCell7, _ARRAY_ELEMENT_COUNT(s_msmCell7), true },
+};
+
+// MSM signal id (1-32) to RINEX observation code, by constellation.  Message 107x, 108x, ... 112x.
+static const int s_msmSys[6] = { SYS_GPS, SYS_GLO, SYS_GAL, SYS_SBS, SYS_QZS, SYS_CMP };
+static const char* s_msmSig[6][32] = {
+    {   // GPS
+        "" ,"1C","1P","1W","" ,"" ,"" ,"2C","2P","2W","" ,"" ,"" ,"" ,"2S","2L",
+        "2X","" ,"" ,"" ,"" ,"5I","5Q","5X","" ,"" ,"" ,"" ,"" ,"1S","1L","1X" },
+    {   // GLONASS
+        "" ,"1C","1P","" ,"" ,"" ,"" ,"2C","2P","" ,"" ,"" ,"" ,"" ,"" ,"" ,
+        "" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" },
+    {   // Galileo
+        "" ,"1C","1A","1B","1X","1Z","" ,"6C","6A","6B","6X","6Z","" ,"7I","7Q",
+        "7X","" ,"8I","8Q","8X","" ,"5I","5Q","5X","" ,"" ,"" ,"" ,"" ,"" ,"" ,"" },
+    {   // SBAS
+        "" ,"1C","" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,
+        "" ,"" ,"" ,"" ,"" ,"5I","5Q","5X","" ,"" ,"" ,"" ,"" ,"" ,"" ,"" },
+    {   // QZSS
+        "" ,"1C","" ,"" ,"" ,"" ,"" ,"" ,"6S","6L","6X","" ,"" ,"" ,"2S","2L",
+        "2X","" ,"" ,"" ,"" ,"5I","5Q","5X","" ,"" ,"" ,"" ,"" ,"1S","1L","1X" },
+    {   // BeiDou
+        "" ,"2I","2Q","2X","" ,"" ,"" ,"6I","6Q","6X","" ,"" ,"" ,"7I","7Q","7X",
+        "" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" ,"" },
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Helpers
+//////////////////////////////////////////////////////////////////////////
+
+static int64_t readBits(const uint8_t* buf, int pos, int bits, int enc)
+{
+    if (bits > 32)
+    {   // Two's complement only, i.e. 38 bit station coordinates
+        int hiBits = bits - 32;
+        int64_t hi = (enc == ENC_U) ? (int64_t)getBitsAsUInt32(buf, pos, hiBits) : (int64_t)getBitsAsInt32(buf, pos, hiBits);
+        return hi * 4294967296LL + getBitsAsUInt32(buf, pos + hiBits, 32);
+    }
+
+    switch (enc)
+    {
+    case ENC_S:     return getBitsAsInt32(buf, pos, bits);
+    case ENC_SM:
+        {
+            int64_t mag = getBitsAsUInt32(buf, pos + 1, bits - 1);
+            return getBitsAsUInt32(buf, pos, 1) ? -mag : mag;
+        }
+    default:        return getBitsAsUInt32(buf, pos, bits);
+    }
+}
+
+static int fieldBits(const sRtcm3Field* fields, int count)
+{
+    int bits = 0;
+    for (int i = 0; i < count; i++)
+    {
+        bits += fields[i].bits;
+    }
+    return bits;
+}
+
+/** Decode a field table into dst and tmp.  Returns the bit position following the fields. */
+static int decodeFields(const uint8_t* buf, int pos, const sRtcm3Field* fields, int count, void* dst, double* tmp)
+{
+    for (int i = 0; i < count; i++)
+    {
+        const sRtcm3Field &f = fields[i];
+        if (f.dst != DST_NONE)
+        {
+            int64_t raw = readBits(buf, pos, f.bits, f.enc);
+            switch (f.dst)
+            {
+            case DST_I32:   *(int32_t*)((uint8_t*)dst + f.offset) = (int32_t)raw;               break;
+            case DST_F64:   *(double*)((uint8_t*)dst + f.offset) = (double)raw * f.scale;       break;
+            case DST_TMP:   tmp[f.offset] = (double)raw * f.scale;                              break;
+            }
+        }
+        pos += f.bits;
+    }
+    return pos;
+}
+
+/** Decode an MSM field table, field by field, for n items */
+static int decodeMsmFields(const uint8_t* buf, int pos, const sRtcm3MsmField* fields, int count, int n, double (*out)[RTCM3_MSM_MAX_CELL])
+{
+    for (int i = 0; i < count; i++)
+    {
+        const sRtcm3MsmField &f = fields[i];
+        int64_t invalid = (f.enc == ENC_S ? -(1LL << (f.bits - 1)) : (1LL << f.bits) - 1);
+        double* v = out[f.index];
+        for (int j = 0; j < n; j++, pos += f.bits)
+        {
+            int64_t raw = readBits(buf, pos, f.bits, f.enc);
+            v[j] = (f.hasInvalid && raw == invalid) ? NAN : (double)raw * f.scale;
+        }
+    }
+    return pos;
+}
+
+static inline int popCount64(uint64_t v)
+{
+    int n = 0;
+    for (; v; n++)
+    {
+        v &= v - 1;
+    }
+    return n;
+}
+
+/** Lock time (ms) from the MSM lock time indicator */
+static uint32_t lockTimeMs(uint32_t lock, bool extended)
+{
+    if (!extended)
+    {
+        static const uint32_t s_lock[16] = { 0, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768, 65536, 131072, 262144, 524288 };
+        return s_lock[lock & 0xF];
+    }
+    if (lock < 64)
+    {
+        return lock;
+    }
+    if (lock > 704)
+    {
+        return 0;
+    }
+    // Resolution doubles every 32 steps
+    uint32_t n = (lock - 64) / 32 + 1;
+    return (lock - 32 * n) << n;
+}
+
+/** Carrier frequency (Hz) for a RINEX frequency band, or 0 if unknown */
+static double signalFrequency(int sys, char band, int gloFcn)
+{
+    switch (sys)
+    {
+    case SYS_GLO:
+        if (gloFcn < -7 || gloFcn > 6)  { return 0.0; }
+        if (band == '1')                { return 1.60200e9 + 0.5625e6 * gloFcn; }
+        if (band == '2')                { return 1.24600e9 + 0.4375e6 * gloFcn; }
+        return 0.0;
+
+    case SYS_CMP:
+        switch (band)
+        {
+        case '2':   return 1.561098e9;
+        case '7':   return 1.20714e9;
+        case '6':   return 1.26852e9;
+        }
+        break;
+
+    case SYS_GAL:
+        switch (band)
+        {
+        case '7':   return 1.20714e9;
+        case '8':   return 1.191795e9;
+        }
+        break;
+    }
+
+    switch (band)
+    {
+    case '1':   return 1.57542e9;
+    case '2':   return 1.22760e9;
+    case '5':   return 1.17645e9;
+    case '6':   return 1.27875e9;
+    }
+    return 0.0;
+}
+
+/** obsd_t frequency slot for a band: 0 = L1/E1/B1, 1 = L5/E5a (L1_L5_RTK) or L2/E5b/B2 */
+static int obsSlot(int sys, char band)
+{
+    char l1 = (sys == SYS_CMP ? '2' : '1');
+    char l2;
+    if (sys == SYS_GLO)     { l2 = '2'; }
+    else if (L1_L5_RTK)     { l2 = '5'; }
+    else                    { l2 = (sys == SYS_GAL || sys == SYS_CMP) ? '7' : '2'; }
+
+    if (band == l1)                             { return 0; }
+    if (band == l2 && NFREQ + NEXOBS > 1)       { return 1; }
+    return -1;
+}
+
+static gtime_t systemGpsTime()
+{
+    uint64_t nowUs = cISClock::Get().TimeUs();
+    gtime_t t;
+    t.time = (int64_t)(nowUs / 1000000);
+    t.sec = (nowUs % 1000000) * 1.0e-6;
+    return ISutc2gpst(t);
+}
+
+static gtime_t gpsToUtc(gtime_t t)
+{
+    return IStimeadd(t, -IStimediff(ISutc2gpst(t), t));
+}
+
+/** GPS time from time of week, using the week that puts it closest to the reference time */
+static gtime_t resolveTow(gtime_t ref, double tow)
+{
+    int week;
+    double refTow = IStime2gpst(ref, &week);
+    if      (tow < refTow - 302400.0)   { tow += 604800.0; }
+    else if (tow > refTow + 302400.0)   { tow -= 604800.0; }
+    return ISgpst2time(week, tow);
+}
+
+/** GPS time from GLONASS (Moscow) day of week (7 = unknown) and time of day, closest to the reference time */
+static gtime_t glonassTime(gtime_t ref, int dow, double tod)
+{
+    int week;
+    gtime_t utcRef = gpsToUtc(ref);
+    double refTow = IStime2gpst(utcRef, &week);
+    double tow;
+    if (dow < 7)
+    {
+        tow = dow * 86400.0 + tod - MOSCOW_UTC_SEC;
+        if      (tow < refTow - 302400.0)   { tow += 604800.0; }
+        else if (tow > refTow + 302400.0)   { tow -= 604800.0; }
+    }
+    else
+    {
+        double refTod = fmod(refTow, 86400.0);
+        tod -= MOSCOW_UTC_SEC;
+        if      (tod < refTod - 43200.0)    { tod += 86400.0; }
+        else if (tod > refTod + 43200.0)    { tod -= 86400.0; }
+        tow = refTow - refTod + tod;
+    }
+    return ISutc2gpst(ISgpst2time(week, tow));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// cRtcm3Decoder
+//////////////////////////////////////////////////////////////////////////
+
+cRtcm3Decoder::cRtcm3Decoder()
+{
+    memset(m_obs, 0, sizeof(m_obs));
+    memset(m_lockMs, 0, sizeof(m_lockMs));
+    memset(m_gloFcn, 0, sizeof(m_gloFcn));
+}
+
+gtime_t cRtcm3Decoder::RefTime()
+{
+    return m_time.time ? m_time : systemGpsTime();
+}
+
+int cRtcm3Decoder::Decode(const uint8_t* frame, int size)
+{
+    m_stats.messages++;
+
+    if (frame == NULLPTR || size < RTCM3_HEADER_SIZE + 2 + 3 || frame[0] != RTCM3_START_BYTE)
+    {
+        m_stats.errors++;
+        return -1;
+    }
+    int len = (int)getBitsAsUInt32(frame, 14, 10);
+    if (len < 2 || size < RTCM3_HEADER_SIZE + len + 3)
+    {
+        m_stats.errors++;
+        return -1;
+    }
+
+    // Bit positions are relative to the start of the frame.  Message number follows the 24 bit header.
+    int bitLen = (RTCM3_HEADER_SIZE + len) * 8;
+    int type = (int)getBitsAsUInt32(frame, 24, 12);
+
+    switch (type)
+    {
+    case 1005:
+    case 1006:  return DecodeStation(frame, bitLen, type);
+    case 1019:  return DecodeGpsEphemeris(frame, bitLen);
+    case 1020:  return DecodeGlonassEphemeris(frame, bitLen);
+    }
+
+    int msm = type % 10;
+    if (type >= 1071 && type <= 1127 && msm >= 4 && msm <= 7)
+    {
+        return DecodeMsm(frame, bitLen, s_msmSys[(type - 1071) / 10], msm);
+    }
+
+    m_stats.unsupported++;
+    return 0;
+}
+
+int cRtcm3Decoder::DecodeStation(const uint8_t* buf, int bitLen, int type)
+{
+    int pos = 36;
+    int bits = fieldBits(s_msg1005, _ARRAY_ELEMENT_COUNT(s_msg1005)) + (type == 1006 ? fieldBits(s_msg1006, _ARRAY_ELEMENT_COUNT(s_msg1006)) : 0);
+    if (pos + bits > bitLen)
+    {
+        m_stats.errors++;
+        return -1;
+    }
+
+    double tmp[T_COUNT] = {};
+    sta_t sta = {};
+    pos = decodeFields(buf, pos, s_msg1005, _ARRAY_ELEMENT_COUNT(s_msg1005), &sta, tmp);
+    if (type == 1006)
+    {
+        decodeFields(buf, pos, s_msg1006, _ARRAY_ELEMENT_COUNT(s_msg1006), &sta, tmp);
+    }
+    sta.stationId = (int32_t)tmp[T_STAID];
+    sta.hgt = tmp[T_HEIGHT];
+    m_sta = sta;
+    m_stats.stations++;
+    return raw_data_type_base_station_antenna_position;
+}
+
+int cRtcm3Decoder::DecodeGpsEphemeris(const uint8_t* buf, int bitLen)
+{
+    int pos = 36;
+    if (pos + fieldBits(s_msg1019, _ARRAY_ELEMENT_COUNT(s_msg1019)) > bitLen)
+    {
+        m_stats.errors++;
+        return -1;
+    }
+
+    double tmp[T_COUNT] = {};
+    eph_t eph = {};
+    decodeFields(buf, pos, s_msg1019, _ARRAY_ELEMENT_COUNT(s_msg1019), &eph, tmp);
+
+    int prn = (int)tmp[T_PRN];
+    if ((eph.sat = satNo(SYS_GPS, prn)) == 0)
+    {
+        m_stats.unsupported++;
+        return 0;
+    }
+
+    // 10 bit week number rolls over every 1024 weeks
+    gtime_t ref = RefTime();
+    int refWeek;
+    IStime2gpst(ref, &refWeek);
+    int week = (int)tmp[T_WEEK];
+    eph.week = week + (refWeek - week + 512) / 1024 * 1024;
+
+    eph.A = tmp[T_SQRTA] * tmp[T_SQRTA];
+    eph.fit = tmp[T_FIT] ? 0.0 : 4.0;
+    eph.toe = ISgpst2time(eph.week, eph.toes);
+    eph.toc = ISgpst2time(eph.week, tmp[T_TOC]);
+    eph.ttr = ref;
+    m_eph = eph;
+    m_stats.ephemerides++;
+    return raw_data_type_ephemeris;
+}
+
+int cRtcm3Decoder::DecodeGlonassEphemeris(const uint8_t* buf, int bitLen)
+{
+    int pos = 36;
+    if (pos + fieldBits(s_msg1020, _ARRAY_ELEMENT_COUNT(s_msg1020)) > bitLen)
+    {
+        m_stats.errors++;
+        return -1;
+    }
+
+    double tmp[T_COUNT] = {};
+    geph_t geph = {};
+    decodeFields(buf, pos, s_msg1020, _ARRAY_ELEMENT_COUNT(s_msg1020), &geph, tmp);
+
+    int prn = (int)tmp[T_PRN];
+    geph.frq = (int32_t)tmp[T_FRQ] - 7;
+    if (prn >= 1 && prn <= (int)sizeof(m_gloFcn))
+    {   // Frequency channel is needed to decode phase and doppler in MSM4/6
+        m_gloFcn[prn - 1] = (int8_t)(geph.frq + 8);
+    }
+    if ((geph.sat = satNo(SYS_GLO, prn)) == 0)
+    {
+        m_stats.unsupported++;
+        return 0;
+    }
+
+    gtime_t ref = RefTime();
+    geph.svh = (int32_t)tmp[T_BN];
+    geph.iode = (int32_t)tmp[T_TB] & 0x7F;
+    geph.toe = glonassTime(ref, 7, tmp[T_TB] * 900.0);
+    geph.tof = glonassTime(ref, 7, tmp[T_TKH] + tmp[T_TKM] + tmp[T_TKS]);
+    m_geph = geph;
+    m_stats.glonassEphemerides++;
+    return raw_data_type_glonass_ephemeris;
+}
+
+obsd_t* cRtcm3Decoder::EpochObs(int sat, gtime_t time)
+{
+    for (int i = 0; i < m_obsCount; i++)
+    {
+        if (m_obs[i].sat == sat)
+        {
+            return &m_obs[i];
+        }
+    }
+    if (m_obsCount >= RTCM3_MAX_EPOCH_SAT)
+    {
+        return NULLPTR;
+    }
+    obsd_t* o = &m_obs[m_obsCount++];
+    memset(o, 0, sizeof(obsd_t));
+    o->time = time;
+    o->sat = (uint8_t)sat;
+    return o;
+}
+
+void cRtcm3Decoder::CompleteEpoch()
+{
+    int signals = 0;
+    double cnr = 0;
+    for (int i = 0; i < m_obsCount; i++)
+    {
+        for (int f = 0; f < NFREQ + NEXOBS; f++)
+        {
+            if (m_obs[i].code[f])
+            {
+                signals++;
+                cnr += m_obs[i].SNR[f] * 0.25;
+            }
+        }
+    }
+
+    m_stats.epochs++;
+    m_stats.epochSatCount = m_obsCount;
+    m_stats.epochSignalCount = signals;
+    m_stats.epochMeanCnr = signals ? (float)(cnr / signals) : 0.0f;
+    m_stats.epochAgeSec = m_obsCount ? IStimediff(systemGpsTime(), m_obs[0].time) : 0.0;
+    m_obsComplete = true;
+}
+
+int cRtcm3Decoder::DecodeMsm(const uint8_t* buf, int bitLen, int sys, int msmType)
+{
+    const sRtcm3MsmType &msm = s_msmTypes[msmType - 4];
+    int sysIndex = 0;
+    while (s_msmSys[sysIndex] != sys) { sysIndex++; }
+
+    // Header
+    int pos = 36;
+    if (pos + 157 > bitLen)
+    {
+        m_stats.errors++;
+        return -1;
+    }
+    int staId = (int)getBitsAsUInt32(buf, pos, 12);         pos += 12;
+    uint32_t epoch = getBitsAsUInt32(buf, pos, 30);         pos += 30;
+    int sync = (int)getBitsAsUInt32(buf, pos, 1);           pos += 1;
+    pos += 3 + 7 + 2 + 2 + 1 + 3;                           // IODS, reserved, clock steering, external clock, smoothing, smoothing interval
+    uint64_t satMask = ((uint64_t)getBitsAsUInt32(buf, pos, 32) << 32) | getBitsAsUInt32(buf, pos + 32, 32);   pos += 64;
+    uint32_t sigMask = getBitsAsUInt32(buf, pos, 32);       pos += 32;
+
+    int nsat = popCount64(satMask);
+    int nsig = popCount64(sigMask);
+    if (nsat * nsig > RTCM3_MSM_MAX_CELL || pos + nsat * nsig > bitLen)
+    {
+        m_stats.errors++;
+        return -1;
+    }
+
+    uint64_t cellMask = 0;
+    int ncell = 0;
+    for (int i = 0; i < nsat * nsig; i++, pos++)
+    {
+        if (getBitsAsUInt32(buf, pos, 1))
+        {
+            cellMask |= 1ULL << i;
+            ncell++;
+        }
+    }
+
+    int satBits = 0, cellBits = 0;
+    for (int i = 0; i < msm.satCount; i++)  { satBits += msm.sat[i].bits; }
+    for (int i = 0; i < msm.cellCount; i++) { cellBits += msm.cell[i].bits; }
+    if (pos + nsat * satBits + ncell * cellBits > bitLen)
+    {
+        m_stats.errors++;
+        return -1;
+    }
+
+    // Satellite and signal data.  Fields not in this MSM type stay invalid.
+    double sat[SAT_FIELD_COUNT][RTCM3_MSM_MAX_CELL];
+    double cell[CELL_FIELD_COUNT][RTCM3_MSM_MAX_CELL];
+    for (int i = 0; i < nsat; i++)  { sat[SAT_EXT][i] = NAN; sat[SAT_RATE][i] = NAN; }
+    for (int i = 0; i < ncell; i++) { cell[CELL_RATE][i] = NAN; }
+    pos = decodeMsmFields(buf, pos, msm.sat, msm.satCount, nsat, sat);
+    decodeMsmFields(buf, pos, msm.cell, msm.cellCount, ncell, cell);
+
+    // Epoch time
+    gtime_t ref = RefTime();
+    gtime_t time;
+    if (sys == SYS_GLO)
+    {
+        time = glonassTime(ref, (int)(epoch >> 27), (epoch & 0x7FFFFFF) * 0.001);
+    }
+    else
+    {
+        time = resolveTow(ref, epoch * 0.001 + (sys == SYS_CMP ? BDT_GPST_SEC : 0.0));
+    }
+    if (m_time.time)
+    {   // Follow the data so week rollover works when replaying
+        m_time = time;
+    }
+
+    // Start a new epoch after the last one completed or when its closing message was lost
+    if (m_obsComplete || (m_obsCount && fabs(IStimediff(time, m_obs[0].time)) > 1e-3))
+    {
+        m_obsCount = 0;
+        m_obsComplete = false;
+    }
+    m_staId = staId;
+
+    // Observation codes of the signals in this message
+    uint8_t sigCode[32];
+    char sigBand[32];
+    for (int j = 0, b = 0; b < 32; b++)
+    {
+        if (sigMask & (0x80000000u >> b))
+        {
+            const char* code = s_msmSig[sysIndex][b];
+            sigCode[j] = rinexObsCodeIndex(code);
+            sigBand[j] = code[0];
+            j++;
+        }
+    }
+
+    int i = 0, k = 0;
+    for (int b = 0; b < RTCM3_MSM_MAX_SAT; b++)
+    {
+        if (!(satMask & (0x8000000000000000ULL >> b)))
+        {
+            continue;
+        }
+
+        int prn = b + 1;
+        switch (sys)
+        {
+        case SYS_QZS:   prn += 192; break;
+        case SYS_SBS:   prn += 119; break;
+        }
+        int satNum = satNo(sys, prn);
+
+        // GLONASS frequency channel from extended satellite info or ephemeris
+        int fcn = -100;
+        if (sys == SYS_GLO && prn <= (int)sizeof(m_gloFcn))
+        {
+            if (!isnan(sat[SAT_EXT][i]) && sat[SAT_EXT][i] <= 13)
+            {
+                m_gloFcn[prn - 1] = (int8_t)(sat[SAT_EXT][i] - 7 + 8);
+            }
+            if (m_gloFcn[prn - 1])
+            {
+                fcn = m_gloFcn[prn - 1] - 8;
+            }
+        }
+
+        double range = sat[SAT_RR_INT][i] + sat[SAT_RR_MOD][i];     // (ms) NAN if invalid
+        double rate = sat[SAT_RATE][i];                             // (m/s)
+
+        for (int j = 0; j < nsig; j++)
+        {
+            if (!(cellMask & (1ULL << (i * nsig + j))))
+            {
+                continue;
+            }
+            int c = k++;
+
+            int slot = obsSlot(sys, sigBand[j]);
+            if (satNum == 0 || slot < 0 || sigCode[j] == 0 || isnan(range))
+            {
+                continue;
+            }
+            obsd_t* o = EpochObs(satNum, time);
+            if (o == NULLPTR || o->code[slot])
+            {   // Epoch full or slot already used by another signal on this band
+                continue;
+            }
+
+            double freq = signalFrequency(sys, sigBand[j], fcn);
+            o->code[slot] = sigCode[j];
+            o->SNR[slot] = (uint8_t)_MIN(cell[CELL_CNR][c] * 4.0 + 0.5, 255.0);
+            if (!isnan(cell[CELL_PR][c]))
+            {
+                o->P[slot] = (range + cell[CELL_PR][c]) * RANGE_MS;
+            }
+            if (!isnan(cell[CELL_CP][c]) && freq > 0.0)
+            {
+                o->L[slot] = (range + cell[CELL_CP][c]) * RANGE_MS * freq / CLIGHT;
+
+                uint32_t lock = lockTimeMs((uint32_t)cell[CELL_LOCK][c], msm.extendedLock);
+                uint32_t &lastLock = m_lockMs[satNum][slot];
+                uint8_t lli = ((lock == 0 && lastLock == 0) || lock < lastLock) ? 1 : 0;
+                lastLock = lock;
+                if (lli)
+                {
+                    m_stats.cycleSlips++;
+                }
+                o->LLI[slot] = lli | (cell[CELL_HALF][c] ? 2 : 0);
+            }
+            if (!isnan(rate) && !isnan(cell[CELL_RATE][c]) && freq > 0.0)
+            {
+                o->D[slot] = (float)(-(rate + cell[CELL_RATE][c]) * freq / CLIGHT);
+            }
+        }
+        i++;
+    }
+
+    m_stats.msm++;
+    if (!sync)
+    {
+        CompleteEpoch();
+        return raw_data_type_observation;
+    }
+    return 0;
+}
@@ -0,0 +1,118 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef IS_RTCM3_H
+#define IS_RTCM3_H
+
+#include <stdint.h>
+
+#include "ISConstants.h"
+#include "ISRinex.h"
+#include "rtk_defines.h"
+
+extern "C"
+{
+#include "data_sets.h"
+}
+
+#define RTCM3_MAX_EPOCH_SAT     64          // Max satellites per observation epoch (all constellations)
+#define RTCM3_MSM_MAX_SAT       64          // Satellite mask size in MSM header
+#define RTCM3_MSM_MAX_CELL      64          // Max satellite/signal cells in one MSM message
+
+/**
+ * Host side RTCM3 message decoder.  Supports:
+ *  - MSM4, MSM5, MSM6, MSM7 for GPS, GLONASS, Galileo, SBAS, QZSS, BeiDou (107x - 112x) into obsd_t
+ *  - 1005, 1006 stationary reference station position into sta_t
+ *  - 1019 GPS ephemeris into eph_t
+ *  - 1020 GLONASS ephemeris into geph_t
+ *
+ * Message fields are described by bitfield tables and read with getBitsAsUInt32().  Decoding does not allocate and
+ * results stay valid until the next call to Decode().  Observations from constellations are merged into one epoch
+ * until a message with the MSM multiple message bit cleared is received.  Satellites of constellations disabled in
+ * rtk_defines.h are skipped.
+ */
+class cRtcm3Decoder
+{
+public:
+    struct sStats
+    {
+        uint32_t messages;                  // Messages passed to Decode()
+        uint32_t unsupported;               // Valid frames of message types not decoded
+        uint32_t errors;                    // Frames too short for their content or not RTCM3
+        uint32_t msm;                       // MSM messages decoded
+        uint32_t epochs;                    // Complete observation epochs
+        uint32_t ephemerides;               // 1019 decoded
+        uint32_t glonassEphemerides;        // 1020 decoded
+        uint32_t stations;                  // 1005/1006 decoded
+        uint32_t cycleSlips;                // Observations with loss of lock indicated
+
+        // Last complete epoch
+        uint32_t epochSatCount;             // Satellites
+        uint32_t epochSignalCount;          // Signals (satellite x frequency)
+        float    epochMeanCnr;              // (dB-Hz) Mean signal strength
+        double   epochAgeSec;               // (s) Reference time minus epoch time.  Latency when reference time is live.
+    };
+
+    cRtcm3Decoder();
+
+    /**
+     * Decode one complete RTCM3 frame (preamble, length, payload and CRC), as found in is_comm_instance_t rxPkt.data
+     * for _PTYPE_RTCM3.  The CRC is not rechecked.
+     * @return eRawDataType of the decoded content: raw_data_type_observation when an epoch is complete,
+     *  raw_data_type_ephemeris, raw_data_type_glonass_ephemeris or raw_data_type_base_station_antenna_position.
+     *  0 if the message was consumed without new output and -1 on error.
+     */
+    int Decode(const uint8_t* frame, int size);
+
+    /**
+     * Approximate current GPS time, used to resolve week numbers and time of day rollover.  If never set, the
+     * system clock is used.  Updated internally as observation epochs are decoded.
+     */
+    void SetTime(gtime_t gpsTime) { m_time = gpsTime; }
+    gtime_t Time() { return m_time; }
+
+    // Output of Decode()
+    const obsd_t* Observations() { return m_obs; }
+    int ObservationCount() { return m_obsCount; }
+    int StationId() { return m_staId; }
+    const eph_t& Ephemeris() { return m_eph; }
+    const geph_t& GlonassEphemeris() { return m_geph; }
+    const sta_t& Station() { return m_sta; }
+
+    const sStats& Stats() { return m_stats; }
+    void ResetStats() { m_stats = {}; }
+
+private:
+    int DecodeMsm(const uint8_t* buf, int bitLen, int sys, int msmType);
+    int DecodeStation(const uint8_t* buf, int bitLen, int type);
+    int DecodeGpsEphemeris(const uint8_t* buf, int bitLen);
+    int DecodeGlonassEphemeris(const uint8_t* buf, int bitLen);
+    gtime_t RefTime();
+    obsd_t* EpochObs(int sat, gtime_t time);
+    void CompleteEpoch();
+
+    gtime_t m_time = {};
+    obsd_t m_obs[RTCM3_MAX_EPOCH_SAT];
+    int m_obsCount = 0;
+    bool m_obsComplete = false;
+    int m_staId = 0;
+    eph_t m_eph = {};
+    geph_t m_geph = {};
+    sta_t m_sta = {};
+    sStats m_stats = {};
+
+    // Per satellite/frequency lock time (ms) for loss of lock detection.  GLONASS frequency channel (+8, 0 = unknown).
+    uint32_t m_lockMs[RINEX_MAX_SAT + 1][NFREQ + NEXOBS];
+    int8_t m_gloFcn[32];
+};
+
+#endif // IS_RTCM3_H
@@ -0,0 +1,335 @@
+/*
+MIT LICENSE
+
+Copyright (c) 2014-2025 Inertial Sense, Inc. - http://inertialsense.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef IS_UBX_H
+#define IS_UBX_H
+
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+/**
+ * Zero-copy views over UBX packets as passed to the is_comm_callbacks_t ublox handler (complete packet: sync chars,
+ * header, payload and checksum).  Views only hold a pointer into the receive buffer, so they are valid for the
+ * duration of the callback.  Fields are read little-endian at compile-time offsets regardless of host byte order or
+ * alignment.  Repeated blocks (RAWX measurements, NAV-SAT satellites, ...) are iterated with range-for and are bounded
+ * by the actual payload size, not only by the count field in the message.
+ *
+ *  int ubxHandler(unsigned int port, const unsigned char* msg, int msgSize)
+ *  {
+ *      cUbxRxmRawx rawx(msg, msgSize);
+ *      if (rawx.Valid())
+ *      {
+ *          for (auto meas : rawx.Meas()) { use(meas.PrMes(), meas.Cno()); }
+ *      }
+ *      return 0;
+ *  }
+ */
+
+#define UBX_HEADER_SIZE         6           // Sync chars, class, id, length
+#define UBX_CHECKSUM_SIZE       2
+
+enum eUbxClass
+{
+    UBX_CLASS_NAV = 0x01,
+    UBX_CLASS_RXM = 0x02,
+};
+
+enum eUbxId
+{
+    UBX_NAV_PVT     = 0x07,
+    UBX_NAV_SAT     = 0x35,
+    UBX_NAV_SIG     = 0x43,
+    UBX_RXM_SFRBX   = 0x13,
+    UBX_RXM_RAWX    = 0x15,
+};
+
+/** Read little-endian value of type T from unaligned buffer */
+template <typename T>
+static inline T ubxRead(const uint8_t* p)
+{
+    static_assert(std::is_arithmetic<T>::value, "ubxRead requires arithmetic type");
+    typedef typename std::conditional<sizeof(T) == 1, uint8_t,
+            typename std::conditional<sizeof(T) == 2, uint16_t,
+            typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type>::type>::type uint_t;
+    uint_t u = 0;
+    for (unsigned int i = 0; i < sizeof(T); i++)
+    {
+        u |= (uint_t)((uint_t)p[i] << (8 * i));
+    }
+    T value;
+    memcpy(&value, &u, sizeof(T));
+    return value;
+}
+
+/** Field accessor helper.  OFFSET is relative to the start of the view (payload or repeated block). */
+#define UBX_FIELD(name, type, offset)   type name() const { return this->template Get<type, offset>(); }
+
+/** Fixed size region of a UBX payload */
+template <int SIZE>
+class cUbxRegion
+{
+public:
+    static const int size = SIZE;
+
+    cUbxRegion(const uint8_t* ptr = nullptr) : m_ptr(ptr) {}
+    const uint8_t* Ptr() const { return m_ptr; }
+
+    template <typename T, int OFFSET>
+    T Get() const
+    {
+        static_assert(OFFSET + sizeof(T) <= (unsigned int)SIZE, "UBX field outside of region");
+        return ubxRead<T>(m_ptr + OFFSET);
+    }
+
+protected:
+    const uint8_t* m_ptr;
+};
+
+/** Iterable sequence of BLOCK regions with constant stride */
+template <typename BLOCK>
+class cUbxBlockRange
+{
+public:
+    class iterator
+    {
+    public:
+        iterator(const uint8_t* p) : m_p(p) {}
+        BLOCK operator*() const { return BLOCK(m_p); }
+        iterator& operator++() { m_p += BLOCK::size; return *this; }
+        bool operator!=(const iterator& other) const { return m_p != other.m_p; }
+    private:
+        const uint8_t* m_p;
+    };
+
+    cUbxBlockRange(const uint8_t* begin, int count) : m_begin(begin), m_count(count) {}
+    iterator begin() const { return iterator(m_begin); }
+    iterator end() const { return iterator(m_begin + m_count * BLOCK::size); }
+    int size() const { return m_count; }
+    BLOCK operator[](int i) const { return BLOCK(m_begin + i * BLOCK::size); }
+
+private:
+    const uint8_t* m_begin;
+    int m_count;
+};
+
+/** Any UBX packet */
+class cUbxPacket
+{
+public:
+    cUbxPacket(const uint8_t* pkt, int pktSize) : m_pkt(pkt), m_size(pktSize) {}
+
+    /** Complete packet with consistent length.  Checksum is validated by the ISComm parser. */
+    bool Valid() const
+    {
+        return m_pkt && m_size >= UBX_HEADER_SIZE + UBX_CHECKSUM_SIZE &&
+            m_pkt[0] == 0xB5 && m_pkt[1] == 0x62 &&
+            UBX_HEADER_SIZE + PayloadSize() + UBX_CHECKSUM_SIZE <= m_size;
+    }
+    uint8_t MsgClass() const { return m_pkt[2]; }
+    uint8_t MsgId() const { return m_pkt[3]; }
+    int PayloadSize() const { return ubxRead<uint16_t>(m_pkt + 4); }
+    const uint8_t* Payload() const { return m_pkt + UBX_HEADER_SIZE; }
+
+protected:
+    const uint8_t* m_pkt;
+    int m_size;
+};
+
+/** Typed message view.  PAYLOAD is the fixed part of the payload, repeated blocks follow it. */
+template <uint8_t MSG_CLASS, uint8_t MSG_ID, int PAYLOAD_SIZE>
+class cUbxMsg : public cUbxPacket
+{
+public:
+    static const uint8_t msgClass = MSG_CLASS;
+    static const uint8_t msgId = MSG_ID;
+    static const int size = PAYLOAD_SIZE;
+
+    cUbxMsg(const uint8_t* pkt, int pktSize) : cUbxPacket(pkt, pktSize) {}
+
+    bool Valid() const
+    {
+        return cUbxPacket::Valid() && MsgClass() == MSG_CLASS && MsgId() == MSG_ID && PayloadSize() >= PAYLOAD_SIZE;
+    }
+
+    template <typename T, int OFFSET>
+    T Get() const
+    {
+        static_assert(OFFSET + sizeof(T) <= (unsigned int)PAYLOAD_SIZE, "UBX field outside of payload");
+        return ubxRead<T>(Payload() + OFFSET);
+    }
+
+protected:
+    /** Repeated blocks following the fixed payload, limited to those fully contained in the payload */
+    template <typename BLOCK>
+    cUbxBlockRange<BLOCK> Blocks(int count) const
+    {
+        int available = (PayloadSize() - PAYLOAD_SIZE) / BLOCK::size;
+        return cUbxBlockRange<BLOCK>(Payload() + PAYLOAD_SIZE, count < available ? count : available);
+    }
+};
+
+/** UBX-NAV-PVT navigation position velocity time solution */
+class cUbxNavPvt : public cUbxMsg<UBX_CLASS_NAV, UBX_NAV_PVT, 92>
+{
+public:
+    using cUbxMsg::cUbxMsg;
+    UBX_FIELD(ITow,         uint32_t,   0)      // (ms) GPS time of week
+    UBX_FIELD(Year,         uint16_t,   4)
+    UBX_FIELD(Month,        uint8_t,    6)
+    UBX_FIELD(Day,          uint8_t,    7)
+    UBX_FIELD(Hour,         uint8_t,    8)
+    UBX_FIELD(Min,          uint8_t,    9)
+    UBX_FIELD(Sec,          uint8_t,    10)
+    UBX_FIELD(ValidFlags,   uint8_t,    11)     // Validity flags
+    UBX_FIELD(TAcc,         uint32_t,   12)     // (ns)
+    UBX_FIELD(Nano,         int32_t,    16)     // (ns) Fraction of second
+    UBX_FIELD(FixType,      uint8_t,    20)     // 0 no fix, 2 2D, 3 3D, 4 GNSS + dead reckoning, 5 time only
+    UBX_FIELD(Flags,        uint8_t,    21)
+    UBX_FIELD(Flags2,       uint8_t,    22)
+    UBX_FIELD(NumSV,        uint8_t,    23)
+    UBX_FIELD(Lon,          int32_t,    24)     // (1e-7 deg)
+    UBX_FIELD(Lat,          int32_t,    28)     // (1e-7 deg)
+    UBX_FIELD(Height,       int32_t,    32)     // (mm) Above ellipsoid
+    UBX_FIELD(HMSL,         int32_t,    36)     // (mm) Above mean sea level
+    UBX_FIELD(HAcc,         uint32_t,   40)     // (mm)
+    UBX_FIELD(VAcc,         uint32_t,   44)     // (mm)
+    UBX_FIELD(VelN,         int32_t,    48)     // (mm/s)
+    UBX_FIELD(VelE,         int32_t,    52)     // (mm/s)
+    UBX_FIELD(VelD,         int32_t,    56)     // (mm/s)
+    UBX_FIELD(GSpeed,       int32_t,    60)     // (mm/s) Ground speed
+    UBX_FIELD(HeadMot,      int32_t,    64)     // (1e-5 deg) Heading of motion
+    UBX_FIELD(SAcc,         uint32_t,   68)     // (mm/s)
+    UBX_FIELD(HeadAcc,      uint32_t,   72)     // (1e-5 deg)
+    UBX_FIELD(PDop,         uint16_t,   76)     // (0.01)
+    UBX_FIELD(Flags3,       uint8_t,    78)
+    UBX_FIELD(HeadVeh,      int32_t,    84)     // (1e-5 deg)
+    UBX_FIELD(MagDec,       int16_t,    88)     // (1e-2 deg)
+    UBX_FIELD(MagAcc,       uint16_t,   90)     // (1e-2 deg)
+
+    bool GnssFixOk() const { return Flags() & 0x01; }
+    double LatDeg() const { return Lat() * 1.0e-7; }
+    double LonDeg() const { return Lon() * 1.0e-7; }
+};
+
+/** UBX-RXM-RAWX multi-GNSS raw measurements */
+class cUbxRxmRawxMeas : public cUbxRegion<32>
+{
+public:
+    using cUbxRegion::cUbxRegion;
+    UBX_FIELD(PrMes,        double,     0)      // (m) Pseudorange
+    UBX_FIELD(CpMes,        double,     8)      // (cycles) Carrier phase
+    UBX_FIELD(DoMes,        float,      16)     // (Hz) Doppler
+    UBX_FIELD(GnssId,       uint8_t,    20)
+    UBX_FIELD(SvId,         uint8_t,    21)
+    UBX_FIELD(SigId,        uint8_t,    22)
+    UBX_FIELD(FreqId,       uint8_t,    23)     // GLONASS frequency slot + 7
+    UBX_FIELD(Locktime,     uint16_t,   24)     // (ms) Carrier phase locktime
+    UBX_FIELD(Cno,          uint8_t,    26)     // (dB-Hz)
+    UBX_FIELD(TrkStat,      uint8_t,    30)     // Tracking status bitfield
+
+    uint8_t PrStdev() const { return Get<uint8_t, 27>() & 0x0F; }       // (0.01*2^n m)
+    uint8_t CpStdev() const { return Get<uint8_t, 28>() & 0x0F; }       // (0.004 cycles)
+    uint8_t DoStdev() const { return Get<uint8_t, 29>() & 0x0F; }       // (0.002*2^n Hz)
+    bool PrValid() const { return TrkStat() & 0x01; }
+    bool CpValid() const { return TrkStat() & 0x02; }
+    bool HalfCyc() const { return TrkStat() & 0x04; }
+};
+
+class cUbxRxmRawx : public cUbxMsg<UBX_CLASS_RXM, UBX_RXM_RAWX, 16>
+{
+public:
+    using cUbxMsg::cUbxMsg;
+    UBX_FIELD(RcvTow,       double,     0)      // (s) Receiver time of week
+    UBX_FIELD(Week,         uint16_t,   8)
+    UBX_FIELD(LeapS,        int8_t,     10)     // (s) GPS leap seconds
+    UBX_FIELD(NumMeas,      uint8_t,    11)
+    UBX_FIELD(RecStat,      uint8_t,    12)
+    UBX_FIELD(Version,      uint8_t,    13)
+
+    cUbxBlockRange<cUbxRxmRawxMeas> Meas() const { return Blocks<cUbxRxmRawxMeas>(NumMeas()); }
+};
+
+/** UBX-NAV-SAT satellite information */
+class cUbxNavSatSv : public cUbxRegion<12>
+{
+public:
+    using cUbxRegion::cUbxRegion;
+    UBX_FIELD(GnssId,       uint8_t,    0)
+    UBX_FIELD(SvId,         uint8_t,    1)
+    UBX_FIELD(Cno,          uint8_t,    2)      // (dB-Hz)
+    UBX_FIELD(Elev,         int8_t,     3)      // (deg)
+    UBX_FIELD(Azim,         int16_t,    4)      // (deg)
+    UBX_FIELD(PrRes,        int16_t,    6)      // (0.1 m) Pseudorange residual
+    UBX_FIELD(Flags,        uint32_t,   8)
+
+    uint8_t QualityInd() const { return Flags() & 0x07; }
+    bool SvUsed() const { return Flags() & 0x08; }
+};
+
+class cUbxNavSat : public cUbxMsg<UBX_CLASS_NAV, UBX_NAV_SAT, 8>
+{
+public:
+    using cUbxMsg::cUbxMsg;
+    UBX_FIELD(ITow,         uint32_t,   0)      // (ms) GPS time of week
+    UBX_FIELD(Version,      uint8_t,    4)
+    UBX_FIELD(NumSvs,       uint8_t,    5)
+
+    cUbxBlockRange<cUbxNavSatSv> Svs() const { return Blocks<cUbxNavSatSv>(NumSvs()); }
+};
+
+/** UBX-NAV-SIG signal information */
+class cUbxNavSigSig : public cUbxRegion<16>
+{
+public:
+    using cUbxRegion::cUbxRegion;
+    UBX_FIELD(GnssId,       uint8_t,    0)
+    UBX_FIELD(SvId,         uint8_t,    1)
+    UBX_FIELD(SigId,        uint8_t,    2)
+    UBX_FIELD(FreqId,       uint8_t,    3)
+    UBX_FIELD(PrRes,        int16_t,    4)      // (0.1 m) Pseudorange residual
+    UBX_FIELD(Cno,          uint8_t,    6)      // (dB-Hz)
+    UBX_FIELD(QualityInd,   uint8_t,    7)
+    UBX_FIELD(CorrSource,   uint8_t,    8)
+    UBX_FIELD(IonoModel,    uint8_t,    9)
+    UBX_FIELD(SigFlags,     uint16_t,   10)
+};
+
+class cUbxNavSig : public cUbxMsg<UBX_CLASS_NAV, UBX_NAV_SIG, 8>
+{
+public:
+    using cUbxMsg::cUbxMsg;
+    UBX_FIELD(ITow,         uint32_t,   0)      // (ms) GPS time of week
+    UBX_FIELD(Version,      uint8_t,    4)
+    UBX_FIELD(NumSigs,      uint8_t,    5)
+
+    cUbxBlockRange<cUbxNavSigSig> Sigs() const { return Blocks<cUbxNavSigSig>(NumSigs()); }
+};
+
+/** UBX-RXM-SFRBX broadcast navigation data subframe */
+class cUbxRxmSfrbx : public cUbxMsg<UBX_CLASS_RXM, UBX_RXM_SFRBX, 8>
+{
+public:
+    using cUbxMsg::cUbxMsg;
+    UBX_FIELD(GnssId,       uint8_t,    0)
+    UBX_FIELD(SvId,         uint8_t,    1)
+    UBX_FIELD(SigId,        uint8_t,    2)
+    UBX_FIELD(FreqId,       uint8_t,    3)
+    UBX_FIELD(NumWords,     uint8_t,    4)
+    UBX_FIELD(Chn,          uint8_t,    5)
+    UBX_FIELD(Version,      uint8_t,    6)
+
+    int WordCount() const { int n = (PayloadSize() - size) / 4; return NumWords() < n ? NumWords() : n; }
+    uint32_t Word(int i) const { return ubxRead<uint32_t>(Payload() + size + 4 * i); }
+};
+
+#endif // IS_UBX_H
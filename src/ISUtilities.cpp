@@ -17,6 +17,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <string>
 
 #include "ISUtilities.h"
+#include "ISClock.h"
 #include "ISPose.h"
 #include "ISEarth.h"
 
@@ -202,6 +203,10 @@ extern "C" {
 
 /** System time in seconds */
 double current_timeSecD() {
+    if (cISClock* clock = cISClock::Installed())
+    {
+        return clock->TimeUs() * 1.0e-6;
+    }
 #if PLATFORM_IS_WINDOWS
     // Time since week start (Sunday morning) in seconds, GMT
     LARGE_INTEGER StartingTime;
@@ -220,6 +225,10 @@ double current_timeSecD() {
 }
 
 unsigned int current_timeSec() {
+	if (cISClock* clock = cISClock::Installed())
+	{
+		return (unsigned int)(clock->TimeUs() / 1000000);
+	}
 #if PLATFORM_IS_WINDOWS
 	SYSTEMTIME st;
 	GetLocalTime(&st);
@@ -233,6 +242,10 @@ unsigned int current_timeSec() {
 
 /** System time in milliseconds */
 unsigned int current_timeMs() {
+	if (cISClock* clock = cISClock::Installed())
+	{
+		return (unsigned int)(clock->TimeUs() / 1000);
+	}
 #if PLATFORM_IS_WINDOWS
 	// Time since week start (Sunday morning) in milliseconds, GMT
 	SYSTEMTIME st;
@@ -250,6 +263,10 @@ unsigned int current_timeMs() {
 
 /** System time in milliseconds */
 uint64_t current_timeUs() {
+	if (cISClock* clock = cISClock::Installed())
+	{
+		return clock->TimeUs();
+	}
 #if PLATFORM_IS_WINDOWS
 	// Time since week start (Sunday morning) in milliseconds, GMT
 	LARGE_INTEGER StartingTime;
@@ -354,6 +371,10 @@ uint64_t timerRawEnd(uint64_t start)
 
 uint64_t getTickCount(void)
 {
+	if (cISClock* clock = cISClock::Installed())
+	{
+		return clock->TickMs();
+	}
 
 #if PLATFORM_IS_WINDOWS
 	return GetTickCount64();
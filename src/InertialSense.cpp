@@ -31,13 +31,27 @@ using namespace std;
 static InertialSense *s_is = NULL;
 static InertialSense::com_manager_cpp_state_t *s_cm_state = NULL;
 
+/**
+ * All packet writes to a port go through here.  A correction packet that only partially fit in the port send buffer
+ * owns the port until it is finished, so packets from com_manager or other threads are never spliced into it.
+ */
 static int staticSendData(unsigned int port, const uint8_t* buf, int len)
 {
+    cMutexLocker txLock(&s_cm_state->txMutex);
     if ((size_t)port >= s_cm_state->devices.size())
     {
         return 0;
     }
-    return serialPortWrite(&(s_cm_state->devices[port].serialPort), buf, len);
+    ISDevice& device = s_cm_state->devices[port];
+    if (device.corrections.Partial())
+    {
+        serial_port_t* serialPort = &device.serialPort;
+        device.corrections.FinishPartial(current_timeMs(), [serialPort](const uint8_t* data, int size)
+        {
+            return serialPortWrite(serialPort, data, size);
+        });
+    }
+    return serialPortWrite(&device.serialPort, buf, len);
 }
 
 static int staticReadData(unsigned int port, uint8_t* buf, int len)
@@ -88,11 +102,10 @@ static int staticProcessRxData(unsigned int port, p_data_t* data)
     switch (data->hdr.id)
     {
         case DID_GPS1_POS:
-            static time_t lastTime;
-            time_t currentTime = time(NULLPTR);
-            if (abs(currentTime - lastTime) > 5)
+            time_t currentTime = cISClock::UnixTime();
+            if (abs(currentTime - s_cm_state->ggaTime) > 5)
             {	// Update every 5 seconds
-                lastTime = currentTime;
+                s_cm_state->ggaTime = currentTime;
                 gps_pos_t &gps = *((gps_pos_t*)data->ptr);
                 if ((gps.status&GPS_STATUS_FIX_MASK) >= GPS_STATUS_FIX_3D)
                 {
@@ -106,6 +119,8 @@ static int staticProcessRxData(unsigned int port, p_data_t* data)
 
 static int staticProcessAck(unsigned int port, p_ack_t* ack, unsigned char packetIdentifier)
 {
+    s_cm_state->inertialSenseInterface->ProcessRxAck(port, ack, packetIdentifier);
+
     pfnHandleAckData handler = s_cm_state->binaryAckCallback;
     if (handler != NULLPTR)
     {
@@ -139,7 +154,7 @@ InertialSense::InertialSense(
     s_is = this;
     s_cm_state = &m_comManagerState;
     m_logThread = NULLPTR;
-    m_lastLogReInit = time(0);
+    m_lastLogReInit = cISClock::UnixTime();
     m_clientStream = NULLPTR;
     m_clientBufferBytesToSend = 0;
     m_clientServerByteCount = 0;
@@ -224,8 +239,8 @@ bool InertialSense::HasReceivedDeviceInfo(size_t index)
     }
 
     return (
-            m_comManagerState.devices[index].devInfo.serialNumber != 0 &&
-            m_comManagerState.devices[index].devInfo.manufacturer[0] != 0);
+            m_comManagerState.devices[index].config->devInfo.serialNumber != 0 &&
+            m_comManagerState.devices[index].config->devInfo.manufacturer[0] != 0);
 }
 
 bool InertialSense::HasReceivedDeviceInfoFromAllDevices()
@@ -253,6 +268,7 @@ void InertialSense::RemoveDevice(size_t index)
         return;
     }
 
+    cMutexLocker txLock(&m_comManagerState.txMutex);
     serialPortClose(&m_comManagerState.devices[index].serialPort);
 }
 
@@ -262,21 +278,16 @@ void InertialSense::LoggerThread(void* info)
     InertialSense* inertialSense = (InertialSense*)info;
 
     // gather up packets in memory
-    map<int, vector<p_data_buf_t>> packets;
+    log_packets_t packets;
 
     while (running)
     {
         SLEEP_MS(20);
         {
-            // lock so we can read and clear m_logPackets
+            // lock so we can take m_logPackets.  Swapping hands back the drained vectors, so their capacity is reused
+            // rather than copying every packet and reallocating each cycle.
             cMutexLocker logMutexLocker(&inertialSense->m_logMutex);
-            for (map<int, vector<p_data_buf_t>>::iterator i = inertialSense->m_logPackets.begin(); i != inertialSense->m_logPackets.end(); i++)
-            {
-                packets[i->first] = i->second;
-            }
-
-            // clear shared memory
-            inertialSense->m_logPackets.clear();
+            packets.swap(inertialSense->m_logPackets);
 
             // update running state
             running = inertialSense->m_logger.Enabled();
@@ -285,13 +296,26 @@ void InertialSense::LoggerThread(void* info)
         if (running)
         {
             // log the packets
-            for (map<int, vector<p_data_buf_t>>::iterator i = packets.begin(); i != packets.end(); i++)
+            for (log_packets_t::iterator i = packets.begin(); i != packets.end(); i++)
             {
                 if (inertialSense->m_logger.Type() != cISLogger::LOGTYPE_RAW) {
+                    // Hold our own reference, the device list can be cleared or reallocated by the Update() thread
+                    std::shared_ptr<cDeviceLog> devLogger;
+                    {
+                        cMutexLocker logMutexLocker(&inertialSense->m_logMutex);
+                        if ((size_t)i->first < inertialSense->m_comManagerState.devices.size())
+                        {
+                            devLogger = inertialSense->m_comManagerState.devices[i->first].devLogger;
+                        }
+                    }
+                    if (devLogger == NULLPTR)
+                    {
+                        i->second.clear();
+                        continue;
+                    }
                     size_t numPackets = i->second.size();
                     for (size_t j = 0; j < numPackets; j++) {
-                        auto device = inertialSense->m_comManagerState.devices[i->first];
-                        if (!inertialSense->m_logger.LogData(device.devLogger, &i->second[j].hdr, i->second[j].buf)) {
+                        if (!inertialSense->m_logger.LogData(devLogger, &i->second[j].hdr, i->second[j].buf)) {
                             // Failed to write to log
                             SLEEP_MS(20); // FIXME:  This maybe problematic, as it may unnecessarily delay the thread, leading run-away memory usage.
                         }
@@ -314,10 +338,15 @@ void InertialSense::StepLogger(InertialSense* i, const p_data_t* data, int pHand
     cMutexLocker logMutexLocker(&i->m_logMutex);
     if (i->m_logger.Enabled())
     {
+        log_packet_vector_t& vec = i->m_logPackets[pHandle];
+        if (!cISMemory::Available(cISMemory::LOGGER_QUEUE, cISMemory::GrowthBytes(vec)))
+        {   // Logger is falling behind, drop the newest packet
+            cISMemory::Shed(cISMemory::LOGGER_QUEUE);
+            return;
+        }
         p_data_buf_t d;
         d.hdr = data->hdr;
         memcpy(d.buf, data->ptr, d.hdr.size);
-        vector<p_data_buf_t>& vec = i->m_logPackets[pHandle];
         vec.push_back(d);
     }
 }
@@ -443,6 +472,12 @@ bool InertialSense::Update()
 {
     m_timeMs = current_timeMs();
 
+    // Send commands queued by other threads
+    m_commandQueue.Step(m_timeMs, [this](int pHandle, uint8_t pktType, uint16_t did, const void* data, uint16_t size, uint16_t offset)
+    {
+        return (size_t)pHandle < m_comManagerState.devices.size() && comManagerSend(pHandle, pktType, (void*)data, did, size, offset) == 0;
+    });
+
     if (m_tcpServer.IsOpen() && m_comManagerState.devices.size() > 0)
     {
         UpdateServer();
@@ -451,6 +486,12 @@ bool InertialSense::Update()
     {
         UpdateClient();
 
+        // Continue writing corrections that didn't fit in the port send buffers
+        for (auto& device : m_comManagerState.devices)
+        {
+            DrainCorrections(device);
+        }
+
         // [C COMM INSTRUCTION]  2.) Update Com Manager at regular interval to send and receive data.
         // Normally called within a while loop.  Include a thread "sleep" if running on a multi-thread/
         // task system with serial port read function that does NOT incorporate a timeout.
@@ -461,9 +502,9 @@ bool InertialSense::Update()
 
             // check if we have an valid instance of the FirmareUpdate class, and if so, call it's Step() function
             for (auto& device : m_comManagerState.devices) {
-                if (serialPortIsOpen(&(device.serialPort)) && device.fwUpdate.fwUpdater != nullptr) {
-                    if (!device.fwUpdate.update()) {
-                        if (device.fwUpdate.lastStatus < fwUpdate::NOT_STARTED) {
+                if (serialPortIsOpen(&(device.serialPort)) && device.config->fwUpdate.fwUpdater != nullptr) {
+                    if (!device.config->fwUpdate.update()) {
+                        if (device.config->fwUpdate.lastStatus < fwUpdate::NOT_STARTED) {
                             // TODO: Report a REAL error
                             // printf("Error starting firmware update: %s\n", fwUpdater->getSessionStatusName());
                         }
@@ -482,6 +523,11 @@ bool InertialSense::Update()
         }
     }
 
+    if (m_hotplugEnabled)
+    {
+        UpdateHotplug();
+    }
+
     // if any serial ports have closed, shutdown
     bool anyOpen = false;
     for (size_t i = 0; i < m_comManagerState.devices.size(); i++)
@@ -490,6 +536,10 @@ bool InertialSense::Update()
         {
             // Make sure its closed..
             serialPortClose(&m_comManagerState.devices[i].serialPort);
+            if (m_hotplugEnabled && m_comManagerState.devices[i].disconnectTimeMs)
+            {   // Waiting to reconnect
+                anyOpen = true;
+            }
         } else
             anyOpen = true;
     }
@@ -529,6 +579,10 @@ bool InertialSense::UpdateServer()
                     }
                     if (ptype == _PTYPE_RTCM3)
                     {
+                        if (m_rtcm3DecodeEnabled)
+                        {
+                            m_rtcm3Decoder.Decode(comm->rxPkt.data.ptr, comm->rxPkt.data.size);
+                        }
                         if ((comm->rxPkt.id == 1029) && (comm->rxPkt.data.size < 1024))
                         {
                             str = string().assign(reinterpret_cast<char*>(comm->rxPkt.data.ptr + 12), comm->rxPkt.data.size - 12);
@@ -586,6 +640,10 @@ bool InertialSense::UpdateClient()
 
                     if (ptype == _PTYPE_RTCM3)
                     {
+                        if (m_rtcm3DecodeEnabled)
+                        {
+                            m_rtcm3Decoder.Decode(comm->rxPkt.data.ptr, comm->rxPkt.data.size);
+                        }
                         if ((comm->rxPkt.id == 1029) && (comm->rxPkt.data.size < 1024))
                         {
                             str = string().assign(reinterpret_cast<char*>(comm->rxPkt.data.ptr + 12), comm->rxPkt.data.size - 12);
@@ -715,6 +773,64 @@ void InertialSense::SendData(eDataIDs dataId, uint8_t* data, uint32_t length, ui
     }
 }
 
+int InertialSense::CreateDataTemplate(int pHandle, eDataIDs dataId, uint32_t length, uint32_t offset)
+{
+    if ((size_t)pHandle >= m_comManagerState.devices.size() || length + offset > UINT16_MAX)
+    {
+        return -1;
+    }
+
+    data_template_t tmpl = {};
+    tmpl.pHandle = pHandle;
+    tmpl.buf.resize(length + sizeof(packet_hdr_t) + 4);     // Header + offset + payload + checksum
+    cMutexLocker lock(&m_dataTemplateMutex);
+    m_dataTemplates.push_back(std::move(tmpl));
+    data_template_t& t = m_dataTemplates.back();
+    if (is_comm_template_init(&t.pkt, t.buf.data(), (uint32_t)t.buf.size(), PKT_TYPE_SET_DATA, dataId, (uint16_t)length, (uint16_t)offset) < 0)
+    {
+        m_dataTemplates.pop_back();
+        return -1;
+    }
+    return (int)m_dataTemplates.size() - 1;
+}
+
+bool InertialSense::SendDataTemplate(int templateHandle, const void* data)
+{
+    // Serializes producers and protects the templates from CloseSerialPorts().  The write itself goes through
+    // staticSendData(), which serializes it with Update() and correction writes on the same port.  Tx count is not
+    // updated as the comm instance belongs to the Update() thread.
+    cMutexLocker lock(&m_dataTemplateMutex);
+    if ((size_t)templateHandle >= m_dataTemplates.size())
+    {
+        return false;
+    }
+    data_template_t& t = m_dataTemplates[templateHandle];
+    return is_comm_template_write(staticSendData, t.pHandle, NULLPTR, &t.pkt, data) > 0;
+}
+
+future<cISCommandQueue::eStatus> InertialSense::QueueSendData(int pHandle, eDataIDs dataId, const void* data, uint32_t length, uint32_t offset, uint32_t timeoutMs, cISCommandQueue::pfnCompletion callback)
+{
+    return m_commandQueue.Push(pHandle, PKT_TYPE_SET_DATA, (uint16_t)dataId, data, (uint16_t)length, (uint16_t)offset, current_timeMs() + timeoutMs, callback);
+}
+
+future<cISCommandQueue::eStatus> InertialSense::QueueGetData(int pHandle, eDataIDs dataId, uint16_t length, uint16_t offset, uint16_t period, uint32_t timeoutMs, cISCommandQueue::pfnCompletion callback)
+{
+    p_data_get_t get;
+    get.id = dataId;
+    get.offset = offset;
+    get.size = length;
+    get.period = period;
+    return m_commandQueue.Push(pHandle, PKT_TYPE_GET_DATA, 0, &get, sizeof(get), 0, current_timeMs() + timeoutMs, callback);
+}
+
+future<cISCommandQueue::eStatus> InertialSense::QueueSysCmd(uint32_t command, int pHandle, uint32_t timeoutMs, cISCommandQueue::pfnCompletion callback)
+{
+    system_command_t cmd;
+    cmd.command = command;
+    cmd.invCommand = ~command;
+    return QueueSendData(pHandle, DID_SYS_CMD, &cmd, sizeof(cmd), 0, timeoutMs, callback);
+}
+
 void InertialSense::SendRawData(eDataIDs dataId, uint8_t* data, uint32_t length, uint32_t offset)
 {
     for (size_t i = 0; i < m_comManagerState.devices.size(); i++)
@@ -747,10 +863,10 @@ void InertialSense::SetSysCmd(const uint32_t command, int pHandle)
             return;
         }
 
-        m_comManagerState.devices[pHandle].sysCmd.command = command;
-        m_comManagerState.devices[pHandle].sysCmd.invCommand = ~command;
+        m_comManagerState.devices[pHandle].config->sysCmd.command = command;
+        m_comManagerState.devices[pHandle].config->sysCmd.invCommand = ~command;
         // [C COMM INSTRUCTION]  Update the entire DID_SYS_CMD data set in the IMX.
-        comManagerSendData(pHandle, &m_comManagerState.devices[pHandle].sysCmd, DID_SYS_CMD, sizeof(system_command_t), 0);
+        comManagerSendData(pHandle, &m_comManagerState.devices[pHandle].config->sysCmd, DID_SYS_CMD, sizeof(system_command_t), 0);
     }
 }
 
@@ -877,15 +993,15 @@ void InertialSense::SyncFlashConfig(unsigned int timeMs)
     {
         ISDevice& device = m_comManagerState.devices[i];
 
-        if (device.devInfo.hardwareType == IS_HARDWARE_TYPE_IMX)
+        if (device.config->devInfo.hardwareType == IS_HARDWARE_TYPE_IMX)
         {   // Sync IMX flash config if a IMX present
-            DeviceSyncFlashCfg(i, timeMs, DID_FLASH_CONFIG,  DID_SYS_PARAMS, device.imxFlashCfgUploadTimeMs, device.imxFlashCfg.checksum, device.sysParams.flashCfgChecksum, device.imxFlashCfgUploadChecksum);
+            DeviceSyncFlashCfg(i, timeMs, DID_FLASH_CONFIG,  DID_SYS_PARAMS, device.config->imxFlashCfgUploadTimeMs, device.config->imxFlashCfg.checksum, device.config->sysParams.flashCfgChecksum, device.config->imxFlashCfgUploadChecksum);
         }
 
-        if (device.devInfo.hardwareType == IS_HARDWARE_TYPE_GPX ||
-            device.gpxDevInfo.hardwareType == IS_HARDWARE_TYPE_GPX)
+        if (device.config->devInfo.hardwareType == IS_HARDWARE_TYPE_GPX ||
+            device.config->gpxDevInfo.hardwareType == IS_HARDWARE_TYPE_GPX)
         {   // Sync GPX flash config if a GPX present
-            DeviceSyncFlashCfg(i, timeMs, DID_GPX_FLASH_CFG, DID_GPX_STATUS, device.gpxFlashCfgUploadTimeMs, device.gpxFlashCfg.checksum, device.gpxStatus.flashCfgChecksum, device.gpxFlashCfgUploadChecksum);
+            DeviceSyncFlashCfg(i, timeMs, DID_GPX_FLASH_CFG, DID_GPX_STATUS, device.config->gpxFlashCfgUploadTimeMs, device.config->gpxFlashCfg.checksum, device.config->gpxStatus.flashCfgChecksum, device.config->gpxFlashCfgUploadChecksum);
         }
     }
 }
@@ -916,10 +1032,10 @@ bool InertialSense::ImxFlashConfig(nvm_flash_cfg_t &flashCfg, int pHandle)
     ISDevice& device = m_comManagerState.devices[pHandle];
 
     // Copy flash config
-    flashCfg = device.imxFlashCfg;
+    flashCfg = device.config->imxFlashCfg;
 
     // Indicate whether flash config is synchronized
-    return ValidFlashCfgCksum(device.imxFlashCfg.checksum) && device.sysParams.flashCfgChecksum == device.imxFlashCfg.checksum;
+    return ValidFlashCfgCksum(device.config->imxFlashCfg.checksum) && device.config->sysParams.flashCfgChecksum == device.config->imxFlashCfg.checksum;
 }
 
 bool InertialSense::GpxFlashConfig(gpx_flash_cfg_t &flashCfg, int pHandle)
@@ -931,10 +1047,10 @@ bool InertialSense::GpxFlashConfig(gpx_flash_cfg_t &flashCfg, int pHandle)
     ISDevice& device = m_comManagerState.devices[pHandle];
 
     // Copy flash config
-    flashCfg = device.gpxFlashCfg;
+    flashCfg = device.config->gpxFlashCfg;
 
     // Indicate whether flash config is synchronized
-    return ValidFlashCfgCksum(device.gpxFlashCfg.checksum) && device.gpxStatus.flashCfgChecksum == device.gpxFlashCfg.checksum;
+    return ValidFlashCfgCksum(device.config->gpxFlashCfg.checksum) && device.config->gpxStatus.flashCfgChecksum == device.config->gpxFlashCfg.checksum;
 }
 
 bool InertialSense::ImxFlashConfigSynced(int pHandle) 
@@ -945,9 +1061,9 @@ bool InertialSense::ImxFlashConfigSynced(int pHandle)
     }
 
     ISDevice& device = m_comManagerState.devices[pHandle];
-    return  ValidFlashCfgCksum(device.imxFlashCfg.checksum) &&
-            (device.imxFlashCfg.checksum == device.sysParams.flashCfgChecksum) && 
-            (device.imxFlashCfgUploadTimeMs==0) && !ImxFlashConfigUploadFailure(pHandle); 
+    return  ValidFlashCfgCksum(device.config->imxFlashCfg.checksum) &&
+            (device.config->imxFlashCfg.checksum == device.config->sysParams.flashCfgChecksum) && 
+            (device.config->imxFlashCfgUploadTimeMs==0) && !ImxFlashConfigUploadFailure(pHandle); 
 }
 
 bool InertialSense::GpxFlashConfigSynced(int pHandle) 
@@ -958,9 +1074,9 @@ bool InertialSense::GpxFlashConfigSynced(int pHandle)
     }
 
     ISDevice& device = m_comManagerState.devices[pHandle];
-    return  ValidFlashCfgCksum(device.gpxFlashCfg.checksum) &&
-            (device.gpxFlashCfg.checksum == device.gpxStatus.flashCfgChecksum) && 
-            (device.gpxFlashCfgUploadTimeMs==0) && !GpxFlashConfigUploadFailure(pHandle); 
+    return  ValidFlashCfgCksum(device.config->gpxFlashCfg.checksum) &&
+            (device.config->gpxFlashCfg.checksum == device.config->gpxStatus.flashCfgChecksum) && 
+            (device.config->gpxFlashCfgUploadTimeMs==0) && !GpxFlashConfigUploadFailure(pHandle); 
 }
 
 bool InertialSense::ImxFlashConfigUploadFailure(int pHandle)
@@ -971,7 +1087,7 @@ bool InertialSense::ImxFlashConfigUploadFailure(int pHandle)
     }
 
     ISDevice& device = m_comManagerState.devices[pHandle];
-    return device.imxFlashCfgUploadChecksum && (device.imxFlashCfgUploadChecksum != device.sysParams.flashCfgChecksum);
+    return device.config->imxFlashCfgUploadChecksum && (device.config->imxFlashCfgUploadChecksum != device.config->sysParams.flashCfgChecksum);
 } 
 
 bool InertialSense::GpxFlashConfigUploadFailure(int pHandle)
@@ -982,7 +1098,7 @@ bool InertialSense::GpxFlashConfigUploadFailure(int pHandle)
     }
 
     ISDevice& device = m_comManagerState.devices[pHandle];
-    return device.gpxFlashCfgUploadChecksum && (device.gpxFlashCfgUploadChecksum != device.gpxStatus.flashCfgChecksum);
+    return device.config->gpxFlashCfgUploadChecksum && (device.config->gpxFlashCfgUploadChecksum != device.config->gpxStatus.flashCfgChecksum);
 }
 
 bool InertialSense::UploadFlashConfigDiff(int pHandle, uint8_t* newData, uint8_t* curData, size_t sizeBytes, uint32_t flashCfgDid, uint32_t& uploadTimeMsOut, uint32_t& checksumOut)
@@ -1042,19 +1158,19 @@ bool InertialSense::SetImxFlashConfig(nvm_flash_cfg_t &flashCfg, int pHandle)
     bool success = UploadFlashConfigDiff(
         pHandle,
         reinterpret_cast<uint8_t*>(&flashCfg),
-        reinterpret_cast<uint8_t*>(&device.imxFlashCfg),
+        reinterpret_cast<uint8_t*>(&device.config->imxFlashCfg),
         sizeof(nvm_flash_cfg_t),
         DID_FLASH_CONFIG,
-        device.imxFlashCfgUploadTimeMs,
-        device.imxFlashCfgUploadChecksum
+        device.config->imxFlashCfgUploadTimeMs,
+        device.config->imxFlashCfgUploadChecksum
     );
 
-    if (!device.imxFlashCfgUploadTimeMs)
+    if (!device.config->imxFlashCfgUploadTimeMs)
         printf("DID_FLASH_CONFIG in sync.  No upload.\n");
     else
-        device.imxFlashCfgUploadChecksum = flashCfg.checksum;
+        device.config->imxFlashCfgUploadChecksum = flashCfg.checksum;
 
-    device.imxFlashCfg = flashCfg;
+    device.config->imxFlashCfg = flashCfg;
     return success;
 }
 
@@ -1065,19 +1181,19 @@ bool InertialSense::SetGpxFlashConfig(gpx_flash_cfg_t &flashCfg, int pHandle)
     bool success = UploadFlashConfigDiff(
         pHandle,
         reinterpret_cast<uint8_t*>(&flashCfg),
-        reinterpret_cast<uint8_t*>(&device.gpxFlashCfg),
+        reinterpret_cast<uint8_t*>(&device.config->gpxFlashCfg),
         sizeof(gpx_flash_cfg_t),
         DID_GPX_FLASH_CFG,
-        device.gpxFlashCfgUploadTimeMs,
-        device.gpxFlashCfgUploadChecksum
+        device.config->gpxFlashCfgUploadTimeMs,
+        device.config->gpxFlashCfgUploadChecksum
     );
 
-    if (!device.gpxFlashCfgUploadTimeMs)
+    if (!device.config->gpxFlashCfgUploadTimeMs)
         printf("DID_GPX_FLASH_CONFIG in sync.  No upload.\n");
     else
-        device.gpxFlashCfgUploadChecksum = flashCfg.checksum;
+        device.config->gpxFlashCfgUploadChecksum = flashCfg.checksum;
 
-    device.gpxFlashCfg = flashCfg;
+    device.config->gpxFlashCfg = flashCfg;
     return success;
 }
 
@@ -1090,13 +1206,13 @@ bool InertialSense::WaitForImxFlashCfgSynced(bool forceSync, uint32_t timeout, i
     ISDevice& device = m_comManagerState.devices[pHandle];
 
     if (forceSync)
-        device.sysParams.flashCfgChecksum = 0xFFFFFFFF;    // Invalidate to force re-sync
+        device.config->sysParams.flashCfgChecksum = 0xFFFFFFFF;    // Invalidate to force re-sync
 
     unsigned int startMs = current_timeMs();
     while(!ImxFlashConfigSynced(pHandle))
     {   // Request and wait for IMX flash config
         Update();
-        SLEEP_MS(100);
+        cISClock::Sleep(100);
 
         if (current_timeMs() - startMs > timeout)
         {   // Timeout waiting for IMX flash config
@@ -1130,13 +1246,13 @@ bool InertialSense::WaitForGpxFlashCfgSynced(bool forceSync, uint32_t timeout, i
     ISDevice& device = m_comManagerState.devices[pHandle];
 
     if (forceSync)
-        device.gpxStatus.flashCfgChecksum = 0xFFFFFFFF;    // Invalidate to force re-sync
+        device.config->gpxStatus.flashCfgChecksum = 0xFFFFFFFF;    // Invalidate to force re-sync
 
     unsigned int startMs = current_timeMs();
     while(!GpxFlashConfigSynced(pHandle))
     {   // Request and wait for GPX flash config
         Update();
-        SLEEP_MS(100);
+        cISClock::Sleep(100);
 
         if (current_timeMs() - startMs > timeout)
         {   // Timeout waiting for GPX flash config
@@ -1170,48 +1286,64 @@ void InertialSense::ProcessRxData(int pHandle, p_data_t* data)
 
     ISDevice& device = m_comManagerState.devices[pHandle];
 
+    if (device.reopenTimeMs)
+    {   // First data after hot-plug reconnect
+        uint32_t recoverMs = current_timeMs() - device.disconnectTimeMs;
+        m_hotplugStats.reconnects++;
+        m_hotplugStats.lastRecoverMs = recoverMs;
+        m_hotplugStats.maxRecoverMs = _MAX(m_hotplugStats.maxRecoverMs, recoverMs);
+        m_hotplugStats.totalRecoverMs += recoverMs;
+        device.disconnectTimeMs = 0;
+        device.reopenTimeMs = 0;
+    }
+
     switch (data->hdr.id)
     {
         case DID_DEV_INFO:
-            device.devInfo = *(dev_info_t*)data->ptr;
+            device.config->devInfo = *(dev_info_t*)data->ptr;
             break;
         case DID_GPX_DEV_INFO:
-            device.gpxDevInfo = *(dev_info_t*)data->ptr;
+            device.config->gpxDevInfo = *(dev_info_t*)data->ptr;
             break;
-        case DID_SYS_CMD:           device.sysCmd = *(system_command_t*)data->ptr;                          break;
+        case DID_SYS_CMD:           device.config->sysCmd = *(system_command_t*)data->ptr;                          break;
         case DID_SYS_PARAMS:        
-            copyDataPToStructP(&device.sysParams, data, sizeof(sys_params_t));      
+            copyDataPToStructP(&device.config->sysParams, data, sizeof(sys_params_t));      
             DEBUG_PRINT("Received DID_SYS_PARAMS\n");
             break;
         case DID_GPX_STATUS:
-            copyDataPToStructP(&device.gpxStatus, data, sizeof(gpx_status_t));
+            copyDataPToStructP(&device.config->gpxStatus, data, sizeof(gpx_status_t));
             DEBUG_PRINT("Received DID_GPX_STATUS\n");
             break;
         case DID_FLASH_CONFIG:
-            copyDataPToStructP(&device.imxFlashCfg, data, sizeof(nvm_flash_cfg_t));
+            copyDataPToStructP(&device.config->imxFlashCfg, data, sizeof(nvm_flash_cfg_t));
             if ( dataOverlap( offsetof(nvm_flash_cfg_t, checksum), 4, data ) )
             {	// Checksum received
-                device.sysParams.flashCfgChecksum = device.imxFlashCfg.checksum;
+                device.config->sysParams.flashCfgChecksum = device.config->imxFlashCfg.checksum;
             }
             DEBUG_PRINT("Received DID_FLASH_CONFIG\n");
             break;
         case DID_GPX_FLASH_CFG:
-            copyDataPToStructP(&device.gpxFlashCfg, data, sizeof(gpx_flash_cfg_t));
+            copyDataPToStructP(&device.config->gpxFlashCfg, data, sizeof(gpx_flash_cfg_t));
             if ( dataOverlap( offsetof(gpx_flash_cfg_t, checksum), 4, data ) )
             {	// Checksum received
-                device.gpxStatus.flashCfgChecksum = device.gpxFlashCfg.checksum;
+                device.config->gpxStatus.flashCfgChecksum = device.config->gpxFlashCfg.checksum;
             }
             DEBUG_PRINT("Received DID_GPX_FLASH_CFG\n");
             break;
         case DID_FIRMWARE_UPDATE:
             // we don't respond to messages if we don't already have an active Updater
-            if (m_comManagerState.devices[pHandle].fwUpdate.fwUpdater) {
-                m_comManagerState.devices[pHandle].fwUpdate.fwUpdater->fwUpdate_processMessage(data->ptr, data->hdr.size);
+            if (m_comManagerState.devices[pHandle].config->fwUpdate.fwUpdater) {
+                m_comManagerState.devices[pHandle].config->fwUpdate.fwUpdater->fwUpdate_processMessage(data->ptr, data->hdr.size);
             }
             break;
     }
 }
 
+void InertialSense::ProcessRxAck(int pHandle, p_ack_t* ack, unsigned char packetIdentifier)
+{
+    m_commandQueue.OnAck(pHandle, ack, packetIdentifier);
+}
+
 // return 0 on success, -1 on failure
 void InertialSense::ProcessRxNmea(int pHandle, const uint8_t* msg, int msgSize)
 {
@@ -1231,16 +1363,16 @@ void InertialSense::ProcessRxNmea(int pHandle, const uint8_t* msg, int msgSize)
             switch (info.hardwareType)
             {
             case IS_HARDWARE_TYPE_IMX:
-                device.devInfo = info;
+                device.config->devInfo = info;
                 break;
 
             case IS_HARDWARE_TYPE_GPX:
-                if (device.devInfo.hardwareType == 0 ||
-                    device.devInfo.hardwareType == IS_HARDWARE_TYPE_GPX)
+                if (device.config->devInfo.hardwareType == 0 ||
+                    device.config->devInfo.hardwareType == IS_HARDWARE_TYPE_GPX)
                 {   // Populate if device info is not set or GPX
-                    device.devInfo = info;
+                    device.config->devInfo = info;
                 }
-                device.gpxDevInfo = info;
+                device.config->gpxDevInfo = info;
                 break;
             }
 		}
@@ -1257,8 +1389,10 @@ bool InertialSense::BroadcastBinaryData(int pHandle, uint32_t dataId, int period
 
     if (periodMultiple < 0) {
         comManagerDisableData(pHandle, dataId);
-    } else if (m_comManagerState.devices[pHandle].devInfo.protocolVer[0] == PROTOCOL_VERSION_CHAR0) {
+        m_comManagerState.devices[pHandle].config->broadcastPeriods.erase(dataId);
+    } else if (m_comManagerState.devices[pHandle].config->devInfo.protocolVer[0] == PROTOCOL_VERSION_CHAR0) {
         comManagerGetData(pHandle, dataId, 0, 0, periodMultiple);
+        m_comManagerState.devices[pHandle].config->broadcastPeriods[dataId] = periodMultiple;
     }
     return true;
 }
@@ -1281,6 +1415,7 @@ bool InertialSense::BroadcastBinaryData(uint32_t dataId, int periodMultiple, pfn
         {
             // [C COMM INSTRUCTION]  Stop broadcasting of one specific DID message from the IMX.
             comManagerDisableData(i, dataId);
+            m_comManagerState.devices[i].config->broadcastPeriods.erase(dataId);
         }
     }
     else
@@ -1289,9 +1424,10 @@ bool InertialSense::BroadcastBinaryData(uint32_t dataId, int periodMultiple, pfn
         {
             // [C COMM INSTRUCTION]  3.) Request a specific data set from the IMX.  "periodMultiple" specifies the interval
             // between broadcasts and "periodMultiple=0" will disable broadcasts and transmit one single message.
-            if (m_comManagerState.devices[i].devInfo.protocolVer[0] == PROTOCOL_VERSION_CHAR0 || !m_enableDeviceValidation) 
+            if (m_comManagerState.devices[i].config->devInfo.protocolVer[0] == PROTOCOL_VERSION_CHAR0 || !m_enableDeviceValidation) 
             {
                 comManagerGetData(i, dataId, 0, 0, periodMultiple);
+                m_comManagerState.devices[i].config->broadcastPeriods[dataId] = periodMultiple;
             }
         }
     }
@@ -1304,6 +1440,8 @@ void InertialSense::BroadcastBinaryDataRmcPreset(uint64_t rmcPreset, uint32_t rm
     {
         // [C COMM INSTRUCTION]  Use a preset to enable a predefined set of messages.  R
         comManagerGetDataRmc((int)i, rmcPreset, rmcOptions);
+        m_comManagerState.devices[i].config->rmcPreset = rmcPreset;
+        m_comManagerState.devices[i].config->rmcOptions = rmcOptions;
     }
 }
 
@@ -1322,15 +1460,15 @@ is_operation_result InertialSense::updateFirmware(
     if (OpenSerialPorts(comPort.c_str(), baudRate)) {
         for (int i = 0; i < (int) m_comManagerState.devices.size(); i++) {
             ISDevice& device = m_comManagerState.devices[i];
-            device.fwUpdate.fwUpdater = new ISFirmwareUpdater(i, m_comManagerState.devices[i].serialPort.port, &m_comManagerState.devices[i].devInfo);
-            device.fwUpdate.fwUpdater->setTarget(targetDevice);
+            device.config->fwUpdate.fwUpdater = new ISFirmwareUpdater(i, m_comManagerState.devices[i].serialPort.port, &m_comManagerState.devices[i].config->devInfo);
+            device.config->fwUpdate.fwUpdater->setTarget(targetDevice);
 
             // TODO: Implement maybe
-            device.fwUpdate.fwUpdater->setUploadProgressCb(uploadProgress);
-            device.fwUpdate.fwUpdater->setVerifyProgressCb(verifyProgress);
-            device.fwUpdate.fwUpdater->setInfoProgressCb(infoProgress);
+            device.config->fwUpdate.fwUpdater->setUploadProgressCb(uploadProgress);
+            device.config->fwUpdate.fwUpdater->setVerifyProgressCb(verifyProgress);
+            device.config->fwUpdate.fwUpdater->setInfoProgressCb(infoProgress);
 
-            device.fwUpdate.fwUpdater->setCommands(cmds);
+            device.config->fwUpdate.fwUpdater->setCommands(cmds);
         }
     }
 
@@ -1354,15 +1492,15 @@ is_operation_result InertialSense::updateFirmware(
 )
 {
     EnableDeviceValidation(true);
-    device.fwUpdate.fwUpdater = new ISFirmwareUpdater(device);
-    device.fwUpdate.fwUpdater->setTarget(targetDevice);
+    device.config->fwUpdate.fwUpdater = new ISFirmwareUpdater(device);
+    device.config->fwUpdate.fwUpdater->setTarget(targetDevice);
 
     // TODO: Implement maybe
-    device.fwUpdate.fwUpdater->setUploadProgressCb(uploadProgress);
-    device.fwUpdate.fwUpdater->setVerifyProgressCb(verifyProgress);
-    device.fwUpdate.fwUpdater->setInfoProgressCb(infoProgress);
+    device.config->fwUpdate.fwUpdater->setUploadProgressCb(uploadProgress);
+    device.config->fwUpdate.fwUpdater->setVerifyProgressCb(verifyProgress);
+    device.config->fwUpdate.fwUpdater->setInfoProgressCb(infoProgress);
 
-    device.fwUpdate.fwUpdater->setCommands(cmds);
+    device.config->fwUpdate.fwUpdater->setCommands(cmds);
 
     printf("\n\r");
 
@@ -1378,7 +1516,7 @@ is_operation_result InertialSense::updateFirmware(
  */
 bool InertialSense::isFirmwareUpdateFinished() {
     for (auto& device : m_comManagerState.devices) {
-        if (device.fwUpdate.inProgress())
+        if (device.config->fwUpdate.inProgress())
             return false;
     }
     return true;
@@ -1388,9 +1526,9 @@ bool InertialSense::isFirmwareUpdateFinished() {
  * @return false if ANY connected devices returned an error from ANY firmware update; but you should first call isFirmwareUpdateFinished()
  */
 bool InertialSense::isFirmwareUpdateSuccessful() {
-    for (auto device : m_comManagerState.devices) {
-        ISFirmwareUpdater *fwUpdater = device.fwUpdate.fwUpdater;
-        if (device.fwUpdate.hasError ||
+    for (auto& device : m_comManagerState.devices) {
+        ISFirmwareUpdater *fwUpdater = device.config->fwUpdate.fwUpdater;
+        if (device.config->fwUpdate.hasError ||
             (   (fwUpdater != nullptr) &&
                 fwUpdater->fwUpdate_isDone() &&
                 (
@@ -1408,9 +1546,9 @@ int InertialSense::getFirmwareUpdatePercent() {
     float total_percent = 0.0;
     int total_devices = 0;
 
-    for (auto device : m_comManagerState.devices) {
-        if (device.fwUpdate.inProgress()) {
-            total_percent += device.fwUpdate.percent;
+    for (auto& device : m_comManagerState.devices) {
+        if (device.config->fwUpdate.inProgress()) {
+            total_percent += device.config->fwUpdate.percent;
             total_devices++;
         }
     }
@@ -1427,8 +1565,8 @@ int InertialSense::getFirmwareUpdatePercent() {
  */
 fwUpdate::update_status_e InertialSense::getUpdateStatus(uint32_t deviceIndex)
 {
-    if (m_comManagerState.devices[deviceIndex].fwUpdate.fwUpdater != NULL)
-        return m_comManagerState.devices[deviceIndex].fwUpdate.fwUpdater->fwUpdate_getSessionStatus();
+    if (m_comManagerState.devices[deviceIndex].config->fwUpdate.fwUpdater != NULL)
+        return m_comManagerState.devices[deviceIndex].config->fwUpdate.fwUpdater->fwUpdate_getSessionStatus();
     else
         return fwUpdate::ERR_UPDATER_CLOSED;
 }
@@ -1454,9 +1592,9 @@ int InertialSense::getUpdateDeviceIndex(const char* com)
  */
 bool InertialSense::getUpdateDevInfo(dev_info_t* devInfo, uint32_t deviceIndex)
 {
-    if (m_comManagerState.devices[deviceIndex].fwUpdate.fwUpdater != NULL || 1)
+    if (m_comManagerState.devices[deviceIndex].config->fwUpdate.fwUpdater != NULL || 1)
     {
-        *devInfo = m_comManagerState.devices[deviceIndex].devInfo;
+        *devInfo = m_comManagerState.devices[deviceIndex].config->devInfo;
         return true;
     }
     else
@@ -1564,16 +1702,47 @@ is_operation_result InertialSense::BootloadFile(
 
 bool InertialSense::OnClientPacketReceived(const uint8_t* data, uint32_t dataLength)
 {
-    for (size_t i = 0; i < m_comManagerState.devices.size(); i++)
+    for (auto& device : m_comManagerState.devices)
     {
-        // sleep in between to allow test bed to send the serial data
-        // TODO: This was 10ms, but that was to long for the CI test.
-// 		SLEEP_MS(1);	// This is commented out because it causes problems when using testbad with cltool on single board computer.
-        serialPortWrite(&m_comManagerState.devices[i].serialPort, data, dataLength);
+        device.corrections.Push(data, dataLength, m_timeMs);
+        DrainCorrections(device);
     }
     return false; // do not parse, since we are just forwarding it on
 }
 
+void InertialSense::DrainCorrections(ISDevice& device)
+{
+    if (device.corrections.Empty())
+    {
+        return;
+    }
+
+    cMutexLocker txLock(&m_comManagerState.txMutex);
+    serial_port_t* serialPort = &device.serialPort;
+    device.corrections.Drain(m_timeMs, [serialPort](const uint8_t* data, int size)
+    {
+        return serialPortWriteNonBlocking(serialPort, data, size);
+    });
+}
+
+void InertialSense::SetCorrectionMaxAge(uint32_t maxAgeMs)
+{
+    m_correctionMaxAgeMs = maxAgeMs;
+    for (auto& device : m_comManagerState.devices)
+    {
+        device.corrections.SetMaxAge(maxAgeMs);
+    }
+}
+
+cISCorrectionQueue::sStats InertialSense::CorrectionStats(int pHandle)
+{
+    if ((size_t)pHandle >= m_comManagerState.devices.size())
+    {
+        return {};
+    }
+    return m_comManagerState.devices[pHandle].corrections.Stats();
+}
+
 void InertialSense::OnClientConnecting(cISTcpServer* server)
 {
     (void)server;
@@ -1610,6 +1779,7 @@ bool InertialSense::OpenSerialPorts(const char* port, int baudRate)
     {
         return false;
     }
+    m_baudRate = baudRate;
 
     // split port on comma in case we need to open multiple serial ports
     vector<string> ports;
@@ -1637,6 +1807,11 @@ bool InertialSense::OpenSerialPorts(const char* port, int baudRate)
     {
         serial_port_t serial;
         serialPortPlatformInit(&serial);
+        if (!cISMemory::Available(cISMemory::DEVICE, sizeof(ISDeviceConfig)))
+        {   // Device memory cap reached, remaining ports are not opened
+            cISMemory::Shed(cISMemory::DEVICE, ports.size() - i);
+            break;
+        }
         if (serialPortOpen(&serial, ports[i].c_str(), baudRate, 0) == 0)
         {
             // failed to open
@@ -1647,7 +1822,9 @@ bool InertialSense::OpenSerialPorts(const char* port, int baudRate)
             ISDevice device;
             device.portHandle = i;
             device.serialPort = serial;
-            m_comManagerState.devices.push_back(device);
+            device.corrections.SetMaxAge(m_correctionMaxAgeMs);
+            cMutexLocker logMutexLocker(&m_logMutex);
+            m_comManagerState.devices.push_back(std::move(device));
         }
     }
 
@@ -1688,7 +1865,7 @@ bool InertialSense::OpenSerialPorts(const char* port, int baudRate)
                 }
             }
 
-            SLEEP_MS(100);
+            cISClock::Sleep(100);
             comManagerStep();
 
             if ((current_timeMs() - startTime) > (uint32_t)m_comManagerState.discoveryTimeout) {
@@ -1737,32 +1914,157 @@ bool InertialSense::OpenSerialPorts(const char* port, int baudRate)
             callbacks.rtcm3 = m_handlerRtcm3;
             callbacks.sprtn = m_handlerSpartn;
             callbacks.error = m_handlerError;
-            comManagerInit((int) m_comManagerState.devices.size(), 10, staticReadData, staticSendData, 0, staticProcessRxData, 0, 0, &m_cmInit, m_cmPorts, &callbacks);
+            comManagerInit((int) m_comManagerState.devices.size(), 10, staticReadData, staticSendData, 0, staticProcessRxData, staticProcessAck, 0, &m_cmInit, m_cmPorts, &callbacks);
         }
     }
 
     // request extended device info for remaining connected devices...
     for (int i = ((int) m_comManagerState.devices.size() - 1); i >= 0; i--) {
         // but only if they are of a compatible protocol version
-        if (m_comManagerState.devices[i].devInfo.protocolVer[0] == PROTOCOL_VERSION_CHAR0) {
+        if (m_comManagerState.devices[i].config->devInfo.protocolVer[0] == PROTOCOL_VERSION_CHAR0) {
             comManagerGetData((int) i, DID_SYS_CMD, 0, 0, 0);
             comManagerGetData((int) i, DID_FLASH_CONFIG, 0, 0, 0);
             comManagerGetData((int) i, DID_GPX_FLASH_CFG, 0, 0, 0);
         }
     }
 
+    if (m_hotplugEnabled)
+    {
+        EnableHotplugRecovery(true);
+    }
+
     return m_comManagerState.devices.size() != 0;
 }
 
-void InertialSense::CloseSerialPorts(bool drainBeforeClose)
+void InertialSense::EnableHotplugRecovery(bool enable)
 {
+    m_hotplugEnabled = enable;
+    if (!enable)
+    {
+        m_hotplugMonitor.Close();
+        return;
+    }
+
     for (auto& device : m_comManagerState.devices)
     {
-        if (drainBeforeClose)
-            serialPortDrain(&device.serialPort);
+        if (serialPortIsOpen(&device.serialPort))
+        {
+            m_hotplugMonitor.Watch(device.serialPort.port);
+        }
+    }
+}
 
+void InertialSense::HotplugDisconnect(ISDevice& device)
+{
+    {   // Writes from other threads must finish before the port goes away.  A partial correction frame is not resumed
+        // on the reopened port.
+        cMutexLocker txLock(&m_comManagerState.txMutex);
         serialPortClose(&device.serialPort);
+        device.corrections.Clear();
+    }
+    device.disconnectTimeMs = _MAX(current_timeMs(), 1);
+    device.reopenTimeMs = 0;
+    device.reopenRetryTimeMs = 0;
+    m_hotplugStats.disconnects++;
+}
+
+bool InertialSense::HotplugReopen(int pHandle)
+{
+    ISDevice& device = m_comManagerState.devices[pHandle];
+    string port = device.serialPort.port;
+    {
+        cMutexLocker txLock(&m_comManagerState.txMutex);
+        if (!serialPortOpen(&device.serialPort, port.c_str(), m_baudRate, 0))
+        {
+            serialPortClose(&device.serialPort);
+            return false;
+        }
+    }
+
+    // Discard partial packet from before the disconnect
+    is_comm_init(&m_cmPorts[pHandle].comm, m_cmPorts[pHandle].comm_buffer, sizeof(m_cmPorts[pHandle].comm_buffer));
+
+    // Restore broadcasts
+    if (device.config->rmcPreset)
+    {
+        comManagerGetDataRmc(pHandle, device.config->rmcPreset, device.config->rmcOptions);
+    }
+    for (auto& bcast : device.config->broadcastPeriods)
+    {
+        comManagerGetData(pHandle, bcast.first, 0, 0, bcast.second);
+    }
+
+    device.reopenTimeMs = _MAX(current_timeMs(), 1);
+    m_hotplugStats.lastReopenMs = device.reopenTimeMs - device.disconnectTimeMs;
+    return true;
+}
+
+void InertialSense::UpdateHotplug()
+{
+    // Port removal or reappearance
+    vector<cISHotplugMonitor::sEvent> events;
+    m_hotplugMonitor.Poll(events);
+    for (auto& event : events)
+    {
+        for (auto& device : m_comManagerState.devices)
+        {
+            if (event.path != device.serialPort.port)
+            {
+                continue;
+            }
+            if (event.type == cISHotplugMonitor::EVENT_REMOVED)
+            {
+                if (device.serialPort.handle)
+                {
+                    HotplugDisconnect(device);
+                }
+            }
+            else if (device.disconnectTimeMs)
+            {   // Retry now
+                device.reopenRetryTimeMs = 0;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < m_comManagerState.devices.size(); i++)
+    {
+        ISDevice& device = m_comManagerState.devices[i];
+        if (device.serialPort.handle)
+        {   // Port read errors caught before the node removal event
+            int err = device.serialPort.errorCode;
+            if (err == EIO || err == ENXIO || err == ENODEV || !serialPortIsOpen(&device.serialPort))
+            {
+                HotplugDisconnect(device);
+            }
+        }
+        else if (device.disconnectTimeMs && (int32_t)(m_timeMs - device.reopenRetryTimeMs) >= 0)
+        {   // Reopen on node creation event, otherwise retry periodically.  Opening can fail until udev has set permissions.
+            if (!HotplugReopen((int)i))
+            {
+                device.reopenRetryTimeMs = m_timeMs + 200;
+            }
+        }
     }
+}
+
+void InertialSense::CloseSerialPorts(bool drainBeforeClose)
+{
+    // Template and port writes from other threads must finish before the ports go away
+    cMutexLocker lock(&m_dataTemplateMutex);
+    {
+        cMutexLocker txLock(&m_comManagerState.txMutex);
+        for (auto& device : m_comManagerState.devices)
+        {
+            if (drainBeforeClose)
+                serialPortDrain(&device.serialPort);
+
+            serialPortClose(&device.serialPort);
+        }
+    }
+    m_commandQueue.Clear();
+    m_hotplugMonitor.Close();
+    m_dataTemplates.clear();
+    cMutexLocker logMutexLocker(&m_logMutex);
     m_comManagerState.devices.clear();
 }
 
@@ -1857,7 +2159,7 @@ const dev_info_t InertialSense::DeviceInfo(int pHandle)
     {
         pHandle = 0;
     }
-    return m_comManagerState.devices[pHandle].devInfo;
+    return m_comManagerState.devices[pHandle].config->devInfo;
 }
 
 /**
@@ -1871,5 +2173,5 @@ system_command_t InertialSense::GetSysCmd(int pHandle)
     {
         pHandle = 0;
     }
-    return m_comManagerState.devices[pHandle].sysCmd;
+    return m_comManagerState.devices[pHandle].config->sysCmd;
 }
@@ -36,8 +36,12 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include "ISDevice.h"
 #include "ISClient.h"
 #include "message_stats.h"
+#include "ISRtcm3.h"
+#include "ISCommandQueue.h"
+#include "ISHotplugMonitor.h"
 #include "ISBootloaderThread.h"
 #include "ISFirmwareUpdater.h"
+#include "ISMemory.h"
 
 extern "C"
 {
@@ -77,6 +81,8 @@ public:
         int clientBufferSize;
         int* clientBytesToSend;
         int16_t discoveryTimeout = 5000;
+        time_t ggaTime = 0;                     // Last GGA position written to the client buffer
+        cMutex txMutex;                         // Serializes writes to the ports, see staticSendData()
     };
 
     typedef struct
@@ -157,6 +163,39 @@ public:
     */
     bool Update();
 
+    struct hotplug_stats_t
+    {
+        uint32_t disconnects;               // Ports lost
+        uint32_t reconnects;                // Ports reopened and receiving data again
+        uint32_t lastReopenMs;              // (ms) Port lost to port reopened
+        uint32_t lastRecoverMs;             // (ms) Port lost to first data received after reopen
+        uint32_t maxRecoverMs;
+        uint64_t totalRecoverMs;
+    };
+
+    /**
+    * Reopen serial ports that drop out (i.e. USB disconnect) when the device node reappears, instead of closing them.
+    * Device nodes are monitored with inotify on Linux.  After reopening, the RMC preset and DID broadcasts previously
+    * requested through this class are restored and logging continues into the same session.  Update() keeps returning
+    * true while a port is being recovered.
+    * @param enable true to recover ports
+    */
+    void EnableHotplugRecovery(bool enable);
+    const hotplug_stats_t& HotplugStats() { return m_hotplugStats; }
+
+    /**
+    * Set how long correction packets (i.e. RTCM3 from the client connection) may wait in a device's queue before they
+    * are dropped as stale.  Each device has its own queue drained with non-blocking writes, so a slow port only drops
+    * its own corrections.
+    * @param maxAgeMs (ms) queue age limit
+    */
+    void SetCorrectionMaxAge(uint32_t maxAgeMs);
+
+    /**
+    * @return correction forwarding latency and drop counters for a device, zeros if pHandle is invalid
+    */
+    cISCorrectionQueue::sStats CorrectionStats(int pHandle);
+
     /**
      * Register a callback handler for data stream errors.
      */
@@ -282,6 +321,52 @@ public:
     */
     void SendData(eDataIDs dataId, uint8_t* data, uint32_t length, uint32_t offset);
 
+    /**
+    * Create a preencoded packet template for sending one data set to one device repeatedly, i.e. DID_WHEEL_ENCODER or
+    * DID_POSITION_MEASUREMENT at 50-100 Hz.  The header and header checksum are encoded once.  SendDataTemplate() copies
+    * the payload into the packet, completes the checksum and writes it to the port in a single call.  Templates are
+    * released when the serial ports are closed.
+    * @param pHandle the device port handle
+    * @param dataId the data id of the data to send
+    * @param length length of data to send
+    * @param offset offset into data to send at
+    * @return template handle, -1 on failure
+    */
+    int CreateDataTemplate(int pHandle, eDataIDs dataId, uint32_t length, uint32_t offset = 0);
+
+    /**
+    * Send data using a packet template.  Safe to call from a producer thread other than the Update() thread; each
+    * packet is written whole, between packets sent by Update() on the same port.
+    * @param templateHandle handle returned by CreateDataTemplate()
+    * @param data payload data of the length given when the template was created
+    * @return true on success
+    */
+    bool SendDataTemplate(int templateHandle, const void* data);
+
+    /**
+    * Queue set data to be sent by the next Update().  Non-blocking and safe to call from any thread while Update() runs
+    * on another, unlike SendData().  The future and optional callback (called from the Update() thread) receive the
+    * device ACK/NACK, or STATUS_TIMEOUT if not sent and acknowledged within timeoutMs.
+    * @param pHandle the device port handle
+    * @param dataId the data id of the data to send
+    * @param data the data to send, copied
+    * @param length length of data to send
+    * @param offset offset into data to send at
+    * @param timeoutMs deadline relative to now
+    * @param callback optional completion callback
+    */
+    std::future<cISCommandQueue::eStatus> QueueSendData(int pHandle, eDataIDs dataId, const void* data, uint32_t length, uint32_t offset = 0, uint32_t timeoutMs = 1000, cISCommandQueue::pfnCompletion callback = NULLPTR);
+
+    /**
+    * Queue a data request, see QueueSendData() and GetData().  Completes with STATUS_ACK when the request is sent.
+    */
+    std::future<cISCommandQueue::eStatus> QueueGetData(int pHandle, eDataIDs dataId, uint16_t length = 0, uint16_t offset = 0, uint16_t period = 0, uint32_t timeoutMs = 1000, cISCommandQueue::pfnCompletion callback = NULLPTR);
+
+    /**
+    * Queue a system command (DID_SYS_CMD), see QueueSendData() and SetSysCmd().
+    */
+    std::future<cISCommandQueue::eStatus> QueueSysCmd(uint32_t command, int pHandle = 0, uint32_t timeoutMs = 1000, cISCommandQueue::pfnCompletion callback = NULLPTR);
+
     /**
     * Send raw data to the IMX - (byte swapping disabled)
     * @param dataId the data id of the data to send
@@ -338,11 +423,11 @@ public:
      * 
      * Key Concepts:
      * - Each device maintains local copies of flash configuration:
-     *      - IMX: device.imxFlashCfg
-     *      - GPX: device.gpxFlashCfg
+     *      - IMX: device.config->imxFlashCfg
+     *      - GPX: device.config->gpxFlashCfg
      * - The device also reports its flash configuration checksum via:
-     *      - IMX: device.sysParams.flashCfgChecksum
-     *      - GPX: device.gpxStatus.flashCfgChecksum
+     *      - IMX: device.config->sysParams.flashCfgChecksum
+     *      - GPX: device.config->gpxStatus.flashCfgChecksum
      * 
      * Synchronization Mechanism:
      * - Periodically (every SYNC_FLASH_CFG_CHECK_PERIOD_MS), SyncFlashConfig() compares
@@ -410,6 +495,7 @@ public:
 
     void ProcessRxData(int pHandle, p_data_t* data);
     void ProcessRxNmea(int pHandle, const uint8_t* msg, int msgSize);
+    void ProcessRxAck(int pHandle, p_ack_t* ack, unsigned char packetIdentifier);
 
     /**
      * Request a specific device broadcast binary data
@@ -447,6 +533,14 @@ public:
     */
     int ClientConnectionCurrent() { return m_clientConnectionsCurrent; }
 
+    /**
+    * Decode RTCM3 observations, ephemerides and base position passing through the client or server connection.
+    * Decoder stats provide live correction quality metrics (satellites, signal strength, latency, cycle slips).
+    * @param enable true to decode, false (default) to only forward
+    */
+    void EnableRtcm3Decode(bool enable) { m_rtcm3DecodeEnabled = enable; }
+    cRtcm3Decoder& Rtcm3Decoder() { return m_rtcm3Decoder; }
+
     /**
     * Get the total number of client connections
     * @return int number of total client that have connected
@@ -637,6 +731,9 @@ protected:
     void OnClientDisconnected(cISTcpServer* server, is_socket_t socket) OVERRIDE;
 
 private:
+    typedef is_counted_vector<p_data_buf_t, cISMemory::LOGGER_QUEUE> log_packet_vector_t;
+    typedef is_counted_map<int, log_packet_vector_t, cISMemory::LOGGER_QUEUE> log_packets_t;
+
     uint32_t m_timeMs;
     InertialSense::com_manager_cpp_state_t m_comManagerState;
     pfnIsCommAsapMsg       m_handlerRmc = NULLPTR;
@@ -648,7 +745,7 @@ private:
     cISLogger m_logger;
     void* m_logThread;
     cMutex m_logMutex;
-    std::map<int, std::vector<p_data_buf_t>> m_logPackets;
+    log_packets_t m_logPackets;             // Packets waiting for the logger thread, by pHandle
     time_t m_lastLogReInit;
 
     char m_clientBuffer[512];
@@ -662,6 +759,23 @@ private:
     int m_clientConnectionsCurrent = 0;
     int m_clientConnectionsTotal = 0;
     mul_msg_stats_t m_clientMessageStats = {};
+    bool m_rtcm3DecodeEnabled = false;
+    cRtcm3Decoder m_rtcm3Decoder;
+
+    struct data_template_t
+    {
+        int pHandle;
+        is_comm_pkt_template_t pkt;
+        std::vector<uint8_t> buf;
+    };
+    std::vector<data_template_t> m_dataTemplates;
+    cMutex m_dataTemplateMutex;
+    cISCommandQueue m_commandQueue;
+    bool m_hotplugEnabled = false;
+    cISHotplugMonitor m_hotplugMonitor;
+    hotplug_stats_t m_hotplugStats = {};
+    uint32_t m_correctionMaxAgeMs = CORRECTION_QUEUE_MAX_AGE_MS;
+    int m_baudRate = IS_BAUDRATE_DEFAULT;
 
     bool m_enableDeviceValidation = true;
     bool m_disableBroadcastsOnClose;
@@ -681,6 +795,10 @@ private:
     bool HasReceivedDeviceInfoFromAllDevices();
     void RemoveDevice(size_t index);
     bool OpenSerialPorts(const char* port, int baudRate);
+    void UpdateHotplug();
+    void HotplugDisconnect(ISDevice& device);
+    bool HotplugReopen(int pHandle);
+    void DrainCorrections(ISDevice& device);
     void CloseSerialPorts(bool drainBeforeClose = false);
     static void LoggerThread(void* info);
     static void StepLogger(InertialSense* i, const p_data_t* data, int pHandle);
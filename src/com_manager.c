@@ -167,6 +167,8 @@ int initComManagerInstanceInternal
         cmInstance->callbacks = *callbacks;
     }
     cmInstance->callbacks.isb = processIsb;
+    cmInstance->gnssTrimTxBytes = 0;
+    cmInstance->gnssTrimRxBytes = 0;
 
     if (buffers == NULL || cmPorts == NULL)
     {
@@ -464,6 +466,16 @@ int comManagerSend(int pHandle, uint8_t pFlags, void* data, uint16_t did, uint16
 int comManagerSendInstance(CMHANDLE cmInstance, int port, uint8_t pFlags, void *data, uint16_t did, uint16_t size, uint16_t offset)
 {
     com_manager_t *cm = (com_manager_t*)cmInstance;
+
+#if !PLATFORM_IS_EMBEDDED
+    if (data && (pFlags == PKT_TYPE_DATA || pFlags == PKT_TYPE_SET_DATA))
+    {   // Don't send unused sat/sig array entries
+        uint16_t trimmed = gnssArrayTrimSize(did, data, size, offset);
+        cm->gnssTrimTxBytes += size - trimmed;
+        size = trimmed;
+    }
+#endif
+
     int bytes = is_comm_write(cm->portWrite, port, &(cm->ports[port].comm), pFlags, did, size, offset, data);
 
     // Return 0 on success, -1 on failure
@@ -569,6 +581,19 @@ int processIsb(unsigned int pHandle, is_comm_instance_t *comm)
 // 		unsigned char additionalDataAvailable // function parameter removed 
 // 		(void)additionalDataAvailable;
 
+#endif
+
+#if !PLATFORM_IS_EMBEDDED
+        // Restore trimmed sat/sig arrays to full size so unused entries are zero rather than stale
+        uint8_t gnssBuf[_MAX(sizeof(gps_sat_t), sizeof(gps_sig_t))];
+        if (gnssArrayIsTrimmed(data.hdr.id, data.ptr, data.hdr.size, data.hdr.offset))
+        {
+            memcpy(gnssBuf, data.ptr, data.hdr.size);
+            uint16_t size = gnssArrayZeroFill(data.hdr.id, gnssBuf, data.hdr.size, 0);
+            cmInstance->gnssTrimRxBytes += size - data.hdr.size;
+            data.hdr.size = size;
+            data.ptr = gnssBuf;
+        }
 #endif
 
         if (regData)
@@ -165,6 +165,10 @@ typedef struct
 	// Message handlers
 	is_comm_callbacks_t callbacks;
 
+	// Bytes saved by trimming DID_GPS*_SAT/SIG arrays to numSats/numSigs (see gnssArrayTrimSize).  Host only.
+	uint64_t gnssTrimTxBytes;
+	uint64_t gnssTrimRxBytes;
+
 } com_manager_t;
 
 
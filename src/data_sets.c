@@ -12,6 +12,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include "data_sets.h"
 #include <stddef.h>
+#include <string.h>
 #include <math.h>
 
 const char* g_isHardwareTypeNames[IS_HARDWARE_TYPE_COUNT] = {"UNKNOWN", "uINS", "EVB", "IMX", "GPX"};
@@ -602,6 +603,73 @@ uint16_t* getStringOffsetsLengths(eDataIDs dataId, uint16_t* offsetsLength)
 	return 0;
 }
 
+// Element size and count of the sat/sig array.  The array count follows timeOfWeekMs and precedes the array.
+static int gnssArrayInfo(uint32_t dataId, uint16_t* elementSize, uint16_t* maxCount)
+{
+    STATIC_ASSERT(offsetof(gps_sat_t, numSats) == offsetof(gps_sig_t, numSigs));
+    STATIC_ASSERT(offsetof(gps_sat_t, sat) == offsetof(gps_sig_t, sig));
+
+    switch (dataId)
+    {
+    case DID_GPS1_SAT:
+    case DID_GPS2_SAT:
+        *elementSize = sizeof(gps_sat_sv_t);
+        *maxCount = MAX_NUM_SATELLITES;
+        return 1;
+
+    case DID_GPS1_SIG:
+    case DID_GPS2_SIG:
+        *elementSize = sizeof(gps_sig_sv_t);
+        *maxCount = MAX_NUM_SAT_SIGNALS;
+        return 1;
+    }
+    return 0;
+}
+
+uint16_t gnssArrayTrimSize(uint32_t dataId, const void* data, uint16_t size, uint16_t offset)
+{
+    uint16_t elementSize, maxCount;
+    uint32_t count, trimmed;
+    if (!gnssArrayInfo(dataId, &elementSize, &maxCount) || offset != 0 || size < offsetof(gps_sat_t, sat))
+    {
+        return size;
+    }
+
+    memcpy(&count, (const uint8_t*)data + offsetof(gps_sat_t, numSats), sizeof(count));
+    if (count > maxCount)
+    {
+        return size;
+    }
+    trimmed = offsetof(gps_sat_t, sat) + count * elementSize;
+    return (uint16_t)_MIN(trimmed, size);
+}
+
+int gnssArrayIsTrimmed(uint32_t dataId, const void* data, uint16_t size, uint16_t offset)
+{
+    uint16_t elementSize, maxCount;
+    uint32_t count;
+    if (!gnssArrayInfo(dataId, &elementSize, &maxCount) || offset != 0 || size < offsetof(gps_sat_t, sat))
+    {
+        return 0;
+    }
+
+    memcpy(&count, (const uint8_t*)data + offsetof(gps_sat_t, numSats), sizeof(count));
+    return count < maxCount && size == offsetof(gps_sat_t, sat) + count * elementSize;
+}
+
+uint16_t gnssArrayZeroFill(uint32_t dataId, void* data, uint16_t size, uint16_t offset)
+{
+    uint16_t elementSize, maxCount, fullSize;
+    if (!gnssArrayIsTrimmed(dataId, data, size, offset) || !gnssArrayInfo(dataId, &elementSize, &maxCount))
+    {
+        return size;
+    }
+
+    fullSize = (uint16_t)(offsetof(gps_sat_t, sat) + maxCount * elementSize);
+    memset((uint8_t*)data + size, 0, fullSize - size);
+    return fullSize;
+}
+
 uint32_t checksum32(const void* data, int count)
 {
 	if (count < 1 || count % 4 != 0)
@@ -5895,6 +5895,32 @@ Gets the offsets and lengths of strings given a data id
 */
 uint16_t* getStringOffsetsLengths(eDataIDs dataId, uint16_t* offsetsLength);
 
+/**
+Size of DID_GPS1_SAT, DID_GPS2_SAT, DID_GPS1_SIG or DID_GPS2_SIG data with the sat/sig array trimmed to numSats/numSigs
+entries.  The trimmed data is a valid partial (offset 0) update of the data set.
+
+@param dataId the data id
+@param data the data, starting at offset
+@param size the data size
+@param offset the data offset into the data set
+@return trimmed size, or size if the data id has no trimmable array, data does not start at offset 0 or the count is invalid
+*/
+uint16_t gnssArrayTrimSize(uint32_t dataId, const void* data, uint16_t size, uint16_t offset);
+
+/** @return 1 if data is a DID_GPS1_SAT, DID_GPS2_SAT, DID_GPS1_SIG or DID_GPS2_SIG array trimmed to numSats/numSigs, otherwise 0 */
+int gnssArrayIsTrimmed(uint32_t dataId, const void* data, uint16_t size, uint16_t offset);
+
+/**
+Restore trimmed DID_GPS1_SAT, DID_GPS2_SAT, DID_GPS1_SIG or DID_GPS2_SIG data to full size, zero filling unused entries.
+
+@param dataId the data id
+@param data the data, starting at offset.  Must hold the full data set.
+@param size the data size
+@param offset the data offset into the data set
+@return full data set size if data was trimmed, otherwise size
+*/
+uint16_t gnssArrayZeroFill(uint32_t dataId, void* data, uint16_t size, uint16_t offset);
+
 /** DID to RMC bit look-up table */
 extern const uint64_t g_didToRmcBit[DID_COUNT];
 uint64_t didToRmcBit(uint32_t dataId, uint64_t defaultRmcBits, uint64_t devInfoRmcBits);
@@ -117,6 +117,18 @@ static void updateTimeMs(msg_stats_t &s, int timeMs, int bytes)
     }
 }
 
+// Ids that would exceed the cISMemory::MESSAGE_STATS cap are counted together in untracked
+static bool canTrackNewId(mul_msg_stats_t &msgStats, int timeMs, int bytes)
+{
+	if (cISMemory::Available(cISMemory::MESSAGE_STATS, cISMemory::NodeBytes<msg_stats_map_t>()))
+	{
+		return true;
+	}
+	cISMemory::Shed(cISMemory::MESSAGE_STATS);
+	updateTimeMs(msgStats.untracked, timeMs, bytes);
+	return false;
+}
+
 void messageStatsAppend(string message, mul_msg_stats_t &msgStats, unsigned int ptype, int id, int bytes, int timeMs)
 {
 	switch (ptype)
@@ -125,6 +137,10 @@ void messageStatsAppend(string message, mul_msg_stats_t &msgStats, unsigned int
 	case _PTYPE_INERTIAL_SENSE_DATA:
 		if (msgStats.isb.find(id) == msgStats.isb.end())
 		{	// Create new 
+			if (!canTrackNewId(msgStats, timeMs, bytes))
+			{
+				break;
+			}
 			msgStats.isb[id] = createNewMsgStats(timeMs, cISDataMappings::DataName(id));
 		}
 
@@ -136,6 +152,10 @@ void messageStatsAppend(string message, mul_msg_stats_t &msgStats, unsigned int
 	case _PTYPE_NMEA:
 		if (msgStats.nmea.find(id) == msgStats.nmea.end())
 		{	// Create new 
+			if (!canTrackNewId(msgStats, timeMs, bytes))
+			{
+				break;
+			}
 			msgStats.nmea[id] = createNewMsgStats(timeMs);
 		}
 
@@ -147,6 +167,10 @@ void messageStatsAppend(string message, mul_msg_stats_t &msgStats, unsigned int
 	case _PTYPE_UBLOX:
 		if (msgStats.ublox.find(id) == msgStats.ublox.end())
 		{	// Create new 
+			if (!canTrackNewId(msgStats, timeMs, bytes))
+			{
+				break;
+			}
 			uint8_t msgClass = (uint8_t)id;
 			uint8_t msgID = (uint8_t)(id >> 8);
 			msgStats.ublox[id] = createNewMsgStats(timeMs, messageDescriptionUblox(msgClass, msgID));
@@ -160,6 +184,10 @@ void messageStatsAppend(string message, mul_msg_stats_t &msgStats, unsigned int
 	case _PTYPE_RTCM3:
 		if (msgStats.rtcm3.find(id) == msgStats.rtcm3.end())
 		{	// Create new 
+			if (!canTrackNewId(msgStats, timeMs, bytes))
+			{
+				break;
+			}
 			msgStats.rtcm3[id] = createNewMsgStats(timeMs, messageDescriptionRtcm3(id));
 		}
 
@@ -199,7 +227,7 @@ string messageStatsSummary(mul_msg_stats_t &msgStats)
 	{
 		str.append("Inertial Sense Binary: __________________\n");
 		str.append(" DID   Count  dtMs   Bps  Description\n");
-		std::map<int, msg_stats_t>::iterator it;
+		msg_stats_map_t::iterator it;
 		for (it = msgStats.isb.begin(); it != msgStats.isb.end(); it++)
 		{
 			int did = it->first;
@@ -215,7 +243,7 @@ string messageStatsSummary(mul_msg_stats_t &msgStats)
 	{
 		str.append("NMEA: __________________________________\n");
 		str.append("  ID   Count  dtMs   Bps  Description\n");
-		std::map<int, msg_stats_t>::iterator it;
+		msg_stats_map_t::iterator it;
 		for (it = msgStats.nmea.begin(); it != msgStats.nmea.end(); it++)
 		{
 			msg_stats_t &s = it->second;
@@ -235,7 +263,7 @@ string messageStatsSummary(mul_msg_stats_t &msgStats)
 	{
 		str.append("Ublox: __________________________________\n");
 		str.append("(Class  ID)   Count  dtMs   Bps  Description\n");
-		std::map<int, msg_stats_t>::iterator it;
+		msg_stats_map_t::iterator it;
 		for (it = msgStats.ublox.begin(); it != msgStats.ublox.end(); it++)
 		{
 			int id = it->first;
@@ -252,7 +280,7 @@ string messageStatsSummary(mul_msg_stats_t &msgStats)
 	{
 		str.append("RTCM3: __________________________________\n");
 		str.append("  ID   Count  dtMs   Bps  Description\n");
-		std::map<int, msg_stats_t>::iterator it;
+		msg_stats_map_t::iterator it;
 		for (it = msgStats.rtcm3.begin(); it != msgStats.rtcm3.end(); it++)
 		{
 			int id = it->first;
@@ -273,6 +301,15 @@ string messageStatsSummary(mul_msg_stats_t &msgStats)
 		str.append(string(buf));
 	}
 
+	if (msgStats.untracked.count)
+	{
+		str.append("Untracked (memory cap): _________________\n");
+		str.append("   Count   Bps\n");
+		msg_stats_t &s = msgStats.untracked;
+		SNPRINTF(buf, BUF_SIZE, "%8d %5d\n", s.count, s.bytesPerSec);
+		str.append(string(buf));
+	}
+
 #ifdef DEBUG
 	if (msgStats.parseError.count>5)
 	{
@@ -15,6 +15,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <string>
 
+#include "ISMemory.h"
+
 
 typedef struct
 {
@@ -27,14 +29,17 @@ typedef struct
     std::string description;
 } msg_stats_t;
 
+typedef is_counted_map<int, msg_stats_t, cISMemory::MESSAGE_STATS> msg_stats_map_t;
+
 typedef struct
 {
-    std::map<int, msg_stats_t> isb;
-    std::map<int, msg_stats_t> nmea;
-    std::map<int, msg_stats_t> ublox;
-    std::map<int, msg_stats_t> rtcm3;
+    msg_stats_map_t isb;
+    msg_stats_map_t nmea;
+    msg_stats_map_t ublox;
+    msg_stats_map_t rtcm3;
     msg_stats_t ack;
     msg_stats_t parseError;
+    msg_stats_t untracked;      // New message ids beyond the cISMemory::MESSAGE_STATS cap
 } mul_msg_stats_t;
 
 
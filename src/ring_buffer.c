@@ -92,8 +92,9 @@ int ringBufWrite(ring_buf_t *rb, unsigned char *buf, int numBytes)
 			// Copy data to end of buffer
 			memcpy((void *)rb->wrPtr, (void *)buf, bytesToEnd);
 
-			// Update pointer
+			// Update pointers
 			rb->wrPtr = rb->startPtr;
+			buf += bytesToEnd;
 
 			numBytes -= bytesToEnd;
 		}
@@ -239,15 +240,12 @@ int ringBufPeek(const ring_buf_t *rbuf, unsigned char *buf, int len, int offset)
  */
 unsigned char* ringfindChar(unsigned char* bufPtr, unsigned char* endPtr, unsigned char character)
 {
-	// Search for character
-	for (; bufPtr < endPtr; bufPtr++)
-	{
-		// Check for match
-		if (*bufPtr == character)
-			return bufPtr + 1;
-	}
+	if (bufPtr >= endPtr)
+		return 0;
+
+	unsigned char *fndPtr = (unsigned char*)memchr(bufPtr, character, endPtr - bufPtr);
 
-	return 0;
+	return (fndPtr ? fndPtr + 1 : 0);
 }
 
 
@@ -262,15 +260,16 @@ unsigned char* ringfindChar(unsigned char* bufPtr, unsigned char* endPtr, unsign
  */
 unsigned char* ringfindChar2(unsigned char* bufPtr, unsigned char* endPtr, unsigned char character1, unsigned char character2)
 {
-	// Search for character
-	for (; bufPtr < endPtr; bufPtr++)
-	{
-		// Check for match
-		if (*bufPtr == character1 || *bufPtr == character2)
-			return bufPtr + 1;
+	unsigned char *fndPtr = ringfindChar(bufPtr, endPtr, character1);
+
+	if (character2 != character1)
+	{	// Second character only needs searching up to the first
+		unsigned char *fndPtr2 = ringfindChar(bufPtr, (fndPtr ? fndPtr - 1 : endPtr), character2);
+		if (fndPtr2)
+			fndPtr = fndPtr2;
 	}
 
-	return 0;
+	return fndPtr;
 }
 
 
@@ -375,52 +374,67 @@ int ringBufReadToChar2(ring_buf_t *rbuf, unsigned char *buf, int len, unsigned c
 
 
 /**
- * \brief This function finds the index of the first matching string in the ring buffer.
- *  Returns -1 if not found.
- *
- * \param rbuf  Ring buffer struct pointer.
- * \param len   Length of data to attempt reading.
- * \param str	Character string to search for.
- *
- * \return Index of the first matching string.  -1 if not found.
+ * \brief This function returns the index of the first occurrence of str in the spans, -1 if not found.
+ *        Candidates are located with memchr on the first byte, then compared, including across the span boundary.
  */
-int ringBufFind(const ring_buf_t *rbuf, const unsigned char *str, int len)
+static int findInSpans(const ring_buf_span_t spans[2], const unsigned char *str, int len)
 {
-	int i;
-	int used = ringBufUsed(rbuf);
-	// 	int bytesToEnd = rbuf->endPtr - rbuf->rdPtr;
+	int used = spans[0].len + spans[1].len;
 
-	unsigned char *buf = (unsigned char*)(rbuf->rdPtr);
+	if (len <= 0)
+		return (used > 0 ? 0 : -1);
 
-	for (i = 0; i < used; i++)
+	int offset = 0;
+	for (int s = 0; s < 2; offset += spans[s].len, s++)
 	{
-		if (buf + len >= rbuf->endPtr)
-		{
-			// Handle wrapping
-			int len1 = (int)(buf + len - rbuf->endPtr);
-			int len2 = len - len1;
+		const unsigned char *ptr = spans[s].ptr;
+		const unsigned char *end = ptr + spans[s].len;
 
-			if (!strncmp((const char*)buf, (const char*)str, len1) && !strncmp((const char*)buf, (const char*)rbuf->startPtr, len2))
-				return i;
-		}
-		else
+		while (ptr < end && (ptr = (const unsigned char*)memchr(ptr, str[0], end - ptr)) != 0)
 		{
-			// Not Wrapping
-			if (!strncmp((const char*)buf, (const char*)str, len))
-				return i;
-		}
-
-		buf++;
+			int index = offset + (int)(ptr - spans[s].ptr);
+			if (index + len > used)
+				return -1;      // Later candidates are even shorter
 
-		// Handling wrapping
-		if (buf >= rbuf->endPtr)
-			buf = rbuf->startPtr;
+			// Part in this span, then the rest at the start of the second
+			int len1 = (int)(end - ptr);
+			if (len1 >= len)
+			{
+				if (!memcmp(ptr, str, len))
+					return index;
+			}
+			else if (!memcmp(ptr, str, len1) && !memcmp(spans[1].ptr, str + len1, len - len1))
+			{
+				return index;
+			}
+			ptr++;
+		}
 	}
 
 	return -1;
 }
 
 
+/**
+ * \brief This function finds the index of the first matching string in the ring buffer.
+ *  Returns -1 if not found.
+ *
+ * \param rbuf  Ring buffer struct pointer.
+ * \param str	Byte string to search for.  May contain zeros.
+ * \param len   Length of str.
+ *
+ * \return Index of the first matching string.  -1 if not found.
+ */
+int ringBufFind(const ring_buf_t *rbuf, const unsigned char *str, int len)
+{
+	ring_buf_span_t spans[2];
+
+	ringBufReadSpans(rbuf, spans);
+
+	return findInSpans(spans, str, len);
+}
+
+
 /**
  * \brief This function removes data from the ring buffer.
  *
@@ -482,3 +496,253 @@ int ringBufEmpty(const ring_buf_t *rbuf)
 {
 	return ringBufUsed(rbuf) == 0;
 }
+
+
+/**
+ * \brief This function gets the data in the ring buffer as up to two contiguous spans, oldest first.
+ *        Data can be parsed in place and then released with ringBufRemove().
+ *
+ * \return Number of bytes in both spans.
+ */
+int ringBufReadSpans(const ring_buf_t *rbuf, ring_buf_span_t spans[2])
+{
+	int used = ringBufUsed(rbuf);
+	int toEnd = (int)(rbuf->endPtr - rbuf->rdPtr);
+
+	spans[0].ptr = rbuf->rdPtr;
+	spans[0].len = (used < toEnd ? used : toEnd);
+	spans[1].ptr = rbuf->startPtr;
+	spans[1].len = used - spans[0].len;
+
+	return used;
+}
+
+
+//_____ S P S C ____________________________________________________________
+
+// Index published by one thread and observed by the other
+#if defined(__GNUC__) || defined(__clang__)
+#define RB_LOAD_ACQUIRE(x)          __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define RB_STORE_RELEASE(x, v)      __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#if defined(_M_ARM64)
+#define RB_BARRIER()                __dmb(_ARM64_BARRIER_ISH)
+#elif defined(_M_ARM)
+#define RB_BARRIER()                __dmb(_ARM_BARRIER_ISH)
+#else
+#define RB_BARRIER()                _ReadWriteBarrier()     // x86 loads and stores are already acquire and release
+#endif
+static __inline int rbLoadAcquire(const volatile int *x)         { int v = *x; RB_BARRIER(); return v; }
+static __inline void rbStoreRelease(volatile int *x, int v)      { RB_BARRIER(); *x = v; }
+#define RB_LOAD_ACQUIRE(x)          rbLoadAcquire(&(x))
+#define RB_STORE_RELEASE(x, v)      rbStoreRelease(&(x), (v))
+#else   // Single core targets, ordering between thread and ISR
+#define RB_LOAD_ACQUIRE(x)          (*(const volatile int*)&(x))
+#define RB_STORE_RELEASE(x, v)      (*(volatile int*)&(x) = (v))
+#endif
+
+
+/**
+ * \brief Initialize single producer, single consumer ring buffer.  Not thread safe.
+ */
+void ringBufSpscInit(ring_buf_spsc_t *rb, unsigned char *buf, int bufSize)
+{
+	memset(rb, 0, sizeof(*rb));
+	rb->startPtr = buf;
+	rb->bufSize = bufSize;
+}
+
+
+/**
+ * \brief Number of bytes in the buffer.  Exact for the consumer, a lower bound for the producer.
+ */
+int ringBufSpscUsed(const ring_buf_spsc_t *rb)
+{
+	int used = RB_LOAD_ACQUIRE(rb->wrIndex) - RB_LOAD_ACQUIRE(rb->rdIndex);
+
+	return (used < 0 ? used + rb->bufSize : used);
+}
+
+
+/**
+ * \brief Number of bytes that can be written.  Exact for the producer, a lower bound for the consumer.
+ */
+int ringBufSpscFree(const ring_buf_spsc_t *rb)
+{
+	return rb->bufSize - 1 - ringBufSpscUsed(rb);
+}
+
+
+/**
+ * \brief Free space as up to two spans to fill in place, then publish with ringBufSpscCommitWrite().
+ *
+ * \return Number of bytes in both spans.
+ */
+int ringBufSpscWriteSpans(ring_buf_spsc_t *rb, ring_buf_span_t spans[2])
+{
+	int wr = rb->wrIndex;
+	int rd = RB_LOAD_ACQUIRE(rb->rdIndex);
+	int bytesFree = rd - wr - 1;
+
+	if (bytesFree < 0)
+		bytesFree += rb->bufSize;
+
+	int toEnd = rb->bufSize - wr;
+	spans[0].ptr = rb->startPtr + wr;
+	spans[0].len = (bytesFree < toEnd ? bytesFree : toEnd);
+	spans[1].ptr = rb->startPtr;
+	spans[1].len = bytesFree - spans[0].len;
+
+	return bytesFree;
+}
+
+
+/**
+ * \brief Publish len bytes written into the spans from ringBufSpscWriteSpans().
+ */
+void ringBufSpscCommitWrite(ring_buf_spsc_t *rb, int len)
+{
+	int wr = rb->wrIndex + len;
+
+	if (wr >= rb->bufSize)
+		wr -= rb->bufSize;
+
+	RB_STORE_RELEASE(rb->wrIndex, wr);
+}
+
+
+/**
+ * \brief This function writes as much of buf as fits.
+ *
+ * \return Number of bytes written, less than len if the buffer is full.
+ */
+int ringBufSpscWrite(ring_buf_spsc_t *rb, const unsigned char *buf, int len)
+{
+	ring_buf_span_t spans[2];
+
+	if (len <= 0)
+		return 0;
+
+	int bytesFree = ringBufSpscWriteSpans(rb, spans);
+	if (len > bytesFree)
+		len = bytesFree;
+
+	int len1 = (len < spans[0].len ? len : spans[0].len);
+	memcpy(spans[0].ptr, buf, len1);
+	memcpy(spans[1].ptr, buf + len1, len - len1);
+
+	ringBufSpscCommitWrite(rb, len);
+
+	return len;
+}
+
+
+/**
+ * \brief Data as up to two spans, oldest first, to parse in place and then release with ringBufSpscRemove().
+ *
+ * \return Number of bytes in both spans.
+ */
+int ringBufSpscReadSpans(const ring_buf_spsc_t *rb, ring_buf_span_t spans[2])
+{
+	int rd = rb->rdIndex;
+	int used = RB_LOAD_ACQUIRE(rb->wrIndex) - rd;
+
+	if (used < 0)
+		used += rb->bufSize;
+
+	int toEnd = rb->bufSize - rd;
+	spans[0].ptr = rb->startPtr + rd;
+	spans[0].len = (used < toEnd ? used : toEnd);
+	spans[1].ptr = rb->startPtr;
+	spans[1].len = used - spans[0].len;
+
+	return used;
+}
+
+
+/**
+ * \brief Release up to len bytes back to the producer.
+ *
+ * \return Number of bytes removed.
+ */
+int ringBufSpscRemove(ring_buf_spsc_t *rb, int len)
+{
+	ring_buf_span_t spans[2];
+	int used = ringBufSpscReadSpans(rb, spans);
+
+	if (len > used)
+		len = used;
+	if (len <= 0)
+		return 0;
+
+	int rd = rb->rdIndex + len;
+	if (rd >= rb->bufSize)
+		rd -= rb->bufSize;
+
+	RB_STORE_RELEASE(rb->rdIndex, rd);
+
+	return len;
+}
+
+
+/**
+ * \brief This function copies up to len bytes starting offset bytes into the data, without removing them.
+ *
+ * \return Number of bytes copied.
+ */
+int ringBufSpscPeek(const ring_buf_spsc_t *rb, unsigned char *buf, int len, int offset)
+{
+	ring_buf_span_t spans[2];
+	int used = ringBufSpscReadSpans(rb, spans);
+
+	if (offset < 0 || offset >= used || len <= 0)
+		return 0;
+	if (len > used - offset)
+		len = used - offset;
+
+	int copied = 0;
+	if (offset < spans[0].len)
+	{
+		copied = spans[0].len - offset;
+		if (copied > len)
+			copied = len;
+		memcpy(buf, spans[0].ptr + offset, copied);
+		offset = 0;
+	}
+	else
+	{
+		offset -= spans[0].len;
+	}
+	memcpy(buf + copied, spans[1].ptr + offset, len - copied);
+
+	return len;
+}
+
+
+/**
+ * \brief This function reads and removes up to len bytes.
+ *
+ * \return Number of bytes read.
+ */
+int ringBufSpscRead(ring_buf_spsc_t *rb, unsigned char *buf, int len)
+{
+	len = ringBufSpscPeek(rb, buf, len, 0);
+
+	return ringBufSpscRemove(rb, len);
+}
+
+
+/**
+ * \brief This function finds the index of the first occurrence of str in the data.
+ *
+ * \return Index of the first match, -1 if not found.
+ */
+int ringBufSpscFind(const ring_buf_spsc_t *rb, const unsigned char *str, int len)
+{
+	ring_buf_span_t spans[2];
+
+	ringBufSpscReadSpans(rb, spans);
+
+	return findInSpans(spans, str, len);
+}
@@ -25,6 +25,30 @@ typedef struct
     int wordByteSize;                   // Byte size of a single element in the buffer
 } ring_buf_t;
 
+// Contiguous part of a ring buffer.  Used or free space is at most two spans, the second starting at the buffer start.
+typedef struct
+{
+	unsigned char *ptr;
+	int len;
+} ring_buf_span_t;
+
+#define RING_BUF_CACHE_LINE     64
+
+// Single producer, single consumer ring buffer.  Safe without locking when one thread (or ISR) only writes and
+// another only reads.  The write index is only stored by the producer and the read index only by the consumer,
+// each published with release and observed with acquire ordering, and kept on separate cache lines.
+// Capacity is bufSize - 1.  Writes never overwrite unread data.
+typedef struct
+{
+	unsigned char *startPtr;        // Buffer start
+	int bufSize;                    // Byte size of buffer
+	unsigned char pad0[RING_BUF_CACHE_LINE - sizeof(unsigned char*) - sizeof(int)];
+	int wrIndex;                    // Producer owned
+	unsigned char pad1[RING_BUF_CACHE_LINE - sizeof(int)];
+	int rdIndex;                    // Consumer owned
+	unsigned char pad2[RING_BUF_CACHE_LINE - sizeof(int)];
+} ring_buf_spsc_t;
+
 
 //_____ P R O T O T Y P E S ________________________________________________
 
@@ -40,6 +64,23 @@ int ringBufFind(const ring_buf_t *rbuf, const unsigned char *str, int len);
 int ringBufRemove(ring_buf_t *rbuf, int len);
 int ringBufClear(ring_buf_t *rbuf);
 int ringBufEmpty(const ring_buf_t *rbuf);
+int ringBufReadSpans(const ring_buf_t *rbuf, ring_buf_span_t spans[2]);
+
+void ringBufSpscInit(ring_buf_spsc_t *rb, unsigned char *buf, int bufSize);
+
+// Producer only
+int ringBufSpscWrite(ring_buf_spsc_t *rb, const unsigned char *buf, int len);
+int ringBufSpscWriteSpans(ring_buf_spsc_t *rb, ring_buf_span_t spans[2]);
+void ringBufSpscCommitWrite(ring_buf_spsc_t *rb, int len);
+int ringBufSpscFree(const ring_buf_spsc_t *rb);
+
+// Consumer only
+int ringBufSpscRead(ring_buf_spsc_t *rb, unsigned char *buf, int len);
+int ringBufSpscPeek(const ring_buf_spsc_t *rb, unsigned char *buf, int len, int offset);
+int ringBufSpscReadSpans(const ring_buf_spsc_t *rb, ring_buf_span_t spans[2]);
+int ringBufSpscRemove(ring_buf_spsc_t *rb, int len);
+int ringBufSpscFind(const ring_buf_spsc_t *rb, const unsigned char *str, int len);
+int ringBufSpscUsed(const ring_buf_spsc_t *rb);
 
 
 
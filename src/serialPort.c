@@ -243,6 +243,27 @@ int serialPortWrite(serial_port_t* serialPort, const unsigned char* buffer, int
 	return count;
 }
 
+int serialPortWriteNonBlocking(serial_port_t* serialPort, const unsigned char* buffer, int writeCount)
+{
+	if (serialPort == 0 || serialPort->handle == 0 || buffer == 0 || writeCount < 1)
+	{
+		return 0;
+	}
+
+	if (serialPort->pfnWriteNonBlocking == 0)
+	{
+		return serialPortWrite(serialPort, buffer, writeCount);
+	}
+
+	int count = serialPort->pfnWriteNonBlocking(serialPort, buffer, writeCount);
+
+	if (count > 0)
+	{
+		serialPort->txBytes += count;
+	}
+	return count;
+}
+
 int serialPortWriteLine(serial_port_t* serialPort, const unsigned char* buffer, int writeCount)
 {
 	if (serialPort == 0 || serialPort->handle == 0 || buffer == 0 || writeCount < 1)
@@ -113,6 +113,9 @@ struct serial_port_t
 	// write data synchronously
 	pfnSerialPortWrite pfnWrite;
 
+	// write only as much data as the OS accepts without waiting (optional, pfnWrite is used if 0)
+	pfnSerialPortWrite pfnWriteNonBlocking;
+
 	// close the serial port
 	pfnSerialPortClose pfnClose;
 
@@ -208,6 +211,10 @@ int serialPortReadCharTimeout(serial_port_t* serialPort, unsigned char* c, int t
 // write, returns the number of bytes written
 int serialPortWrite(serial_port_t* serialPort, const unsigned char* buffer, int writeCount);
 
+// write without waiting for space in the OS send buffer, returns the number of bytes accepted which may be less than writeCount.
+// returns -1 on port error (see errorCode).
+int serialPortWriteNonBlocking(serial_port_t* serialPort, const unsigned char* buffer, int writeCount);
+
 // write with a \r\n added at the end, \r\n should not be part of buffer, returns the number of bytes written
 int serialPortWriteLine(serial_port_t* serialPort, const unsigned char* buffer, int writeCount);
 
@@ -796,6 +796,43 @@ static int serialPortWritePlatform(serial_port_t* serialPort, const unsigned cha
 
 }
 
+static int serialPortWriteNonBlockingPlatform(serial_port_t* serialPort, const unsigned char* buffer, int writeCount)
+{
+#if PLATFORM_IS_WINDOWS
+
+    return serialPortWritePlatform(serialPort, buffer, writeCount);
+
+#else
+
+    serialPortHandle* handle = (serialPortHandle*)serialPort->handle;
+    if (!handle) {
+        serialPort->errorCode = ENODEV;
+        return -1;
+    }
+
+    // Single write() on the O_NONBLOCK descriptor.  A full OS buffer returns 0 so the caller can retry later.
+    ssize_t result;
+    do
+    {
+        result = write(handle->fd, buffer, writeCount);
+    } while ((result < 0) && (errno == EINTR));
+
+    if (result < 0)
+    {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+        {
+            return 0;
+        }
+        serialPort->errorCode = errno;
+        return -1;
+    }
+
+    debugDumpBuffer(">> ", buffer, (int)result);
+    return (int)result;
+
+#endif
+}
+
 static int serialPortGetByteCountAvailableToReadPlatform(serial_port_t* serialPort)
 {
     serialPortHandle* handle = (serialPortHandle*)serialPort->handle;
@@ -867,6 +904,7 @@ int serialPortPlatformInit(serial_port_t* serialPort)
     serialPort->pfnRead = serialPortReadTimeoutPlatform;
     serialPort->pfnAsyncRead = serialPortAsyncReadPlatform;
     serialPort->pfnWrite = serialPortWritePlatform;
+    serialPort->pfnWriteNonBlocking = serialPortWriteNonBlockingPlatform;
     serialPort->pfnGetByteCountAvailableToRead = serialPortGetByteCountAvailableToReadPlatform;
     serialPort->pfnGetByteCountAvailableToWrite = serialPortGetByteCountAvailableToWritePlatform;
     serialPort->pfnSleep = serialPortSleepPlatform;
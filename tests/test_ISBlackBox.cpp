@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "ISBlackBox.h"
+#include "data_sets.h"
+
+using namespace std;
+
+static vector<uint32_t> RingValues(cISBlackBoxRing& ring)
+{
+	vector<uint32_t> values;
+	ring.ForEach([&](const uint8_t* data, uint32_t size, uint32_t timeMs)
+	{
+		uint32_t value;
+		EXPECT_GE(size, sizeof(value));
+		memcpy(&value, data, sizeof(value));
+		EXPECT_EQ(value, timeMs);
+		values.push_back(value);
+	});
+	return values;
+}
+
+TEST(ISBlackBox, ring_wrap_evict)
+{
+	cISBlackBoxRing ring;
+	ring.Init(256);
+	EXPECT_EQ(ring.Capacity(), 256u);
+	EXPECT_FALSE(ring.Push(0, NULL, 512));
+
+	// Mixed record sizes so records wrap at uneven offsets
+	uint8_t pad[40] = {};
+	uint32_t next = 0;
+	for (int i = 0; i < 200; i++)
+	{
+		uint32_t value = i;
+		EXPECT_TRUE(ring.Push(value, &value, sizeof(value), pad, (i * 7) % sizeof(pad)));
+		vector<uint32_t> values = RingValues(ring);
+		ASSERT_EQ(values.size(), ring.Count());
+		ASSERT_FALSE(values.empty());
+		EXPECT_EQ(values.back(), value);
+		EXPECT_GE(values.front(), next);
+		for (size_t j = 1; j < values.size(); j++)
+		{
+			EXPECT_EQ(values[j], values[j - 1] + 1);
+		}
+		next = values.front();
+	}
+	EXPECT_EQ(ring.Evicted() + ring.Count(), 200u);
+
+	ring.Clear();
+	EXPECT_EQ(ring.Count(), 0u);
+	EXPECT_TRUE(RingValues(ring).empty());
+}
+
+TEST(ISBlackBox, trigger_window)
+{
+	cISBlackBox blackBox;
+	blackBox.Init(4096, 1000, 500);
+
+	for (uint32_t timeMs = 0; timeMs < 3000; timeMs += 100)
+	{
+		blackBox.Push(timeMs, (const uint8_t*)&timeMs, sizeof(timeMs));
+	}
+	EXPECT_FALSE(blackBox.Recording(3000));
+
+	// Only the pre-trigger window is written
+	vector<uint32_t> written;
+	auto write = [&](const uint8_t* data, uint32_t size)
+	{
+		uint32_t timeMs;
+		memcpy(&timeMs, data, sizeof(timeMs));
+		written.push_back(timeMs);
+	};
+	blackBox.Trigger(3000, write);
+	ASSERT_EQ(written.size(), 10u);
+	EXPECT_EQ(written.front(), 2000u);
+	EXPECT_EQ(written.back(), 2900u);
+	EXPECT_TRUE(blackBox.Recording(3499));
+	EXPECT_FALSE(blackBox.Recording(3500));
+
+	// Overlapping trigger extends the window
+	blackBox.Trigger(3400, write);
+	EXPECT_EQ(written.size(), 10u);
+	EXPECT_TRUE(blackBox.Recording(3899));
+	EXPECT_EQ(blackBox.Stats().triggers, 2u);
+	EXPECT_EQ(blackBox.Stats().flushedRecords, 10u);
+}
+
+TEST(ISBlackBox, fault_triggers)
+{
+	cISBlackBox blackBox;
+	blackBox.Init(1024, 1000, 500);
+
+	p_data_hdr_t hdr = { DID_SYS_PARAMS, sizeof(sys_params_t), 0 };
+	sys_params_t sys = {};
+	EXPECT_FALSE(blackBox.IsTrigger(&hdr, (uint8_t*)&sys));
+	sys.genFaultCode = 0x1;
+	EXPECT_TRUE(blackBox.IsTrigger(&hdr, (uint8_t*)&sys));
+	EXPECT_FALSE(blackBox.IsTrigger(&hdr, (uint8_t*)&sys));		// Fault persists
+	sys.genFaultCode = 0x3;
+	EXPECT_TRUE(blackBox.IsTrigger(&hdr, (uint8_t*)&sys));			// New fault bit
+
+	system_fault_t fault = {};
+	hdr = { DID_SYS_FAULT, sizeof(fault), 0 };
+	EXPECT_FALSE(blackBox.IsTrigger(&hdr, (uint8_t*)&fault));
+	fault.status = 1;
+	EXPECT_TRUE(blackBox.IsTrigger(&hdr, (uint8_t*)&fault));
+
+	did_event_t ev = {};
+	hdr = { DID_EVENT, sizeof(ev), 0 };
+	EXPECT_TRUE(blackBox.IsTrigger(&hdr, (uint8_t*)&ev));
+}
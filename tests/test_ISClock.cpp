@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "ISClock.h"
+#include "ISUtilities.h"
+#include "ISLogger.h"
+#include "ISFileManager.h"
+#include "InertialSense.h"
+#if !PLATFORM_IS_WINDOWS
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+
+static double realSec(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+
+TEST(ISClock, time_functions)
+{
+	uint64_t startUs = cISVirtualClock::DEFAULT_START_US + 123456;
+	cISVirtualClock clock(startUs);
+	{
+		cISClockScope scope(&clock);
+		EXPECT_EQ(&clock, cISClock::Installed());
+		EXPECT_EQ(startUs, current_timeUs());
+		EXPECT_EQ((unsigned int)(startUs / 1000), current_timeMs());
+		EXPECT_EQ((unsigned int)(startUs / 1000000), current_timeSec());
+		EXPECT_EQ((time_t)(startUs / 1000000), cISClock::UnixTime());
+		uint64_t tick = getTickCount();
+		EXPECT_GT(tick, 0u);
+
+		// Nothing moves until advanced
+		SLEEP_MS(5);
+		EXPECT_EQ(startUs, current_timeUs());
+
+		clock.AdvanceMs(1500);
+		EXPECT_EQ(startUs + 1500000, current_timeUs());
+		EXPECT_EQ(tick + 1500, getTickCount());
+		EXPECT_DOUBLE_EQ((startUs + 1500000) * 1.0e-6, current_timeSecD());
+
+		// Sleeping in a timeout loop advances instead of blocking
+		auto start = chrono::steady_clock::now();
+		unsigned int startMs = current_timeMs();
+		while (current_timeMs() - startMs < 3600000)
+		{
+			cISClock::Sleep(100);
+		}
+		EXPECT_LT(realSec(start), 1.0);
+		EXPECT_EQ(tick + 1500 + 3600000, getTickCount());
+
+		// Wall time may jump, ticks don't
+		clock.SetTimeUs(startUs);
+		EXPECT_EQ(startUs, current_timeUs());
+		EXPECT_EQ(tick + 1500 + 3600000, getTickCount());
+	}
+
+	// Platform time restored
+	EXPECT_EQ(NULLPTR, cISClock::Installed());
+	EXPECT_GT(cISClock::UnixTime(), (time_t)(cISVirtualClock::DEFAULT_START_US / 1000000));
+}
+
+
+TEST(ISClock, logger_system_time_rotation)
+{
+	string logPath = "test_clock_rotation";
+	ISFileManager::DeleteDirectory(logPath);
+
+	// Three hours of 10 Hz data with hourly files, starting half way into an hour
+	cISVirtualClock clock(1700002800ULL * 1000000 + 1800ULL * 1000000);
+	cISClockScope scope(&clock);
+	auto start = chrono::steady_clock::now();
+
+	cISLogger::sSaveOptions options(cISLogger::eLogType::LOGTYPE_DAT, 0.5f, 0, DEFAULT_LOGS_MAX_FILE_SIZE, false);
+	options.rotatePeriodSec = 3600;
+	cISLogger logger;
+	ASSERT_TRUE(logger.InitSave(logPath, options));
+	logger.EnableLogging(true);
+	dev_info_t info = {};
+	info.serialNumber = 123456;
+	std::shared_ptr<cDeviceLog> devLog = logger.registerDevice(info);
+
+	int count = 0;
+	for (uint32_t ms = 0; ms < 3 * 3600000; ms += 100)
+	{
+		ins_1_t ins = {};
+		ins.week = 2300;
+		ins.timeOfWeek = ms * 0.001;
+		p_data_hdr_t hdr = { DID_INS_1, sizeof(ins), 0 };
+		EXPECT_TRUE(logger.LogData(devLog, &hdr, (uint8_t*)&ins));
+		count++;
+		clock.AdvanceMs(100);
+	}
+	logger.CloseAllFiles();
+
+	// Partial first hour, 2 full hours, partial last hour
+	vector<ISFileManager::file_info_t> files;
+	ISFileManager::GetDirectorySpaceUsed(logPath, "[\\/\\\\]" IS_LOG_FILE_PREFIX "123456_.*\\.dat", files, false, false);
+	EXPECT_EQ(files.size(), 4u);
+
+	cISLogger reader;
+	ASSERT_TRUE(reader.LoadFromDirectory(logPath, cISLogger::eLogType::LOGTYPE_DAT));
+	std::shared_ptr<cDeviceLog> readLog = reader.DeviceLogBySerialNumber(123456);
+	ASSERT_NE(readLog, nullptr);
+	int readCount = 0;
+	while (reader.ReadData(readLog))
+	{
+		readCount++;
+	}
+	EXPECT_EQ(readCount, count);
+	printf("3 simulated hours of logging in %.2f s\n", realSec(start));
+	ISFileManager::DeleteDirectory(logPath);
+}
+
+
+#if !PLATFORM_IS_WINDOWS
+TEST(ISClock, inertial_sense_timeouts)
+{
+	// Device on a pty that never answers
+	int master = posix_openpt(O_RDWR | O_NOCTTY);
+	ASSERT_GE(master, 0);
+	ASSERT_EQ(0, grantpt(master));
+	ASSERT_EQ(0, unlockpt(master));
+	fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+	string slave = ptsname(master);
+
+	// Discard whatever the SDK sends so port writes never block
+	atomic<bool> running(true);
+	thread drain([&]()
+	{
+		char discard[4096];
+		pollfd fd = { master, POLLIN, 0 };
+		while (running)
+		{
+			if (poll(&fd, 1, 10) > 0)
+			{
+				while (read(master, discard, sizeof(discard)) > 0) {}
+			}
+		}
+	});
+
+	cISVirtualClock clock;
+	cISClockScope scope(&clock);
+	auto start = chrono::steady_clock::now();
+	{
+		InertialSense is;
+		is.EnableDeviceValidation(false);
+		ASSERT_TRUE(is.Open(slave.c_str(), 921600));
+
+		// Unacknowledged set data times out exactly at its deadline
+		for (int run = 0; run < 2; run++)
+		{
+			uint32_t startMs = current_timeMs();
+			uint32_t flag = 1;
+			future<cISCommandQueue::eStatus> status = is.QueueSendData(0, DID_SYS_CMD, &flag, sizeof(flag), 0, 60000);
+			uint32_t doneMs = 0;
+			while (!doneMs)
+			{
+				is.Update();
+				if (status.wait_for(chrono::seconds(0)) == future_status::ready)
+				{
+					doneMs = current_timeMs() - startMs;
+					break;
+				}
+				clock.AdvanceMs(100);
+			}
+			EXPECT_EQ(cISCommandQueue::STATUS_TIMEOUT, status.get());
+			EXPECT_EQ(60000u, doneMs);
+		}
+
+		// A 10 minute wait for the flash config returns when the virtual time is up.  Real time is mostly the 1 ms
+		// port read timeout of each Update().
+		uint32_t startMs = current_timeMs();
+		EXPECT_FALSE(is.WaitForImxFlashCfgSynced(false, 600000));
+		EXPECT_EQ(600100u, current_timeMs() - startMs);
+
+		is.Close();
+	}
+	running = false;
+	drain.join();
+	close(master);
+	double sec = realSec(start);
+	printf("12 simulated minutes of timeouts in %.2f s\n", sec);
+	EXPECT_LT(sec, 30.0);
+}
+
+
+// GGA for the correction server is rate limited on the installed clock, per instance
+TEST(ISClock, gga_upload_period)
+{
+	int master = posix_openpt(O_RDWR | O_NOCTTY);
+	ASSERT_GE(master, 0);
+	ASSERT_EQ(0, grantpt(master));
+	ASSERT_EQ(0, unlockpt(master));
+	fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+	string slave = ptsname(master);
+
+	cISVirtualClock clock;
+	cISClockScope scope(&clock);
+
+	gps_pos_t gps = {};
+	gps.status = GPS_STATUS_FIX_3D;
+	gps.lla[0] = 40.0;
+	gps.lla[1] = -111.0;
+	uint8_t buf[256];
+	uint8_t commBuf[256];
+	is_comm_instance_t comm;
+	is_comm_init(&comm, commBuf, sizeof(commBuf));
+	int size = is_comm_write_to_buf(buf, sizeof(buf), &comm, PKT_TYPE_DATA, DID_GPS1_POS, sizeof(gps), 0, &gps);
+	ASSERT_GT(size, 0);
+
+	for (int instance = 0; instance < 2; instance++)
+	{
+		InertialSense is;
+		is.EnableDeviceValidation(false);
+		ASSERT_TRUE(is.Open(slave.c_str(), 921600));
+		int& bytesToSend = *is.ComManagerState()->clientBytesToSend;
+		auto receiveGps = [&]()
+		{
+			bytesToSend = 0;
+			ASSERT_EQ(size, (int)write(master, buf, size));
+			for (int i = 0; i < 20; i++)
+			{
+				is.Update();
+			}
+			char discard[1024];
+			while (read(master, discard, sizeof(discard)) > 0) {}
+		};
+
+		// First position is sent, then not again for 5 s
+		receiveGps();
+		EXPECT_GT(bytesToSend, 0) << "instance " << instance;
+		clock.AdvanceMs(4000);
+		receiveGps();
+		EXPECT_EQ(bytesToSend, 0);
+		clock.AdvanceMs(2000);
+		receiveGps();
+		EXPECT_GT(bytesToSend, 0);
+		is.Close();
+	}
+	close(master);
+}
+#endif
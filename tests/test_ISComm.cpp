@@ -20,6 +20,7 @@ extern "C"
 #define BASIC_TX_RX_MULTI_BYTE_TEST          	1
 #define TXRX_MULTI_BYTE_PRECEEDED_BY_GARBAGE 	1
 #define TXRX_WITH_OFFSET_TEST                	1
+#define TXRX_PKT_TEMPLATE_TEST               	1
 #define SEGMENTED_RX_TEST                    	1
 #define BLAST_RX_TEST                        	1
 #define TEST_ALTERNATING_ISB_NMEA_PARSE_ERRORS  1
@@ -1042,6 +1043,60 @@ TEST(ISComm, TxRxWithOffsetTest)
 #endif
 
 
+#if TXRX_PKT_TEMPLATE_TEST
+// Tests preencoded packet templates match is_comm_write() output
+TEST(ISComm, TxRxPktTemplateTest)
+{
+	// Initialize Com Manager
+	init(tcm);
+
+	wheel_encoder_t wheel = {};
+	uint8_t tmplBuf[sizeof(wheel_encoder_t) + 10];
+	uint8_t refBuf[sizeof(wheel_encoder_t) + 10];
+	is_comm_pkt_template_t tmpl;
+	ASSERT_EQ(is_comm_template_init(&tmpl, tmplBuf, sizeof(wheel) + 7, PKT_TYPE_SET_DATA, DID_WHEEL_ENCODER, sizeof(wheel), 0), -1);
+	ASSERT_EQ(is_comm_template_init(&tmpl, tmplBuf, sizeof(tmplBuf), PKT_TYPE_SET_DATA, DID_WHEEL_ENCODER, sizeof(wheel), 0), (int)(sizeof(wheel) + 8));
+
+	for (int i = 0; i < 10; i++)
+	{
+		wheel.timeOfWeek = 1000.0 + i * 0.02;
+		wheel.theta_l = 0.1f * i;
+		wheel.omega_r = -0.2f * i;
+		wheel.wrap_count_l = i;
+		int n = is_comm_template_write(portWrite, 0, &g_comm, &tmpl, &wheel);
+		ASSERT_EQ(n, tmpl.size);
+		ASSERT_EQ(is_comm_write_to_buf(refBuf, sizeof(refBuf), &g_comm, PKT_TYPE_SET_DATA, DID_WHEEL_ENCODER, sizeof(wheel), 0, &wheel), n);
+		EXPECT_EQ(memcmp(tmplBuf, refBuf, n), 0);
+	}
+
+	// Payload updated in place with offset into data set
+	ASSERT_EQ(is_comm_template_init(&tmpl, tmplBuf, sizeof(tmplBuf), PKT_TYPE_SET_DATA, DID_WHEEL_ENCODER, sizeof(float), offsetof(wheel_encoder_t, omega_l)), (int)(sizeof(float) + 10));
+	float omega = 3.5f;
+	memcpy(tmpl.payload, &omega, sizeof(omega));
+	EXPECT_EQ(is_comm_template_write(portWrite, 0, NULL, &tmpl, NULL), tmpl.size);
+	ASSERT_EQ(is_comm_write_to_buf(refBuf, sizeof(refBuf), &g_comm, PKT_TYPE_SET_DATA, DID_WHEEL_ENCODER, sizeof(float), offsetof(wheel_encoder_t, omega_l), &omega), tmpl.size);
+	EXPECT_EQ(memcmp(tmplBuf, refBuf, tmpl.size), 0);
+
+	// Parse everything written to the port
+	is_comm_init(&g_comm, g_comm_buffer, COM_BUFFER_SIZE);
+	int n = ringBufUsed(&tcm.portTxBuf);
+	ringBufRead(&tcm.portTxBuf, g_comm.rxBuf.tail, n);
+	g_comm.rxBuf.tail += n;
+
+	wheel_encoder_t rxWheel = {};
+	for (int i = 0; i < 11; i++)
+	{
+		ASSERT_EQ(is_comm_parse(&g_comm), _PTYPE_INERTIAL_SENSE_DATA);
+		EXPECT_EQ(g_comm.rxPkt.dataHdr.id, DID_WHEEL_ENCODER);
+		is_comm_copy_to_struct(&rxWheel, &g_comm, sizeof(rxWheel));
+	}
+	EXPECT_EQ(rxWheel.timeOfWeek, wheel.timeOfWeek);
+	EXPECT_EQ(rxWheel.wrap_count_l, 9u);
+	EXPECT_EQ(rxWheel.omega_l, omega);
+	EXPECT_EQ(g_comm.rxErrorCount, 0);
+}
+#endif
+
 #if SEGMENTED_RX_TEST
 // Tests ISComm handles segmented serial data properly
 TEST(ISComm, SegmentedRxTest)
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include "ISCommDataBuffer.h"
+#include "ISFileManager.h"
+
+using namespace std;
+
+
+static void pushIns1(cComDataBuffer& buf, int pHandle, double timeOfWeek, uint32_t offset = 0, uint32_t size = sizeof(ins_1_t))
+{
+	ins_1_t ins = {};
+	ins.timeOfWeek = timeOfWeek;
+	ins.week = 2300;
+	ins.theta[0] = (float)timeOfWeek;
+	p_data_t data = {};
+	data.hdr.id = DID_INS_1;
+	data.hdr.offset = offset;
+	data.hdr.size = size;
+	data.ptr = (uint8_t*)&ins + offset;
+	EXPECT_EQ(0, buf.PushData(pHandle, &data));
+}
+
+
+TEST(ISCommDataBuffer, ring_wrap)
+{
+	cComDataBuffer buf;
+	buf.SetCapacity(8);
+
+	for (int i = 1; i <= 20; i++)
+	{
+		pushIns1(buf, 0, i);
+	}
+	EXPECT_EQ(8u, buf.Count(0, DID_INS_1));
+	EXPECT_EQ(12u, buf.Dropped(0, DID_INS_1));
+	EXPECT_EQ(0u, buf.Count(0, DID_INS_2));
+	EXPECT_EQ(0u, buf.Count(1, DID_INS_1));
+
+	// Oldest first
+	vector<uint8_t> item;
+	float timestamp = 0;
+	for (size_t i = 0; i < 8; i++)
+	{
+		ASSERT_EQ(0, buf.ReadItem(0, DID_INS_1, i, item, &timestamp));
+		ASSERT_EQ(sizeof(ins_1_t), item.size());
+		EXPECT_EQ(13.0 + i, ((ins_1_t*)item.data())->timeOfWeek);
+		EXPECT_FLOAT_EQ(13.0f + i, timestamp);
+	}
+	EXPECT_NE(0, buf.ReadItem(0, DID_INS_1, 8, item));
+
+	vector<uint8_t> all;
+	ASSERT_EQ(0, buf.ReadData(0, DID_INS_1, all));
+	ASSERT_EQ(8 * sizeof(ins_1_t), all.size());
+	for (size_t i = 0; i < 8; i++)
+	{
+		EXPECT_EQ(13.0 + i, ((ins_1_t*)&all[i * sizeof(ins_1_t)])->timeOfWeek);
+	}
+	EXPECT_NE(0, buf.ReadData(0, DID_INS_2, all));
+	EXPECT_TRUE(all.empty());
+
+	buf.Reset();
+	EXPECT_EQ(0u, buf.Count(0, DID_INS_1));
+}
+
+
+TEST(ISCommDataBuffer, partial_data_zero_filled)
+{
+	cComDataBuffer buf;
+
+	// Only theta, starting part way into the struct
+	pushIns1(buf, 0, 5.0, offsetof(ins_1_t, theta), sizeof(float) * 3);
+	// Out of bounds is stored as an all zero data set
+	pushIns1(buf, 0, 6.0, sizeof(ins_1_t) - 4, 8);
+
+	vector<uint8_t> item;
+	ASSERT_EQ(0, buf.ReadItem(0, DID_INS_1, 0, item));
+	ins_1_t* ins = (ins_1_t*)item.data();
+	EXPECT_EQ(0u, ins->week);
+	EXPECT_EQ(0.0, ins->timeOfWeek);
+	EXPECT_FLOAT_EQ(5.0f, ins->theta[0]);
+	EXPECT_EQ(0.0f, ins->uvw[0]);
+	EXPECT_EQ(0.0, ins->lla[2]);
+
+	ASSERT_EQ(0, buf.ReadItem(0, DID_INS_1, 1, item));
+	for (uint8_t b : item)
+	{
+		EXPECT_EQ(0, b);
+	}
+}
+
+
+TEST(ISCommDataBuffer, find_time_range)
+{
+	cComDataBuffer buf;
+	buf.SetCapacity(100);
+
+	// Wrap the ring so the search spans both halves
+	for (int i = 0; i < 150; i++)
+	{
+		pushIns1(buf, 2, 1000.0 + i * 0.5);
+	}
+
+	size_t first, last;
+	buf.FindTimeRange(2, DID_INS_1, 1030.0f, 1040.0f, first, last);
+	EXPECT_EQ(10u, first);      // 1025 is the oldest held
+	EXPECT_EQ(31u, last);
+
+	buf.FindTimeRange(2, DID_INS_1, 0.0f, 5000.0f, first, last);
+	EXPECT_EQ(0u, first);
+	EXPECT_EQ(100u, last);
+
+	buf.FindTimeRange(2, DID_INS_1, 2000.0f, 3000.0f, first, last);
+	EXPECT_EQ(first, last);
+
+	buf.FindTimeRange(0, DID_INS_1, 0.0f, 5000.0f, first, last);
+	EXPECT_EQ(0u, first);
+	EXPECT_EQ(0u, last);
+}
+
+
+TEST(ISCommDataBuffer, spill)
+{
+	string directory = "ISCommDataBufferSpill";
+	ISFileManager::DeleteDirectory(directory);
+
+	{
+		cComDataBuffer buf;
+		buf.SetCapacity(16);
+		ASSERT_TRUE(buf.EnableSpill(directory));
+
+		for (int i = 0; i < 100; i++)
+		{
+			pushIns1(buf, 1, i);
+		}
+		EXPECT_EQ(16u, buf.Count(1, DID_INS_1));
+		EXPECT_EQ(0u, buf.Dropped(1, DID_INS_1));
+
+		// Evicted items are read back ahead of those in memory
+		vector<uint8_t> all;
+		ASSERT_EQ(0, buf.ReadData(1, DID_INS_1, all));
+		ASSERT_EQ(100 * sizeof(ins_1_t), all.size());
+		for (size_t i = 0; i < 100; i++)
+		{
+			EXPECT_EQ((double)i, ((ins_1_t*)&all[i * sizeof(ins_1_t)])->timeOfWeek);
+		}
+
+		// Pushing after a read still appends
+		pushIns1(buf, 1, 100);
+		ASSERT_EQ(0, buf.ReadData(1, DID_INS_1, all));
+		EXPECT_EQ(101 * sizeof(ins_1_t), all.size());
+
+		// Reset removes spill files
+		vector<string> files;
+		ISFileManager::GetAllFilesInDirectory(directory, false, files);
+		EXPECT_EQ(1u, files.size());
+		buf.Reset();
+		files.clear();
+		ISFileManager::GetAllFilesInDirectory(directory, false, files);
+		EXPECT_EQ(0u, files.size());
+	}
+
+	ISFileManager::DeleteDirectory(directory);
+}
+
+
+// Set COM_DATA_BUFFER_BENCH to print throughput
+TEST(ISCommDataBuffer, benchmark)
+{
+	cComDataBuffer buf;
+	const int pushes = 1000000;
+
+	auto start = chrono::high_resolution_clock::now();
+	for (int i = 0; i < pushes; i++)
+	{
+		pushIns1(buf, 0, i * 0.001);
+	}
+	double pushSec = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+
+	vector<uint8_t> all;
+	const int reads = 1000;
+	start = chrono::high_resolution_clock::now();
+	for (int i = 0; i < reads; i++)
+	{
+		buf.ReadData(0, DID_INS_1, all);
+	}
+	double readSec = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+	EXPECT_EQ(COM_DATA_BUFFER_DEFAULT_HISTORY * sizeof(ins_1_t), all.size());
+	EXPECT_EQ((uint64_t)(pushes - COM_DATA_BUFFER_DEFAULT_HISTORY), buf.Dropped(0, DID_INS_1));
+
+	if (getenv("COM_DATA_BUFFER_BENCH"))
+	{
+		printf("PushData: %.1f M/s   ReadData (%d items): %.1f us\n", pushes / pushSec * 1e-6, COM_DATA_BUFFER_DEFAULT_HISTORY, readSec / reads * 1e6);
+	}
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "ISCommandQueue.h"
+
+using namespace std;
+
+struct sTestNode
+{
+	std::atomic<sTestNode*> next;
+	int producer;
+	int seq;
+};
+
+struct sSent
+{
+	int pHandle;
+	uint8_t pktType;
+	uint16_t did;
+	vector<uint8_t> data;
+	uint16_t offset;
+};
+
+static p_ack_t MakeAck(uint16_t did, uint16_t size, uint16_t offset)
+{
+	p_ack_t ack = {};
+	ack.hdr.pktInfo.flags = PKT_TYPE_SET_DATA;
+	ack.hdr.pktInfo.id = (uint8_t)did;
+	ack.body.dataHdr.id = did;
+	ack.body.dataHdr.size = size;
+	ack.body.dataHdr.offset = offset;
+	return ack;
+}
+
+TEST(ISCommandQueue, mpsc_order)
+{
+	const int producers = 4;
+	const int count = 50000;
+	cMpscQueue<sTestNode> queue;
+	vector<sTestNode> nodes(producers * count);
+
+	vector<thread> threads;
+	for (int p = 0; p < producers; p++)
+	{
+		threads.emplace_back([&, p]()
+		{
+			for (int i = 0; i < count; i++)
+			{
+				sTestNode& n = nodes[p * count + i];
+				n.producer = p;
+				n.seq = i;
+				queue.Push(&n);
+			}
+		});
+	}
+
+	// Consume concurrently, checking per producer order
+	vector<int> expected(producers, 0);
+	int received = 0;
+	while (received < producers * count)
+	{
+		sTestNode* n = queue.Pop();
+		if (n == NULLPTR)
+		{
+			this_thread::yield();
+			continue;
+		}
+		ASSERT_EQ(n->seq, expected[n->producer]);
+		expected[n->producer]++;
+		received++;
+	}
+	for (auto& t : threads)
+	{
+		t.join();
+	}
+	EXPECT_EQ(queue.Pop(), (sTestNode*)NULLPTR);
+}
+
+TEST(ISCommandQueue, completion)
+{
+	cISCommandQueue queue;
+	vector<sSent> sent;
+	bool sendOk = true;
+	auto send = [&](int pHandle, uint8_t pktType, uint16_t did, const void* data, uint16_t size, uint16_t offset)
+	{
+		sent.push_back({ pHandle, pktType, did, vector<uint8_t>((const uint8_t*)data, (const uint8_t*)data + size), offset });
+		return sendOk;
+	};
+
+	uint32_t value = 0x12345678;
+	int callbackCount = 0;
+	cISCommandQueue::eStatus callbackStatus = cISCommandQueue::STATUS_FAILED;
+	auto fAck = queue.Push(0, PKT_TYPE_SET_DATA, DID_SYS_CMD, &value, sizeof(value), 0, 1000,
+		[&](cISCommandQueue::eStatus status) { callbackCount++; callbackStatus = status; });
+	auto fNack = queue.Push(1, PKT_TYPE_SET_DATA, DID_FLASH_CONFIG, &value, sizeof(value), 8, 1000);
+	auto fTimeout = queue.Push(0, PKT_TYPE_SET_DATA, DID_WHEEL_ENCODER, &value, sizeof(value), 0, 600);
+	auto fGet = queue.Push(0, PKT_TYPE_GET_DATA, 0, &value, sizeof(value), 0, 1000);
+	auto fExpired = queue.Push(0, PKT_TYPE_SET_DATA, DID_SYS_CMD, &value, sizeof(value), 0, 90);
+
+	// Nothing happens until the consumer steps
+	EXPECT_EQ(fAck.wait_for(chrono::milliseconds(0)), future_status::timeout);
+
+	queue.Step(100, send);
+	ASSERT_EQ(sent.size(), 4u);
+	EXPECT_EQ(sent[0].did, DID_SYS_CMD);
+	EXPECT_EQ(sent[0].data.size(), sizeof(value));
+	EXPECT_EQ(sent[1].pHandle, 1);
+	EXPECT_EQ(sent[1].offset, 8);
+	EXPECT_EQ(sent[3].pktType, PKT_TYPE_GET_DATA);
+	EXPECT_EQ(queue.PendingCount(), 3u);
+	EXPECT_EQ(fGet.get(), cISCommandQueue::STATUS_ACK);
+	EXPECT_EQ(fExpired.get(), cISCommandQueue::STATUS_TIMEOUT);
+
+	// ACK for wrong port is ignored
+	p_ack_t ack = MakeAck(DID_FLASH_CONFIG, sizeof(value) + 2, 8);
+	queue.OnAck(0, &ack, PKT_TYPE_NACK);
+	EXPECT_EQ(queue.PendingCount(), 3u);
+	queue.OnAck(1, &ack, PKT_TYPE_NACK);
+	EXPECT_EQ(fNack.get(), cISCommandQueue::STATUS_NACK);
+
+	ack = MakeAck(DID_SYS_CMD, sizeof(value), 0);
+	queue.OnAck(0, &ack, PKT_TYPE_ACK);
+	EXPECT_EQ(fAck.get(), cISCommandQueue::STATUS_ACK);
+	EXPECT_EQ(callbackCount, 1);
+	EXPECT_EQ(callbackStatus, cISCommandQueue::STATUS_ACK);
+
+	queue.Step(599, send);
+	EXPECT_EQ(queue.PendingCount(), 1u);
+	queue.Step(600, send);
+	EXPECT_EQ(queue.PendingCount(), 0u);
+	EXPECT_EQ(fTimeout.get(), cISCommandQueue::STATUS_TIMEOUT);
+
+	// Port write failure and shutdown
+	sendOk = false;
+	auto fFailed = queue.Push(0, PKT_TYPE_SET_DATA, DID_SYS_CMD, &value, sizeof(value), 0, 2000);
+	queue.Step(700, send);
+	EXPECT_EQ(fFailed.get(), cISCommandQueue::STATUS_FAILED);
+	auto fCleared = queue.Push(0, PKT_TYPE_SET_DATA, DID_SYS_CMD, &value, sizeof(value), 0, 2000);
+	queue.Clear();
+	EXPECT_EQ(fCleared.get(), cISCommandQueue::STATUS_FAILED);
+}
+
+// Producers block on their futures while the consumer keeps stepping
+TEST(ISCommandQueue, concurrent_producers)
+{
+	const int producers = 4;
+	const int count = 2000;
+	cISCommandQueue queue;
+	atomic<bool> done(false);
+	atomic<int> acked(0);
+
+	thread consumer([&]()
+	{
+		uint32_t timeMs = 0;
+		while (!done)
+		{
+			vector<pair<int, uint16_t>> toAck;
+			queue.Step(timeMs++, [&](int pHandle, uint8_t pktType, uint16_t did, const void* data, uint16_t size, uint16_t offset)
+			{
+				toAck.push_back({ pHandle, did });
+				return true;
+			});
+			for (auto& a : toAck)
+			{
+				p_ack_t ack = MakeAck(a.second, 4, 0);
+				queue.OnAck(a.first, &ack, PKT_TYPE_ACK);
+			}
+		}
+	});
+
+	vector<thread> threads;
+	for (int p = 0; p < producers; p++)
+	{
+		threads.emplace_back([&, p]()
+		{
+			for (int i = 0; i < count; i++)
+			{
+				uint32_t value = i;
+				if (queue.Push(p, PKT_TYPE_SET_DATA, DID_WHEEL_ENCODER, &value, sizeof(value), 0, UINT32_MAX / 2).get() == cISCommandQueue::STATUS_ACK)
+				{
+					acked++;
+				}
+			}
+		});
+	}
+	for (auto& t : threads)
+	{
+		t.join();
+	}
+	done = true;
+	consumer.join();
+	EXPECT_EQ(acked, producers * count);
+}
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include "ISCorrectionQueue.h"
+
+using namespace std;
+
+static vector<uint8_t> MakePacket(int seq, int size)
+{
+	vector<uint8_t> pkt(size);
+	for (int i = 0; i < size; i++)
+	{
+		pkt[i] = (uint8_t)(seq + i);
+	}
+	return pkt;
+}
+
+TEST(ISCorrectionQueue, partial_writes)
+{
+	cISCorrectionQueue queue;
+	vector<uint8_t> port;
+	int room = 0;
+	auto write = [&](const uint8_t* data, int size)
+	{
+		int n = _MIN(size, room);
+		port.insert(port.end(), data, data + n);
+		room -= n;
+		return n;
+	};
+
+	vector<uint8_t> expected;
+	for (int i = 0; i < 10; i++)
+	{
+		vector<uint8_t> pkt = MakePacket(i, 100 + i);
+		expected.insert(expected.end(), pkt.begin(), pkt.end());
+		queue.Push(pkt.data(), (int)pkt.size(), 0);
+	}
+
+	// Port accepts 37 bytes per call
+	for (uint32_t t = 0; !queue.Empty(); t++)
+	{
+		room = 37;
+		ASSERT_TRUE(queue.Drain(t, write));
+		ASSERT_LT(t, 100u);
+	}
+	EXPECT_EQ(port, expected);
+	EXPECT_EQ(queue.Stats().sentPkts, 10u);
+	EXPECT_EQ(queue.Stats().droppedPkts, 0u);
+	EXPECT_GT(queue.Stats().maxLatencyMs, 0u);
+	EXPECT_EQ(queue.PendingBytes(), 0u);
+
+	// Port error
+	queue.Push(expected.data(), 10, 50);
+	EXPECT_FALSE(queue.Drain(50, [](const uint8_t*, int) { return -1; }));
+	EXPECT_EQ(queue.PendingBytes(), 10u);
+}
+
+// Another writer finishes the frame on the wire before sending its own packet
+TEST(ISCorrectionQueue, finish_partial)
+{
+	cISCorrectionQueue queue;
+	vector<uint8_t> port;
+	int room = 30;
+	auto write = [&](const uint8_t* data, int size)
+	{
+		int n = _MIN(size, room);
+		port.insert(port.end(), data, data + n);
+		room -= n;
+		return n;
+	};
+	auto blockingWrite = [&](const uint8_t* data, int size)
+	{
+		port.insert(port.end(), data, data + size);
+		return size;
+	};
+
+	vector<uint8_t> pkt0 = MakePacket(0, 100), pkt1 = MakePacket(1, 100);
+	queue.Push(pkt0.data(), 100, 0);
+	queue.Push(pkt1.data(), 100, 0);
+	ASSERT_TRUE(queue.Drain(0, write));
+	EXPECT_TRUE(queue.Partial());
+	EXPECT_TRUE(queue.FinishPartial(5, blockingWrite));
+	EXPECT_FALSE(queue.Partial());
+	EXPECT_EQ(port, pkt0);
+	EXPECT_EQ(queue.Stats().sentPkts, 1u);
+	EXPECT_EQ(queue.PendingBytes(), 100u);
+
+	// Nothing started, nothing written
+	EXPECT_TRUE(queue.FinishPartial(5, blockingWrite));
+	EXPECT_EQ(port.size(), 100u);
+
+	// Port stops accepting, the rest of the frame is dropped
+	room = 10;
+	ASSERT_TRUE(queue.Drain(10, write));
+	EXPECT_FALSE(queue.FinishPartial(10, [](const uint8_t*, int) { return 0; }));
+	EXPECT_FALSE(queue.Partial());
+	EXPECT_TRUE(queue.Empty());
+	EXPECT_EQ(queue.PendingBytes(), 0u);
+	EXPECT_EQ(queue.Stats().droppedPkts, 1u);
+	EXPECT_EQ(queue.Stats().droppedBytes, 90u);
+}
+
+TEST(ISCorrectionQueue, stale_drop)
+{
+	cISCorrectionQueue queue(1000, 1000);
+	vector<uint8_t> port;
+	bool stalled = true;
+	auto write = [&](const uint8_t* data, int size)
+	{
+		if (stalled)
+		{
+			return 0;
+		}
+		port.insert(port.end(), data, data + size);
+		return size;
+	};
+
+	vector<uint8_t> pkt = MakePacket(0, 100);
+	queue.Push(pkt.data(), 100, 0);
+	queue.Push(pkt.data(), 100, 500);
+	queue.Drain(500, write);
+	EXPECT_EQ(queue.PendingBytes(), 200u);
+
+	// First epoch ages out
+	queue.Drain(1001, write);
+	EXPECT_EQ(queue.Stats().droppedPkts, 1u);
+	EXPECT_EQ(queue.PendingBytes(), 100u);
+
+	// Size limit drops oldest
+	for (int i = 0; i < 12; i++)
+	{
+		queue.Push(pkt.data(), 100, 1100);
+	}
+	EXPECT_EQ(queue.PendingBytes(), 1000u);
+	EXPECT_EQ(queue.Stats().droppedPkts, 4u);
+	EXPECT_EQ(queue.Stats().droppedBytes, 400u);
+
+	stalled = false;
+	queue.Drain(1200, write);
+	EXPECT_EQ(port.size(), 1000u);
+	EXPECT_EQ(queue.Stats().sentPkts, 10u);
+	EXPECT_EQ(queue.Stats().lastLatencyMs, 100u);
+}
+
+// One base stream fanned out to 16 rovers with one stalled port
+TEST(ISCorrectionQueue, fan_out)
+{
+	const int devices = 16;
+	vector<cISCorrectionQueue> queues(devices);
+	vector<size_t> received(devices, 0);
+
+	vector<uint8_t> pkt = MakePacket(0, 300);
+	for (uint32_t t = 0; t < 10000; t += 100)
+	{
+		for (int d = 0; d < devices; d++)
+		{
+			queues[d].Push(pkt.data(), (int)pkt.size(), t);
+			queues[d].Drain(t, [&, d](const uint8_t*, int size)
+			{
+				int n = (d == 3 ? 0 : size);
+				received[d] += n;
+				return n;
+			});
+		}
+	}
+
+	for (int d = 0; d < devices; d++)
+	{
+		if (d == 3)
+		{
+			EXPECT_EQ(received[d], 0u);
+			EXPECT_LE(queues[d].PendingBytes(), (size_t)CORRECTION_QUEUE_MAX_BYTES);
+			EXPECT_GT(queues[d].Stats().droppedPkts, 0u);
+		}
+		else
+		{
+			EXPECT_EQ(received[d], 100 * pkt.size());
+			EXPECT_EQ(queues[d].Stats().maxLatencyMs, 0u);
+			EXPECT_EQ(queues[d].Stats().droppedPkts, 0u);
+		}
+	}
+}
@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <regex>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "ISFileManager.h"
+
+using namespace std;
+
+
+// Previous implementation: readdir, stat by path and std::regex per entry
+static void referenceWalk(const string& directory, const regex* re, vector<ISFileManager::file_info_t>& files)
+{
+	DIR* dir = opendir(directory.c_str());
+	if (dir == NULL)
+	{
+		return;
+	}
+	struct dirent* ent;
+	while ((ent = readdir(dir)) != NULL)
+	{
+		string name = ent->d_name;
+		string path = directory + "/" + name;
+		struct stat st;
+		if (name[0] == '.' || stat(path.c_str(), &st) == -1 || (re && !regex_search(path, *re)))
+		{
+			continue;
+		}
+		if (S_ISDIR(st.st_mode))
+		{
+			referenceWalk(path, re, files);
+			continue;
+		}
+		files.push_back({ path, (uint64_t)st.st_size, st.st_mtime });
+	}
+	closedir(dir);
+}
+
+static void createFile(const string& path, size_t size)
+{
+	FILE* f = fopen(path.c_str(), "wb");
+	ASSERT_NE(f, nullptr);
+	for (size_t i = 0; i < size; i++)
+	{
+		fputc('x', f);
+	}
+	fclose(f);
+}
+
+
+TEST(ISFileManager, path_pattern)
+{
+	const char* patterns[] =
+	{
+		"\\.dat$",
+		"\\.(dat|raw)$",
+		"[\\/\\\\]LOG_SN60339_.*\\.dat",
+		"LOG_SN60339.*?DID_INS_1\\.csv$",
+		"^logs/a.c",
+	};
+	const char* paths[] =
+	{
+		"logs/LOG_SN60339_20240101_120000_0001.dat",
+		"logs/LOG_SN60339_20240101_120000_0001.DAT",
+		"logs\\LOG_SN60339_20240101_120000_0001.dat",
+		"logs/LOG_SN60339_20240101_120000_0001.dat.tmp",
+		"logs/LOG_SN60338_20240101_120000_0001.dat",
+		"logs/XLOG_SN60339_1.dat",
+		"logs/LOG_SN60339_20240101_120000_0001.raw",
+		"logs/LOG_SN60339_20240101_120000_DID_INS_1.csv",
+		"logs/LOG_SN60339_20240101_120000_DID_INS_12.csv",
+		"logs/abc",
+		"xlogs/abc",
+		"stats_all.txt",
+		"",
+	};
+
+	for (const char* p : patterns)
+	{
+		ISFileManager::cPathPattern pattern(p);
+		EXPECT_TRUE(pattern.IsGlob()) << p;
+		regex re(p, regex::icase);
+		for (const char* path : paths)
+		{
+			EXPECT_EQ(pattern.Match(path), regex_search(string(path), re)) << p << "  " << path;
+		}
+	}
+
+	// Unsupported syntax falls back to std::regex
+	ISFileManager::cPathPattern digits("[\\/\\\\][0-9]+\\.dat");
+	EXPECT_FALSE(digits.IsGlob());
+	EXPECT_TRUE(digits.Match("logs/123.dat"));
+	EXPECT_FALSE(digits.Match("logs/a123.dat"));
+
+	EXPECT_TRUE(ISFileManager::cPathPattern().Match("anything"));
+}
+
+
+TEST(ISFileManager, directory_walk)
+{
+	string root = "test_file_manager_walk";
+	ISFileManager::DeleteDirectory(root);
+	ISFileManager::CreateDirectory(root + "/a/b");
+	ISFileManager::CreateDirectory(root + "/c");
+	createFile(root + "/1.dat", 10);
+	createFile(root + "/2.raw", 20);
+	createFile(root + "/.hidden", 5);
+	createFile(root + "/a/3.dat", 30);
+	createFile(root + "/a/b/4.dat", 40);
+	createFile(root + "/c/5.txt", 50);
+
+	vector<string> files;
+	EXPECT_TRUE(ISFileManager::GetAllFilesInDirectory(root, true, files));
+	EXPECT_EQ(files.size(), 5u);
+	files.clear();
+	EXPECT_TRUE(ISFileManager::GetAllFilesInDirectory(root, false, "\\.dat$", files));
+	ASSERT_EQ(files.size(), 1u);
+	EXPECT_EQ(files[0], root + "/1.dat");
+
+	vector<ISFileManager::file_info_t> infos;
+	EXPECT_EQ(ISFileManager::GetDirectorySpaceUsed(root, infos, false, true), 150u);
+	ASSERT_EQ(infos.size(), 5u);
+	EXPECT_EQ(infos[0].name, root + "/1.dat");
+	EXPECT_EQ(infos[0].size, 10u);
+	EXPECT_EQ(infos[4].name, root + "/c/5.txt");
+	EXPECT_GT(infos[4].lastModificationDate, 0);
+
+	// Same results as the previous implementation
+	vector<ISFileManager::file_info_t> reference;
+	referenceWalk(root, NULL, reference);
+	EXPECT_EQ(reference.size(), infos.size());
+
+	// Culling removes oldest first, including hidden files
+	ISFileManager::RemoveOldestFiles(root, 0);
+	files.clear();
+	EXPECT_FALSE(ISFileManager::GetAllFilesInDirectory(root, true, files));
+	struct stat st;
+	EXPECT_NE(stat((root + "/.hidden").c_str(), &st), 0);
+	ISFileManager::DeleteDirectory(root);
+}
+
+
+// A small tree checked against the previous implementation.  Set FILE_MANAGER_BENCH for 100k files and timing.
+TEST(ISFileManager, benchmark)
+{
+	string root = "test_file_manager_benchmark";
+	bool bench = (getenv("FILE_MANAGER_BENCH") != NULL);
+	const int dirs = (bench ? 100 : 4);
+	const int filesPerDir = (bench ? 1000 : 50);
+	ISFileManager::DeleteDirectory(root);
+	for (int d = 0; d < dirs; d++)
+	{
+		string dir = root + "/" + to_string(d);
+		ISFileManager::CreateDirectory(dir);
+		for (int f = 0; f < filesPerDir; f++)
+		{
+			char name[64];
+			snprintf(name, sizeof(name), "/LOG_SN%d_20240101_120000_%04d.%s", 1000 + d % 4, f, (f % 10 ? "dat" : "txt"));
+			createFile(dir + name, 0);
+		}
+	}
+
+	// Whole tree with size and time, as used for log culling
+	auto start = chrono::high_resolution_clock::now();
+	vector<ISFileManager::file_info_t> reference;
+	referenceWalk(root, NULL, reference);
+	double referenceSec = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+
+	start = chrono::high_resolution_clock::now();
+	vector<ISFileManager::file_info_t> infos;
+	ISFileManager::GetDirectorySpaceUsed(root, infos, false, true);
+	double walkSec = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+	EXPECT_EQ(infos.size(), (size_t)(dirs * filesPerDir));
+	EXPECT_EQ(reference.size(), infos.size());
+
+	// Names only, no stat unless the file system doesn't report the entry type
+	start = chrono::high_resolution_clock::now();
+	vector<string> names;
+	ISFileManager::GetAllFilesInDirectory(root, true, names);
+	double listSec = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+	EXPECT_EQ(names.size(), infos.size());
+
+	// Log file pattern over all paths
+	regex re("[\\/\\\\]LOG_SN1001_.*\\.dat", regex::icase);
+	ISFileManager::cPathPattern pattern("[\\/\\\\]LOG_SN1001_.*\\.dat");
+	start = chrono::high_resolution_clock::now();
+	size_t regexCount = 0;
+	for (auto& info : infos)
+	{
+		regexCount += regex_search(info.name, re);
+	}
+	double regexSec = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+	start = chrono::high_resolution_clock::now();
+	size_t globCount = 0;
+	for (auto& info : infos)
+	{
+		globCount += pattern.Match(info.name);
+	}
+	double globSec = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+	EXPECT_EQ(regexCount, globCount);
+	EXPECT_EQ(globCount, (size_t)(dirs / 4 * filesPerDir * 9 / 10));
+
+	if (bench)
+	{
+		printf("%d files  readdir+stat: %.1f ms  getdents64+fstatat: %.1f ms  getdents64 names: %.1f ms  regex: %.1f ms  glob: %.1f ms\n",
+			dirs * filesPerDir, referenceSec * 1e3, walkSec * 1e3, listSec * 1e3, regexSec * 1e3, globSec * 1e3);
+	}
+
+	ISFileManager::DeleteDirectory(root);
+}
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include "ISHotplugMonitor.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static void touch(const fs::path& path)
+{
+	ofstream f(path);
+}
+
+TEST(ISHotplugMonitor, add_remove)
+{
+	fs::path dir = fs::temp_directory_path() / "is_hotplug_test";
+	fs::remove_all(dir);
+	fs::create_directories(dir);
+	fs::path node = dir / "ttyACM0";
+	fs::path other = dir / "ttyACM1";
+	touch(node);
+
+	cISHotplugMonitor monitor;
+	ASSERT_TRUE(monitor.Watch(node.string()));
+	EXPECT_TRUE(monitor.IsOpen());
+
+	vector<cISHotplugMonitor::sEvent> events;
+	EXPECT_EQ(monitor.Poll(events), 0);
+
+	// Unrelated node in the same directory is ignored
+	touch(other);
+	fs::remove(node);
+	ASSERT_EQ(monitor.Poll(events), 1);
+	EXPECT_EQ(events[0].type, cISHotplugMonitor::EVENT_REMOVED);
+	EXPECT_EQ(events[0].path, node.string());
+
+	events.clear();
+	touch(node);
+	ASSERT_GE(monitor.Poll(events), 1);
+	EXPECT_EQ(events[0].type, cISHotplugMonitor::EVENT_ADDED);
+	EXPECT_EQ(events[0].path, node.string());
+
+	monitor.Close();
+	fs::remove(node);
+	events.clear();
+	EXPECT_EQ(monitor.Poll(events), 0);
+	fs::remove_all(dir);
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include "ISLogCompare.h"
+#include "ISLogger.h"
+#include "ISFileManager.h"
+#include "yaml-cpp/yaml.h"
+
+using namespace std;
+
+// 10 Hz INS and 1 Hz GPS from one device.  thetaError is added to INS theta[0] of every record, and badIndex (if
+// not negative) gets an extra 0.1.  GPS record dropGps (if not negative) is not logged.
+static void WriteLog(const string& path, uint32_t serial, int count, float thetaError, int badIndex, int dropGps)
+{
+	ISFileManager::DeleteDirectory(path);
+	cISLogger::sSaveOptions options(cISLogger::LOGTYPE_DAT, 0.5f, 0, DEFAULT_LOGS_MAX_FILE_SIZE, false);
+	cISLogger logger;
+	ASSERT_TRUE(logger.InitSave(path, options));
+	logger.EnableLogging(true);
+	std::shared_ptr<cDeviceLog> devLog = logger.registerDevice(0, serial);
+
+	for (int i = 0; i < count; i++)
+	{
+		uint32_t towMs = 3600000 + i * 100;
+		if (i % 10 == 0 && i / 10 != dropGps)
+		{
+			gps_pos_t pos = {};
+			pos.week = 2300;
+			pos.timeOfWeekMs = towMs;
+			pos.lla[0] = 40.0 + i * 1e-6;
+			p_data_hdr_t hdr = { DID_GPS1_POS, sizeof(pos), 0 };
+			logger.LogData(devLog, &hdr, (uint8_t*)&pos);
+		}
+		ins_1_t ins = {};
+		ins.week = 2300;
+		ins.timeOfWeek = towMs * 0.001;
+		ins.theta[0] = 0.5f + i * 1e-4f + thetaError + (i == badIndex ? 0.1f : 0.0f);
+		ins.theta[1] = -0.25f;
+		p_data_hdr_t hdr = { DID_INS_1, sizeof(ins), 0 };
+		logger.LogData(devLog, &hdr, (uint8_t*)&ins);
+	}
+	logger.CloseAllFiles();
+}
+
+
+TEST(ISLogCompare, identical)
+{
+	WriteLog("test_log_compare_a", 1001, 1000, 0.0f, -1, -1);
+	WriteLog("test_log_compare_b", 2002, 1000, 0.0f, -1, -1);
+
+	// Single device logs are compared regardless of serial number
+	cISLogCompare compare;
+	ASSERT_TRUE(compare.Compare("test_log_compare_a", "test_log_compare_b"));
+	EXPECT_TRUE(compare.Passed());
+	ASSERT_EQ(compare.Results().size(), 2u);
+	for (auto& r : compare.Results())
+	{
+		EXPECT_EQ(r.serialA, 1001u);
+		EXPECT_EQ(r.serialB, 2002u);
+		EXPECT_EQ(r.paired, r.countA);
+		EXPECT_EQ(r.violations, 0u);
+	}
+	EXPECT_EQ(compare.Results()[0].did, (uint32_t)DID_INS_1);
+	EXPECT_EQ(compare.Results()[0].paired, 1000u);
+	EXPECT_EQ(compare.Results()[1].did, (uint32_t)DID_GPS1_POS);
+	EXPECT_EQ(compare.Results()[1].paired, 100u);
+
+	EXPECT_FALSE(compare.Compare("test_log_compare_a", "test_log_compare_missing"));
+
+	ISFileManager::DeleteDirectory("test_log_compare_a");
+	ISFileManager::DeleteDirectory("test_log_compare_b");
+}
+
+
+TEST(ISLogCompare, differences)
+{
+	WriteLog("test_log_compare_a", 1001, 1000, 0.0f, -1, -1);
+	WriteLog("test_log_compare_b", 1001, 1000, 1e-5f, 250, 42);
+
+	cISLogCompare::sOptions options;
+	options.fieldTolerances["DID_INS_1.theta"].abs = 1e-4;
+	options.threads = 4;
+	cISLogCompare compare;
+	ASSERT_TRUE(compare.Compare("test_log_compare_a", "test_log_compare_b", cISLogger::LOGTYPE_DAT, options));
+	EXPECT_FALSE(compare.Passed());
+
+	ASSERT_EQ(compare.Results().size(), 2u);
+	const cISLogCompare::sDidResult& ins = compare.Results()[0];
+	EXPECT_EQ(ins.paired, 1000u);
+	EXPECT_EQ(ins.violations, 1u);
+	EXPECT_EQ(ins.firstFailure.indexA, 250u);
+	EXPECT_EQ(ins.firstFailure.field, "theta[0]");
+	EXPECT_NEAR(ins.firstFailure.time, 3600.0 + 25.0, 1e-9);
+	EXPECT_NEAR(ins.firstFailure.error, 0.1, 1e-4);
+	auto theta0 = find_if(ins.fields.begin(), ins.fields.end(), [](const cISLogCompare::sFieldStats& s) { return s.name == "theta[0]"; });
+	ASSERT_NE(theta0, ins.fields.end());
+	EXPECT_EQ(theta0->count, 1000u);
+	EXPECT_NEAR(theta0->maxAbsError, 0.1, 1e-4);
+	EXPECT_GT(theta0->RmsError(), theta0->MeanAbsError());
+	for (auto& s : ins.fields)
+	{
+		if (s.name != "theta[0]")
+		{
+			EXPECT_EQ(s.maxAbsError, 0.0) << s.name;
+		}
+	}
+
+	// Dropped GPS record is unpaired, the rest match
+	const cISLogCompare::sDidResult& gps = compare.Results()[1];
+	EXPECT_EQ(gps.countA, 100u);
+	EXPECT_EQ(gps.countB, 99u);
+	EXPECT_EQ(gps.paired, 99u);
+	EXPECT_EQ(gps.violations, 0u);
+	EXPECT_FALSE(gps.Passed());
+
+	// Machine readable report
+	YAML::Node report = YAML::Load(compare.ToYaml());
+	EXPECT_FALSE(report["passed"].as<bool>());
+	ASSERT_EQ(report["dids"].size(), 2u);
+	YAML::Node did = report["dids"][0];
+	EXPECT_EQ(did["did"].as<string>(), "DID_INS_1");
+	EXPECT_EQ(did["violations"].as<int>(), 1);
+	EXPECT_EQ(did["fields"].size(), 1u);
+	EXPECT_EQ(did["fields"]["theta[0]"]["violations"].as<int>(), 1);
+	EXPECT_EQ(did["firstFailure"]["field"].as<string>(), "theta[0]");
+	EXPECT_EQ(did["firstFailure"]["indexB"].as<int>(), 250);
+	EXPECT_FALSE(report["dids"][1]["firstFailure"]);
+
+	// Without the tolerance every theta[0] differs.  The result does not depend on the thread count.
+	options.fieldTolerances.clear();
+	options.threads = 1;
+	ASSERT_TRUE(compare.Compare("test_log_compare_a", "test_log_compare_b", cISLogger::LOGTYPE_DAT, options));
+	EXPECT_EQ(compare.Results()[0].violations, 1000u);
+	EXPECT_EQ(compare.Results()[0].firstFailure.indexA, 0u);
+
+	ISFileManager::DeleteDirectory("test_log_compare_a");
+	ISFileManager::DeleteDirectory("test_log_compare_b");
+}
+
+
+TEST(ISLogCompare, benchmark)
+{
+	const int count = 200000;
+	WriteLog("test_log_compare_a", 1001, count, 0.0f, -1, -1);
+	WriteLog("test_log_compare_b", 1001, count, 1e-5f, -1, -1);
+
+	cISLogCompare::sOptions options;
+	options.tolerance.abs = 1e-4;
+	cISLogCompare compare;
+	auto start = chrono::high_resolution_clock::now();
+	ASSERT_TRUE(compare.Compare("test_log_compare_a", "test_log_compare_b", cISLogger::LOGTYPE_DAT, options));
+	double sec = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+	EXPECT_TRUE(compare.Passed());
+
+	printf("Compared %d records per log in %.1f ms (%.2f M records/s)\n", count + count / 10, sec * 1e3, (count + count / 10) * 2 / sec * 1e-6);
+
+	ISFileManager::DeleteDirectory("test_log_compare_a");
+	ISFileManager::DeleteDirectory("test_log_compare_b");
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "ISLogFilter.h"
+#include "yaml-cpp/yaml.h"
+
+using namespace std;
+
+static int KeepCount(cISLogFilter& filter, uint32_t serialNo, uint32_t did, int count, uint32_t periodMs = 10, bool changing = true)
+{
+	ins_1_t ins = {};
+	p_data_hdr_t hdr = { (uint8_t)did, sizeof(ins), 0 };
+	int kept = 0;
+	for (int i = 0; i < count; i++)
+	{
+		ins.timeOfWeek = (changing ? i : 0);
+		kept += filter.Keep(serialNo, &hdr, (uint8_t*)&ins, i * periodMs);
+	}
+	return kept;
+}
+
+TEST(ISLogFilter, rules)
+{
+	cISLogFilter filter;
+	EXPECT_FALSE(filter.Enabled());
+	EXPECT_EQ(KeepCount(filter, 100, DID_INS_1, 100), 100);
+
+	ASSERT_TRUE(filter.Load(YAML::Load(
+		"all:\n"
+		"  DID_INS_1: { every: 10 }\n"
+		"  DID_INS_2: { period_ms: 100 }\n"
+		"  DID_SYS_PARAMS: { on_change: true }\n"
+		"  DID_PIMU: { every: 0 }\n"
+		"200:\n"
+		"  DID_INS_1: { every: 1 }\n")));
+	EXPECT_TRUE(filter.Enabled());
+
+	EXPECT_EQ(KeepCount(filter, 100, DID_INS_1, 100), 10);
+	EXPECT_EQ(KeepCount(filter, 200, DID_INS_1, 100), 100);		// Device specific rule
+	EXPECT_EQ(KeepCount(filter, 100, DID_INS_2, 100), 10);			// 10 ms apart, one per 100 ms
+	EXPECT_EQ(KeepCount(filter, 100, DID_SYS_PARAMS, 100, 10, false), 1);
+	EXPECT_EQ(KeepCount(filter, 100, DID_PIMU, 100), 0);
+	EXPECT_EQ(KeepCount(filter, 100, DID_GPS1_POS, 100), 100);		// No rule
+
+	cISLogFilter::sStats stats = filter.Stats(100, DID_INS_1);
+	EXPECT_EQ(stats.kept, 10u);
+	EXPECT_EQ(stats.dropped, 90u);
+	stats = filter.TotalStats();
+	EXPECT_EQ(stats.kept, 10u + 100 + 10 + 1 + 0 + 100);
+	EXPECT_EQ(stats.kept + stats.dropped, 600u);
+
+	EXPECT_FALSE(filter.Load(YAML::Load("all:\n  DID_INS_1: { every_nth: 10 }\n")));
+	EXPECT_FALSE(filter.Load(YAML::Load("all:\n  NOT_A_DID: { every: 10 }\n")));
+	EXPECT_FALSE(filter.Enabled());
+}
+
+TEST(ISLogFilter, raw_stream)
+{
+	cISLogFilter filter;
+	filter.SetRule(cISLogFilter::ALL_DEVICES, DID_INS_1, cISLogFilter::sRule(2));
+
+	// Stream of ISB packets
+	uint8_t commBuf[PKT_BUF_SIZE];
+	is_comm_instance_t comm;
+	is_comm_init(&comm, commBuf, sizeof(commBuf));
+	vector<uint8_t> stream;
+	uint8_t pkt[PKT_BUF_SIZE];
+	ins_1_t ins = {};
+	int pktSize = 0;
+	for (int i = 0; i < 10; i++)
+	{
+		ins.timeOfWeek = i;
+		pktSize = is_comm_data_to_buf(pkt, sizeof(pkt), &comm, DID_INS_1, sizeof(ins), 0, &ins);
+		stream.insert(stream.end(), pkt, pkt + pktSize);
+	}
+
+	// Feed in uneven pieces
+	vector<uint8_t> out;
+	int writes = 0;
+	for (size_t i = 0; i < stream.size(); i += 37)
+	{
+		filter.Filter(1, stream.data() + i, (int)_MIN(37, stream.size() - i), 0, [&](const uint8_t* data, int size)
+		{
+			out.insert(out.end(), data, data + size);
+			writes++;
+		});
+	}
+	EXPECT_EQ(writes, 5);
+	ASSERT_EQ(out.size(), 5u * pktSize);
+
+	// Every other packet, unmodified
+	for (int i = 0; i < 5; i++)
+	{
+		EXPECT_EQ(memcmp(out.data() + i * pktSize, stream.data() + 2 * i * pktSize, pktSize), 0);
+	}
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "ISLogInventory.h"
+#include "ISLogger.h"
+#include "ISFileManager.h"
+#include "yaml-cpp/yaml.h"
+
+using namespace std;
+
+static const char s_nmea[] = "$GPGGA,000000.00,,,,,0,00,99.99,,,,,,*60\r\n";
+
+// Two devices, 10 Hz INS with a 5 s dropout and 1 Hz GPS, rotated into several files per device
+static void WriteLog(const string& path, cISLogger::eLogType logType, int& ins, int& gps)
+{
+	ISFileManager::DeleteDirectory(path);
+	cISLogger::sSaveOptions options(logType, 0.5f, 0, DEFAULT_LOGS_MAX_FILE_SIZE, false);
+	options.rotatePeriodSec = 60;
+	options.rotateGpsTime = true;
+	cISLogger logger;
+	ASSERT_TRUE(logger.InitSave(path, options));
+	logger.EnableLogging(true);
+	std::shared_ptr<cDeviceLog> devLogs[2] = { logger.registerDevice(0, 1001), logger.registerDevice(0, 1002) };
+
+	uint8_t commBuf[PKT_BUF_SIZE];
+	is_comm_instance_t comm;
+	is_comm_init(&comm, commBuf, sizeof(commBuf));
+	uint8_t pkt[PKT_BUF_SIZE];
+
+	ins = gps = 0;
+	for (uint32_t ms = 0; ms < 200000; ms += 100)
+	{
+		uint32_t towMs = 3600000 + ms;
+		for (auto& devLog : devLogs)
+		{
+			if (ms % 1000 == 0)
+			{
+				gps_pos_t pos = {};
+				pos.week = 2300;
+				pos.timeOfWeekMs = towMs;
+				p_data_hdr_t hdr = { DID_GPS1_POS, sizeof(pos), 0 };
+				if (logType == cISLogger::LOGTYPE_RAW)
+				{
+					logger.LogData(devLog, is_comm_data_to_buf(pkt, sizeof(pkt), &comm, hdr.id, hdr.size, 0, &pos), pkt);
+					logger.LogData(devLog, (int)sizeof(s_nmea) - 1, (const uint8_t*)s_nmea);
+				}
+				else
+				{
+					logger.LogData(devLog, &hdr, (uint8_t*)&pos);
+				}
+				if (devLog == devLogs[0]) { gps++; }
+			}
+			if (ms >= 100000 && ms < 105000)
+			{	// INS dropout
+				continue;
+			}
+			ins_1_t ins1 = {};
+			ins1.week = 2300;
+			ins1.timeOfWeek = towMs * 0.001;
+			p_data_hdr_t hdr = { DID_INS_1, sizeof(ins1), 0 };
+			if (logType == cISLogger::LOGTYPE_RAW)
+			{
+				logger.LogData(devLog, is_comm_data_to_buf(pkt, sizeof(pkt), &comm, hdr.id, hdr.size, 0, &ins1), pkt);
+			}
+			else
+			{
+				logger.LogData(devLog, &hdr, (uint8_t*)&ins1);
+			}
+			if (devLog == devLogs[0]) { ins++; }
+		}
+	}
+	logger.CloseAllFiles();
+}
+
+static void CheckInventory(const string& path, int ins, int gps, bool raw)
+{
+	cISLogInventory::sOptions options;
+	options.threads = 3;
+	cISLogInventory inventory;
+	ASSERT_TRUE(inventory.Scan(path, options));
+	ASSERT_EQ(inventory.Devices().size(), 2u);
+
+	for (auto& it : inventory.Devices())
+	{
+		const cISLogInventory::sDeviceSummary& dev = it.second;
+		EXPECT_EQ(dev.serialNo, it.first);
+		EXPECT_GT(dev.fileCount, 1u);
+		EXPECT_EQ(dev.errors, 0u);
+		EXPECT_EQ(dev.packets, (uint64_t)(ins + gps));
+		if (raw)
+		{
+			EXPECT_EQ(dev.otherBytes, gps * (sizeof(s_nmea) - 1));
+		}
+		ASSERT_EQ(dev.dids.size(), 2u);
+
+		const cISLogInventory::sDidSummary& i = dev.dids.at(DID_INS_1);
+		EXPECT_EQ(i.count, (uint64_t)ins);
+		EXPECT_EQ(i.bytes, ins * sizeof(ins_1_t));
+		EXPECT_DOUBLE_EQ(i.firstTime, 3600.0);
+		EXPECT_NEAR(i.lastTime, 3799.9, 1e-6);
+		EXPECT_EQ(i.gaps, 1u);
+		EXPECT_NEAR(i.maxGap, 5.1, 1e-6);
+
+		const cISLogInventory::sDidSummary& g = dev.dids.at(DID_GPS1_POS);
+		EXPECT_EQ(g.count, (uint64_t)gps);
+		EXPECT_EQ(g.gaps, 0u);
+		EXPECT_NEAR(g.maxGap, 1.0, 1e-6);
+	}
+
+	// Same result with one thread
+	options.threads = 1;
+	cISLogInventory serial;
+	ASSERT_TRUE(serial.Scan(path, options));
+	EXPECT_EQ(serial.ToYaml(), inventory.ToYaml());
+
+	YAML::Node yaml = YAML::Load(inventory.ToYaml());
+	ASSERT_EQ(yaml["devices"].size(), 2u);
+	EXPECT_EQ(yaml["devices"][0]["serial"].as<uint32_t>(), 1001u);
+	EXPECT_EQ(yaml["devices"][0]["dids"]["DID_INS_1"]["count"].as<int>(), ins);
+}
+
+TEST(ISLogInventory, dat)
+{
+	string path = "test_log_inventory_dat";
+	int ins, gps;
+	WriteLog(path, cISLogger::LOGTYPE_DAT, ins, gps);
+	CheckInventory(path, ins, gps, false);
+	ISFileManager::DeleteDirectory(path);
+}
+
+TEST(ISLogInventory, raw)
+{
+	string path = "test_log_inventory_raw";
+	int ins, gps;
+	WriteLog(path, cISLogger::LOGTYPE_RAW, ins, gps);
+	CheckInventory(path, ins, gps, true);
+	ISFileManager::DeleteDirectory(path);
+}
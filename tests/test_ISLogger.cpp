@@ -1,8 +1,13 @@
 #include <gtest/gtest.h>
 #include "ISLogger.h"
+#include "ISLogInventory.h"
 #include "ISDataMappings.h"
 #include "ISFileManager.h"
+#include "ISUtilities.h"
 #include "test_data_utils.h"
+#if !PLATFORM_IS_WINDOWS
+#include <sys/stat.h>
+#endif
 
 #if 1
 #define DELETE_DIRECTORY(d)		ISFileManager::DeleteDirectory(d)
@@ -220,6 +225,426 @@ TEST(ISLogger, raw_conversion_with_garbage)
 	DELETE_DIRECTORY(logPath);
 }
 
+TEST(ISLogger, gps_time_rotation)
+{
+	string logPath = "test_log_rotation";
+	DELETE_DIRECTORY(logPath);
+
+	cISLogger::sSaveOptions options(cISLogger::eLogType::LOGTYPE_DAT, s_logDiskUsageLimitPercent, 0, s_maxFileSize, s_useTimestampSubFolder);
+	options.rotatePeriodSec = 60;
+	options.rotateGpsTime = true;
+	cISLogger logger;
+	ASSERT_TRUE(logger.InitSave(logPath, options));
+	logger.EnableLogging(true);
+	dev_info_t info = CreateDeviceInfo(123456);
+	std::shared_ptr<cDeviceLog> devLog = logger.registerDevice(info);
+
+	// 5 minutes of 1 Hz GPS and 10 Hz INS, starting 30 s into a period
+	int count = 0;
+	for (uint32_t ms = 0; ms < 300000; ms += 100)
+	{
+		uint32_t towMs = 3600000 + 30000 + ms;
+		if (ms % 1000 == 0)
+		{
+			gps_pos_t pos = {};
+			pos.week = 2300;
+			pos.timeOfWeekMs = towMs;
+			EXPECT_TRUE(LogData(logger, devLog, DID_GPS1_POS, 0, sizeof(pos), &pos));
+			count++;
+		}
+		ins_1_t ins = {};
+		ins.week = 2300;
+		ins.timeOfWeek = towMs * 0.001;
+		EXPECT_TRUE(LogData(logger, devLog, DID_INS_1, 0, sizeof(ins), &ins));
+		count++;
+	}
+	logger.CloseAllFiles();
+
+	// Partial first period, 4 full periods, partial last period.  No preallocated next file left behind.
+	vector<ISFileManager::file_info_t> files;
+	ISFileManager::GetDirectorySpaceUsed(logPath, "[\\/\\\\]" IS_LOG_FILE_PREFIX "123456_.*\\.dat", files, false, false);
+	EXPECT_EQ(files.size(), 6u);
+#if !PLATFORM_IS_WINDOWS
+	// Preallocated space past the data is released, so the drive usage limit counts what is really used
+	for (auto& file : files)
+	{
+		struct stat st;
+		ASSERT_EQ(0, stat(file.name.c_str(), &st));
+		EXPECT_LT((uint64_t)st.st_blocks * 512, file.size + 64 * 1024) << file.name;
+	}
+#endif
+
+	cISLogger reader;
+	ASSERT_TRUE(reader.LoadFromDirectory(logPath, cISLogger::eLogType::LOGTYPE_DAT));
+	std::shared_ptr<cDeviceLog> readLog = reader.DeviceLogBySerialNumber(123456);
+	ASSERT_NE(readLog, nullptr);
+	int readCount = 0;
+	while (reader.ReadData(readLog))
+	{
+		readCount++;
+	}
+	EXPECT_EQ(readCount, count);
+	DELETE_DIRECTORY(logPath);
+}
+
+TEST(ISLogger, black_box)
+{
+	string logPath = "test_log_black_box";
+	DELETE_DIRECTORY(logPath);
+
+	cISLogger::sSaveOptions options(cISLogger::eLogType::LOGTYPE_DAT, s_logDiskUsageLimitPercent, 0, s_maxFileSize, s_useTimestampSubFolder);
+	cISLogger logger;
+	ASSERT_TRUE(logger.InitSave(logPath, options));
+	logger.EnableLogging(true);
+	logger.EnableBlackBox(64 * 1024, 60000, 200);
+	dev_info_t info = CreateDeviceInfo(123456);
+	std::shared_ptr<cDeviceLog> devLog = logger.registerDevice(info);
+
+	// More than the ring holds, so the oldest records are evicted
+	ins_1_t ins = {};
+	int count = 0;
+	for (int i = 0; i < 1000; i++)
+	{
+		EXPECT_TRUE(LogData(logger, devLog, DID_INS_1, 0, sizeof(ins), &ins));
+	}
+	cISBlackBox::sStats stats = logger.BlackBoxStats(devLog);
+	EXPECT_GT(stats.evictedRecords, 0u);
+	EXPECT_EQ(stats.triggers, 0u);
+
+	// Trigger writes the buffered records, the event, and following data
+	did_event_t ev = {};
+	EXPECT_TRUE(LogData(logger, devLog, DID_EVENT, 0, sizeof(ev), &ev));
+	stats = logger.BlackBoxStats(devLog);
+	EXPECT_EQ(stats.triggers, 1u);
+	EXPECT_EQ(stats.flushedRecords + stats.evictedRecords, 1000u);
+	count += stats.flushedRecords + 1;
+
+	// Overlapping trigger extends the window without writing anything twice
+	for (int i = 0; i < 10; i++)
+	{
+		EXPECT_TRUE(LogData(logger, devLog, DID_INS_1, 0, sizeof(ins), &ins));
+		count++;
+	}
+	// Manual trigger is handled on the logging thread
+	logger.TriggerBlackBox();
+	EXPECT_EQ(logger.BlackBoxStats(devLog).triggers, 1u);
+	logger.Update();
+	EXPECT_EQ(logger.BlackBoxStats(devLog).triggers, 2u);
+	EXPECT_EQ(logger.BlackBoxStats(devLog).flushedRecords, stats.flushedRecords);
+	for (int i = 0; i < 10; i++)
+	{
+		EXPECT_TRUE(LogData(logger, devLog, DID_INS_1, 0, sizeof(ins), &ins));
+		count++;
+	}
+
+	// After the post-trigger window data is held in memory again
+	SLEEP_MS(300);
+	for (int i = 0; i < 10; i++)
+	{
+		EXPECT_TRUE(LogData(logger, devLog, DID_INS_1, 0, sizeof(ins), &ins));
+	}
+	logger.CloseAllFiles();
+
+	cISLogger reader;
+	ASSERT_TRUE(reader.LoadFromDirectory(logPath, cISLogger::eLogType::LOGTYPE_DAT));
+	std::shared_ptr<cDeviceLog> readLog = reader.DeviceLogBySerialNumber(123456);
+	ASSERT_NE(readLog, nullptr);
+	int readCount = 0;
+	while (reader.ReadData(readLog))
+	{
+		readCount++;
+	}
+	EXPECT_EQ(readCount, count);
+	DELETE_DIRECTORY(logPath);
+}
+
+// Slowly changing IMU, INS and GPS data with some partial records, as with a live device
+static void LogDeltaTestData(cISLogger& logger, std::shared_ptr<cDeviceLog> devLog, vector<vector<uint8_t>>& records)
+{
+	pimu_t pimu = {};
+	ins_2_t ins = {};
+	gps_pos_t gps = {};
+	for (int i = 0; i < 20000; i++)
+	{
+		pimu.time = i * 0.001;
+		pimu.theta[i % 3] += 0.0001f * (i % 7);
+		pimu.vel[2] = -9.8f * 0.001f + (i % 5) * 1e-6f;
+		LogData(logger, devLog, DID_PIMU, 0, sizeof(pimu), &pimu);
+		records.emplace_back((uint8_t*)&pimu, (uint8_t*)&pimu + sizeof(pimu));
+		if (i % 4 == 0)
+		{
+			ins.timeOfWeek = 3600 + i * 0.001;
+			ins.qn2b[i % 4] += 1e-5f;
+			ins.lla[0] = 40.0 + i * 1e-9;
+			LogData(logger, devLog, DID_INS_2, 0, sizeof(ins), &ins);
+			records.emplace_back((uint8_t*)&ins, (uint8_t*)&ins + sizeof(ins));
+		}
+		if (i % 200 == 0)
+		{
+			gps.timeOfWeekMs = 3600000 + i;
+			gps.satsUsed = 10 + i % 3;
+			LogData(logger, devLog, DID_GPS1_POS, 0, sizeof(gps), &gps);
+			records.emplace_back((uint8_t*)&gps, (uint8_t*)&gps + sizeof(gps));
+
+			// Partial record of the same DID is not delta encoded against the full record
+			LogData(logger, devLog, DID_GPS1_POS, offsetof(gps_pos_t, timeOfWeekMs), sizeof(uint32_t), &gps.timeOfWeekMs);
+			records.emplace_back((uint8_t*)&gps.timeOfWeekMs, (uint8_t*)&gps.timeOfWeekMs + sizeof(uint32_t));
+		}
+	}
+}
+
+TEST(ISLogger, delta_encoding)
+{
+	uint64_t logSize[2];
+	for (int delta = 0; delta < 2; delta++)
+	{
+		string logPath = "test_log_delta";
+		DELETE_DIRECTORY(logPath);
+		cISLogger::sSaveOptions options(cISLogger::eLogType::LOGTYPE_DAT, s_logDiskUsageLimitPercent, 0, s_maxFileSize, s_useTimestampSubFolder);
+		options.deltaEncoding = (delta != 0);
+		cISLogger logger;
+		ASSERT_TRUE(logger.InitSave(logPath, options));
+		logger.EnableLogging(true);
+		dev_info_t info = CreateDeviceInfo(123456);
+		vector<vector<uint8_t>> records;
+		LogDeltaTestData(logger, logger.registerDevice(info), records);
+		logger.CloseAllFiles();
+		logSize[delta] = ISFileManager::GetDirectorySpaceUsed(logPath);
+
+		// Decoding is transparent to the reader
+		cISLogger reader;
+		ASSERT_TRUE(reader.LoadFromDirectory(logPath, cISLogger::eLogType::LOGTYPE_DAT));
+		std::shared_ptr<cDeviceLog> readLog = reader.DeviceLogBySerialNumber(123456);
+		ASSERT_NE(readLog, nullptr);
+		size_t n = 0;
+		p_data_buf_t* data;
+		while ((data = reader.ReadData(readLog)) != NULLPTR)
+		{
+			ASSERT_LT(n, records.size());
+			ASSERT_EQ(data->hdr.size, records[n].size());
+			ASSERT_EQ(memcmp(data->buf, records[n].data(), data->hdr.size), 0) << n;
+			n++;
+		}
+		EXPECT_EQ(n, records.size());
+
+		cISLogInventory inventory;
+		ASSERT_TRUE(inventory.Scan(logPath));
+		EXPECT_EQ(inventory.Devices().at(123456).packets, records.size());
+		EXPECT_EQ(inventory.Devices().at(123456).errors, 0u);
+		DELETE_DIRECTORY(logPath);
+	}
+	EXPECT_LT(logSize[1] * 2, logSize[0]);
+
+	// Corrupt runs from a log file must not reach past the record
+	uint8_t decoded[256];
+	const uint8_t wrap[] = { 1, 0, 4, 0, 0, 0, 'a', 'b', 'c', 'd',			// Literal record, 4 bytes
+		1, 1, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0x01, 'x' };				// Delta record: equal 0xFFFFFFFF, changed 1
+	EXPECT_EQ(-1, cDataChunk::DeltaDecode(wrap, sizeof(wrap), decoded, sizeof(decoded)));
+	const uint8_t overrun[] = { 1, 0, 4, 0, 0, 0, 'a', 'b', 'c', 'd',
+		1, 1, 0x03, 0x02, 'x', 'y' };									// Delta record: equal 3, changed 2
+	EXPECT_EQ(-1, cDataChunk::DeltaDecode(overrun, sizeof(overrun), decoded, sizeof(decoded)));
+	const uint8_t valid[] = { 1, 0, 4, 0, 0, 0, 'a', 'b', 'c', 'd',
+		1, 1, 0x03, 0x01, 'x' };
+	ASSERT_EQ(2 * (int32_t)(sizeof(p_data_hdr_t) + 4), cDataChunk::DeltaDecode(valid, sizeof(valid), decoded, sizeof(decoded)));
+	EXPECT_EQ(0, memcmp(decoded + 2 * sizeof(p_data_hdr_t) + 4, "abcx", 4));
+}
+
+TEST(ISLogger, gnss_array_trim)
+{
+	string logPath = "test_log_gnss_trim";
+	DELETE_DIRECTORY(logPath);
+	cISLogger::sSaveOptions options(cISLogger::eLogType::LOGTYPE_DAT, s_logDiskUsageLimitPercent, 0, s_maxFileSize, s_useTimestampSubFolder);
+	cISLogger logger;
+	ASSERT_TRUE(logger.InitSave(logPath, options));
+	logger.EnableLogging(true);
+	dev_info_t info = CreateDeviceInfo(123456);
+	std::shared_ptr<cDeviceLog> devLog = logger.registerDevice(info);
+
+	gps_sat_t sat = {};
+	gps_sig_t sig = {};
+	for (int i = 0; i < 100; i++)
+	{
+		sat.timeOfWeekMs = sig.timeOfWeekMs = i * 200;
+		sat.numSats = i % 20;
+		sig.numSigs = i % 40;
+		for (uint32_t j = 0; j < MAX_NUM_SATELLITES; j++)
+		{
+			sat.sat[j].svId = (j < sat.numSats ? j + 1 : 0);
+		}
+		for (uint32_t j = 0; j < MAX_NUM_SAT_SIGNALS; j++)
+		{
+			sig.sig[j].svId = (j < sig.numSigs ? j + 1 : 0);
+		}
+		EXPECT_TRUE(LogData(logger, devLog, DID_GPS1_SAT, 0, sizeof(sat), &sat));
+		EXPECT_TRUE(LogData(logger, devLog, DID_GPS1_SIG, 0, sizeof(sig), &sig));
+	}
+	EXPECT_GT(logger.GnssTrimBytesAll(), 100 * (sizeof(sat) + sizeof(sig)) / 2);
+	logger.CloseAllFiles();
+
+	// Full size structures with unused entries zeroed
+	cISLogger reader;
+	ASSERT_TRUE(reader.LoadFromDirectory(logPath, cISLogger::eLogType::LOGTYPE_DAT));
+	std::shared_ptr<cDeviceLog> readLog = reader.DeviceLogBySerialNumber(123456);
+	ASSERT_NE(readLog, nullptr);
+	int count = 0;
+	p_data_buf_t* data;
+	while ((data = reader.ReadData(readLog)) != NULLPTR)
+	{
+		if (data->hdr.id == DID_GPS1_SAT)
+		{
+			ASSERT_EQ(data->hdr.size, sizeof(gps_sat_t));
+			gps_sat_t* s = (gps_sat_t*)data->buf;
+			for (uint32_t j = 0; j < MAX_NUM_SATELLITES; j++)
+			{
+				EXPECT_EQ(s->sat[j].svId, (j < s->numSats ? j + 1 : 0));
+			}
+		}
+		else
+		{
+			ASSERT_EQ(data->hdr.size, sizeof(gps_sig_t));
+			gps_sig_t* s = (gps_sig_t*)data->buf;
+			for (uint32_t j = 0; j < MAX_NUM_SAT_SIGNALS; j++)
+			{
+				EXPECT_EQ(s->sig[j].svId, (j < s->numSigs ? j + 1 : 0));
+			}
+		}
+		count++;
+	}
+	EXPECT_EQ(count, 200);
+	DELETE_DIRECTORY(logPath);
+}
+
+TEST(ISLogger, catalog)
+{
+	string logPath = "test_log_catalog";
+	DELETE_DIRECTORY(logPath);
+	cISLogger::sSaveOptions options(cISLogger::eLogType::LOGTYPE_DAT, s_logDiskUsageLimitPercent, 0, 20000, s_useTimestampSubFolder);
+	cISLogger logger;
+	ASSERT_TRUE(logger.InitSave(logPath, options));
+	ASSERT_NE(logger.Catalog(), nullptr);
+	logger.EnableLogging(true);
+	dev_info_t info1 = CreateDeviceInfo(1001);
+	dev_info_t info2 = CreateDeviceInfo(1002);
+	std::shared_ptr<cDeviceLog> devLog1 = logger.registerDevice(info1);
+	std::shared_ptr<cDeviceLog> devLog2 = logger.registerDevice(info2);
+
+	int count = 0;
+	for (int i = 1; i <= 20000; i++)
+	{
+		ins_1_t ins = {};
+		ins.week = 2300;
+		ins.timeOfWeek = 1000.0 + i * 0.01;
+		EXPECT_TRUE(LogData(logger, devLog1, DID_INS_1, 0, sizeof(ins), &ins));
+		EXPECT_TRUE(LogData(logger, devLog2, DID_INS_1, 0, sizeof(ins), &ins));
+		count++;
+		if (i == 10000)
+		{	// While recording, the catalogued files and the open file are all there is.  The prepared next file isn't seen.
+			vector<ISFileManager::file_info_t> files;
+			ISFileManager::GetDirectorySpaceUsed(logPath, "[\\/\\\\]" IS_LOG_FILE_PREFIX "1001_.*\\.dat", files, false, false);
+			ASSERT_GT(files.size(), 1u);
+			EXPECT_EQ(files.size(), logger.Catalog()->Devices()[1001].size() + 1);
+		}
+	}
+	logger.CloseAllFiles();
+
+	// Catalog matches the directory, in write order with contiguous time spans
+	std::map<uint32_t, vector<cISLogCatalog::sFile>> devices = logger.Catalog()->Devices();
+	ASSERT_EQ(devices.size(), 2u);
+	for (auto& device : devices)
+	{
+		vector<ISFileManager::file_info_t> files;
+		ISFileManager::GetDirectorySpaceUsed(logPath, "[\\/\\\\]" IS_LOG_FILE_PREFIX + to_string(device.first) + "_.*\\.dat", files, false, false);
+		ASSERT_GT(files.size(), 2u);
+		ASSERT_EQ(files.size(), device.second.size());
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			EXPECT_EQ(ISFileManager::GetFileName(files[i].name), device.second[i].name);
+			EXPECT_EQ(files[i].size, device.second[i].size);
+			EXPECT_LE(device.second[i].startTime, device.second[i].endTime);
+			if (i)
+			{
+				EXPECT_GT(device.second[i].startTime, device.second[i - 1].endTime);
+			}
+		}
+		EXPECT_DOUBLE_EQ(device.second.front().startTime, 1000.01);
+		EXPECT_DOUBLE_EQ(device.second.back().endTime, 1200.0);
+	}
+
+	auto readAll = [&](cISLogger& reader)
+	{
+		for (uint32_t serial : { 1001, 1002 })
+		{
+			std::shared_ptr<cDeviceLog> readLog = reader.DeviceLogBySerialNumber(serial);
+			ASSERT_NE(readLog, nullptr);
+			int readCount = 0;
+			while (reader.ReadData(readLog))
+			{
+				readCount++;
+			}
+			EXPECT_EQ(readCount, count);
+		}
+	};
+
+	{	// Read using the catalog
+		cISLogger reader;
+		ASSERT_TRUE(reader.LoadFromDirectory(logPath, cISLogger::eLogType::LOGTYPE_DAT));
+		EXPECT_NE(reader.Catalog(), nullptr);
+		readAll(reader);
+	}
+
+	// An empty next file, i.e. left by a crash, doesn't make the catalog stale
+	string lastName = devices[1002].back().name;
+	FILE* extra = fopen((logPath + "/" + cISLogCatalog::NextFileName(lastName)).c_str(), "wb");
+	ASSERT_NE(extra, nullptr);
+	fclose(extra);
+	{
+		cISLogger reader;
+		ASSERT_TRUE(reader.LoadFromDirectory(logPath, cISLogger::eLogType::LOGTYPE_DAT));
+		EXPECT_NE(reader.Catalog(), nullptr);
+	}
+
+	// A file the catalog doesn't know about makes it stale, so the directory is scanned
+	extra = fopen((logPath + "/" + cISLogCatalog::NextFileName(lastName)).c_str(), "wb");
+	ASSERT_NE(extra, nullptr);
+	fputc(0, extra);
+	fclose(extra);
+	{
+		cISLogger reader;
+		ASSERT_TRUE(reader.LoadFromDirectory(logPath, cISLogger::eLogType::LOGTYPE_DAT));
+		EXPECT_EQ(reader.Catalog(), nullptr);
+		readAll(reader);
+	}
+
+	// So do files of a device the catalog doesn't know about
+	ISFileManager::DeleteFile(logPath + "/" + cISLogCatalog::NextFileName(lastName));
+	{
+		cISLogger reader;
+		ASSERT_TRUE(reader.LoadFromDirectory(logPath, cISLogger::eLogType::LOGTYPE_DAT));
+		EXPECT_NE(reader.Catalog(), nullptr);
+	}
+	string newDevice = devices[1002].front().name;
+	newDevice.replace(newDevice.find("1002"), 4, "1003");
+	FILE* copy = fopen((logPath + "/" + newDevice).c_str(), "wb");
+	ASSERT_NE(copy, nullptr);
+	fclose(copy);
+	{
+		cISLogger reader;
+		ASSERT_TRUE(reader.LoadFromDirectory(logPath, cISLogger::eLogType::LOGTYPE_DAT));
+		EXPECT_EQ(reader.Catalog(), nullptr);
+	}
+
+	// Logging into a directory with uncatalogued files doesn't write a catalog
+	ASSERT_TRUE(logger.InitSave(logPath, options));
+	EXPECT_EQ(logger.Catalog(), nullptr);
+	vector<string> catalogs;
+	ISFileManager::GetAllFilesInDirectory(logPath, false, IS_LOG_CATALOG_PREFIX, catalogs);
+	EXPECT_EQ(catalogs.size(), 0u);
+
+	EXPECT_EQ(cISLogCatalog::NextFileName("LOG_SN1_20240101_120000_9999.raw"), "LOG_SN1_20240101_120000_0000.raw");
+	EXPECT_EQ(cISLogCatalog::NextFileName("data.dat"), "");
+	DELETE_DIRECTORY(logPath);
+}
+
 #else	// Disabled
 
 #pragma message("-------------------------------------------------------------------------------------------")
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+#include "ISMagCal.h"
+#include "ISFileManager.h"
+
+using namespace std;
+
+// Symmetric soft iron, hard iron and field strength of the simulated sensor
+static const double s_soft[9] = { 1.20,  0.05, -0.03,
+                                  0.05,  0.90,  0.08,
+                                 -0.03,  0.08,  1.05 };
+static const double s_hard[3] = { 12.0, -35.0, 8.0 };
+static const double s_field = 48.0;
+
+// Raw sample of a field in direction of the random unit vector u, or a spike if outlier
+static void rawSample(mt19937& rng, float mag[3], double noise, bool outlier, bool upperOnly = false)
+{
+	normal_distribution<double> gauss(0.0, 1.0);
+	double u[3] = { gauss(rng), gauss(rng), gauss(rng) };
+	double norm = sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+	if (upperOnly)
+	{
+		u[2] = fabs(u[2]);
+	}
+	for (int i = 0; i < 3; i++)
+	{
+		mag[i] = (float)(s_hard[i] + s_field * (s_soft[i * 3] * u[0] + s_soft[i * 3 + 1] * u[1] + s_soft[i * 3 + 2] * u[2]) / norm + noise * gauss(rng));
+		if (outlier)
+		{
+			mag[i] += (float)(gauss(rng) * s_field);
+		}
+	}
+}
+
+static double calibratedMagnitude(const cISMagCal::sResult& r, const float mag[3])
+{
+	double sum = 0.0;
+	for (int i = 0; i < 3; i++)
+	{
+		double v = 0.0;
+		for (int j = 0; j < 3; j++)
+		{
+			v += r.Wcal[i * 3 + j] * (mag[j] - r.bias_cal[j]);
+		}
+		sum += v * v;
+	}
+	return sqrt(sum);
+}
+
+
+TEST(ISMagCal, ellipsoid_fit)
+{
+	mt19937 rng(1);
+	uniform_real_distribution<double> uniform(0.0, 1.0);
+	cISMagCal cal;
+	for (int i = 0; i < 20000; i++)
+	{
+		float mag[3];
+		rawSample(rng, mag, 0.1, uniform(rng) < 0.05);
+		cal.Add(mag);
+	}
+	const cISMagCal::sResult& r = cal.Fit();
+	ASSERT_TRUE(r.valid);
+	EXPECT_EQ(r.samples, 20000u);
+	EXPECT_NEAR((double)r.inliers, 19000.0, 300.0);
+	EXPECT_GT(r.iterations, 1);
+	for (int i = 0; i < 3; i++)
+	{
+		EXPECT_NEAR(r.bias_cal[i], s_hard[i], 0.1);
+	}
+
+	// Wcal = cbrt(det(soft)) * soft^-1, so calibrated magnitude is the fitted field strength
+	double det = s_soft[0] * (s_soft[4] * s_soft[8] - s_soft[5] * s_soft[7]) - s_soft[1] * (s_soft[3] * s_soft[8] - s_soft[5] * s_soft[6]) + s_soft[2] * (s_soft[3] * s_soft[7] - s_soft[4] * s_soft[6]);
+	EXPECT_NEAR(r.fieldStrength, s_field * cbrt(det), 0.1);
+	for (int i = 0; i < 20; i++)
+	{
+		float mag[3];
+		rawSample(rng, mag, 0.0, false);
+		EXPECT_NEAR(calibratedMagnitude(r, mag), r.fieldStrength, 0.1);
+	}
+	EXPECT_LT(r.residualRms, 0.005);
+	EXPECT_GT(r.conditionNumber, 1.2);
+	EXPECT_EQ(r.coverage, 1.0);
+
+	// Outliers pull the plain least squares fit away
+	cISMagCal::sOptions options;
+	options.iterations = 0;
+	const cISMagCal::sResult& plain = cal.Fit(options);
+	ASSERT_TRUE(plain.valid);
+	EXPECT_GT(plain.residualRms, 0.05);
+
+	// Normalized output for DID_INL2_MAG_OBS_INFO
+	options = cISMagCal::sOptions();
+	options.fieldStrength = 1.0;
+	cal.Fit(options);
+	float mag[3];
+	rawSample(rng, mag, 0.0, false);
+	EXPECT_NEAR(calibratedMagnitude(cal.Result(), mag), 1.0, 0.003);
+	inl2_mag_obs_info_t info = {};
+	cal.ToMagObsInfo(info);
+	EXPECT_EQ(info.calibrated, 1u);
+	EXPECT_EQ(info.Wcal[4], cal.Result().Wcal[4]);
+	EXPECT_EQ(info.bias_cal[1], cal.Result().bias_cal[1]);
+	EXPECT_NE(cal.ToYaml().find("DID_INL2_MAG_OBS_INFO"), string::npos);
+}
+
+
+TEST(ISMagCal, partial_coverage)
+{
+	mt19937 rng(2);
+	cISMagCal cal;
+	for (int i = 0; i < 5000; i++)
+	{
+		float mag[3];
+		rawSample(rng, mag, 0.05, false, true);
+		cal.Add(mag);
+	}
+	const cISMagCal::sResult& r = cal.Fit();
+	ASSERT_TRUE(r.valid);
+	EXPECT_NEAR(r.coverage, 0.5, 0.1);
+
+	// Too few samples, or all the same
+	cal.Clear();
+	float mag[3] = { 1, 2, 3 };
+	for (int i = 0; i < 1000; i++)
+	{
+		cal.Add(mag);
+	}
+	EXPECT_FALSE(cal.Fit().valid);
+	cal.Clear();
+	EXPECT_FALSE(cal.Fit().valid);
+}
+
+
+TEST(ISMagCal, log)
+{
+	string path = "test_mag_cal_log";
+	ISFileManager::DeleteDirectory(path);
+	{
+		cISLogger::sSaveOptions options(cISLogger::LOGTYPE_DAT, 0.5f, 0, DEFAULT_LOGS_MAX_FILE_SIZE, false);
+		cISLogger logger;
+		ASSERT_TRUE(logger.InitSave(path, options));
+		logger.EnableLogging(true);
+		std::shared_ptr<cDeviceLog> devLog = logger.registerDevice(0, 1001);
+		mt19937 rng(3);
+		for (int i = 0; i < 2000; i++)
+		{
+			magnetometer_t m = {};
+			m.time = i * 0.01;
+			rawSample(rng, m.mag, 0.05, false);
+			p_data_hdr_t hdr = { DID_MAGNETOMETER, sizeof(m), 0 };
+			logger.LogData(devLog, &hdr, (uint8_t*)&m);
+
+			pimu_mag_t pm = {};
+			rawSample(rng, pm.mag.mag, 0.05, false);
+			hdr = { DID_PIMU_MAG, sizeof(pm), 0 };
+			logger.LogData(devLog, &hdr, (uint8_t*)&pm);
+		}
+		logger.CloseAllFiles();
+	}
+
+	cISMagCal cal;
+	ASSERT_TRUE(cal.AddLog(path));
+	EXPECT_EQ(cal.SampleCount(), 4000u);
+	EXPECT_FALSE(cal.AddLog(path, cISLogger::LOGTYPE_DAT, 999));
+	const cISMagCal::sResult& r = cal.Fit();
+	ASSERT_TRUE(r.valid);
+	for (int i = 0; i < 3; i++)
+	{
+		EXPECT_NEAR(r.bias_cal[i], s_hard[i], 0.1);
+	}
+	ISFileManager::DeleteDirectory(path);
+}
+
+
+// Timing only, fits are checked above.  Set MAG_CAL_BENCH to run.
+TEST(ISMagCal, benchmark)
+{
+	if (!getenv("MAG_CAL_BENCH")) { GTEST_SKIP() << "Set MAG_CAL_BENCH to run"; }
+
+	mt19937 rng(4);
+	const int count = 2000000;
+	vector<array<float, 3>> samples(count);
+	for (auto& s : samples)
+	{
+		rawSample(rng, s.data(), 0.1, false);
+	}
+
+	cISMagCal cal;
+	auto start = chrono::high_resolution_clock::now();
+	for (auto& s : samples)
+	{
+		cal.Add(s.data());
+	}
+	double addSec = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+	start = chrono::high_resolution_clock::now();
+	const cISMagCal::sResult& r = cal.Fit();
+	double fitSec = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+	EXPECT_TRUE(r.valid);
+
+	printf("%d samples  Add: %.1f ms (%.1f M/s)  Fit: %.1f ms, %d iterations\n", count, addSec * 1e3, count / addSec * 1e-6, fitSec * 1e3, r.iterations);
+}
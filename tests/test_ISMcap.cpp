@@ -0,0 +1,396 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include "ISMcap.h"
+#include "ISLogger.h"
+#include "ISFileManager.h"
+#include "ISDataMappings.h"
+#include "miniz.h"
+#include "time_conversion.h"
+
+using namespace std;
+
+// Unix ns at the start of a GPS week
+static int64_t weekStartNs(uint32_t week)
+{
+	return ((int64_t)C_GPS_TO_UNIX_OFFSET_S + (int64_t)week * C_SECONDS_PER_WEEK - C_GPS_LEAP_SECONDS) * 1000000000LL;
+}
+
+template <typename T> static T get(const uint8_t*& p) { T v; memcpy(&v, p, sizeof(T)); p += sizeof(T); return v; }
+static string getStr(const uint8_t*& p) { uint32_t n = get<uint32_t>(p); string s((const char*)p, n); p += n; return s; }
+
+// Reference LZ4 frame decoder (no checksums, as written by lz4CompressFrame)
+static bool lz4Decompress(const uint8_t* src, size_t size, vector<uint8_t>& out)
+{
+	const uint8_t* end = src + size;
+	if (size < 11 || get<uint32_t>(src) != 0x184D2204) { return false; }
+	src += 3;
+	out.clear();
+	while (src + 4 <= end)
+	{
+		uint32_t blockSize = get<uint32_t>(src);
+		if (blockSize == 0) { return src == end; }
+		const uint8_t* bend = src + (blockSize & 0x7FFFFFFF);
+		if (bend > end) { return false; }
+		if (blockSize & 0x80000000)
+		{
+			out.insert(out.end(), src, bend);
+			src = bend;
+			continue;
+		}
+		size_t blockStart = out.size();
+		while (src < bend)
+		{
+			uint8_t token = *src++;
+			size_t len = token >> 4;
+			if (len == 15) { uint8_t b; do { b = *src++; len += b; } while (b == 255); }
+			out.insert(out.end(), src, src + len);
+			src += len;
+			if (src >= bend) { break; }
+			uint16_t offset = get<uint16_t>(src);
+			if (offset == 0 || offset > out.size() - blockStart) { return false; }
+			len = token & 15;
+			if (len == 15) { uint8_t b; do { b = *src++; len += b; } while (b == 255); }
+			len += 4;
+			for (size_t i = 0; i < len; i++) { out.push_back(out[out.size() - offset]); }
+		}
+	}
+	return false;
+}
+
+struct sMcapFile
+{
+	map<uint16_t, string> schemas;             // id -> data
+	map<uint16_t, pair<uint16_t, string>> channels;  // id -> schema, topic
+	map<uint16_t, vector<vector<uint8_t>>> messages;
+	map<uint16_t, vector<uint64_t>> times;
+	uint64_t statMessages = 0;
+	uint32_t statChunks = 0;
+	uint32_t chunkIndexes = 0;
+};
+
+static void ParseRecords(const uint8_t* p, const uint8_t* end, sMcapFile& f, bool summary)
+{
+	while (p < end)
+	{
+		uint8_t op = *p++;
+		uint64_t len = get<uint64_t>(p);
+		const uint8_t* r = p;
+		p += len;
+		ASSERT_LE(p, end);
+		switch (op)
+		{
+		case 0x03: { uint16_t id = get<uint16_t>(r); getStr(r); EXPECT_EQ(getStr(r), "ros1msg"); f.schemas[id] = getStr(r); break; }
+		case 0x04: { uint16_t id = get<uint16_t>(r); uint16_t s = get<uint16_t>(r); f.channels[id] = { s, getStr(r) }; EXPECT_EQ(getStr(r), "ros1"); break; }
+		case 0x05:
+			{
+				ASSERT_FALSE(summary);
+				uint16_t ch = get<uint16_t>(r);
+				ASSERT_TRUE(f.channels.count(ch));
+				EXPECT_EQ(get<uint32_t>(r), (uint32_t)f.messages[ch].size());
+				f.times[ch].push_back(get<uint64_t>(r));
+				get<uint64_t>(r);
+				f.messages[ch].emplace_back(r, p);
+			}
+			break;
+		case 0x06:
+			{
+				get<uint64_t>(r); get<uint64_t>(r);
+				uint64_t usize = get<uint64_t>(r);
+				uint32_t crc = get<uint32_t>(r);
+				string compression = getStr(r);
+				uint64_t size = get<uint64_t>(r);
+				ASSERT_EQ(r + size, p);
+				vector<uint8_t> records(r, r + size);
+				if (compression == "lz4")
+				{
+					ASSERT_TRUE(lz4Decompress(r, size, records));
+				}
+				else
+				{
+					ASSERT_EQ(compression, "");
+				}
+				ASSERT_EQ(records.size(), usize);
+				EXPECT_EQ(crc, (uint32_t)mz_crc32(0, records.data(), records.size()));
+				ParseRecords(records.data(), records.data() + records.size(), f, false);
+			}
+			break;
+		case 0x08: f.chunkIndexes++; break;
+		case 0x0B: f.statMessages = get<uint64_t>(r); get<uint16_t>(r); get<uint32_t>(r); get<uint32_t>(r); get<uint32_t>(r); f.statChunks = get<uint32_t>(r); break;
+		}
+	}
+}
+
+static void ReadMcap(const string& filename, sMcapFile& f)
+{
+	ifstream in(filename, ios::binary);
+	vector<uint8_t> buf((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+	ASSERT_GT(buf.size(), 16u);
+	ASSERT_EQ(memcmp(buf.data(), "\x89MCAP0\r\n", 8), 0);
+	ASSERT_EQ(memcmp(buf.data() + buf.size() - 8, "\x89MCAP0\r\n", 8), 0);
+
+	// Footer
+	const uint8_t* footer = buf.data() + buf.size() - 8 - 29;
+	ASSERT_EQ(footer[0], 0x02);
+	const uint8_t* p = footer + 9;
+	uint64_t summaryStart = get<uint64_t>(p);
+	uint64_t summaryOffsetStart = get<uint64_t>(p);
+	uint32_t summaryCrc = get<uint32_t>(p);
+	ASSERT_LT(summaryStart, summaryOffsetStart);
+	EXPECT_EQ(summaryCrc, (uint32_t)mz_crc32(0, buf.data() + summaryStart, (footer + 9 + 16) - (buf.data() + summaryStart)));
+
+	// Data section ends with a data end record holding its CRC
+	const uint8_t* dataEnd = buf.data() + summaryStart - 13;
+	ASSERT_EQ(dataEnd[0], 0x0F);
+	p = dataEnd + 9;
+	EXPECT_EQ(get<uint32_t>(p), (uint32_t)mz_crc32(0, buf.data(), dataEnd - buf.data()));
+
+	ParseRecords(buf.data() + 8, dataEnd, f, false);
+	size_t messages = 0;
+	for (auto& m : f.messages) { messages += m.second.size(); }
+
+	sMcapFile summary;
+	ParseRecords(buf.data() + summaryStart, buf.data() + summaryOffsetStart, summary, true);
+	EXPECT_EQ(summary.schemas, f.schemas);
+	EXPECT_EQ(summary.channels, f.channels);
+	EXPECT_EQ(summary.statMessages, messages);
+	EXPECT_EQ(summary.statChunks, summary.chunkIndexes);
+	f.statMessages = summary.statMessages;
+	f.statChunks = summary.statChunks;
+}
+
+TEST(ISMcap, lz4_round_trip)
+{
+	vector<uint8_t> src(3 * MCAP_LZ4_BLOCK_SIZE / 2);
+	uint32_t seed = 1;
+	for (size_t i = 0; i < src.size(); i++)
+	{	// Mix of repeating structure and noise
+		seed = seed * 1103515245 + 12345;
+		src[i] = (i % 64 < 40) ? (uint8_t)(i / 64) : (uint8_t)(seed >> 16);
+	}
+	vector<uint8_t> frame, out;
+	size_t size = lz4CompressFrame(src.data(), src.size(), frame);
+	EXPECT_LT(size, src.size());
+	ASSERT_TRUE(lz4Decompress(frame.data(), size, out));
+	EXPECT_EQ(out, src);
+
+	// Incompressible and tiny inputs are stored
+	for (size_t n : { (size_t)0, (size_t)5, (size_t)1000 })
+	{
+		vector<uint8_t> noise(n);
+		for (auto& b : noise) { seed = seed * 1103515245 + 12345; b = (uint8_t)(seed >> 16); }
+		size = lz4CompressFrame(noise.data(), noise.size(), frame);
+		ASSERT_TRUE(lz4Decompress(frame.data(), size, out));
+		EXPECT_EQ(out, noise);
+	}
+}
+
+// Frames must decode with the reference LZ4 implementation, not only the decoder above
+TEST(ISMcap, lz4_reference_decoder)
+{
+#if PLATFORM_IS_WINDOWS
+	GTEST_SKIP();
+#else
+	if (system("lz4 --version > /dev/null 2>&1") != 0)
+	{
+		GTEST_SKIP() << "lz4 command line tool not found";
+	}
+
+	vector<uint8_t> src(MCAP_LZ4_BLOCK_SIZE + 12345);
+	uint32_t seed = 7;
+	for (size_t i = 0; i < src.size(); i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		src[i] = (i % 100 < 70) ? (uint8_t)(i / 100) : (uint8_t)(seed >> 16);
+	}
+	vector<uint8_t> frame;
+	size_t size = lz4CompressFrame(src.data(), src.size(), frame);
+	{
+		ofstream out("test_mcap.lz4", ios::binary);
+		out.write((const char*)frame.data(), size);
+	}
+	ASSERT_EQ(system("lz4 -d -f -q test_mcap.lz4 test_mcap.lz4.out"), 0);
+	ifstream in("test_mcap.lz4.out", ios::binary);
+	vector<uint8_t> out((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+	EXPECT_TRUE(out == src);
+	ISFileManager::DeleteFile("test_mcap.lz4");
+	ISFileManager::DeleteFile("test_mcap.lz4.out");
+#endif
+}
+
+TEST(ISMcap, schema)
+{
+	// Padded ros1msg definition must describe exactly the packed structure
+	for (uint32_t did : { (uint32_t)DID_INS_1, (uint32_t)DID_GPS1_POS, (uint32_t)DID_DEV_INFO })
+	{
+		istringstream def(cMcapExporter::SchemaDefinition(did));
+		map<string, uint32_t> sizes = { { "int8", 1 }, { "uint8", 1 }, { "int16", 2 }, { "uint16", 2 }, { "int32", 4 }, { "uint32", 4 }, { "int64", 8 }, { "uint64", 8 }, { "float32", 4 }, { "float64", 8 } };
+		uint32_t total = 0;
+		string line;
+		while (getline(def, line))
+		{
+			string type = line.substr(0, line.find(' '));
+			uint32_t count = 1;
+			size_t bracket = type.find('[');
+			if (bracket != string::npos)
+			{
+				count = stoi(type.substr(bracket + 1));
+				type = type.substr(0, bracket);
+			}
+			ASSERT_TRUE(sizes.count(type)) << line;
+			total += sizes[type] * count;
+		}
+		EXPECT_EQ(total, cISDataMappings::DataSize(did));
+	}
+	EXPECT_NE(cMcapExporter::SchemaDefinition(DID_INS_1).find("float64 timeOfWeek"), string::npos);
+}
+
+static void TestExport(cISLogger::eLogType logType, cMcapWriter::eCompression compression)
+{
+	string path = "test_mcap_log";
+	string filename = "test_mcap.mcap";
+	ISFileManager::DeleteDirectory(path);
+	{
+		cISLogger logger;
+		ASSERT_TRUE(logger.InitSave(path, cISLogger::sSaveOptions(logType, 0.5f, 0, DEFAULT_LOGS_MAX_FILE_SIZE, false)));
+		logger.EnableLogging(true);
+		std::shared_ptr<cDeviceLog> devLog = logger.registerDevice(0, 1001);
+		uint8_t commBuf[PKT_BUF_SIZE];
+		is_comm_instance_t comm;
+		is_comm_init(&comm, commBuf, sizeof(commBuf));
+		uint8_t pkt[PKT_BUF_SIZE];
+		for (int i = 0; i < 20000; i++)
+		{
+			ins_1_t ins1 = {};
+			ins1.week = 2300;
+			ins1.timeOfWeek = 3600.0 + i * 0.01;
+			ins1.lla[0] = 40.0 + i * 1e-7;
+			p_data_hdr_t hdr = { DID_INS_1, sizeof(ins1), 0 };
+			if (logType == cISLogger::LOGTYPE_RAW)
+			{
+				logger.LogData(devLog, is_comm_data_to_buf(pkt, sizeof(pkt), &comm, hdr.id, hdr.size, 0, &ins1), pkt);
+			}
+			else
+			{
+				logger.LogData(devLog, &hdr, (uint8_t*)&ins1);
+			}
+		}
+		logger.CloseAllFiles();
+	}
+
+	cMcapExporter::sOptions options;
+	options.logType = logType;
+	options.writer.compression = compression;
+	options.writer.chunkSize = 256 * 1024;
+	cMcapExporter::sStats stats;
+	ASSERT_TRUE(cMcapExporter::Export(path, filename, options, &stats));
+	EXPECT_EQ(stats.messages, 20000u);
+	EXPECT_EQ(stats.devices, 1u);
+	EXPECT_EQ(stats.channels, 1u);
+
+	sMcapFile f;
+	ReadMcap(filename, f);
+	ASSERT_EQ(f.channels.size(), 1u);
+	EXPECT_EQ(f.channels.begin()->second.second, "/SN1001/DID_INS_1");
+	EXPECT_GT(f.statChunks, 1u);
+	auto& msgs = f.messages.begin()->second;
+	auto& times = f.times.begin()->second;
+	ASSERT_EQ(msgs.size(), 20000u);
+	for (int i = 0; i < 20000; i += 997)
+	{
+		ASSERT_EQ(msgs[i].size(), sizeof(ins_1_t));
+		ins_1_t ins1;
+		memcpy(&ins1, msgs[i].data(), sizeof(ins1));
+		EXPECT_DOUBLE_EQ(ins1.timeOfWeek, 3600.0 + i * 0.01);
+		EXPECT_NEAR((double)((int64_t)times[i] - weekStartNs(2300)), ins1.timeOfWeek * 1e9, 1.0);
+	}
+
+	ISFileManager::DeleteDirectory(path);
+	ISFileManager::DeleteFile(filename);
+}
+
+TEST(ISMcap, export_dat)
+{
+	TestExport(cISLogger::LOGTYPE_DAT, cMcapWriter::COMPRESSION_NONE);
+}
+
+TEST(ISMcap, export_raw_lz4)
+{
+	TestExport(cISLogger::LOGTYPE_RAW, cMcapWriter::COMPRESSION_LZ4);
+}
+
+// Time since boot, GPS time of week and raw observation data of one device share one log time epoch
+TEST(ISMcap, export_epoch)
+{
+	string path = "test_mcap_log";
+	string filename = "test_mcap.mcap";
+	ISFileManager::DeleteDirectory(path);
+	const uint32_t week = 2300;
+	const double towOffset = 100000.0;              // GPS time of week at boot
+	{
+		cISLogger logger;
+		ASSERT_TRUE(logger.InitSave(path, cISLogger::sSaveOptions(cISLogger::LOGTYPE_DAT, 0.5f, 0, DEFAULT_LOGS_MAX_FILE_SIZE, false)));
+		logger.EnableLogging(true);
+		std::shared_ptr<cDeviceLog> devLog = logger.registerDevice(0, 1001);
+		for (int i = 0; i < 100; i++)
+		{
+			double bootTime = 10.0 + i * 0.1;
+			pimu_t pimu = {};
+			pimu.time = bootTime;
+			p_data_hdr_t hdr = { DID_PIMU, sizeof(pimu), 0 };
+			logger.LogData(devLog, &hdr, (uint8_t*)&pimu);
+			if (i == 50)
+			{	// GPS fix
+				gps_pos_t pos = {};
+				pos.week = week;
+				pos.timeOfWeekMs = (uint32_t)((bootTime + towOffset) * 1000.0 + 0.5);
+				pos.towOffset = towOffset;
+				pos.leapS = C_GPS_LEAP_SECONDS;
+				hdr = { DID_GPS1_POS, sizeof(pos), 0 };
+				logger.LogData(devLog, &hdr, (uint8_t*)&pos);
+			}
+			if (i > 50)
+			{
+				ins_1_t ins1 = {};
+				ins1.week = week;
+				ins1.timeOfWeek = bootTime + towOffset;
+				hdr = { DID_INS_1, sizeof(ins1), 0 };
+				logger.LogData(devLog, &hdr, (uint8_t*)&ins1);
+			}
+		}
+		logger.CloseAllFiles();
+	}
+
+	cMcapExporter::sOptions options;
+	ASSERT_TRUE(cMcapExporter::Export(path, filename, options));
+	sMcapFile f;
+	ReadMcap(filename, f);
+	map<string, vector<uint64_t>> times;
+	for (auto& c : f.channels)
+	{
+		times[c.second.second] = f.times[c.first];
+	}
+	vector<uint64_t>& pimu = times["/SN1001/DID_PIMU"];
+	vector<uint64_t>& ins1 = times["/SN1001/DID_INS_1"];
+	ASSERT_EQ(pimu.size(), 100u);
+	ASSERT_EQ(ins1.size(), 49u);
+	ASSERT_EQ(times["/SN1001/DID_GPS1_POS"].size(), 1u);
+
+	// Time since boot until the GPS fix
+	EXPECT_EQ(pimu[0], 10000000000ULL);
+	EXPECT_EQ(pimu[50], 15000000000ULL);
+	EXPECT_EQ((int64_t)times["/SN1001/DID_GPS1_POS"][0], weekStartNs(week) + (int64_t)((15.0 + towOffset) * 1e9 + 0.5));
+
+	// Then GPS time, the same for data sets stamped with time since boot and time of week
+	for (int i = 51; i < 100; i++)
+	{
+		EXPECT_EQ((int64_t)pimu[i], weekStartNs(week) + (int64_t)((10.0 + i * 0.1 + towOffset) * 1e9 + 0.5)) << i;
+		EXPECT_EQ(pimu[i], ins1[i - 51]) << i;
+		EXPECT_GT(pimu[i], pimu[i - 1]);
+	}
+
+	ISFileManager::DeleteDirectory(path);
+	ISFileManager::DeleteFile(filename);
+}
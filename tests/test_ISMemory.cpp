@@ -0,0 +1,418 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include "ISMemory.h"
+#include "ISDevice.h"
+#include "ISLogStats.h"
+#include "DataKML.h"
+#include "message_stats.h"
+#include "InertialSense.h"
+#include "ISFileManager.h"
+#if !PLATFORM_IS_WINDOWS
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+
+static size_t live(cISMemory::eSubsystem s)
+{
+	return cISMemory::Usage(s).live;
+}
+
+// Caps are relative to what is already allocated by other tests and static objects
+static void setBudget(cISMemory::eSubsystem s, size_t bytes)
+{
+	cISMemory::SetCap(s, bytes ? live(s) + bytes : 0);
+}
+
+static void pushIns1(cDataKML& kml, kml_log_data_t& list, double timeOfWeek)
+{
+	ins_1_t ins = {};
+	ins.timeOfWeek = timeOfWeek;
+	ins.lla[0] = 40.0 + timeOfWeek * 1e-6;
+	ins.lla[1] = -111.0;
+	p_data_hdr_t hdr = { DID_INS_1, sizeof(ins_1_t), 0 };
+	kml.WriteDataToFile(list, &hdr, (uint8_t*)&ins);
+}
+
+
+TEST(ISMemory, accounting)
+{
+	size_t base = live(cISMemory::LOG_STATS);
+	cISMemory::ResetPeak(cISMemory::LOG_STATS);
+	uint64_t allocations = cISMemory::Usage(cISMemory::LOG_STATS).allocations;
+	{
+		is_counted_vector<uint64_t, cISMemory::LOG_STATS> v;
+		v.reserve(1000);
+		EXPECT_EQ(base + 8000, live(cISMemory::LOG_STATS));
+
+		log_stat_msg_map_t m;
+		for (int i = 0; i < 100; i++)
+		{
+			m[i].count = i;
+		}
+		EXPECT_EQ(base + 8000 + 100 * cISMemory::NodeBytes<log_stat_msg_map_t>(), live(cISMemory::LOG_STATS));
+		EXPECT_EQ(allocations + 101, cISMemory::Usage(cISMemory::LOG_STATS).allocations);
+
+		// Moves keep the accounting with the storage
+		log_stat_msg_map_t moved = std::move(m);
+		EXPECT_EQ(base + 8000 + 100 * cISMemory::NodeBytes<log_stat_msg_map_t>(), live(cISMemory::LOG_STATS));
+	}
+	EXPECT_EQ(base, live(cISMemory::LOG_STATS));
+	EXPECT_GE(cISMemory::Usage(cISMemory::LOG_STATS).peak, base + 8000 + 100 * cISMemory::NodeBytes<log_stat_msg_map_t>());
+	cISMemory::ResetPeak(cISMemory::LOG_STATS);
+	EXPECT_EQ(base, cISMemory::Usage(cISMemory::LOG_STATS).peak);
+
+	// Device config is counted, ISDevice itself lives in the caller's container
+	size_t deviceBase = live(cISMemory::DEVICE);
+	{
+		vector<ISDevice> devices(3);
+		EXPECT_EQ(deviceBase + 3 * sizeof(ISDeviceConfig), live(cISMemory::DEVICE));
+		devices.erase(devices.begin());
+		EXPECT_EQ(deviceBase + 2 * sizeof(ISDeviceConfig), live(cISMemory::DEVICE));
+	}
+	EXPECT_EQ(deviceBase, live(cISMemory::DEVICE));
+
+	string report = cISMemory::Report();
+	for (int s = 0; s < cISMemory::SUBSYSTEM_COUNT; s++)
+	{
+		EXPECT_NE(string::npos, report.find(cISMemory::Name((cISMemory::eSubsystem)s)));
+	}
+}
+
+
+TEST(ISMemory, caps_shed)
+{
+	// New message ids are counted as untracked
+	{
+		mul_msg_stats_t msgStats = {};
+		uint64_t shed = cISMemory::Usage(cISMemory::MESSAGE_STATS).shed;
+		setBudget(cISMemory::MESSAGE_STATS, 10 * cISMemory::NodeBytes<msg_stats_map_t>());
+		for (int id = 0; id < 20; id++)
+		{
+			messageStatsAppend("", msgStats, _PTYPE_RTCM3, 1000 + id, 100, id * 1000);
+		}
+		messageStatsAppend("", msgStats, _PTYPE_RTCM3, 1005, 100, 30000);       // Already tracked
+		EXPECT_EQ(10u, msgStats.rtcm3.size());
+		EXPECT_EQ(2, msgStats.rtcm3[1005].count);
+		EXPECT_EQ(10, msgStats.untracked.count);
+		EXPECT_EQ(shed + 10, cISMemory::Usage(cISMemory::MESSAGE_STATS).shed);
+		EXPECT_NE(string::npos, messageStatsSummary(msgStats).find("Untracked"));
+		setBudget(cISMemory::MESSAGE_STATS, 0);
+	}
+
+	// Log stats keep the protocol totals
+	{
+		cLogStats stats;
+		stats.LogData(_PTYPE_NMEA, 0, 10);
+		setBudget(cISMemory::LOG_STATS, 4 * cISMemory::NodeBytes<log_stat_msg_map_t>());
+		for (int id = 1; id < 10; id++)
+		{
+			stats.LogData(_PTYPE_NMEA, id, 10);
+		}
+		EXPECT_EQ(5u, stats.msgs[_PTYPE_NMEA].stats.size());
+		EXPECT_EQ(10u, stats.msgs[_PTYPE_NMEA].count);
+		setBudget(cISMemory::LOG_STATS, 0);
+	}
+
+	// KML track is decimated
+	{
+		cDataKML kml;
+		kml_log_data_t list;
+		setBudget(cISMemory::KML, 1024 * sizeof(sKmlLogData));
+		for (int i = 0; i < 10000; i++)
+		{
+			pushIns1(kml, list, i);
+		}
+		EXPECT_LE(list.capacity(), 1024u);
+		EXPECT_GT(list.size(), 256u);
+		for (size_t i = 1; i < list.size(); i++)
+		{
+			ASSERT_LT(list[i - 1].time, list[i].time);
+		}
+		EXPECT_EQ(9999.0, list.back().time);
+		setBudget(cISMemory::KML, 0);
+	}
+}
+
+
+#if !PLATFORM_IS_WINDOWS
+/** Devices on ptys that never answer.  Whatever the SDK sends is discarded so port writes never block. */
+class cPtyDevices
+{
+public:
+	cPtyDevices(int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			int master = posix_openpt(O_RDWR | O_NOCTTY);
+			if (master < 0 || grantpt(master) || unlockpt(master))
+			{
+				continue;
+			}
+			fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+			m_masters.push_back(master);
+			m_ports += (m_ports.empty() ? "" : ",") + string(ptsname(master));
+		}
+		m_drain = thread([this]()
+		{
+			char discard[4096];
+			while (m_running)
+			{
+				for (int master : m_masters)
+				{
+					while (read(master, discard, sizeof(discard)) > 0) {}
+				}
+				SLEEP_MS(5);
+			}
+		});
+	}
+
+	~cPtyDevices()
+	{
+		m_running = false;
+		m_drain.join();
+		for (int master : m_masters)
+		{
+			close(master);
+		}
+	}
+
+	size_t Count() { return m_masters.size(); }
+	const char* Ports() { return m_ports.c_str(); }
+
+private:
+	vector<int> m_masters;
+	string m_ports;
+	atomic<bool> m_running{ true };
+	thread m_drain;
+};
+
+
+// Received data queued for InertialSense::LoggerThread is shed at the cap, and logged once the cap allows
+TEST(ISMemory, logger_queue_cap)
+{
+	string logPath = "test_memory_logger_queue";
+	ISFileManager::DeleteDirectory(logPath);
+	cPtyDevices pty(1);
+	ASSERT_EQ(1u, pty.Count());
+
+	InertialSense is;
+	is.EnableDeviceValidation(false);
+	ASSERT_TRUE(is.Open(pty.Ports(), 921600));
+	is.getDevice(0).config->devInfo.serialNumber = 123456;     // Not validated, so no dev info from the device
+	cISLogger::sSaveOptions options(cISLogger::eLogType::LOGTYPE_DAT, 0.5f, 0, DEFAULT_LOGS_MAX_FILE_SIZE, false);
+	ASSERT_TRUE(is.EnableLogger(true, logPath, options));
+	pfnStepLogFunction stepLog = is.ComManagerState()->stepLogFunction;
+	ASSERT_NE(NULLPTR, stepLog);
+
+	ins_1_t ins = {};
+	p_data_t data = { { DID_INS_1, sizeof(ins), 0 }, (uint8_t*)&ins };
+	uint64_t shed = cISMemory::Usage(cISMemory::LOGGER_QUEUE).shed;
+
+	// No room for the queue to grow, everything received is dropped
+	setBudget(cISMemory::LOGGER_QUEUE, 1);
+	for (int i = 0; i < 100; i++)
+	{
+		stepLog(&is, &data, 0);
+	}
+	EXPECT_EQ(shed + 100, cISMemory::Usage(cISMemory::LOGGER_QUEUE).shed);
+
+	// Uncapped, all of it reaches the log
+	setBudget(cISMemory::LOGGER_QUEUE, 0);
+	for (int i = 0; i < 100; i++)
+	{
+		ins.timeOfWeek = i;
+		stepLog(&is, &data, 0);
+	}
+	EXPECT_EQ(shed + 100, cISMemory::Usage(cISMemory::LOGGER_QUEUE).shed);
+	SLEEP_MS(200);
+	is.EnableLogger(false);
+	is.Close();
+
+	cISLogger reader;
+	ASSERT_TRUE(reader.LoadFromDirectory(logPath, cISLogger::eLogType::LOGTYPE_DAT));
+	std::shared_ptr<cDeviceLog> readLog = reader.DeviceLogBySerialNumber(123456);
+	ASSERT_NE(readLog, nullptr);
+	int count = 0;
+	while (p_data_buf_t* d = reader.ReadData(readLog))
+	{
+		EXPECT_EQ((uint32_t)DID_INS_1, d->hdr.id);
+		count++;
+	}
+	EXPECT_EQ(100, count);
+	ISFileManager::DeleteDirectory(logPath);
+}
+
+
+// Ports beyond the DEVICE cap are not opened
+TEST(ISMemory, device_cap)
+{
+	cPtyDevices pty(3);
+	ASSERT_EQ(3u, pty.Count());
+	uint64_t shed = cISMemory::Usage(cISMemory::DEVICE).shed;
+
+	InertialSense is;
+	is.EnableDeviceValidation(false);
+	setBudget(cISMemory::DEVICE, 2 * sizeof(ISDeviceConfig));
+	EXPECT_TRUE(is.Open(pty.Ports(), 921600));
+	EXPECT_EQ(2u, is.DeviceCount());
+	EXPECT_EQ(shed + 1, cISMemory::Usage(cISMemory::DEVICE).shed);
+	is.Close();
+	setBudget(cISMemory::DEVICE, 0);
+
+	EXPECT_TRUE(is.Open(pty.Ports(), 921600));
+	EXPECT_EQ(3u, is.DeviceCount());
+	is.Close();
+}
+#endif
+
+
+/**
+ * Simulated traffic from several devices, with hot-plug and logger stalls, in compressed time.  Unique message ids from
+ * corrupt NMEA and a KML file that is never rotated would grow without bound, so live bytes must level off at the caps.
+ * The default 36 minutes reaches every cap and one hot-plug.  Set MEM_SOAK_HOURS (i.e. 4) to also check that usage stops
+ * growing after the second hour.
+ */
+TEST(ISMemory, soak)
+{
+	double hours = 0.6;
+	if (getenv("MEM_SOAK_HOURS")) { hours = atof(getenv("MEM_SOAK_HOURS")); }
+	const int numDevices = 4;
+	const int stepMs = 10;                  // 100 Hz INS
+	const size_t budget = 256 * 1024;
+	const cISMemory::eSubsystem capped[] = { cISMemory::LOGGER_QUEUE, cISMemory::LOG_STATS, cISMemory::MESSAGE_STATS, cISMemory::KML };
+
+	size_t base[cISMemory::SUBSYSTEM_COUNT];
+	uint64_t shedBase[cISMemory::SUBSYSTEM_COUNT];
+	for (int s = 0; s < cISMemory::SUBSYSTEM_COUNT; s++)
+	{
+		base[s] = live((cISMemory::eSubsystem)s);
+		shedBase[s] = cISMemory::Usage((cISMemory::eSubsystem)s).shed;
+		cISMemory::ResetPeak((cISMemory::eSubsystem)s);
+	}
+	for (cISMemory::eSubsystem s : capped)
+	{
+		setBudget(s, budget);
+	}
+
+	struct sDevice
+	{
+		cLogStats logStats;
+		mul_msg_stats_t msgStats = {};
+		kml_log_data_t kml;
+	};
+	vector<ISDevice> devices(numDevices);
+	vector<sDevice> state(numDevices);
+	cDataKML kml;
+	typedef is_counted_vector<p_data_buf_t, cISMemory::LOGGER_QUEUE> queue_t;
+	queue_t queue, draining;                // Same swap pattern as InertialSense::LoggerThread
+	mt19937 rng(1234);
+	const uint32_t dids[] = { DID_INS_1, DID_PIMU, DID_GPS1_POS, DID_GPS1_RTK_POS, DID_SYS_PARAMS };
+
+	auto start = chrono::high_resolution_clock::now();
+	uint64_t steps = (uint64_t)(hours * 3600 * 1000 / stepMs);
+	size_t hourTwoMax = 0, lastHourMax = 0;
+	uint64_t messages = 0;
+	for (uint64_t step = 0; step < steps; step++)
+	{
+		uint32_t timeMs = (uint32_t)(step * stepMs);
+		for (int d = 0; d < numDevices; d++)
+		{
+			sDevice& dev = state[d];
+			for (uint32_t did : dids)
+			{
+				if (did != DID_INS_1 && did != DID_PIMU && step % 20)
+				{
+					continue;       // 5 Hz
+				}
+				dev.logStats.LogData(_PTYPE_INERTIAL_SENSE_DATA, did, 100, timeMs * 0.001);
+				messageStatsAppend("", dev.msgStats, _PTYPE_INERTIAL_SENSE_DATA, did, 100, timeMs);
+				messages++;
+
+				cISMemory::eSubsystem s = cISMemory::LOGGER_QUEUE;
+				if (cISMemory::Available(s, cISMemory::GrowthBytes(queue)))
+				{
+					p_data_buf_t pkt;
+					pkt.hdr = { (uint8_t)did, 100, 0 };
+					queue.push_back(pkt);
+				}
+				else
+				{
+					cISMemory::Shed(s);
+				}
+			}
+			pushIns1(kml, dev.kml, timeMs * 0.001);
+
+			if (step % 100 == (uint64_t)d)
+			{   // Corrupt NMEA once a second, each with a new id
+				int id = (int)rng();
+				dev.logStats.LogData(_PTYPE_NMEA, id, 80, timeMs * 0.001);
+				messageStatsAppend("", dev.msgStats, _PTYPE_NMEA, id, 80, timeMs);
+				messages++;
+			}
+		}
+
+		// Logger drains every 20 ms, except for a 30 s stall every 10 minutes
+		if (step % 2 == 0 && timeMs % 600000 >= 30000)
+		{
+			draining.swap(queue);
+			draining.clear();
+		}
+
+		if (timeMs % 1800000 == 0 && step)
+		{   // Hot-plug one device every 30 minutes
+			int d = (int)(step / 180000) % numDevices;
+			devices.erase(devices.begin() + d);
+			devices.insert(devices.begin() + d, ISDevice());
+		}
+
+		if (timeMs % 60000 == 0)
+		{
+			for (cISMemory::eSubsystem s : capped)
+			{
+				ASSERT_LE(live(s), cISMemory::Usage(s).cap) << cISMemory::Name(s) << " at " << timeMs / 60000 << " min";
+			}
+			size_t total = cISMemory::TotalLive();
+			if (timeMs > 3600000 && timeMs <= 7200000)
+			{
+				hourTwoMax = _MAX(hourTwoMax, total);
+			}
+			if (timeMs > (steps * stepMs) - 3600000)
+			{
+				lastHourMax = _MAX(lastHourMax, total);
+			}
+		}
+	}
+	double sec = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+
+	printf("%.1f simulated hours, %d devices, %.1f M messages in %.1f s\n%s", hours, numDevices, messages * 1e-6, sec, cISMemory::Report().c_str());
+
+	// Bounded: no growth after the second hour, and every cap was exercised
+	if (hours > 2)
+	{
+		EXPECT_LE(lastHourMax, hourTwoMax);
+	}
+	for (cISMemory::eSubsystem s : capped)
+	{
+		EXPECT_LE(cISMemory::Usage(s).peak, cISMemory::Usage(s).cap) << cISMemory::Name(s);
+		EXPECT_GT(cISMemory::Usage(s).shed, shedBase[s]) << cISMemory::Name(s);
+	}
+	EXPECT_EQ(base[cISMemory::DEVICE] + numDevices * sizeof(ISDeviceConfig), live(cISMemory::DEVICE));
+
+	// Everything is returned
+	devices.clear();
+	state.clear();
+	queue = queue_t();
+	draining = queue_t();
+	for (int s = 0; s < cISMemory::SUBSYSTEM_COUNT; s++)
+	{
+		EXPECT_EQ(base[s], live((cISMemory::eSubsystem)s)) << cISMemory::Name((cISMemory::eSubsystem)s);
+		cISMemory::SetCap((cISMemory::eSubsystem)s, 0);
+	}
+}
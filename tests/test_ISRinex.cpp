@@ -0,0 +1,285 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include "ISRinex.h"
+#include "ISEarth.h"
+#include "ISLogger.h"
+#include "ISFileManager.h"
+
+using namespace std;
+
+static string ReadFile(const string& filename)
+{
+	ifstream f(filename, ios::binary);
+	stringstream ss;
+	ss << f.rdbuf();
+	return ss.str();
+}
+
+static string FormatFixed(double value, int width, int decimals)
+{
+	char buf[64];
+	char* end = rinexFormatFixed(buf, value, width, decimals);
+	return string(buf, end - buf);
+}
+
+static string FormatExp(double value, int width, int decimals)
+{
+	char buf[64];
+	char* end = rinexFormatExp(buf, value, width, decimals);
+	return string(buf, end - buf);
+}
+
+static obsd_t CreateObs(gtime_t time, int sat, uint8_t code, double range)
+{
+	obsd_t o = {};
+	o.time = time;
+	o.sat = (uint8_t)sat;
+	o.code[0] = code;
+	o.SNR[0] = 45 * 4;
+	o.P[0] = range;
+	o.L[0] = range / 0.19029367;
+	o.D[0] = -1234.567f;
+	return o;
+}
+
+TEST(ISRinex, format_int)
+{
+	char buf[16];
+	EXPECT_EQ(string(buf, rinexFormatInt(buf, 42, 5) - buf), "   42");
+	EXPECT_EQ(string(buf, rinexFormatInt(buf, -42, 5) - buf), "  -42");
+	EXPECT_EQ(string(buf, rinexFormatInt(buf, 7, 2, '0') - buf), "07");
+	EXPECT_EQ(string(buf, rinexFormatInt(buf, 123456, 3) - buf), "   ");		// Does not fit
+}
+
+TEST(ISRinex, format_fixed_matches_printf)
+{
+	mt19937 rng(1234);
+	uniform_real_distribution<double> range(-3.0e8, 3.0e8);
+	uniform_int_distribution<int> decimals(0, 7);
+	char ref[64];
+
+	for (int i = 0; i < 200000; i++)
+	{
+		double v = range(rng);
+		int d = decimals(rng);
+		if (i % 3 == 0)
+		{	// Values with few integer digits
+			v *= 1e-8;
+		}
+		snprintf(ref, sizeof(ref), "%*.*f", 20, d, v);
+		ASSERT_EQ(FormatFixed(v, 20, d), string(ref)) << "value: " << v << " decimals: " << d;
+	}
+
+	EXPECT_EQ(FormatFixed(0.0, 14, 3), "         0.000");
+	EXPECT_EQ(FormatFixed(0.0005, 6, 3), snprintf(ref, sizeof(ref), "%6.3f", 0.0005) ? string(ref) : "");
+	EXPECT_EQ(FormatFixed(59.99999999, 11, 7), " 60.0000000");	// Carry into the integer part
+	EXPECT_EQ(FormatFixed(1.0e12, 14, 3), "              ");	// Too wide is blank
+}
+
+TEST(ISRinex, format_exp_matches_printf)
+{
+	mt19937 rng(5678);
+	uniform_real_distribution<double> mantissa(-10.0, 10.0);
+	uniform_int_distribution<int> exponent(-40, 40);
+	char ref[64];
+
+	for (int i = 0; i < 200000; i++)
+	{
+		double v = mantissa(rng) * pow(10.0, exponent(rng));
+		snprintf(ref, sizeof(ref), "%19.12E", v);
+		ASSERT_EQ(FormatExp(v, 19, 12), string(ref)) << "value: " << v;
+	}
+
+	snprintf(ref, sizeof(ref), "%19.12E", 0.0);
+	EXPECT_EQ(FormatExp(0.0, 19, 12), string(ref));
+	snprintf(ref, sizeof(ref), "%19.12E", 1.0);
+	EXPECT_EQ(FormatExp(1.0, 19, 12), string(ref));
+	snprintf(ref, sizeof(ref), "%19.12E", 9.9999999999999);
+	EXPECT_EQ(FormatExp(9.9999999999999, 19, 12), string(ref));
+}
+
+TEST(ISRinex, satellite_id)
+{
+	char id[4];
+	EXPECT_TRUE(rinexSatId(satNo(SYS_GPS, 5), id));
+	EXPECT_STREQ(id, "G05");
+	EXPECT_TRUE(rinexSatId(satNo(SYS_GPS, 32), id));
+	EXPECT_STREQ(id, "G32");
+#ifdef ENAGAL
+	EXPECT_TRUE(rinexSatId(satNo(SYS_GAL, 12), id));
+	EXPECT_STREQ(id, "E12");
+#endif
+	EXPECT_FALSE(rinexSatId(0, id));
+	EXPECT_FALSE(rinexSatId(RINEX_MAX_SAT + 1, id));
+
+	for (int sat = 1; sat <= RINEX_MAX_SAT; sat++)
+	{	// Round trip against satNo()
+		int prn;
+		int sys = rinexSatSys(sat, &prn);
+		EXPECT_EQ(satNo(sys, prn), sat);
+	}
+
+	EXPECT_STREQ(rinexObsCode(1), "1C");
+	EXPECT_STREQ(rinexObsCode(12), "1X");
+	EXPECT_EQ(rinexObsCode(0), nullptr);
+	EXPECT_EQ(rinexObsCode(255), nullptr);
+}
+
+TEST(ISRinex, obs_writer)
+{
+	string filename = "test_rinex.obs";
+	gtime_t t0 = ISgpst2time(2300, 345600.0);
+
+	cRinexObsWriter writer;
+	ASSERT_TRUE(writer.Open(filename));
+	writer.HeaderInfo().markerName = "TEST";
+	for (int e = 0; e < 10; e++)
+	{
+		gtime_t t = IStimeadd(t0, e * 0.2);
+		obsd_t obs[3] = {
+			CreateObs(t, satNo(SYS_GPS, 12), 1, 21000000.123),
+			CreateObs(t, satNo(SYS_GPS, 3), 1, 22000000.456),		// Out of order, sorted on output
+			CreateObs(t, satNo(SYS_GPS, 7), e < 5 ? 1 : 14, 23000000.789),	// New signal mid-stream
+		};
+		// Epoch split across two messages
+		writer.AddObservations(obs, 2);
+		writer.AddObservations(obs + 2, 1);
+	}
+	EXPECT_TRUE(writer.Close());
+	EXPECT_EQ(writer.EpochCount(), 10u);
+	EXPECT_EQ(writer.ObservationCount(), 30u);
+	EXPECT_FALSE(ifstream(filename + ".tmp").good());
+
+	string text = ReadFile(filename);
+	EXPECT_EQ((uint64_t)text.size(), writer.BytesWritten());
+	EXPECT_EQ(text.find("     3.04           OBSERVATION DATA    M: Mixed            RINEX VERSION / TYPE\n"), 0u);
+	EXPECT_NE(text.find("G    8 C1C L1C D1C S1C C2C L2C D2C S2C                      SYS / # / OBS TYPES \n"), string::npos);
+	EXPECT_NE(text.find("  2024     2     8     0     0    0.0000000     GPS         TIME OF FIRST OBS   \n"), string::npos);
+	EXPECT_NE(text.find("END OF HEADER       \n> 2024 02 08 00 00  0.0000000  0  3\nG03  22000000.456  "), string::npos);
+	EXPECT_NE(text.find("> 2024 02 08 00 00  1.8000000  0  3\n"), string::npos);
+	EXPECT_NE(text.find("     -1234.567          45.000  \n"), string::npos);
+	EXPECT_NE(text.find("\nG07" + string(64, ' ') + "  23000000.789"), string::npos);	// 1C columns left blank
+
+	// Every header line is 80 characters
+	size_t end = text.find("END OF HEADER");
+	for (size_t pos = 0; pos < end; pos = text.find('\n', pos) + 1)
+	{
+		EXPECT_EQ(text.find('\n', pos) - pos, 80u);
+	}
+
+	ISFileManager::DeleteFile(filename);
+}
+
+TEST(ISRinex, nav_writer_drops_duplicates)
+{
+	string filename = "test_rinex.nav";
+	cRinexNavWriter writer;
+	ASSERT_TRUE(writer.Open(filename));
+
+	eph_t eph = {};
+	eph.sat = satNo(SYS_GPS, 5);
+	eph.iode = 10;
+	eph.toe = eph.toc = eph.ttr = ISgpst2time(2300, 345600.0);
+	eph.toes = 345600.0;
+	eph.A = 26560000.0 * 26560000.0;
+	eph.f0 = -1.2345e-4;
+	EXPECT_TRUE(writer.AddEphemeris(eph));
+	EXPECT_FALSE(writer.AddEphemeris(eph));		// Rebroadcast
+	eph.iode = 11;
+	EXPECT_TRUE(writer.AddEphemeris(eph));
+	EXPECT_TRUE(writer.Close());
+	EXPECT_EQ(writer.EphemerisCount(), 2u);
+
+	string text = ReadFile(filename);
+	EXPECT_NE(text.find("N: GNSS NAV DATA    M: MIXED            RINEX VERSION / TYPE"), string::npos);
+	EXPECT_NE(text.find("G05 2024 02 08 00 00 00-1.234500000000E-04 0.000000000000E+00 0.000000000000E+00\n"), string::npos);
+	EXPECT_NE(text.find("     1.000000000000E+01"), string::npos);	// IODE
+	EXPECT_NE(text.find(" 2.656000000000E+07\n"), string::npos);	// sqrt(A) ends line 3
+	ISFileManager::DeleteFile(filename);
+}
+
+TEST(ISRinex, export_log)
+{
+	string logPath = "test_rinex_log";
+	string outPath = "test_rinex_out";
+	ISFileManager::DeleteDirectory(logPath);
+	ISFileManager::DeleteDirectory(outPath);
+
+	{	// Generate log with raw GNSS data
+		cISLogger logger;
+		cISLogger::sSaveOptions options;
+		options.logType = cISLogger::LOGTYPE_DAT;
+		options.useSubFolderTimestamp = false;
+		logger.InitSave(logPath, options);
+		auto devLog = logger.registerDevice(IS_HARDWARE_TYPE_IMX, 12345);
+		logger.EnableLogging(true);
+
+		gtime_t t0 = ISgpst2time(2300, 345600.0);
+		for (int e = 0; e < 50; e++)
+		{
+			gps_raw_t raw = {};
+			raw.dataType = raw_data_type_observation;
+			raw.obsCount = 4;
+			for (int s = 0; s < 4; s++)
+			{
+				raw.data.obs[s] = CreateObs(IStimeadd(t0, e), satNo(SYS_GPS, s + 1), 1, 2.1e7 + s);
+			}
+			p_data_hdr_t hdr = { DID_GPS1_RAW, (uint32_t)(offsetof(gps_raw_t, data) + 4 * sizeof(obsd_t)), 0 };
+			EXPECT_TRUE(logger.LogData(devLog, &hdr, (const uint8_t*)&raw));
+		}
+		logger.CloseAllFiles();
+	}
+
+	cRinexExporter::sOptions options;
+	options.outputDirectory = outPath;
+	cRinexExporter::sStats stats;
+	EXPECT_TRUE(cRinexExporter::Export({ logPath }, options, &stats));
+	EXPECT_EQ(stats.devices, 1u);
+	EXPECT_EQ(stats.epochs, 50u);
+	EXPECT_EQ(stats.observations, 200u);
+
+	vector<string> files;
+	ISFileManager::GetAllFilesInDirectory(outPath, false, ".*\\.obs", files);
+	ASSERT_EQ(files.size(), 1u);
+	EXPECT_NE(files[0].find("SN12345"), string::npos);
+	EXPECT_NE(ReadFile(files[0]).find("12345               "), string::npos);
+
+	ISFileManager::DeleteDirectory(logPath);
+	ISFileManager::DeleteDirectory(outPath);
+}
+
+TEST(ISRinex, obs_writer_throughput)
+{
+	string filename = "test_rinex_bench.obs";
+	const int epochCount = 20000;
+	const int satCount = 24;
+	gtime_t t0 = ISgpst2time(2300, 345600.0);
+	obsd_t obs[satCount];
+
+	auto start = chrono::steady_clock::now();
+	cRinexObsWriter writer;
+	ASSERT_TRUE(writer.Open(filename));
+	for (int e = 0; e < epochCount; e++)
+	{
+		gtime_t t = IStimeadd(t0, e * 0.2);
+		for (int s = 0; s < satCount; s++)
+		{
+			int sat = 1 + s % RINEX_MAX_SAT;
+			obs[s] = CreateObs(t, sat, 1, 2.0e7 + e * 3.3 + s * 1000.1);
+			obs[s].code[1] = 14;
+			obs[s].P[1] = obs[s].P[0] + 2.5;
+			obs[s].L[1] = obs[s].L[0] * 0.779;
+		}
+		writer.AddObservations(obs, satCount);
+	}
+	EXPECT_TRUE(writer.Close());
+	double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	EXPECT_EQ(writer.EpochCount(), (uint64_t)epochCount);
+	printf("RINEX OBS: %d epochs, %.1f MB in %.3f s (%.0f epochs/s, %.1f MB/s)\n",
+		epochCount, writer.BytesWritten() * 1.0e-6, sec, epochCount / sec, writer.BytesWritten() * 1.0e-6 / sec);
+	ISFileManager::DeleteFile(filename);
+}
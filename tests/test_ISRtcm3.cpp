@@ -0,0 +1,374 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+#include "ISRtcm3.h"
+#include "ISEarth.h"
+extern "C"
+{
+#include "ISComm.h"
+}
+
+using namespace std;
+
+#define CLIGHT      299792458.0
+#define RANGE_MS    (CLIGHT * 0.001)
+#define FREQ_L1     1.57542e9
+#define FREQ_L5     1.17645e9
+
+// Minimal RTCM3 message writer used to create test frames
+class cRtcm3Writer
+{
+public:
+	cRtcm3Writer(int type) { memset(buf, 0, sizeof(buf)); U(12, type); }
+
+	void U(int bits, uint64_t value)
+	{
+		for (int i = bits - 1; i >= 0; i--, pos++)
+		{
+			if ((value >> i) & 1)
+			{
+				buf[pos / 8] |= (uint8_t)(0x80 >> (pos % 8));
+			}
+		}
+	}
+	void S(int bits, int64_t value) { U(bits, (uint64_t)value & ((1ULL << bits) - 1)); }
+	void SM(int bits, int64_t value) { U(1, value < 0); U(bits - 1, (uint64_t)(value < 0 ? -value : value)); }
+
+	// Add header and CRC.  Returns frame size.
+	int Finish()
+	{
+		int len = (pos - 24 + 7) / 8;
+		buf[0] = RTCM3_START_BYTE;
+		buf[1] = (uint8_t)(len >> 8) & 0x3;
+		buf[2] = (uint8_t)len;
+		unsigned int crc = calculate24BitCRCQ(buf, len + 3);
+		buf[len + 3] = (uint8_t)(crc >> 16);
+		buf[len + 4] = (uint8_t)(crc >> 8);
+		buf[len + 5] = (uint8_t)crc;
+		return len + 6;
+	}
+
+	uint8_t buf[1100];
+	int pos = 24;
+};
+
+struct sMsmTestCell
+{
+	int64_t pr, cp, lock, half, cnr, rate;
+};
+
+static const int s_rrInt = 70;
+static const int s_rrMod = 512;
+static const int s_rate = -700;
+
+// MSM message with all satellite / signal cells present except those in skipCells
+static int BuildMsm(cRtcm3Writer& w, int msmType, uint32_t epochMs, int sync, const vector<int>& prns, const vector<int>& sigIds, const sMsmTestCell& c, uint64_t skipCells = 0)
+{
+	w.U(12, 1234);				// Station id
+	w.U(30, epochMs);
+	w.U(1, sync);
+	w.U(3 + 7 + 2 + 2 + 1 + 3, 0);
+	uint64_t satMask = 0;
+	for (int prn : prns) { satMask |= 1ULL << (64 - prn); }
+	w.U(32, satMask >> 32);
+	w.U(32, satMask & 0xFFFFFFFF);
+	uint32_t sigMask = 0;
+	for (int id : sigIds) { sigMask |= 1u << (32 - id); }
+	w.U(32, sigMask);
+	int ncell = 0;
+	for (size_t i = 0; i < prns.size() * sigIds.size(); i++)
+	{
+		bool present = !(skipCells & (1ULL << i));
+		w.U(1, present);
+		ncell += present;
+	}
+
+	bool ext = (msmType >= 6);
+	bool rate = (msmType == 5 || msmType == 7);
+	for (size_t i = 0; i < prns.size(); i++) { w.U(8, s_rrInt); }
+	if (rate) { for (size_t i = 0; i < prns.size(); i++) { w.U(4, 15); } }
+	for (size_t i = 0; i < prns.size(); i++) { w.U(10, s_rrMod); }
+	if (rate) { for (size_t i = 0; i < prns.size(); i++) { w.S(14, s_rate); } }
+
+	for (int i = 0; i < ncell; i++) { w.S(ext ? 20 : 15, c.pr); }
+	for (int i = 0; i < ncell; i++) { w.S(ext ? 24 : 22, c.cp); }
+	for (int i = 0; i < ncell; i++) { w.U(ext ? 10 : 4, c.lock); }
+	for (int i = 0; i < ncell; i++) { w.U(1, c.half); }
+	for (int i = 0; i < ncell; i++) { w.U(ext ? 10 : 6, c.cnr); }
+	if (rate) { for (int i = 0; i < ncell; i++) { w.S(15, c.rate); } }
+	return w.Finish();
+}
+
+static const obsd_t* FindObs(cRtcm3Decoder& d, int sat)
+{
+	for (int i = 0; i < d.ObservationCount(); i++)
+	{
+		if (d.Observations()[i].sat == sat)
+		{
+			return &d.Observations()[i];
+		}
+	}
+	return nullptr;
+}
+
+TEST(ISRtcm3, get_bits)
+{
+	mt19937 rng(42);
+	uint8_t buf[64];
+	for (auto& b : buf) { b = (uint8_t)rng(); }
+
+	for (int n = 0; n < 100000; n++)
+	{
+		unsigned int pos = rng() % 400;
+		unsigned int len = rng() % 33;
+		uint32_t ref = 0;
+		for (unsigned int i = pos; i < pos + len; i++)
+		{
+			ref = (ref << 1) + ((buf[i / 8] >> (7 - i % 8)) & 1u);
+		}
+		ASSERT_EQ(getBitsAsUInt32(buf, pos, len), ref) << "pos " << pos << " len " << len;
+
+		int32_t sref = (len && len < 32 && (ref >> (len - 1))) ? (int32_t)(ref | (~0u << len)) : (int32_t)ref;
+		ASSERT_EQ(getBitsAsInt32(buf, pos, len), sref) << "pos " << pos << " len " << len;
+	}
+}
+
+TEST(ISRtcm3, station_1005_1006)
+{
+	cRtcm3Writer w(1006);
+	w.U(12, 321);
+	w.U(10, 0);
+	w.S(38, -21234567890LL);
+	w.U(2, 0);
+	w.S(38, 43210987654LL);
+	w.U(2, 0);
+	w.S(38, -1LL);
+	w.U(16, 15000);
+	int size = w.Finish();
+
+	cRtcm3Decoder d;
+	EXPECT_EQ(d.Decode(w.buf, size), raw_data_type_base_station_antenna_position);
+	EXPECT_EQ(d.Station().stationId, 321);
+	EXPECT_DOUBLE_EQ(d.Station().pos[0], -2123456.7890);
+	EXPECT_DOUBLE_EQ(d.Station().pos[1], 4321098.7654);
+	EXPECT_DOUBLE_EQ(d.Station().pos[2], -0.0001);
+	EXPECT_DOUBLE_EQ(d.Station().hgt, 1.5);
+
+	// Truncated
+	EXPECT_EQ(d.Decode(w.buf, size - 10), -1);
+	EXPECT_EQ(d.Stats().errors, 1u);
+}
+
+TEST(ISRtcm3, gps_ephemeris_1019)
+{
+	cRtcm3Writer w(1019);
+	w.U(6, 17);					// PRN
+	w.U(10, 2300 % 1024);		// Week
+	w.U(4, 2);					// SVA
+	w.U(2, 1);					// Code on L2
+	w.S(14, -100);				// IDOT
+	w.U(8, 77);					// IODE
+	w.U(16, 345600 / 16);		// toc
+	w.S(8, 0);					// af2
+	w.S(16, -5);				// af1
+	w.S(22, -123456);			// af0
+	w.U(10, 333);				// IODC
+	w.S(16, -1000);				// Crs
+	w.S(16, 2000);				// delta n
+	w.S(32, -1000000000);		// M0
+	w.S(16, 100);				// Cuc
+	w.U(32, 50000000);			// e
+	w.S(16, -100);				// Cus
+	w.U(32, 2702606889u);		// sqrt(A)
+	w.U(16, 345600 / 16);		// toe
+	w.S(16, 10);				// Cic
+	w.S(32, 1000000000);		// OMEGA0
+	w.S(16, -10);				// Cis
+	w.S(32, 650000000);			// i0
+	w.S(16, 5000);				// Crc
+	w.S(32, -400000000);		// omega
+	w.S(24, -20000);			// OMEGADOT
+	w.S(8, -3);					// tGD
+	w.U(6, 0);					// SV health
+	w.U(1, 0);					// L2 P data flag
+	w.U(1, 0);					// Fit interval
+	int size = w.Finish();
+
+	cRtcm3Decoder d;
+	d.SetTime(ISgpst2time(2300, 300000.0));
+	ASSERT_EQ(d.Decode(w.buf, size), raw_data_type_ephemeris);
+	const eph_t& eph = d.Ephemeris();
+	EXPECT_EQ(eph.sat, satNo(SYS_GPS, 17));
+	EXPECT_EQ(eph.week, 2300);
+	EXPECT_EQ(eph.iode, 77);
+	EXPECT_EQ(eph.iodc, 333);
+	EXPECT_EQ(eph.sva, 2);
+	EXPECT_EQ(eph.code, 1);
+	EXPECT_DOUBLE_EQ(eph.toes, 345600.0);
+	EXPECT_EQ(eph.toe.time, ISgpst2time(2300, 345600.0).time);
+	EXPECT_DOUBLE_EQ(eph.f0, -123456 * pow(2, -31));
+	EXPECT_DOUBLE_EQ(eph.f1, -5 * pow(2, -43));
+	EXPECT_DOUBLE_EQ(eph.e, 50000000 * pow(2, -33));
+	EXPECT_DOUBLE_EQ(eph.A, pow(2702606889.0 * pow(2, -19), 2));
+	EXPECT_DOUBLE_EQ(eph.M0, -1000000000 * pow(2, -31) * 3.1415926535898);
+	EXPECT_DOUBLE_EQ(eph.OMGd, -20000 * pow(2, -43) * 3.1415926535898);
+	EXPECT_DOUBLE_EQ(eph.crc, 5000 * pow(2, -5));
+	EXPECT_DOUBLE_EQ(eph.tgd[0], -3 * pow(2, -31));
+	EXPECT_DOUBLE_EQ(eph.fit, 4.0);
+}
+
+TEST(ISRtcm3, glonass_ephemeris_1020)
+{
+	cRtcm3Writer w(1020);
+	w.U(6, 5);					// Slot
+	w.U(5, 7 - 2);				// Frequency channel -2
+	w.U(4, 0);
+	w.U(5, 10);					// tk hours
+	w.U(6, 30);					// tk minutes
+	w.U(1, 1);					// tk 30 s
+	w.U(1, 0);					// Bn
+	w.U(1, 0);
+	w.U(7, 45);					// tb (15 minute units)
+	for (int i = 0; i < 3; i++)
+	{
+		w.SM(24, -1000 * (i + 1));
+		w.SM(27, 10000000 + i);
+		w.SM(5, -(i + 1));
+	}
+	w.U(1, 0);
+	w.SM(11, -3);				// gamma
+	w.U(3, 0);
+	w.SM(22, 12345);			// tau
+	w.SM(5, -2);				// delta tau
+	w.U(5, 3);					// E (age)
+	w.U(97, 0);
+	int size = w.Finish();
+
+	cRtcm3Decoder d;
+	d.SetTime(ISgpst2time(2300, 345600.0));
+#ifdef ENAGLO
+	ASSERT_EQ(d.Decode(w.buf, size), raw_data_type_glonass_ephemeris);
+	const geph_t& geph = d.GlonassEphemeris();
+	EXPECT_EQ(geph.frq, -2);
+	EXPECT_EQ(geph.iode, 45);
+	EXPECT_EQ(geph.age, 3);
+	EXPECT_DOUBLE_EQ(geph.pos[0], 10000000 * pow(2, -11) * 1e3);
+	EXPECT_DOUBLE_EQ(geph.vel[1], -2000 * pow(2, -20) * 1e3);
+	EXPECT_DOUBLE_EQ(geph.acc[2], -3 * pow(2, -30) * 1e3);
+	EXPECT_DOUBLE_EQ(geph.gamn, -3 * pow(2, -40));
+	EXPECT_DOUBLE_EQ(geph.taun, 12345 * pow(2, -30));
+#else
+	// GLONASS disabled in rtk_defines.h
+	EXPECT_EQ(d.Decode(w.buf, size), 0);
+	EXPECT_EQ(d.Stats().unsupported, 1u);
+#endif
+}
+
+TEST(ISRtcm3, msm_multi_constellation_epoch)
+{
+	cRtcm3Decoder d;
+	d.SetTime(ISgpst2time(2300, 345000.0));
+	uint32_t towMs = 345600200;
+
+	// GPS MSM7, more messages to follow
+	sMsmTestCell c7 = { 12345, -54321, 100, 0, 45 * 16, 1234 };
+	cRtcm3Writer gps(1077);
+	int size = BuildMsm(gps, 7, towMs, 1, { 5, 12 }, { 2, 23 }, c7);
+	EXPECT_EQ(d.Decode(gps.buf, size), 0);
+
+	// Galileo MSM4 completes the epoch.  PRN 7 has no 5Q.
+	sMsmTestCell c4 = { -2000, 3000, 5, 1, 40, 0 };
+	cRtcm3Writer gal(1094);
+	size = BuildMsm(gal, 4, towMs, 0, { 3, 7 }, { 2, 23 }, c4, 1ULL << 3);
+	ASSERT_EQ(d.Decode(gal.buf, size), raw_data_type_observation);
+	EXPECT_EQ(d.ObservationCount(), 4);
+	EXPECT_EQ(d.StationId(), 1234);
+	EXPECT_EQ(d.Stats().msm, 2u);
+	EXPECT_EQ(d.Stats().epochSatCount, 4u);
+	EXPECT_EQ(d.Stats().epochSignalCount, 7u);
+
+	double range = s_rrInt + s_rrMod * pow(2, -10);
+
+	// GPS L1C and L5Q
+	const obsd_t* o = FindObs(d, satNo(SYS_GPS, 12));
+	ASSERT_NE(o, nullptr);
+	int week;
+	EXPECT_DOUBLE_EQ(IStime2gpst(o->time, &week), 345600.2);
+	EXPECT_EQ(week, 2300);
+	EXPECT_STREQ(rinexObsCode(o->code[0]), "1C");
+	EXPECT_STREQ(rinexObsCode(o->code[1]), "5Q");
+	EXPECT_DOUBLE_EQ(o->P[0], (range + 12345 * pow(2, -29)) * RANGE_MS);
+	EXPECT_DOUBLE_EQ(o->L[1], (range - 54321 * pow(2, -31)) * RANGE_MS * FREQ_L5 / CLIGHT);
+	EXPECT_FLOAT_EQ(o->D[0], (float)(-(s_rate + 0.1234) * FREQ_L1 / CLIGHT));
+	EXPECT_EQ(o->SNR[0], 45 * 4);
+	EXPECT_EQ(o->LLI[0], 0);
+
+	// Galileo MSM4 has no doppler
+	o = FindObs(d, satNo(SYS_GAL, 3));
+	ASSERT_NE(o, nullptr);
+	EXPECT_DOUBLE_EQ(o->P[0], (range - 2000 * pow(2, -24)) * RANGE_MS);
+	EXPECT_DOUBLE_EQ(o->L[0], (range + 3000 * pow(2, -29)) * RANGE_MS * FREQ_L1 / CLIGHT);
+	EXPECT_EQ(o->D[0], 0.0f);
+	EXPECT_EQ(o->SNR[0], 40 * 4);
+	EXPECT_EQ(o->LLI[0], 2);		// Half cycle ambiguity
+	o = FindObs(d, satNo(SYS_GAL, 7));
+	ASSERT_NE(o, nullptr);
+	EXPECT_EQ(o->code[1], 0);
+
+	// Next epoch with a lock time reset is a cycle slip
+	c7.lock = 10;
+	cRtcm3Writer gps2(1077);
+	size = BuildMsm(gps2, 7, towMs + 200, 0, { 5, 12 }, { 2, 23 }, c7);
+	ASSERT_EQ(d.Decode(gps2.buf, size), raw_data_type_observation);
+	EXPECT_EQ(d.ObservationCount(), 2);
+	EXPECT_EQ(d.Observations()[0].LLI[0], 1);
+	EXPECT_EQ(d.Stats().cycleSlips, 4u);
+}
+
+TEST(ISRtcm3, unsupported_and_invalid)
+{
+	cRtcm3Decoder d;
+	cRtcm3Writer w(1033);
+	w.U(64, 0);
+	int size = w.Finish();
+	EXPECT_EQ(d.Decode(w.buf, size), 0);
+	EXPECT_EQ(d.Stats().unsupported, 1u);
+
+	uint8_t garbage[8] = { 0x55, 0, 2, 0, 0, 0, 0, 0 };
+	EXPECT_EQ(d.Decode(garbage, sizeof(garbage)), -1);
+
+	// MSM with cell mask larger than the message
+	cRtcm3Writer msm(1077);
+	sMsmTestCell c = { 1, 1, 1, 0, 1, 1 };
+	size = BuildMsm(msm, 7, 1000, 0, { 1, 2, 3, 4, 5, 6, 7, 8 }, { 2, 3, 4, 5, 23, 24, 25, 30 }, c);
+	EXPECT_EQ(d.Decode(msm.buf, size - 20), -1);
+	EXPECT_EQ(d.Stats().errors, 2u);
+}
+
+// Repeated decodes of one message.  Set RTCM3_BENCH for the decode rate.
+TEST(ISRtcm3, msm7_decode_rate)
+{
+	bool bench = (getenv("RTCM3_BENCH") != NULL);
+	sMsmTestCell c = { 12345, -54321, 500, 0, 45 * 16, 1234 };
+	cRtcm3Writer w(1077);
+	int size = BuildMsm(w, 7, 345600000, 0, { 1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23 }, { 2, 23 }, c);
+
+	cRtcm3Decoder d;
+	d.SetTime(ISgpst2time(2300, 345600.0));
+	const int count = (bench ? 200000 : 1000);
+	int obs = 0;
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < count; i++)
+	{
+		if (d.Decode(w.buf, size) == raw_data_type_observation)
+		{
+			obs += d.ObservationCount();
+		}
+	}
+	double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	EXPECT_EQ(obs, count * 12);
+	if (bench)
+	{
+		printf("RTCM3 MSM7 (12 sat x 2 sig, %d bytes): %.0f messages/s, %.1f MB/s\n", size, count / sec, count * size * 1.0e-6 / sec);
+	}
+}
@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
+#include "ISUbx.h"
+extern "C"
+{
+#include "ISComm.h"
+}
+
+using namespace std;
+
+class cUbxBuilder
+{
+public:
+	cUbxBuilder(uint8_t msgClass, uint8_t msgId) : m_class(msgClass), m_id(msgId) {}
+
+	template <typename T>
+	void Put(int offset, T value)
+	{
+		if (payload.size() < offset + sizeof(T))
+		{
+			payload.resize(offset + sizeof(T));
+		}
+		memcpy(&payload[offset], &value, sizeof(T));	// Test host is little-endian
+	}
+
+	vector<uint8_t> Packet() const
+	{
+		vector<uint8_t> pkt = { UBLOX_START_BYTE1, UBLOX_START_BYTE2, m_class, m_id, (uint8_t)payload.size(), (uint8_t)(payload.size() >> 8) };
+		pkt.insert(pkt.end(), payload.begin(), payload.end());
+		uint16_t ck = is_comm_fletcher16(0, &pkt[2], (uint32_t)pkt.size() - 2);
+		pkt.push_back((uint8_t)ck);
+		pkt.push_back((uint8_t)(ck >> 8));
+		return pkt;
+	}
+
+	vector<uint8_t> payload;
+
+private:
+	uint8_t m_class;
+	uint8_t m_id;
+};
+
+static vector<uint8_t> RawxPacket(int numMeas, double tow)
+{
+	cUbxBuilder b(UBX_CLASS_RXM, UBX_RXM_RAWX);
+	b.Put<double>(0, tow);
+	b.Put<uint16_t>(8, 2300);
+	b.Put<int8_t>(10, 18);
+	b.Put<uint8_t>(11, (uint8_t)numMeas);
+	b.Put<uint8_t>(13, 1);
+	for (int i = 0; i < numMeas; i++)
+	{
+		int o = 16 + 32 * i;
+		b.Put<double>(o + 0, 2.0e7 + i);
+		b.Put<double>(o + 8, 1.0e8 + i * 0.25);
+		b.Put<float>(o + 16, -1000.0f + i);
+		b.Put<uint8_t>(o + 20, (uint8_t)(i % 7));
+		b.Put<uint8_t>(o + 21, (uint8_t)(1 + i % 32));
+		b.Put<uint8_t>(o + 22, (uint8_t)(i % 2));
+		b.Put<uint16_t>(o + 24, (uint16_t)(i * 100));
+		b.Put<uint8_t>(o + 26, (uint8_t)(30 + i % 20));
+		b.Put<uint8_t>(o + 27, 0xA5);
+		b.Put<uint8_t>(o + 30, 0x07);
+		b.Put<uint8_t>(o + 31, 0);
+	}
+	return b.Packet();
+}
+
+TEST(ISUbx, read_unaligned)
+{
+	uint8_t buf[16] = { 0, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
+	EXPECT_EQ(ubxRead<uint16_t>(buf + 1), 0x0201);
+	EXPECT_EQ(ubxRead<uint32_t>(buf + 1), 0x04030201u);
+	EXPECT_EQ(ubxRead<uint64_t>(buf + 1), 0x0807060504030201ull);
+	buf[1] = 0xFE; buf[2] = 0xFF;
+	EXPECT_EQ(ubxRead<int16_t>(buf + 1), -2);
+
+	double d = -12345.678;
+	memcpy(buf + 3, &d, sizeof(d));
+	EXPECT_EQ(ubxRead<double>(buf + 3), d);
+	float f = 3.25f;
+	memcpy(buf + 5, &f, sizeof(f));
+	EXPECT_EQ(ubxRead<float>(buf + 5), f);
+}
+
+TEST(ISUbx, nav_pvt)
+{
+	cUbxBuilder b(UBX_CLASS_NAV, UBX_NAV_PVT);
+	b.Put<uint32_t>(0, 345600200);
+	b.Put<uint16_t>(4, 2024);
+	b.Put<uint8_t>(20, 3);
+	b.Put<uint8_t>(21, 0x01);
+	b.Put<uint8_t>(23, 27);
+	b.Put<int32_t>(24, -1118888888);
+	b.Put<int32_t>(28, 405555555);
+	b.Put<int32_t>(56, -25);
+	b.Put<uint16_t>(90, 0);
+	vector<uint8_t> pkt = b.Packet();
+
+	cUbxNavPvt pvt(pkt.data(), (int)pkt.size());
+	ASSERT_TRUE(pvt.Valid());
+	EXPECT_EQ(pvt.ITow(), 345600200u);
+	EXPECT_EQ(pvt.Year(), 2024);
+	EXPECT_EQ(pvt.FixType(), 3);
+	EXPECT_TRUE(pvt.GnssFixOk());
+	EXPECT_EQ(pvt.NumSV(), 27);
+	EXPECT_DOUBLE_EQ(pvt.LonDeg(), -111.8888888);
+	EXPECT_DOUBLE_EQ(pvt.LatDeg(), 40.5555555);
+	EXPECT_EQ(pvt.VelD(), -25);
+
+	// Wrong message type or truncated
+	EXPECT_FALSE(cUbxNavSat(pkt.data(), (int)pkt.size()).Valid());
+	EXPECT_FALSE(cUbxNavPvt(pkt.data(), (int)pkt.size() - 3).Valid());
+}
+
+TEST(ISUbx, rxm_rawx_blocks)
+{
+	vector<uint8_t> pkt = RawxPacket(10, 345600.5);
+	cUbxRxmRawx rawx(pkt.data(), (int)pkt.size());
+	ASSERT_TRUE(rawx.Valid());
+	EXPECT_EQ(rawx.RcvTow(), 345600.5);
+	EXPECT_EQ(rawx.Week(), 2300);
+	EXPECT_EQ(rawx.LeapS(), 18);
+	ASSERT_EQ(rawx.Meas().size(), 10);
+
+	int i = 0;
+	for (auto m : rawx.Meas())
+	{
+		EXPECT_EQ(m.PrMes(), 2.0e7 + i);
+		EXPECT_EQ(m.CpMes(), 1.0e8 + i * 0.25);
+		EXPECT_EQ(m.DoMes(), -1000.0f + i);
+		EXPECT_EQ(m.GnssId(), i % 7);
+		EXPECT_EQ(m.SvId(), 1 + i % 32);
+		EXPECT_EQ(m.Locktime(), i * 100);
+		EXPECT_EQ(m.Cno(), 30 + i % 20);
+		EXPECT_EQ(m.PrStdev(), 5);
+		EXPECT_TRUE(m.PrValid() && m.CpValid() && m.HalfCyc());
+		i++;
+	}
+	EXPECT_EQ(i, 10);
+	EXPECT_EQ(rawx.Meas()[9].PrMes(), 2.0e7 + 9);
+
+	// Count field larger than payload is limited to complete blocks
+	pkt[UBX_HEADER_SIZE + 11] = 200;
+	EXPECT_EQ(cUbxRxmRawx(pkt.data(), (int)pkt.size()).Meas().size(), 10);
+}
+
+TEST(ISUbx, nav_sat)
+{
+	cUbxBuilder b(UBX_CLASS_NAV, UBX_NAV_SAT);
+	b.Put<uint32_t>(0, 1000);
+	b.Put<uint8_t>(5, 2);
+	b.Put<uint8_t>(8 + 0, 2);
+	b.Put<uint8_t>(8 + 1, 11);
+	b.Put<int8_t>(8 + 3, -5);
+	b.Put<int16_t>(8 + 4, 270);
+	b.Put<uint32_t>(8 + 8, 0x0C);
+	b.Put<uint8_t>(20 + 1, 12);
+	b.Put<uint32_t>(20 + 8, 0);
+	vector<uint8_t> pkt = b.Packet();
+
+	cUbxNavSat sat(pkt.data(), (int)pkt.size());
+	ASSERT_TRUE(sat.Valid());
+	ASSERT_EQ(sat.Svs().size(), 2);
+	EXPECT_EQ(sat.Svs()[0].GnssId(), 2);
+	EXPECT_EQ(sat.Svs()[0].Elev(), -5);
+	EXPECT_EQ(sat.Svs()[0].Azim(), 270);
+	EXPECT_EQ(sat.Svs()[0].QualityInd(), 4);
+	EXPECT_TRUE(sat.Svs()[0].SvUsed());
+	EXPECT_EQ(sat.Svs()[1].SvId(), 12);
+	EXPECT_FALSE(sat.Svs()[1].SvUsed());
+}
+
+struct sRawxStats
+{
+	int messages;
+	int meas;
+	double prSum;
+	uint32_t cnoSum;
+};
+
+static sRawxStats s_rawxStats;
+
+static int ubxRawxHandler(unsigned int port, const unsigned char* msg, int msgSize)
+{
+	cUbxRxmRawx rawx(msg, msgSize);
+	if (!rawx.Valid())
+	{
+		return 0;
+	}
+	s_rawxStats.messages++;
+	for (auto m : rawx.Meas())
+	{
+		s_rawxStats.meas++;
+		s_rawxStats.prSum += m.PrMes() + m.CpMes() + m.DoMes();
+		s_rawxStats.cnoSum += m.Cno();
+	}
+	return 0;
+}
+
+// RAWX with 150 signals at 20 Hz through the ISComm parser and ublox callback
+TEST(ISUbx, rxm_rawx_rate)
+{
+	const int numMeas = 150;
+	const int epochs = 20 * 60 * 10;	// 10 minutes at 20 Hz
+	vector<uint8_t> pkt = RawxPacket(numMeas, 345600.0);
+	size_t pktSize = pkt.size();
+
+	static uint8_t commBuf[8192];
+	is_comm_instance_t comm;
+	is_comm_init(&comm, commBuf, sizeof(commBuf));
+	is_comm_callbacks_t callbacks = {};
+	callbacks.ublox = ubxRawxHandler;
+	s_rawxStats = {};
+
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < epochs; i++)
+	{
+		is_comm_buffer_parse_messages(pkt.data(), (uint32_t)pktSize, &comm, &callbacks);
+	}
+	double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	EXPECT_EQ(s_rawxStats.messages, epochs);
+	EXPECT_EQ(s_rawxStats.meas, epochs * numMeas);
+	EXPECT_GT(s_rawxStats.cnoSum, 0u);
+	printf("UBX RXM-RAWX %d signals (%d bytes): %.0f messages/s (%.0fx 20 Hz real time), %.1f MB/s\n",
+		numMeas, (int)pktSize, epochs / sec, epochs / sec / 20.0, epochs * pktSize * 1.0e-6 / sec);
+}
@@ -1,6 +1,15 @@
 #include <gtest/gtest.h>
+#include <atomic>
 #include <deque>
+#include <filesystem>
+#include <functional>
+#include <thread>
 #include "InertialSense.h"
+#if !PLATFORM_IS_WINDOWS
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
 
 
 TEST(InertialSense, General)
@@ -10,3 +19,233 @@ TEST(InertialSense, General)
 	EXPECT_TRUE(true);
 }
 
+
+#if !PLATFORM_IS_WINDOWS
+// Template packets from a producer thread, interleaved with packets sent by the Update() thread, arrive whole
+TEST(InertialSense, data_template_producer_thread)
+{
+	int master = posix_openpt(O_RDWR | O_NOCTTY);
+	ASSERT_GE(master, 0);
+	ASSERT_EQ(0, grantpt(master));
+	ASSERT_EQ(0, unlockpt(master));
+	fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+	std::string slave = ptsname(master);
+
+	// Device side parses everything written to the port
+	std::atomic<bool> running(true);
+	int wheelCount = 0, otherCount = 0, errorCount = 0;
+	std::thread device([&]()
+	{
+		static uint8_t buf[8192];
+		is_comm_instance_t comm;
+		is_comm_init(&comm, buf, sizeof(buf));
+		comm.rxErrorState = 0;
+		pollfd fd = { master, POLLIN, 0 };
+		while (running)
+		{
+			if (poll(&fd, 1, 10) <= 0)
+			{
+				continue;
+			}
+			int n;
+			while ((n = (int)read(master, comm.rxBuf.tail, is_comm_free(&comm))) > 0)
+			{
+				comm.rxBuf.tail += n;
+				protocol_type_t ptype;
+				while ((ptype = is_comm_parse(&comm)) != _PTYPE_NONE)
+				{
+					if (ptype == _PTYPE_INERTIAL_SENSE_DATA && comm.rxPkt.dataHdr.id == DID_WHEEL_ENCODER)
+						wheelCount++;
+					else if (ptype == _PTYPE_PARSE_ERROR)
+						errorCount++;
+					else
+						otherCount++;
+				}
+			}
+		}
+		errorCount += (int)comm.rxErrorCount;
+	});
+
+	const int numTemplates = 2000;
+	int sent = 0;
+	{
+		InertialSense is;
+		is.EnableDeviceValidation(false);
+		ASSERT_TRUE(is.Open(slave.c_str(), 921600));
+		int handle = is.CreateDataTemplate(0, DID_WHEEL_ENCODER, sizeof(wheel_encoder_t));
+		ASSERT_GE(handle, 0);
+
+		std::thread producer([&]()
+		{
+			wheel_encoder_t wheel = {};
+			for (int i = 0; i < numTemplates; i++)
+			{
+				wheel.timeOfWeek = i * 0.01;
+				if (!is.SendDataTemplate(handle, &wheel))
+				{
+					break;
+				}
+				sent++;
+			}
+		});
+
+		// Update() thread keeps writing its own packets to the same port
+		for (int i = 0; i < 200; i++)
+		{
+			is.GetData(DID_DEV_INFO);
+			is.Update();
+		}
+		producer.join();
+		is.Close();
+
+		// Templates are cleared with the ports
+		wheel_encoder_t wheel = {};
+		EXPECT_FALSE(is.SendDataTemplate(handle, &wheel));
+	}
+	SLEEP_MS(100);
+	running = false;
+	device.join();
+	close(master);
+
+	EXPECT_EQ(numTemplates, sent);
+	EXPECT_EQ(numTemplates, wheelCount);
+	EXPECT_GE(otherCount, 200);
+	EXPECT_EQ(0, errorCount);
+}
+
+
+// Port node removed and recreated while a producer thread is sending: the port is reopened on the new node, broadcasts
+// are restored, and packets written on either side of the drop arrive whole.
+TEST(InertialSense, hotplug_reopen_producer_thread)
+{
+	// The node is a symbolic link that is moved from one pty to another, as udev does for /dev/serial/by-id/...
+	int master[2];
+	std::string slave[2];
+	for (int i = 0; i < 2; i++)
+	{
+		master[i] = posix_openpt(O_RDWR | O_NOCTTY);
+		ASSERT_GE(master[i], 0);
+		ASSERT_EQ(0, grantpt(master[i]));
+		ASSERT_EQ(0, unlockpt(master[i]));
+		fcntl(master[i], F_SETFL, fcntl(master[i], F_GETFL) | O_NONBLOCK);
+		slave[i] = ptsname(master[i]);
+	}
+	std::filesystem::path dir = std::filesystem::temp_directory_path() / "is_hotplug_reopen_test";
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+	std::filesystem::path node = dir / "ttyIS0";
+	std::filesystem::create_symlink(slave[0], node);
+
+	// Device side parses everything written to both ptys
+	std::atomic<bool> running(true);
+	std::atomic<int> wheelCount[2] = { 0, 0 };
+	std::atomic<int> ins1Requests[2] = { 0, 0 };
+	std::atomic<int> errorCount(0);
+	std::thread device([&]()
+	{
+		static uint8_t buf[2][8192];
+		is_comm_instance_t comm[2];
+		pollfd fd[2];
+		for (int i = 0; i < 2; i++)
+		{
+			is_comm_init(&comm[i], buf[i], sizeof(buf[i]));
+			comm[i].rxErrorState = 0;
+			fd[i] = { master[i], POLLIN, 0 };
+		}
+		while (running)
+		{
+			if (poll(fd, 2, 10) <= 0)
+			{
+				continue;
+			}
+			for (int i = 0; i < 2; i++)
+			{
+				int n;
+				while ((n = (int)read(master[i], comm[i].rxBuf.tail, is_comm_free(&comm[i]))) > 0)
+				{
+					comm[i].rxBuf.tail += n;
+					protocol_type_t ptype;
+					while ((ptype = is_comm_parse(&comm[i])) != _PTYPE_NONE)
+					{
+						if (ptype == _PTYPE_INERTIAL_SENSE_DATA && comm[i].rxPkt.dataHdr.id == DID_WHEEL_ENCODER)
+							wheelCount[i]++;
+						else if (ptype == _PTYPE_INERTIAL_SENSE_CMD && (comm[i].rxPkt.hdr.flags & PKT_TYPE_MASK) == PKT_TYPE_GET_DATA &&
+							((p_data_get_t*)comm[i].rxPkt.data.ptr)->id == DID_INS_1)
+							ins1Requests[i]++;
+						else if (ptype == _PTYPE_PARSE_ERROR)
+							errorCount++;
+					}
+				}
+			}
+		}
+		errorCount += (int)(comm[0].rxErrorCount + comm[1].rxErrorCount);
+	});
+
+	{
+		InertialSense is;
+		is.EnableDeviceValidation(false);
+		ASSERT_TRUE(is.Open(node.string().c_str(), 921600));
+		is.EnableHotplugRecovery(true);
+		is.getDevice(0).config->devInfo.protocolVer[0] = PROTOCOL_VERSION_CHAR0;     // Not validated, so no dev info from the device
+		is.BroadcastBinaryData(0, DID_INS_1, 1);
+		int handle = is.CreateDataTemplate(0, DID_WHEEL_ENCODER, sizeof(wheel_encoder_t));
+		ASSERT_GE(handle, 0);
+
+		std::atomic<bool> producing(true);
+		std::thread producer([&]()
+		{
+			wheel_encoder_t wheel = {};
+			for (int i = 0; producing; i++)
+			{
+				wheel.timeOfWeek = i * 0.01;
+				is.SendDataTemplate(handle, &wheel);
+			}
+		});
+
+		auto updateUntil = [&](const std::function<bool()>& done)
+		{
+			for (int i = 0; i < 2000 && !done(); i++)
+			{
+				is.Update();
+			}
+			return done();
+		};
+
+		EXPECT_TRUE(updateUntil([&]() { return wheelCount[0] > 10; }));
+
+		// Node removed
+		std::filesystem::remove(node);
+		EXPECT_TRUE(updateUntil([&]() { return is.HotplugStats().disconnects == 1; }));
+		EXPECT_EQ(NULLPTR, is.getDevice(0).serialPort.handle);
+
+		// Node reappears on the other pty
+		std::filesystem::create_symlink(slave[1], node);
+		EXPECT_TRUE(updateUntil([&]() { return ins1Requests[1] > 0; }));
+		EXPECT_TRUE(updateUntil([&]() { return wheelCount[1] > 10; }));
+
+		// First data from the device completes the recovery
+		ins_1_t ins = {};
+		uint8_t pkt[256];
+		uint8_t commBuf[256];
+		is_comm_instance_t comm;
+		is_comm_init(&comm, commBuf, sizeof(commBuf));
+		int size = is_comm_write_to_buf(pkt, sizeof(pkt), &comm, PKT_TYPE_DATA, DID_INS_1, sizeof(ins), 0, &ins);
+		ASSERT_EQ(size, (int)write(master[1], pkt, size));
+		EXPECT_TRUE(updateUntil([&]() { return is.HotplugStats().reconnects == 1; }));
+
+		producing = false;
+		producer.join();
+		is.Close();
+	}
+	SLEEP_MS(100);
+	running = false;
+	device.join();
+	close(master[0]);
+	close(master[1]);
+	std::filesystem::remove_all(dir);
+
+	EXPECT_EQ(1, ins1Requests[0]);
+	EXPECT_EQ(1, ins1Requests[1]);
+	EXPECT_EQ(0, errorCount);
+}
+#endif
@@ -1032,3 +1032,45 @@ TEST(ComManager, Evb2DataForwardTest)
 }
 #endif
 
+
+
+TEST(ComManager, GnssArrayTrim)
+{
+	init(tcm);
+
+	data_holder_t td = {};
+	td.ptype = _PTYPE_INERTIAL_SENSE_DATA;
+	td.did = DID_GPS1_SAT;
+	td.size = sizeof(gps_sat_t);
+	td.data.set.gpsSat.timeOfWeekMs = 123456;
+	td.data.set.gpsSat.numSats = 5;
+	for (uint32_t i = 0; i < td.data.set.gpsSat.numSats; i++)
+	{
+		td.data.set.gpsSat.sat[i].svId = i + 1;
+		td.data.set.gpsSat.sat[i].cno = 40;
+	}
+	uint16_t trimmed = offsetof(gps_sat_t, sat) + 5 * sizeof(gps_sat_sv_t);
+	EXPECT_EQ(gnssArrayTrimSize(DID_GPS1_SAT, &td.data, sizeof(gps_sat_t), 0), trimmed);
+	EXPECT_EQ(gnssArrayTrimSize(DID_GPS1_SAT, &td.data, sizeof(gps_sat_t), 4), sizeof(gps_sat_t));
+	EXPECT_EQ(gnssArrayTrimSize(DID_INS_1, &td.data, sizeof(ins_1_t), 0), sizeof(ins_1_t));
+	EXPECT_FALSE(gnssArrayIsTrimmed(DID_GPS1_SAT, &td.data, sizeof(gps_sat_t), 0));
+	EXPECT_TRUE(gnssArrayIsTrimmed(DID_GPS1_SAT, &td.data, trimmed, 0));
+
+	// Only the used satellites are sent
+	EXPECT_EQ(comManagerSendDataNoAckInstance(&tcm.cm, 0, &td.data, td.did, td.size, 0), 0);
+	EXPECT_EQ(tcm.cm.gnssTrimTxBytes, sizeof(gps_sat_t) - trimmed);
+	int pktSize = ringBufUsed(&tcm.portTxBuf);
+	EXPECT_LT(pktSize, trimmed + 32);
+
+	// Received full size with the unused entries zeroed
+	g_testRxDeque.push_back(td);
+	uint8_t pkt[PKT_BUF_SIZE];
+	ringBufRead(&tcm.portTxBuf, pkt, pktSize);
+	ringBufWrite(&tcm.portRxBuf, pkt, pktSize);
+	while (!ringBufEmpty(&tcm.portRxBuf))
+	{
+		comManagerStepInstance(&tcm.cm);
+	}
+	EXPECT_TRUE(g_testRxDeque.empty());
+	EXPECT_EQ(tcm.cm.gnssTrimRxBytes, sizeof(gps_sat_t) - trimmed);
+}
@@ -504,6 +504,13 @@ bool GenerateMessage(test_message_t &msg, protocol_type_t ptype)
     return false;
 }
 
+// Messages due at timeMs on the generator timeline, one per call until false.  timeMs should not decrease.
+bool GenerateMessageAtTimeMs(test_message_t &msg, uint32_t timeMs, protocol_type_t ptype)
+{
+    s_timeMs = timeMs;
+    return GenerateMessage(msg, ptype);
+}
+
 void GenerateDataLogFiles(int numDevices, string directory, cISLogger::eLogType logType, float logSizeMB, eTestGenDataOptions options)
 {
     // Remove old files
@@ -520,10 +527,10 @@ void GenerateDataLogFiles(int numDevices, string directory, cISLogger::eLogType
     auto devices = new ISDevice[numDevices]();
     for (int d=0; d<numDevices; d++)
     {   // Assign serial number
-        devices[d].devInfo.hardwareType = IS_HARDWARE_TYPE_IMX;
-        devices[d].devInfo.hardwareVer[0] = 5;
-        devices[d].devInfo.hardwareVer[1] = 0;
-        devices[d].devInfo.serialNumber = rand() % 999999;
+        devices[d].config->devInfo.hardwareType = IS_HARDWARE_TYPE_IMX;
+        devices[d].config->devInfo.hardwareVer[0] = 5;
+        devices[d].config->devInfo.hardwareVer[1] = 0;
+        devices[d].config->devInfo.serialNumber = rand() % 999999;
         logger.registerDevice(devices[d]);
     }
     logger.EnableLogging(true);
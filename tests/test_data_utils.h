@@ -36,6 +36,7 @@ void CurrentGpsTimeMs(uint32_t &gpsTimeOfWeekMs, uint32_t &gpsWeek);
 void PrintUtcDateTime(utc_date_t &utcDate, utc_time_t &utcTime);
 void PrintUtcStdTm(std::tm &utcTime, uint32_t milliseconds=0);
 bool GenerateMessage(test_message_t &msg, protocol_type_t ptype=_PTYPE_NONE);
+bool GenerateMessageAtTimeMs(test_message_t &msg, uint32_t timeMs, protocol_type_t ptype=_PTYPE_NONE);
 void GenerateDataLogFiles(int numDevices, std::string directory, cISLogger::eLogType logType, float logSizeMB=20, eTestGenDataOptions options=GEN_LOG_OPTIONS_NONE);
 int GenerateDataStream(uint8_t *buffer, int bufferSize, eTestGenDataOptions options=GEN_LOG_OPTIONS_NONE);
 
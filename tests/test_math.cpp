@@ -182,3 +182,71 @@ TEST(Math_ixMatrix3_Operations, math_matrix3_oper)
 {
 	testMatrixOperations();
 }
+
+TEST(Math_ixMatrix_Operations, cholesky_solve)
+{
+	// A = M^T M + I is symmetric positive definite
+	const int n = 9;
+	double M[n * n], A[n * n], x[n], b[n], expected[n];
+	for (int i = 0; i < n * n; i++)
+	{
+		M[i] = random_vectors[i % 25][i % 3] + (i / 25) * 0.1;
+	}
+	for (int i = 0; i < n; i++)
+	{
+		for (int j = 0; j < n; j++)
+		{
+			A[i * n + j] = (i == j ? 1.0 : 0.0);
+			for (int k = 0; k < n; k++)
+			{
+				A[i * n + j] += M[k * n + i] * M[k * n + j];
+			}
+		}
+		expected[i] = i - 4.0;
+	}
+	for (int i = 0; i < n; i++)
+	{
+		b[i] = 0.0;
+		for (int j = 0; j < n; j++)
+		{
+			b[i] += A[i * n + j] * expected[j];
+		}
+	}
+	ASSERT_EQ(cholesky_solve_MatN_d(x, A, b, n), 0);
+	for (int i = 0; i < n; i++)
+	{
+		EXPECT_NEAR(x[i], expected[i], 1e-9);
+	}
+
+	double notPositive[4] = { 1, 2, 2, 1 };
+	EXPECT_EQ(cholesky_solve_MatN_d(x, notPositive, b, 2), -1);
+}
+
+TEST(Math_ixMatrix3_Operations, eig_sym)
+{
+	ixMatrix3d m = { 4.0, 1.0, -2.0,
+	                 1.0, 3.0, 0.5,
+	                -2.0, 0.5, 1.0 };
+	ixVector3d eigenvalues;
+	ixMatrix3d V;
+	eig_Mat3x3_sym_d(eigenvalues, V, m);
+	EXPECT_GE(eigenvalues[0], eigenvalues[1]);
+	EXPECT_GE(eigenvalues[1], eigenvalues[2]);
+	EXPECT_NEAR(eigenvalues[0] + eigenvalues[1] + eigenvalues[2], 8.0, 1e-12);
+
+	// m = V diag(eigenvalues) V^T and V is orthonormal
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			double r = 0.0, identity = 0.0;
+			for (int k = 0; k < 3; k++)
+			{
+				r += V[i * 3 + k] * eigenvalues[k] * V[j * 3 + k];
+				identity += V[k * 3 + i] * V[k * 3 + j];
+			}
+			EXPECT_NEAR(r, m[i * 3 + j], 1e-12);
+			EXPECT_NEAR(identity, (i == j ? 1.0 : 0.0), 1e-12);
+		}
+	}
+}
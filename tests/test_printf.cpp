@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <stdio.h>
+#include "printf.h"
+
+// Compare against the C library, not the tiny printf macros
+#undef printf
+#undef sprintf
+#undef snprintf
+#undef vsnprintf
+#undef vprintf
+
+using namespace std;
+
+
+static string tinyFormat(const char* format, int prec, double value)
+{
+	char buf[128];
+	snprintf_(buf, sizeof(buf), format, prec, value);
+	return buf;
+}
+
+static string libcFormat(const char* format, int prec, double value)
+{
+	char buf[128];
+	snprintf(buf, sizeof(buf), format, prec, value);
+	return buf;
+}
+
+
+TEST(printf, fixed_exact_rounding)
+{
+	// Ties only exist where the binary value is exactly half way
+	EXPECT_EQ("0.12", tinyFormat("%.*f", 2, 0.125));
+	EXPECT_EQ("0.38", tinyFormat("%.*f", 2, 0.375));
+	EXPECT_EQ("2", tinyFormat("%.*f", 0, 2.5));
+	EXPECT_EQ("4", tinyFormat("%.*f", 0, 3.5));
+	EXPECT_EQ("2.001", tinyFormat("%.*f", 3, 2.0005));        // 2.000500000000000167
+	EXPECT_EQ("1.000", tinyFormat("%.*f", 3, 0.9995));        // 0.999500000000000055
+	EXPECT_EQ("-0.000", tinyFormat("%.*f", 3, -0.0001));
+	EXPECT_EQ("0.1000000000000000056", tinyFormat("%.*f", 19, 0.1));
+	EXPECT_EQ("40.7127753999999982", tinyFormat("%.*f", 16, 40.7127754));
+	EXPECT_EQ("1.000000e+01", tinyFormat("%.*e", 6, 9.9999996));
+	EXPECT_EQ("0.000000e+00", tinyFormat("%.*e", 6, 0.0));
+	EXPECT_EQ("1.0e-05", tinyFormat("%.*e", 1, 0.0000099999));
+
+	// Width and flags
+	char buf[64];
+	snprintf_(buf, sizeof(buf), "%+012.4f|%-10.2f|% .3e|%010.2e", 3.14159265, -2.5, 12345.678, -0.00042);
+	char ref[64];
+	snprintf(ref, sizeof(ref), "%+012.4f|%-10.2f|% .3e|%010.2e", 3.14159265, -2.5, 12345.678, -0.00042);
+	EXPECT_STREQ(ref, buf);
+}
+
+
+TEST(printf, matches_libc)
+{
+	mt19937_64 rng(12345);
+	uniform_real_distribution<double> exponent(-10.0, 9.0);
+	uniform_real_distribution<double> unit(0.0, 1.0);
+	uniform_int_distribution<int> precision(0, 17);
+
+	int failures = 0;
+	for (int i = 0; i < 200000 && failures < 20; i++)
+	{
+		double value = pow(10.0, exponent(rng)) * (unit(rng) < 0.5 ? -1 : 1);
+		if (i % 4 == 0)
+		{	// Short decimals, where rounding ties are most likely to be mishandled
+			value = round(value * 1e4) / 1e4 + 0.00005;
+		}
+		int prec = precision(rng);
+		for (const char* format : { "%.*f", "%.*e" })
+		{
+			string tiny = tinyFormat(format, prec, value);
+			string libc = libcFormat(format, prec, value);
+			EXPECT_EQ(libc, tiny) << format << " prec " << prec << " value " << value;
+			failures += (libc != tiny);
+		}
+	}
+}
+
+
+TEST(printf, navigation_values)
+{
+	mt19937_64 rng(42);
+	uniform_real_distribution<double> lat(-90.0, 90.0);
+	uniform_real_distribution<double> lon(-180.0, 180.0);
+	uniform_real_distribution<double> alt(-100.0, 9000.0);
+	uniform_real_distribution<double> tow(0.0, 604800.0);
+	uniform_real_distribution<double> small(-1e-3, 1e-3);
+
+	for (int i = 0; i < 20000; i++)
+	{
+		double v[5] = { lat(rng), lon(rng), alt(rng), round(tow(rng) * 1e3) / 1e3, small(rng) };
+		char tiny[256], libc[256];
+		const char* format = "%.9f,%.9f,%.3f,%.3f,%.6e,%.7f";
+		snprintf_(tiny, sizeof(tiny), format, v[0], v[1], v[2], v[3], v[4], v[4]);
+		snprintf(libc, sizeof(libc), format, v[0], v[1], v[2], v[3], v[4], v[4]);
+		ASSERT_STREQ(libc, tiny);
+	}
+}
+
+
+TEST(printf, benchmark)
+{
+	mt19937_64 rng(7);
+	uniform_real_distribution<double> lat(-90.0, 90.0);
+	uniform_real_distribution<double> lon(-180.0, 180.0);
+	uniform_real_distribution<double> alt(-100.0, 9000.0);
+	const int count = 200000;
+	vector<double> values(count * 3);
+	for (int i = 0; i < count; i++)
+	{
+		values[i * 3 + 0] = lat(rng);
+		values[i * 3 + 1] = lon(rng);
+		values[i * 3 + 2] = alt(rng);
+	}
+
+	char buf[128];
+	size_t bytes = 0;
+	auto start = chrono::high_resolution_clock::now();
+	for (int i = 0; i < count; i++)
+	{
+		bytes += snprintf_(buf, sizeof(buf), "%.9f,%.9f,%.3f,%.4e", values[i * 3], values[i * 3 + 1], values[i * 3 + 2], values[i * 3 + 2]);
+	}
+	double tinySec = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+
+	start = chrono::high_resolution_clock::now();
+	for (int i = 0; i < count; i++)
+	{
+		bytes -= snprintf(buf, sizeof(buf), "%.9f,%.9f,%.3f,%.4e", values[i * 3], values[i * 3 + 1], values[i * 3 + 2], values[i * 3 + 2]);
+	}
+	double libcSec = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+	EXPECT_EQ(0u, bytes);
+
+	printf("%d lat,lon,alt,alt lines  snprintf_: %.1f ns/line  libc snprintf: %.1f ns/line\n",
+		count, tinySec / count * 1e9, libcSec / count * 1e9);
+}
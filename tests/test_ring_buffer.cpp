@@ -1,5 +1,10 @@
 #include <gtest/gtest.h>
+#include <chrono>
 #include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
 #include "ring_buffer.h"
 #include "ISComm.h"
 
@@ -273,3 +278,297 @@ TEST(RingBuffer, FloatArrayWithOverflow)
 	// Ensure buffer is empty
 	EXPECT_TRUE(ringBufEmpty(&rb) == 1);
 }
+
+
+// Previous ringBufFind: byte by byte with strncmp
+static int referenceFind(const ring_buf_t *rbuf, const unsigned char *str, int len)
+{
+	int used = ringBufUsed(rbuf);
+	unsigned char *buf = (unsigned char*)(rbuf->rdPtr);
+	for (int i = 0; i < used; i++)
+	{
+		if (buf + len < rbuf->endPtr && !strncmp((const char*)buf, (const char*)str, len))
+			return i;
+		if (++buf >= rbuf->endPtr)
+			buf = rbuf->startPtr;
+	}
+	return -1;
+}
+
+// Expected index of str in the buffer contents
+static int dequeFind(const std::deque<uint8_t>& d, const unsigned char *str, int len)
+{
+	for (int i = 0; i + len <= (int)d.size(); i++)
+	{
+		int j = 0;
+		for (; j < len && d[i + j] == str[j]; j++) {}
+		if (j == len)
+			return i;
+	}
+	return -1;
+}
+
+
+TEST(RingBuffer, Find)
+{
+	uint8_t buffer[64];
+	ring_buf_t rb;
+	ringBufInit(&rb, buffer, sizeof(buffer), 1);
+
+	// Sync word straddling the wrap, with a zero byte
+	uint8_t fill[50] = {};
+	ringBufWrite(&rb, fill, sizeof(fill));
+	ringBufRemove(&rb, sizeof(fill));
+	const uint8_t data[] = { 'x', 'y', 0xEF, 0xFE, 0x00, 0x01, 'z', '$', 'G', 'P' , 'G', 'G', 'A', ',', '1', '\r', '\n' };
+	ringBufWrite(&rb, (uint8_t*)data, sizeof(data));
+	const uint8_t sync[] = { 0xEF, 0xFE, 0x00, 0x01 };
+	EXPECT_EQ(ringBufFind(&rb, sync, 4), 2);
+	EXPECT_EQ(ringBufFind(&rb, (const uint8_t*)"$GPGGA", 6), 7);
+	EXPECT_EQ(ringBufFind(&rb, (const uint8_t*)"\r\n", 2), 15);
+	EXPECT_EQ(ringBufFind(&rb, (const uint8_t*)"\n!", 2), -1);		// Past the end of the data
+	EXPECT_EQ(ringBufFind(&rb, (const uint8_t*)"$GPRMC", 6), -1);
+
+	ring_buf_span_t spans[2];
+	EXPECT_EQ(ringBufReadSpans(&rb, spans), (int)sizeof(data));
+	EXPECT_EQ(spans[0].len, 14);
+	EXPECT_EQ(spans[1].len, 3);
+	EXPECT_EQ(spans[1].ptr, buffer);
+
+	// Random contents and read positions against a plain search
+	std::mt19937 rng(1);
+	for (int trial = 0; trial < 2000; trial++)
+	{
+		ringBufClear(&rb);
+		std::deque<uint8_t> d;
+		int skip = rng() % 64;
+		ringBufWrite(&rb, fill, skip);
+		ringBufRemove(&rb, skip);
+		int n = rng() % 64;
+		for (int i = 0; i < n; i++)
+		{
+			uint8_t b = rng() % 4;
+			ringBufWrite(&rb, &b, 1);
+			d.push_back(b);
+		}
+		uint8_t pattern[4];
+		int len = 1 + rng() % 4;
+		for (int i = 0; i < len; i++)
+		{
+			pattern[i] = rng() % 4;
+		}
+		ASSERT_EQ(ringBufFind(&rb, pattern, len), dequeFind(d, pattern, len)) << trial;
+	}
+}
+
+
+TEST(RingBuffer, ReadToChar)
+{
+	uint8_t buffer[32];
+	ring_buf_t rb;
+	ringBufInit(&rb, buffer, sizeof(buffer), 1);
+	uint8_t fill[28] = {};
+	ringBufWrite(&rb, fill, sizeof(fill));
+	ringBufRemove(&rb, sizeof(fill));
+
+	ringBufWrite(&rb, (uint8_t*)"ab\rcdefg\n", 9);
+	uint8_t out[32];
+	EXPECT_EQ(ringBufReadToChar2(&rb, out, sizeof(out), '\n', '\r'), 3);
+	EXPECT_EQ(ringBufReadToChar(&rb, out, sizeof(out), '\n'), 6);
+	EXPECT_EQ(memcmp(out, "cdefg\n", 6), 0);
+	ringBufWrite(&rb, (uint8_t*)"xyz", 3);
+	EXPECT_EQ(ringBufReadToChar(&rb, out, sizeof(out), '\n'), 0);
+}
+
+
+TEST(RingBuffer, Spsc)
+{
+	uint8_t buffer[100];
+	ring_buf_spsc_t rb;
+	ringBufSpscInit(&rb, buffer, sizeof(buffer));
+	EXPECT_EQ(offsetof(ring_buf_spsc_t, rdIndex) - offsetof(ring_buf_spsc_t, wrIndex), (size_t)RING_BUF_CACHE_LINE);
+	EXPECT_EQ(ringBufSpscFree(&rb), 99);
+
+	// Writes stop at capacity instead of overwriting
+	std::deque<uint8_t> d;
+	uint8_t data[256];
+	for (int i = 0; i < 256; i++)
+	{
+		data[i] = (uint8_t)i;
+	}
+	EXPECT_EQ(ringBufSpscWrite(&rb, data, 150), 99);
+	EXPECT_EQ(ringBufSpscUsed(&rb), 99);
+	EXPECT_EQ(ringBufSpscWrite(&rb, data, 1), 0);
+
+	uint8_t out[256];
+	EXPECT_EQ(ringBufSpscPeek(&rb, out, 10, 95), 4);
+	EXPECT_EQ(out[0], 95);
+	EXPECT_EQ(ringBufSpscRead(&rb, out, 60), 60);
+	EXPECT_EQ(out[59], 59);
+
+	// Wrapped write, then spans
+	EXPECT_EQ(ringBufSpscWrite(&rb, data + 100, 50), 50);
+	ring_buf_span_t spans[2];
+	EXPECT_EQ(ringBufSpscReadSpans(&rb, spans), 89);
+	EXPECT_EQ(spans[0].len, 40);
+	EXPECT_EQ(spans[0].ptr[0], 60);
+	EXPECT_EQ(spans[1].len, 49);
+	EXPECT_EQ(spans[1].ptr[0], 101);
+	const uint8_t pattern[] = { 98, 100, 101 };
+	EXPECT_EQ(ringBufSpscFind(&rb, pattern, 3), 38);
+	EXPECT_EQ(ringBufSpscPeek(&rb, out, 5, 38), 5);
+	EXPECT_EQ(out[4], 103);
+
+	// Fill free space in place
+	EXPECT_EQ(ringBufSpscRemove(&rb, 1000), 89);
+	EXPECT_EQ(ringBufSpscWriteSpans(&rb, spans), 99);
+	memset(spans[0].ptr, 7, spans[0].len);
+	memset(spans[1].ptr, 7, spans[1].len);
+	ringBufSpscCommitWrite(&rb, 99);
+	EXPECT_EQ(ringBufSpscRead(&rb, out, sizeof(out)), 99);
+	EXPECT_EQ(out[98], 7);
+	EXPECT_EQ(ringBufSpscUsed(&rb), 0);
+}
+
+
+// Producer writes a counting byte sequence in random sized pieces, consumer checks it
+static void spscTransfer(size_t total, size_t& received, bool& ordered)
+{
+	static uint8_t buffer[4096];
+	ring_buf_spsc_t rb;
+	ringBufSpscInit(&rb, buffer, sizeof(buffer));
+
+	std::thread producer([&]()
+	{
+		std::mt19937 rng(2);
+		uint8_t chunk[1500];
+		uint8_t next = 0;
+		for (size_t sent = 0; sent < total; )
+		{
+			int len = (int)_MIN(1 + rng() % sizeof(chunk), total - sent);
+			for (int i = 0; i < len; i++)
+			{
+				chunk[i] = next++;
+			}
+			for (int done = 0; done < len; )
+			{
+				int n = ringBufSpscWrite(&rb, chunk + done, len - done);
+				done += n;
+				if (n == 0)
+				{
+					std::this_thread::yield();
+				}
+			}
+			sent += len;
+		}
+	});
+
+	uint8_t expected = 0;
+	received = 0;
+	ordered = true;
+	while (received < total)
+	{
+		ring_buf_span_t spans[2];
+		int n = ringBufSpscReadSpans(&rb, spans);
+		if (n == 0)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		for (int s = 0; s < 2; s++)
+		{
+			for (int i = 0; i < spans[s].len; i++)
+			{
+				ordered &= (spans[s].ptr[i] == expected++);
+			}
+		}
+		ringBufSpscRemove(&rb, n);
+		received += n;
+	}
+	producer.join();
+}
+
+
+TEST(RingBuffer, SpscThreads)
+{
+	size_t received;
+	bool ordered;
+	spscTransfer(20 * 1024 * 1024, received, ordered);
+	EXPECT_EQ(received, 20u * 1024 * 1024);
+	EXPECT_TRUE(ordered);
+}
+
+
+// Timing only, correctness is covered by Find and SpscThreads.  Set RING_BUFFER_BENCH to run.
+TEST(RingBuffer, Benchmark)
+{
+	if (!getenv("RING_BUFFER_BENCH")) { GTEST_SKIP() << "Set RING_BUFFER_BENCH to run"; }
+
+	// Find a sync word near the end of a full buffer, as when resyncing after garbage
+	static uint8_t buffer[65536];
+	ring_buf_t rb;
+	ringBufInit(&rb, buffer, sizeof(buffer), 1);
+	std::vector<uint8_t> data(sizeof(buffer) - 1);
+	std::mt19937 rng(3);
+	for (auto& b : data)
+	{
+		b = (uint8_t)(0x20 + rng() % 0x5E);		// Printable, like NMEA
+	}
+	const uint8_t sync[] = { 0xEF, 0xFE };
+	memcpy(&data[data.size() - 100], sync, sizeof(sync));
+	ringBufWrite(&rb, data.data(), (int)data.size());
+
+	const int reps = 200;
+	auto start = std::chrono::high_resolution_clock::now();
+	int found = 0;
+	for (int i = 0; i < reps; i++)
+	{
+		found += referenceFind(&rb, sync, 2);
+	}
+	double referenceSec = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+	start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < reps; i++)
+	{
+		found -= ringBufFind(&rb, sync, 2);
+	}
+	double findSec = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+	EXPECT_EQ(found, 0);
+	EXPECT_EQ(ringBufFind(&rb, sync, 2), (int)data.size() - 100);
+
+	// Threaded transfer, mutex around the current ring buffer vs SPSC
+	const size_t total = 16 * 1024 * 1024;
+	std::mutex mutex;
+	ringBufClear(&rb);
+	start = std::chrono::high_resolution_clock::now();
+	std::thread producer([&]()
+	{
+		uint8_t chunk[1024] = {};
+		for (size_t sent = 0; sent < total; )
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (ringBufFree(&rb) >= (int)sizeof(chunk))
+			{
+				ringBufWrite(&rb, chunk, sizeof(chunk));
+				sent += sizeof(chunk);
+			}
+		}
+	});
+	uint8_t out[4096];
+	for (size_t received = 0; received < total; )
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		received += ringBufRead(&rb, out, sizeof(out));
+	}
+	producer.join();
+	double mutexSec = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	size_t received;
+	bool ordered;
+	spscTransfer(total, received, ordered);
+	double spscSec = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+	EXPECT_TRUE(ordered);
+
+	printf("ringBufFind 64 KB: %.1f us (was %.1f us)   transfer: SPSC %.0f MB/s, mutex %.0f MB/s\n",
+		findSec / reps * 1e6, referenceSec / reps * 1e6, total / spscSec * 1e-6, total / mutexSec * 1e-6);
+}
+
@@ -0,0 +1,568 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "com_manager.h"
+#include "ring_buffer.h"
+#include "InertialSense.h"
+#include "ISFileManager.h"
+#include "test_data_utils.h"
+#if !PLATFORM_IS_WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/**
+ * End-to-end receive latency.  Generated device traffic, each data set stamped with a sequence number, is written to a
+ * port at a fixed packet rate.  The port is read and parsed either by a com manager instance (memory port, like a
+ * serial driver receive buffer) or by InertialSense::Update() (pty, through the serial port layer and the
+ * InertialSense binary callbacks).  Received data sets are queued to a logger thread that writes them with
+ * cISLogger::LogData() on the same period as InertialSense::LoggerThread.
+ *
+ * The timed benchmarks take seconds and their loss depends on host scheduling, so they only run with RX_BENCH set.  By
+ * default only a short functional run of the same pipeline is checked.
+ *
+ * Environment overrides for manual runs: RX_BENCH_RATE (packets/s), RX_BENCH_SECONDS, RX_BENCH_DIDS (e.g. "1,3,4").
+ */
+
+enum eRxPort
+{
+	RX_PORT_MEMORY,
+	RX_PORT_PTY,
+};
+
+enum eRxStage
+{
+	RX_STAGE_PORT,          // Written to the port until read by the com manager (memory port only)
+	RX_STAGE_PARSE,         // Read until the binary data callback (includes the port stage on a pty)
+	RX_STAGE_LOG,           // Binary data callback until cISLogger::LogData() returns
+	RX_STAGE_TOTAL,
+	RX_STAGE_COUNT
+};
+
+static const char* s_stageNames[RX_STAGE_COUNT] = { "port", "parse", "log", "total" };
+
+struct sRxBenchOptions
+{
+	eRxPort port = RX_PORT_MEMORY;
+	double rateHz = 2000;                   // Packets per second
+	double seconds = 1.0;
+	vector<uint32_t> dids;                  // Data sets to send, empty for the generated mix of DID_PIMU, DID_INS_1, DID_GPS1_POS, DID_GPS1_VEL
+	int portBufferSize = 4096;              // Memory port receive buffer, packets that don't fit are dropped
+	uint32_t rxPollUs = 1000;               // Sleep between port reads when nothing was received
+	uint32_t logPeriodMs = 20;              // As InertialSense::LoggerThread
+	cISLogger::eLogType logType = cISLogger::LOGTYPE_DAT;
+};
+
+struct sRxBenchResult
+{
+	size_t sent = 0;
+	size_t dropped = 0;                     // Didn't fit in the port
+	size_t received = 0;
+	size_t logged = 0;
+	size_t bytes = 0;
+	double achievedHz = 0;                  // Packets written per second, lower than the rate if the writer fell behind
+	vector<double> latencyUs[RX_STAGE_COUNT];
+
+	bool Lossless(double rateHz) const { return dropped == 0 && received == sent && logged == sent && achievedHz > 0.99 * rateHz; }
+};
+
+
+class cRxBench
+{
+public:
+	sRxBenchResult Run(const sRxBenchOptions& options)
+	{
+		m_options = options;
+		sRxBenchResult result;
+		GeneratePackets();
+		size_t count = m_packets.size();
+		m_writeNs.assign(count, 0);
+		m_parseNs.assign(count, 0);
+		m_logNs.assign(count, 0);
+		m_endOffset.assign(count, -1);
+		m_reads.clear();
+		m_readBytes = 0;
+		m_received = 0;
+		m_logged = 0;
+		m_running = true;
+
+		string directory = "test_rx_latency_log";
+		ISFileManager::DeleteDirectory(directory);
+		cISLogger::sSaveOptions logOptions;
+		logOptions.logType = options.logType;
+		logOptions.useSubFolderTimestamp = false;
+		m_logger.InitSave(directory, logOptions);
+		dev_info_t info = {};
+		info.hardwareType = IS_HARDWARE_TYPE_IMX;
+		info.hardwareVer[0] = 5;
+		info.serialNumber = 123456;
+		m_devLog = m_logger.registerDevice(info);
+		m_logger.EnableLogging(true);
+		thread logThread(&cRxBench::LoggerThread, this);
+
+		bool opened = (options.port == RX_PORT_MEMORY ? OpenMemoryPort() : OpenPty());
+		EXPECT_TRUE(opened);
+		thread rxThread;
+		if (opened)
+		{
+			rxThread = thread(&cRxBench::RxThread, this);
+			result.achievedHz = Write(result);
+		}
+
+		// Let the pipeline drain
+		int64_t timeout = nowNs() + 2000000000LL;
+		while (nowNs() < timeout && (m_received < result.sent - result.dropped || m_logged < m_received))
+		{
+			this_thread::sleep_for(chrono::milliseconds(1));
+		}
+		m_running = false;
+		if (rxThread.joinable())
+		{
+			rxThread.join();
+		}
+		logThread.join();
+		Close();
+		m_logger.CloseAllFiles();
+		ISFileManager::DeleteDirectory(directory);
+
+		result.received = m_received;
+		result.logged = m_logged;
+		Latencies(result);
+		return result;
+	}
+
+	static double Percentile(vector<double> values, double p)
+	{
+		if (values.empty())
+		{
+			return 0;
+		}
+		size_t n = _MIN((size_t)(p * values.size()), values.size() - 1);
+		nth_element(values.begin(), values.begin() + n, values.end());
+		return values[n];
+	}
+
+	static void Print(const sRxBenchOptions& options, const sRxBenchResult& result)
+	{
+		printf("%s %.0f pkt/s (%.0f achieved, %.2f MB/s): sent %zu  dropped %zu  received %zu  logged %zu\n",
+			(options.port == RX_PORT_MEMORY ? "memory" : "pty"), options.rateHz, result.achievedHz,
+			result.bytes / options.seconds * 1e-6, result.sent, result.dropped, result.received, result.logged);
+		for (int s = 0; s < RX_STAGE_COUNT; s++)
+		{
+			const vector<double>& us = result.latencyUs[s];
+			if (us.size())
+			{
+				printf("    %-6s p50 %8.1f us   p99 %8.1f us   p99.9 %8.1f us\n", s_stageNames[s], Percentile(us, 0.5), Percentile(us, 0.99), Percentile(us, 0.999));
+			}
+		}
+	}
+
+private:
+	static int64_t nowNs()
+	{
+		return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Generated data sets at the configured rate, sequence number in the last 4 bytes
+	void GeneratePackets()
+	{
+		m_packets.clear();
+		size_t count = (size_t)(m_options.rateHz * m_options.seconds);
+		test_message_t msg = {};
+		uint8_t comBuf[PKT_BUF_SIZE];
+		is_comm_init(&msg.comm, comBuf, PKT_BUF_SIZE);
+		is_comm_instance_t comm;
+		uint8_t pktBuf[PKT_BUF_SIZE];
+		is_comm_init(&comm, pktBuf, PKT_BUF_SIZE);
+
+		for (uint32_t timeMs = 0; m_packets.size() < count && timeMs < 100000000; timeMs += 10)
+		{
+			while (m_packets.size() < count && GenerateMessageAtTimeMs(msg, timeMs, _PTYPE_INERTIAL_SENSE_DATA))
+			{
+				if ((m_options.dids.size() && find(m_options.dids.begin(), m_options.dids.end(), msg.dataHdr.id) == m_options.dids.end()) || msg.dataHdr.size < 4)
+				{
+					continue;
+				}
+				uint32_t seq = (uint32_t)m_packets.size();
+				memcpy((uint8_t*)&msg.data + msg.dataHdr.size - 4, &seq, 4);
+				int n = is_comm_data_to_buf(pktBuf, sizeof(pktBuf), &comm, msg.dataHdr.id, msg.dataHdr.size, 0, (void*)&msg.data);
+				m_packets.emplace_back(pktBuf, pktBuf + n);
+			}
+		}
+		EXPECT_EQ(count, m_packets.size());
+	}
+
+	bool OpenMemoryPort()
+	{
+		s_bench = this;
+		m_portBuffer.resize(m_options.portBufferSize);
+		ringBufSpscInit(&m_portRing, m_portBuffer.data(), (int)m_portBuffer.size());
+
+		com_manager_init_t cmInit = {};
+		cmInit.broadcastMsg = m_cmBcastMsg;
+		cmInit.broadcastMsgSize = sizeof(m_cmBcastMsg);
+		is_comm_callbacks_t callbacks = {};
+		if (comManagerInitInstance(&m_cm, 1, 1, staticMemoryRead, staticPortWrite, 0, staticProcessRxData, 0, 0, &cmInit, &m_cmPort, &callbacks))
+		{
+			return false;
+		}
+		m_cmPort.comm.config.enabledMask |= (uint32_t)ENABLE_PROTOCOL_ISB;
+		return true;
+	}
+
+	bool OpenPty()
+	{
+#if PLATFORM_IS_WINDOWS
+		return false;
+#else
+		m_ptyMaster = posix_openpt(O_RDWR | O_NOCTTY);
+		if (m_ptyMaster < 0 || grantpt(m_ptyMaster) || unlockpt(m_ptyMaster))
+		{
+			return false;
+		}
+		fcntl(m_ptyMaster, F_SETFL, fcntl(m_ptyMaster, F_GETFL) | O_NONBLOCK);
+		string slave = ptsname(m_ptyMaster);
+
+		m_is.reset(new InertialSense([this](InertialSense* i, p_data_t* data, int pHandle) { OnData(data); }));
+		m_is->EnableDeviceValidation(false);
+		return m_is->Open(slave.c_str(), 921600);
+#endif
+	}
+
+	void Close()
+	{
+		if (m_is)
+		{
+			m_is->Close();
+			m_is.reset();
+		}
+#if !PLATFORM_IS_WINDOWS
+		if (m_ptyMaster >= 0)
+		{
+			close(m_ptyMaster);
+			m_ptyMaster = -1;
+		}
+#endif
+		s_bench = NULLPTR;
+	}
+
+	// Paced writer.  Returns the packet rate achieved.
+	double Write(sRxBenchResult& result)
+	{
+		int64_t start = nowNs();
+		double periodNs = 1e9 / m_options.rateHz;
+		int64_t written = 0;
+		for (size_t i = 0; i < m_packets.size(); i++)
+		{
+			int64_t due = start + (int64_t)(i * periodNs);
+			int64_t now;
+			while ((now = nowNs()) < due)
+			{
+				if (due - now > 200000)
+				{
+					this_thread::sleep_for(chrono::microseconds(100));
+				}
+			}
+
+			const vector<uint8_t>& pkt = m_packets[i];
+			m_writeNs[i] = now;
+			result.sent++;
+			if (m_options.port == RX_PORT_MEMORY)
+			{
+				if (ringBufSpscFree(&m_portRing) < (int)pkt.size())
+				{   // Receive buffer overrun
+					result.dropped++;
+					continue;
+				}
+				written += pkt.size();
+				m_endOffset[i] = written;
+				ringBufSpscWrite(&m_portRing, pkt.data(), (int)pkt.size());
+			}
+#if !PLATFORM_IS_WINDOWS
+			else
+			{
+				// Finish a partial write so the stream stays intact.  Drain what InertialSense sends back.
+				size_t n = 0;
+				uint8_t discard[256];
+				while (n < pkt.size() && m_running)
+				{
+					ssize_t w = write(m_ptyMaster, pkt.data() + n, pkt.size() - n);
+					if (w > 0)
+					{
+						n += w;
+					}
+					else
+					{
+						while (read(m_ptyMaster, discard, sizeof(discard)) > 0) {}
+						this_thread::yield();
+					}
+				}
+				written += n;
+			}
+#endif
+			result.bytes += pkt.size();
+		}
+		double sec = (nowNs() - start) * 1e-9;
+		return (sec > 0 ? result.sent / sec : 0);
+	}
+
+	void RxThread()
+	{
+		while (m_running)
+		{
+			size_t before = m_readBytes;
+			if (m_options.port == RX_PORT_MEMORY)
+			{
+				comManagerStepRxInstance(&m_cm, (uint32_t)(nowNs() / 1000000));
+			}
+			else
+			{
+				m_is->Update();
+			}
+			if (m_options.port == RX_PORT_MEMORY && m_readBytes == before)
+			{
+				this_thread::sleep_for(chrono::microseconds(m_options.rxPollUs));
+			}
+		}
+	}
+
+	int MemoryRead(uint8_t* buf, int len)
+	{
+		int n = ringBufSpscRead(&m_portRing, buf, len);
+		if (n > 0)
+		{
+			m_readBytes += n;
+			m_reads.push_back({ nowNs(), (int64_t)m_readBytes });
+		}
+		return n;
+	}
+
+	// Binary data callback
+	void OnData(p_data_t* data)
+	{
+		uint32_t seq;
+		if (data->hdr.offset != 0 || data->hdr.size < 4)
+		{
+			return;
+		}
+		memcpy(&seq, data->ptr + data->hdr.size - 4, 4);
+		if (seq >= m_parseNs.size() || m_parseNs[seq])
+		{
+			return;
+		}
+		m_parseNs[seq] = nowNs();
+
+		p_data_buf_t pkt;
+		pkt.hdr = data->hdr;
+		memcpy(pkt.buf, data->ptr, data->hdr.size);
+		cMutexLocker lock(&m_logMutex);
+		m_logPackets.push_back(pkt);
+		m_received++;
+	}
+
+	// Same batching as InertialSense::LoggerThread
+	void LoggerThread()
+	{
+		vector<p_data_buf_t> packets;
+		bool running = true;
+		while (running)
+		{
+			this_thread::sleep_for(chrono::milliseconds(m_options.logPeriodMs));
+			running = m_running;
+			{
+				cMutexLocker lock(&m_logMutex);
+				packets.swap(m_logPackets);
+			}
+			for (p_data_buf_t& pkt : packets)
+			{
+				m_logger.LogData(m_devLog, &pkt.hdr, pkt.buf);
+				uint32_t seq;
+				memcpy(&seq, pkt.buf + pkt.hdr.size - 4, 4);
+				m_logNs[seq] = nowNs();
+				m_logged++;
+			}
+			packets.clear();
+			m_logger.Update();
+		}
+	}
+
+	void Latencies(sRxBenchResult& result)
+	{
+		// Read time of each packet is the read that completed it
+		vector<int64_t> readNs(m_packets.size(), 0);
+		size_t r = 0;
+		for (size_t i = 0; i < m_packets.size(); i++)
+		{
+			if (m_endOffset[i] < 0)
+			{
+				continue;
+			}
+			while (r < m_reads.size() && m_reads[r].second < m_endOffset[i])
+			{
+				r++;
+			}
+			if (r < m_reads.size())
+			{
+				readNs[i] = m_reads[r].first;
+			}
+		}
+
+		for (size_t i = 0; i < m_packets.size(); i++)
+		{
+			if (!m_parseNs[i] || !m_logNs[i])
+			{
+				continue;
+			}
+			if (readNs[i])
+			{
+				result.latencyUs[RX_STAGE_PORT].push_back((readNs[i] - m_writeNs[i]) * 1e-3);
+				result.latencyUs[RX_STAGE_PARSE].push_back((m_parseNs[i] - readNs[i]) * 1e-3);
+			}
+			else
+			{
+				result.latencyUs[RX_STAGE_PARSE].push_back((m_parseNs[i] - m_writeNs[i]) * 1e-3);
+			}
+			result.latencyUs[RX_STAGE_LOG].push_back((m_logNs[i] - m_parseNs[i]) * 1e-3);
+			result.latencyUs[RX_STAGE_TOTAL].push_back((m_logNs[i] - m_writeNs[i]) * 1e-3);
+		}
+	}
+
+	static int staticMemoryRead(unsigned int port, uint8_t* buf, int len) { return s_bench->MemoryRead(buf, len); }
+	static int staticPortWrite(unsigned int port, const uint8_t* buf, int len) { return len; }
+	static int staticProcessRxData(unsigned int port, p_data_t* data) { s_bench->OnData(data); return 0; }
+
+	static cRxBench* s_bench;
+
+	sRxBenchOptions m_options;
+	vector<vector<uint8_t>> m_packets;
+	vector<int64_t> m_writeNs;
+	vector<int64_t> m_parseNs;
+	vector<int64_t> m_logNs;
+	vector<int64_t> m_endOffset;                // Stream offset of the end of each packet, -1 if dropped
+	vector<pair<int64_t, int64_t>> m_reads;     // Time and stream offset after each port read
+	size_t m_readBytes = 0;
+	atomic<size_t> m_received;
+	atomic<size_t> m_logged;
+	atomic<bool> m_running;
+
+	// Memory port
+	vector<uint8_t> m_portBuffer;
+	ring_buf_spsc_t m_portRing;
+	com_manager_t m_cm = {};
+	com_manager_port_t m_cmPort = {};
+	broadcast_msg_t m_cmBcastMsg[MAX_NUM_BCAST_MSGS] = {};
+
+	// pty
+	unique_ptr<InertialSense> m_is;
+	int m_ptyMaster = -1;
+
+	cISLogger m_logger;
+	shared_ptr<cDeviceLog> m_devLog;
+	cMutex m_logMutex;
+	vector<p_data_buf_t> m_logPackets;
+};
+
+cRxBench* cRxBench::s_bench = NULLPTR;
+
+
+static sRxBenchOptions benchOptions(eRxPort port)
+{
+	sRxBenchOptions options;
+	options.port = port;
+	if (const char* rate = getenv("RX_BENCH_RATE"))
+	{
+		options.rateHz = atof(rate);
+	}
+	if (const char* seconds = getenv("RX_BENCH_SECONDS"))
+	{
+		options.seconds = atof(seconds);
+	}
+	if (const char* dids = getenv("RX_BENCH_DIDS"))
+	{
+		for (char* s = (char*)dids; *s; s++)
+		{
+			options.dids.push_back((uint32_t)strtoul(s, &s, 10));
+			if (*s == 0)
+			{
+				break;
+			}
+		}
+	}
+	return options;
+}
+
+
+#define SKIP_UNLESS_RX_BENCH()     if (!getenv("RX_BENCH")) { GTEST_SKIP() << "Set RX_BENCH to run"; }
+
+
+// Every packet passes through parsing and logging.  The port buffer holds the whole run, so nothing is dropped
+// however the threads are scheduled.
+TEST(RxLatency, functional)
+{
+	sRxBenchOptions options;
+	options.rateHz = 1000;
+	options.seconds = 0.1;
+	options.portBufferSize = 100 * PKT_BUF_SIZE;
+	cRxBench bench;
+	sRxBenchResult result = bench.Run(options);
+	EXPECT_EQ(100u, result.sent);
+	EXPECT_EQ(0u, result.dropped);
+	EXPECT_EQ(result.sent, result.received);
+	EXPECT_EQ(result.sent, result.logged);
+	EXPECT_EQ(result.latencyUs[RX_STAGE_TOTAL].size(), result.logged);
+}
+
+
+TEST(RxLatency, memory_port)
+{
+	SKIP_UNLESS_RX_BENCH();
+	sRxBenchOptions options = benchOptions(RX_PORT_MEMORY);
+	cRxBench bench;
+	sRxBenchResult result = bench.Run(options);
+	cRxBench::Print(options, result);
+	EXPECT_EQ(result.sent, result.received + result.dropped);
+	EXPECT_EQ(result.received, result.logged);
+	EXPECT_EQ(result.latencyUs[RX_STAGE_TOTAL].size(), result.logged);
+}
+
+
+#if !PLATFORM_IS_WINDOWS
+TEST(RxLatency, pty_inertial_sense)
+{
+	SKIP_UNLESS_RX_BENCH();
+	sRxBenchOptions options = benchOptions(RX_PORT_PTY);
+	cRxBench bench;
+	sRxBenchResult result = bench.Run(options);
+	cRxBench::Print(options, result);
+	EXPECT_EQ(result.sent, result.received);
+	EXPECT_EQ(result.received, result.logged);
+}
+#endif
+
+
+// Highest packet rate without loss, doubling until packets are dropped or the pipeline falls behind
+TEST(RxLatency, throughput)
+{
+	SKIP_UNLESS_RX_BENCH();
+	sRxBenchOptions options = benchOptions(RX_PORT_MEMORY);
+	options.seconds = 0.25;
+	double best = 0;
+	for (double rate = 1000; rate <= 512000; rate *= 2)
+	{
+		options.rateHz = rate;
+		cRxBench bench;
+		sRxBenchResult result = bench.Run(options);
+		cRxBench::Print(options, result);
+		if (!result.Lossless(rate))
+		{
+			break;
+		}
+		best = rate;
+	}
+	printf("Sustained without loss: %.0f pkt/s (%d byte port buffer, %u us poll)\n", best, options.portBufferSize, options.rxPollUs);
+	EXPECT_GT(best, 0);
+}